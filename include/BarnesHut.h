@@ -0,0 +1,105 @@
+/**
+ * @file BarnesHut.h
+ * @brief Motor de fuerzas de Barnes-Hut basado en un árbol octal
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef BARNESHUT_H
+#define BARNESHUT_H
+
+#include <vector>
+#include "vector3D.h"
+#include "SistemaCuerpos.h"
+#include "Octree.h"
+
+/**
+ * @brief Calcula fuerzas gravitacionales aproximadas en O(N log N)
+ * @details Agrupa los cuerpos lejanos de cada celda del árbol octal en su
+ *          centro de masa. Los cuerpos se reparten en grupos (las celdas más
+ *          altas con a lo sumo 64 cuerpos) y cada grupo recorre el árbol una
+ *          sola vez: una celda de lado s cuyo centro de masa está a distancia
+ *          d de la caja del grupo se acepta como monopolo si s/d < θ (criterio
+ *          igual o más estricto que el de cada cuerpo por separado); si no,
+ *          se abren sus hijos, y los cuerpos de las hojas abiertas se suman
+ *          directamente. Monopolos y cuerpos forman una lista común que todos
+ *          los cuerpos del grupo recorren en un bucle contiguo con el núcleo
+ *          r²·√r² de la suma directa. Con θ = 0 el resultado coincide con la
+ *          suma directa.
+ * @note Se evalúa en un solo hilo; la opción hilos solo afecta a la suma directa
+ * @see Octree
+ */
+class BarnesHut {
+public:
+    /**
+     * @brief Constructor
+     * @param theta Ángulo de apertura θ (típicamente entre 0.3 y 1.0)
+     * @param max_hoja Número máximo de cuerpos por hoja del árbol
+     * @pre theta >= 0
+     */
+    explicit BarnesHut(double theta = 0.5, int max_hoja = 8);
+
+    /**
+     * @brief Calcula las aceleraciones de todos los cuerpos
+     * @param cuerpos Sistema con posiciones y masas actuales
+     * @param aceleraciones Salida con la aceleración de cada cuerpo, igual
+     *        que calcularTodasLasFuerzas
+     * @param energia_potencial Si no es nulo, recibe la energía potencial
+     *        total ½·Σ mᵢ·φᵢ, con los potenciales φᵢ acumulados en el mismo
+     *        recorrido del árbol (misma aproximación que las fuerzas)
+     * @pre aceleraciones.tamano() == cuerpos.tamano()
+     */
+    void calcularFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                         double* energia_potencial = 0);
+
+    /**
+     * @brief Calcula las aceleraciones de un subconjunto de cuerpos
+     * @param cuerpos Sistema con posiciones y masas actuales (de todos los cuerpos)
+     * @param objetivos Índices de los cuerpos cuya aceleración se calcula
+     * @param n_objetivos Número de índices
+     * @param aceleraciones Salida; solo se escriben las entradas de los objetivos
+     * @details Construye el árbol con todos los cuerpos y solo lo recorre
+     *          para los objetivos
+     */
+    void calcularFuerzasSobre(const SistemaCuerpos& cuerpos, const int* objetivos, int n_objetivos,
+                              Aceleraciones& aceleraciones);
+
+    /// Cambia el ángulo de apertura θ
+    void fijarTheta(double theta) { theta_ = theta; }
+
+    /// Ángulo de apertura θ actual
+    double theta() const { return theta_; }
+
+    /// Número de celdas del último árbol construido
+    int numeroNodos() const { return static_cast<int>(arbol_.nodos().size()); }
+
+private:
+    /**
+     * @brief Calcula la aceleración de un grupo de cuerpos con una lista de interacción común
+     * @param grupo Índices de los cuerpos del grupo
+     * @param n_grupo Número de cuerpos del grupo (>= 1)
+     * @param cuerpos Sistema con posiciones y masas actuales
+     * @param aceleraciones Salida; solo se escriben las entradas del grupo
+     * @param con_potencial Si es true, acumula también los potenciales
+     * @return ½·Σ mᵢ·φᵢ del grupo (0 si con_potencial es false)
+     */
+    double evaluarGrupo(const int* grupo, int n_grupo, const SistemaCuerpos& cuerpos,
+                        Aceleraciones& aceleraciones, bool con_potencial);
+
+    /**
+     * @brief Recorre el árbol para la caja [minimo, maximo] y llena la lista de interacción
+     * @param minimo Esquina inferior de la caja del grupo
+     * @param maximo Esquina superior de la caja del grupo
+     * @param cuerpos Sistema con posiciones y masas actuales
+     */
+    void construirLista(const double* minimo, const double* maximo, const SistemaCuerpos& cuerpos);
+
+    Octree arbol_;                ///< Árbol octal reconstruido en cada evaluación
+    std::vector<int> pila_;       ///< Pila para repartir los cuerpos en grupos
+    std::vector<int> recorrido_;  ///< Pila del recorrido de cada grupo
+    std::vector<double> lista_x_, lista_y_, lista_z_; ///< Posiciones de la lista de interacción
+    std::vector<double> lista_gm_; ///< G·masa de cada entrada de la lista
+    double theta_;                ///< Ángulo de apertura
+};
+
+#endif // BARNESHUT_H
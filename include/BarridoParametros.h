@@ -0,0 +1,144 @@
+/**
+ * @file BarridoParametros.h
+ * @brief Barridos de parámetros en una rejilla ejecutados dentro del mismo proceso
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef BARRIDOPARAMETROS_H
+#define BARRIDOPARAMETROS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Cuerpo.h"
+#include "Trayectoria.h"
+
+/// Parámetro que varía a lo largo de una dimensión del barrido
+enum ParametroBarrido {
+    BARRIDO_DT = 0,   ///< Paso de tiempo
+    BARRIDO_MASA,     ///< Masa de un cuerpo
+    BARRIDO_VELOCIDAD ///< Factor que multiplica la velocidad inicial de un cuerpo (o de todos)
+};
+
+/**
+ * @brief Una dimensión de la rejilla: un parámetro y sus valores
+ */
+struct DimensionBarrido {
+    ParametroBarrido parametro; ///< Parámetro que varía
+    int cuerpo;                 ///< Cuerpo afectado, desde 0 (-1 = todos; sin uso para dt)
+    std::vector<double> valores; ///< Valores de la dimensión, en orden
+};
+
+/**
+ * @brief Interpreta una dimensión escrita como en el escenario
+ * @param texto `dt v1 v2 ...`, `masa k m1 m2 ...` o `velocidad k f1 f2 ...`,
+ *        con k desde 1 (0 = todos los cuerpos, solo para velocidad)
+ * @param dimension Dimensión resultante
+ * @param error Descripción del problema si el texto no es válido
+ * @return true si el texto es válido (dt y masas positivos, al menos un valor)
+ */
+bool interpretarDimensionBarrido(const std::string& texto, DimensionBarrido& dimension, std::string& error);
+
+/// Nombre de la columna de una dimensión en el resumen (dt, masa_2, velocidad_todos...)
+std::string nombreDimensionBarrido(const DimensionBarrido& dimension);
+
+/// Resultado de un trabajo del barrido
+struct ResultadoTrabajo {
+    long pasos;             ///< Pasos de integración dados
+    double energia_inicial; ///< Energía total en t = 0
+    double energia_final;   ///< Energía total en t_max
+    double error_energia;   ///< |E - E₀| / |E₀| al final
+    double segundos;        ///< Tiempo de pared del trabajo
+    int hilo;               ///< Hilo que lo ejecutó
+    bool escrito;           ///< false si no se pudo abrir su archivo de salida
+};
+
+/**
+ * @brief Barrido de dt, masas y velocidades iniciales sobre una rejilla
+ * @details Cada combinación de valores de las dimensiones es un trabajo: una
+ *          integración completa con Verlet de velocidades y la suma directa
+ *          vectorizada de un hilo, con su propio SistemaCuerpos, su propio
+ *          archivo de trayectoria y ningún estado global, de modo que los
+ *          trabajos se ejecutan en paralelo dentro del proceso. Los hilos se
+ *          reparten los trabajos con GrupoTareas, que estima el costo de cada
+ *          uno como el número de pasos t_max/dt.
+ *
+ *          El trabajo k recorre las dimensiones como un número en base mixta:
+ *          la última dimensión es la que varía más rápido.
+ */
+class BarridoParametros {
+public:
+    BarridoParametros();
+
+    /**
+     * @brief Expande la rejilla en trabajos
+     * @param cuerpos Sistema base
+     * @param dt Paso base (lo reemplaza una dimensión dt)
+     * @param t_max Tiempo simulado de cada trabajo
+     * @param dimensiones Dimensiones de la rejilla (al menos una)
+     * @param error Descripción del problema si un cuerpo de las dimensiones no existe
+     * @return true si la rejilla es válida
+     */
+    bool configurar(const std::vector<Cuerpo>& cuerpos, double dt, double t_max,
+                    const std::vector<DimensionBarrido>& dimensiones, std::string& error);
+
+    /// Número de trabajos
+    int trabajos() const { return static_cast<int>(resultados_.size()); }
+
+    /// Valor de la dimensión d en el trabajo k
+    double valor(int k, int d) const;
+
+    /// Paso de tiempo del trabajo k
+    double dtTrabajo(int k) const;
+
+    /**
+     * @brief Ejecuta todos los trabajos
+     * @param directorio Directorio (ya existente) donde se crean los archivos trabajo_NNNN.*
+     * @param formato Formato de las trayectorias
+     * @param cada_pasos Escribir un cuadro cada k pasos
+     * @param hilos Hilos del grupo (0 = todos los núcleos)
+     * @return Número de trabajos cuyo archivo no se pudo escribir
+     */
+    int ejecutar(const std::string& directorio, FormatoTrayectoria formato, int cada_pasos, int hilos);
+
+    /// Resultado del trabajo k (válido después de ejecutar())
+    const ResultadoTrabajo& resultado(int k) const { return resultados_[k]; }
+
+    /// Ruta del archivo de trayectoria del trabajo k
+    const std::string& archivoTrabajo(int k) const { return archivos_[k]; }
+
+    /**
+     * @brief Escribe la tabla resumen: una línea por trabajo con sus valores,
+     *        pasos, error de energía, tiempo, hilo y archivo
+     * @param ruta Archivo de salida
+     * @return false si no se pudo escribir
+     */
+    bool guardarResumen(const std::string& ruta) const;
+
+    /// Imprime el reparto entre hilos: tiempo total, eficiencia y robos
+    void imprimirReparto(std::ostream& salida) const;
+
+private:
+    /**
+     * @brief Integra el trabajo k y escribe su trayectoria
+     * @param k Índice del trabajo
+     * @param formato Formato de la trayectoria
+     * @param cada_pasos Escribir un cuadro cada k pasos
+     * @return Resultado del trabajo (sin el hilo)
+     */
+    ResultadoTrabajo ejecutarTrabajo(int k, FormatoTrayectoria formato, int cada_pasos) const;
+
+    std::vector<Cuerpo> cuerpos_;                ///< Sistema base
+    double dt_;                                  ///< Paso base
+    double t_max_;                               ///< Tiempo simulado de cada trabajo
+    std::vector<DimensionBarrido> dimensiones_;  ///< Dimensiones de la rejilla
+    std::vector<ResultadoTrabajo> resultados_;   ///< Resultado por trabajo
+    std::vector<std::string> archivos_;          ///< Trayectoria por trabajo
+    int hilos_;                                  ///< Hilos de la última ejecución
+    double segundos_totales_;                    ///< Duración de la última ejecución
+    double eficiencia_;                          ///< Fracción ocupada de los hilos
+    long robos_;                                 ///< Robos de la última ejecución
+};
+
+#endif // BARRIDOPARAMETROS_H
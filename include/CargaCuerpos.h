@@ -0,0 +1,82 @@
+/**
+ * @file CargaCuerpos.h
+ * @brief Carga masiva de condiciones iniciales desde archivos CSV o binarios
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef CARGACUERPOS_H
+#define CARGACUERPOS_H
+
+#include <string>
+#include <cstdint>
+#include "SistemaCuerpos.h"
+
+/// Identificador al inicio de un archivo binario de condiciones iniciales
+const char MAGIA_CUERPOS[9] = "NCONDINI";
+
+/// Versión actual del formato binario de condiciones iniciales
+const std::uint32_t VERSION_CUERPOS = 1;
+
+/// Separación mínima entre posiciones iniciales (la misma de verificarDatos)
+const double SEPARACION_MINIMA_CUERPOS = 1e-6;
+
+/// Resultado y rendimiento de una carga
+struct EstadisticasCarga {
+    int cuerpos;      ///< Cuerpos cargados
+    long bytes;       ///< Tamaño del archivo
+    double segundos;  ///< Tiempo de pared de la carga (mapeo, lectura y validación)
+    int hilos;        ///< Hilos usados
+    bool binario;     ///< true si el archivo era binario
+
+    /// Cuerpos cargados por segundo
+    double cuerposPorSegundo() const { return segundos > 0 ? cuerpos / segundos : 0.0; }
+};
+
+/**
+ * @brief Carga las condiciones iniciales de un archivo en un sistema
+ * @param ruta Archivo CSV o binario (se distingue por la firma MAGIA_CUERPOS)
+ * @param cuerpos Sistema que se redimensiona y se llena directamente
+ * @param hilos Hilos de lectura (0 = todos los núcleos)
+ * @param estadisticas Cuerpos, bytes, tiempo y hilos de la carga
+ * @param error Descripción del problema (con número de línea en CSV) si la carga falla
+ * @return true si todos los cuerpos se leyeron y tienen masa > 0 y radio >= 0
+ * @details El archivo se proyecta en memoria con mmap y se reparte en
+ *          bloques contiguos entre los hilos.
+ *
+ *          CSV: una línea `masa, radio, x, y, z, vx, vy, vz` por cuerpo; se
+ *          aceptan comas, punto y coma, espacios o tabuladores como
+ *          separadores, líneas vacías, comentarios con `#` y una primera
+ *          línea de encabezado no numérica. Cada hilo cuenta las líneas de
+ *          su bloque, se calcula el índice del primer cuerpo de cada bloque
+ *          y en una segunda pasada cada hilo escribe sus cuerpos en su lugar.
+ *
+ *          Binario (little-endian, por columnas):
+ *          | desplazamiento | tipo       | contenido                        |
+ *          |----------------|------------|----------------------------------|
+ *          | 0              | char[8]    | "NCONDINI"                       |
+ *          | 8              | uint32     | versión (1)                      |
+ *          | 12             | uint32     | tamaño de la cabecera en bytes   |
+ *          | 16             | uint64     | N                                |
+ *          | cabecera       | float64[N] | m, R, x, y, z, vx, vy, vz (una columna tras otra) |
+ *          Las columnas se copian tal cual en los arreglos del sistema.
+ * @post Las aceleraciones quedan en cero
+ */
+bool cargarCuerpos(const std::string& ruta, SistemaCuerpos& cuerpos, int hilos,
+                   EstadisticasCarga& estadisticas, std::string& error);
+
+/**
+ * @brief Busca dos cuerpos con posiciones prácticamente coincidentes
+ * @param cuerpos Sistema a revisar
+ * @param distancia Distancia por debajo de la cual dos posiciones coinciden
+ * @param i Primer cuerpo del par (el de menor índice entre todos los pares)
+ * @param j Segundo cuerpo del par
+ * @return true si hay algún par más cercano que distancia
+ * @details Ordena los cuerpos por la coordenada de mayor extensión y solo
+ *          compara los que están a menos de distancia en esa coordenada:
+ *          O(N log N) para distribuciones no degeneradas, en lugar de los
+ *          N²/2 pares de la comparación directa.
+ */
+bool buscarPosicionesCoincidentes(const SistemaCuerpos& cuerpos, double distancia, int& i, int& j);
+
+#endif // CARGACUERPOS_H
@@ -0,0 +1,124 @@
+/**
+ * @file Composicion.h
+ * @brief Integradores simplécticos de orden alto por composición de pasos de Verlet
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef COMPOSICION_H
+#define COMPOSICION_H
+
+#include "SistemaCuerpos.h"
+
+/**
+ * @brief Coeficientes de Forest y Ruth (1990), cuarto orden, 3 etapas
+ * @details Salto triple θ, 1 - 2θ, θ con θ = 1/(2 - 2^(1/3))
+ */
+struct ForestRuth4 {
+    static const int orden = 4;  ///< Orden de la composición
+    static const int etapas = 3; ///< Pasos de Verlet (evaluaciones de fuerza) por paso
+
+    /// Fracción del paso dt que avanza la etapa k
+    static constexpr double peso(int k) {
+        return (k == 1) ? 1.0 - 2.0 * 1.3512071919596578 : 1.3512071919596578;
+    }
+};
+
+/**
+ * @brief Coeficientes de Yoshida (1990), sexto orden, 7 etapas (solución A)
+ * @details Secuencia simétrica w₃ w₂ w₁ w₀ w₁ w₂ w₃ con w₀ = 1 - 2(w₁ + w₂ + w₃)
+ */
+struct Yoshida6 {
+    static const int orden = 6;  ///< Orden de la composición
+    static const int etapas = 7; ///< Pasos de Verlet (evaluaciones de fuerza) por paso
+
+    /// Coeficiente wⱼ de la tabla de Yoshida
+    static constexpr double w(int j) {
+        return (j == 1) ? -1.17767998417887 :
+               (j == 2) ? 0.235573213359357 :
+               (j == 3) ? 0.784513610477560 :
+               1.0 - 2.0 * (-1.17767998417887 + 0.235573213359357 + 0.784513610477560);
+    }
+
+    /// Fracción del paso dt que avanza la etapa k
+    static constexpr double peso(int k) { return w(k < 3 ? 3 - k : k - 3); }
+};
+
+/**
+ * @brief Coeficientes de Yoshida (1990), octavo orden, 15 etapas (solución D)
+ * @details Secuencia simétrica w₇ … w₁ w₀ w₁ … w₇ con w₀ = 1 - 2(w₁ + … + w₇)
+ */
+struct Yoshida8 {
+    static const int orden = 8;   ///< Orden de la composición
+    static const int etapas = 15; ///< Pasos de Verlet (evaluaciones de fuerza) por paso
+
+    /// Coeficiente wⱼ de la tabla de Yoshida
+    static constexpr double w(int j) {
+        return (j == 1) ? 0.102799849391985 :
+               (j == 2) ? -1.96061023297549 :
+               (j == 3) ? 1.93813913762276 :
+               (j == 4) ? -0.158240635368243 :
+               (j == 5) ? -1.44485223686048 :
+               (j == 6) ? 0.253693336566229 :
+               (j == 7) ? 0.914844246229740 :
+               1.0 - 2.0 * (0.102799849391985 - 1.96061023297549 + 1.93813913762276 - 0.158240635368243
+                            - 1.44485223686048 + 0.253693336566229 + 0.914844246229740);
+    }
+
+    /// Fracción del paso dt que avanza la etapa k
+    static constexpr double peso(int k) { return w(k < 7 ? 7 - k : k - 7); }
+};
+
+/**
+ * @brief Etapas 0..K-1 de una composición, desenrolladas en tiempo de compilación
+ * @tparam Tabla ForestRuth4, Yoshida6 o Yoshida8 (o cualquier tabla con etapas y peso())
+ * @tparam K Número de etapas que quedan por aplicar
+ */
+template <class Tabla, int K>
+struct EtapasComposicion {
+    /**
+     * @brief Aplica las etapas 0..K-1: en cada una, un paso de Verlet de peso(k)·dt
+     * @details Cada etapa es Muevase_r, evaluación de a en la posición nueva,
+     *          Muevase_V e intercambio de aceleraciones, como pasoVerlet()
+     */
+    template <class Evaluador>
+    static void aplicar(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt,
+                        bool con_potencial, Evaluador evaluar) {
+        EtapasComposicion<Tabla, K - 1>::aplicar(cuerpos, a_siguiente, dt, con_potencial, evaluar);
+        const double h = Tabla::peso(K - 1) * dt;
+        cuerpos.Muevase_r(h);
+        evaluar(cuerpos, a_siguiente, con_potencial && K == Tabla::etapas);
+        cuerpos.Muevase_V(h, a_siguiente);
+        cuerpos.intercambiarAceleraciones(a_siguiente);
+    }
+};
+
+/// Caso base: sin etapas
+template <class Tabla>
+struct EtapasComposicion<Tabla, 0> {
+    template <class Evaluador>
+    static void aplicar(SistemaCuerpos&, Aceleraciones&, double, bool, Evaluador) {}
+};
+
+/**
+ * @brief Avanza un paso dt con una composición simétrica de pasos de Verlet
+ * @tparam Tabla Tabla de coeficientes (ForestRuth4, Yoshida6, Yoshida8)
+ * @param cuerpos Sistema a integrar; contiene a(t) al entrar y a(t+dt) al salir
+ * @param a_siguiente Buffer persistente de aceleraciones, como en pasoVerlet()
+ * @param dt Paso de tiempo
+ * @param con_potencial Si es true, la evaluación de la última etapa calcula también U
+ * @param evaluar Función o functor evaluar(cuerpos, aceleraciones, con_potencial)
+ * @details Verlet de velocidades es un método simétrico de segundo orden;
+ *          componer Tabla::etapas pasos de Verlet de tamaños peso(k)·dt, con
+ *          Σ peso(k) = 1, da un método simpléctico de orden Tabla::orden
+ *          (Yoshida, 1990). Algunos pesos son negativos: esas etapas retroceden
+ *          en el tiempo. Como la a(t+h) de una etapa es la a(t) de la siguiente,
+ *          cada etapa cuesta una evaluación de fuerzas.
+ */
+template <class Tabla, class Evaluador>
+inline void pasoComposicion(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt,
+                            bool con_potencial, Evaluador evaluar) {
+    EtapasComposicion<Tabla, Tabla::etapas>::aplicar(cuerpos, a_siguiente, dt, con_potencial, evaluar);
+}
+
+#endif // COMPOSICION_H
@@ -0,0 +1,211 @@
+/**
+ * @file ConjuntoSistemas.h
+ * @brief Conjunto de muchos sistemas pequeños integrados a la vez en carriles SIMD
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef CONJUNTOSISTEMAS_H
+#define CONJUNTOSISTEMAS_H
+
+#include <string>
+#include <vector>
+#include "Cuerpo.h"
+#include "FuerzasSIMD.h"
+#include "SistemaCuerpos.h"
+
+/// Situación de un miembro del conjunto
+enum EstadoMiembro {
+    MIEMBRO_ACTIVO = 0, ///< Todavía se integra
+    MIEMBRO_COMPLETO,   ///< Llegó al tiempo final sin eventos
+    MIEMBRO_COLISION,   ///< Dos cuerpos se tocaron (distancia < suma de radios)
+    MIEMBRO_ESCAPE      ///< Un cuerpo se alejó más que el radio de escape
+};
+
+/// Nombre de un estado (para la tabla de resultados)
+const char* nombreEstadoMiembro(EstadoMiembro estado);
+
+/**
+ * @brief Resultado de un miembro del conjunto
+ * @details Se completa cuando el miembro termina: por un evento durante
+ *          avanzar() o al llamar a finalizar()
+ */
+struct ResultadoMiembro {
+    EstadoMiembro estado;   ///< Cómo terminó (MIEMBRO_ACTIVO mientras se integra)
+    double t_fin;           ///< Tiempo simulado al terminar
+    long pasos;             ///< Pasos dados por el miembro
+    int cuerpo_a;           ///< Cuerpo que chocó o escapó (-1 si no hubo evento)
+    int cuerpo_b;           ///< Segundo cuerpo de la colisión (-1 si no la hubo)
+    double energia_inicial; ///< Energía total en t = 0
+    double energia_final;   ///< Energía total al terminar
+
+    /// Error relativo de energía |E - E₀| / |E₀|
+    double errorEnergia() const;
+};
+
+/**
+ * @brief Conjunto de M sistemas independientes de N cuerpos en paso fijo
+ * @details Guarda cada magnitud de cada cuerpo k en un arreglo de M carriles
+ *          contiguos, x[k·C + s] para el miembro del carril s (C = carriles
+ *          reservados, múltiplo de ANCHO_CARRILES). Un paso de Verlet avanza a
+ *          la vez todos los miembros de un registro: los pares (i, j) de los N
+ *          cuerpos se recorren una sola vez y cada operación actúa sobre 4 u 8
+ *          sistemas, en lugar de vectorizar sobre los j de un único sistema,
+ *          que con N = 2..5 dejaría casi vacíos los registros.
+ *
+ *          Cada carril repite exactamente las operaciones, en el mismo orden,
+ *          de calcularFuerzasEscalar y SistemaCuerpos::Muevase_r/Muevase_V, con
+ *          raíz y división exactas y sin FMA: la trayectoria de un miembro no
+ *          depende del nivel SIMD ni del carril que ocupe y coincide bit a bit
+ *          con la de un SistemaCuerpos integrado con la suma escalar.
+ *
+ *          Un miembro termina antes del final cuando dos de sus cuerpos se
+ *          tocan o cuando uno se aleja del centro de masa más que el radio de
+ *          escape. Su carril se enmascara (paso 0) y su estado se copia aparte;
+ *          cuando quedan activos menos de la mitad de los carriles recorridos,
+ *          los activos se compactan al principio para no gastar registros en
+ *          miembros terminados.
+ *
+ *          Toda la memoria se reserva en inicializar(): avanzar() no asigna.
+ */
+class ConjuntoSistemas {
+public:
+    /// Carriles por grupo (un registro AVX-512 de dobles); C es múltiplo de este valor
+    static const int ANCHO_CARRILES = 8;
+
+    ConjuntoSistemas();
+
+    /**
+     * @brief Crea M copias perturbadas de un sistema
+     * @param plantilla Cuerpos del sistema de referencia (masa > 0)
+     * @param miembros Número M de sistemas (>= 1)
+     * @param perturbacion Amplitud relativa ε de la perturbación gaussiana
+     * @param semilla Semilla del generador de perturbaciones
+     * @details El miembro 0 es la plantilla sin perturbar. En los demás, cada
+     *          componente de posición y de velocidad recibe ε·σ·N(0, 1), con σ
+     *          la distancia (o la rapidez) cuadrática media de la plantilla
+     *          respecto a su centro de masa. Después cada miembro se lleva a su
+     *          sistema centro de masa y se calculan a(0) y E₀.
+     */
+    void inicializar(const std::vector<Cuerpo>& plantilla, int miembros, double perturbacion,
+                     unsigned long semilla);
+
+    /**
+     * @brief Fija el radio de escape
+     * @param radio Distancia al centro de masa a partir de la cual un cuerpo escapa (0 = sin límite)
+     */
+    void fijarRadioEscape(double radio) { radio_escape_ = radio; }
+
+    /// Radio de escape (0 = sin límite)
+    double radioEscape() const { return radio_escape_; }
+
+    /**
+     * @brief Fija el conjunto de instrucciones del paso
+     * @param nivel Nivel deseado; se limita al detectado en la CPU
+     * @note Por defecto se usa nivelSIMDActivo()
+     */
+    void fijarNivelSIMD(NivelSIMD nivel);
+
+    /// Nivel SIMD del paso
+    NivelSIMD nivelSIMD() const { return nivel_; }
+
+    /**
+     * @brief Avanza los miembros activos
+     * @param dt Paso de tiempo
+     * @param pasos Número de pasos
+     * @return Miembros que siguen activos
+     * @details Se detiene antes si todos los miembros terminan
+     */
+    int avanzar(double dt, long pasos);
+
+    /// Marca como completos los miembros que siguen activos y guarda su estado
+    void finalizar();
+
+    /// Número M de sistemas
+    int miembros() const { return miembros_; }
+
+    /// Cuerpos N por sistema
+    int cuerpos() const { return n_; }
+
+    /// Miembros todavía activos
+    int activos() const { return activos_; }
+
+    /// Carriles recorridos en cada paso (múltiplo de ANCHO_CARRILES)
+    int carrilesRecorridos() const { return recorridos_; }
+
+    /// Tiempo simulado
+    double tiempo() const { return t_; }
+
+    /// Pasos de sistema dados: Σ de los pasos de cada miembro activo
+    double pasosSistemas() const { return pasos_sistemas_; }
+
+    /// Pasos de carril ejecutados: Σ de los carriles recorridos en cada paso
+    double pasosCarriles() const { return pasos_carriles_; }
+
+    /// Resultado del miembro dado
+    const ResultadoMiembro& resultado(int miembro) const { return resultados_[miembro]; }
+
+    /**
+     * @brief Estado actual de un cuerpo de un miembro
+     * @param miembro Índice del miembro
+     * @param k Índice del cuerpo
+     * @return Cuerpo con r, V, m y R (el estado final si el miembro terminó)
+     */
+    Cuerpo cuerpo(int miembro, int k) const;
+
+    /**
+     * @brief Energía total actual de un miembro
+     * @param miembro Índice del miembro
+     * @return K + U con la misma fórmula de pares que calcularFuerzasEscalar
+     */
+    double energia(int miembro) const;
+
+    /**
+     * @brief Escribe una línea por miembro: estado, tiempo final, pasos, cuerpos y error de energía
+     * @param ruta Archivo de salida
+     * @return false si no se pudo escribir
+     */
+    bool guardarResultados(const std::string& ruta) const;
+
+private:
+    /// Índice del cuerpo k en el carril s
+    int indice(int k, int s) const { return k * carriles_ + s; }
+
+    /// Calcula a(t) de todos los carriles recorridos sin mover nada
+    void calcularAceleracionesIniciales();
+
+    /// Energía total del miembro que ocupa el carril s
+    double energiaCarril(int s) const;
+
+    /// Termina el miembro del carril s: copia su estado y lo enmascara
+    void terminarCarril(int s, EstadoMiembro estado, int cuerpo_a, int cuerpo_b);
+
+    /// Lleva los carriles activos al principio y reduce los recorridos
+    void compactar();
+
+    int n_;            ///< Cuerpos por sistema
+    int miembros_;     ///< Sistemas M
+    int carriles_;     ///< Carriles reservados C (M redondeado a ANCHO_CARRILES)
+    int recorridos_;   ///< Carriles recorridos en cada paso (<= C)
+    int activos_;      ///< Miembros activos
+    double t_;         ///< Tiempo simulado
+    long pasos_;       ///< Pasos dados desde inicializar()
+    double radio_escape_; ///< Radio de escape (0 = sin límite)
+    NivelSIMD nivel_;  ///< Conjunto de instrucciones del paso
+    double pasos_sistemas_; ///< Pasos de miembros activos
+    double pasos_carriles_; ///< Pasos de carriles recorridos
+
+    VectorAlineado x_, y_, z_;    ///< Posiciones [k·C + s]
+    VectorAlineado vx_, vy_, vz_; ///< Velocidades
+    VectorAlineado ax_, ay_, az_; ///< Aceleraciones a(t)
+    VectorAlineado bx_, by_, bz_; ///< Aceleraciones a(t+dt) del paso en curso
+    VectorAlineado m_, R_;        ///< Masas y radios
+    VectorAlineado paso_;         ///< dt de cada carril (0 = enmascarado)
+    std::vector<int> evento_;     ///< Evento detectado en el último paso por carril (0 = ninguno)
+    std::vector<int> miembro_;    ///< Miembro que ocupa cada carril (-1 = relleno)
+
+    std::vector<ResultadoMiembro> resultados_; ///< Resultado por miembro
+    std::vector<double> finales_;              ///< Estado final por miembro: [(miembro·N + k)·6 + componente]
+};
+
+#endif // CONJUNTOSISTEMAS_H
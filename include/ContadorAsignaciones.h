@@ -0,0 +1,24 @@
+/**
+ * @file ContadorAsignaciones.h
+ * @brief Conteo de asignaciones de memoria dinámica del programa
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef CONTADORASIGNACIONES_H
+#define CONTADORASIGNACIONES_H
+
+/**
+ * @brief Número total de asignaciones de memoria dinámica desde el arranque
+ * @details Cuenta cada llamada a operator new / new[] (reemplazados en
+ *          ContadorAsignaciones.cpp) y cada reserva de AsignadorAlineado.
+ *          La diferencia entre dos lecturas da las asignaciones realizadas
+ *          entre ellas, p. ej. durante un paso de integración.
+ * @return Contador acumulado (seguro entre hilos)
+ */
+long asignacionesMemoria();
+
+/// Registra una asignación hecha fuera de operator new (p. ej. posix_memalign)
+void registrarAsignacion();
+
+#endif // CONTADORASIGNACIONES_H
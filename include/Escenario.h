@@ -0,0 +1,126 @@
+/**
+ * @file Escenario.h
+ * @brief Archivos de escenario para ejecutar simulaciones sin interacción
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef ESCENARIO_H
+#define ESCENARIO_H
+
+#include <string>
+#include <vector>
+#include "Cuerpo.h"
+#include "Fuerzas.h"
+#include "Trayectoria.h"
+#include "SalidaAsincrona.h"
+#include "Integradores.h"
+#include "BarridoParametros.h"
+
+/**
+ * @brief Configuración completa de una simulación
+ * @details Reúne lo que el modo interactivo pregunta por consola: cuerpos,
+ *          parámetros de integración, motor de fuerzas y opciones de salida.
+ *          Se llena desde un archivo de escenario y, después, desde las
+ *          opciones de la línea de comandos, que tienen prioridad.
+ */
+struct Escenario {
+    std::vector<Cuerpo> cuerpos;        ///< Condiciones iniciales
+    std::string archivo_cuerpos;        ///< Archivo CSV o binario de condiciones iniciales (vacío = usar cuerpos)
+    double dt;                          ///< Paso de tiempo
+    double t_max;                       ///< Tiempo total de simulación
+    TipoMotorFuerzas motor;             ///< Motor de fuerzas
+    int hilos;                          ///< Hilos de la suma directa (0 = todos los núcleos)
+    bool precision_mixta;               ///< Suma directa con pares en float y sumas en double
+    double theta;                       ///< Ángulo de apertura de Barnes-Hut
+    int orden_fmm;                      ///< Orden p del FMM
+    TipoIntegrador integrador;          ///< Esquema de integración temporal
+    int niveles_bloques;                ///< Niveles K de los pasos por bloques
+    double eta_bloques;                 ///< Precisión η del criterio de paso por bloques
+    int orden_composicion;              ///< Orden 4, 6 u 8 de la composición simpléctica
+    double tolerancia_ias15;            ///< Tolerancia ε del control de paso de IAS15
+    double radio_interior_respa;        ///< Radio r₁ bajo el que la fuerza es toda cercana (RESPA)
+    double radio_exterior_respa;        ///< Radio r₂ sobre el que la fuerza es toda lejana (RESPA)
+    int subpasos_respa;                 ///< Subpasos de las fuerzas cercanas por paso dt (RESPA)
+    int cadencia_diagnosticos;          ///< Diagnósticos cada k pasos (0 = en cada paso de salida)
+    FormatoTrayectoria formato;         ///< Formato de la trayectoria
+    SeleccionSalida seleccion;          ///< Cuerpos (0 = todos) y campos escritos
+    int cada_pasos_salida;              ///< Escribir cada k pasos
+    double intervalo_salida;            ///< Escribir cada Δt simulado (0 = usar cada_pasos_salida)
+    int capacidad_salida;               ///< Cuadros del anillo de salida (0 = automático)
+    PoliticaSaturacion politica_salida; ///< Qué hacer con el anillo lleno
+    std::string directorio_salida;      ///< Directorio de sim_data.* y diagnosticos.dat
+    int punto_control_cada;             ///< Punto de control cada k pasos (0 = ninguno)
+    std::string archivo_punto_control;  ///< Archivo de los puntos de control (vacío = salida/punto_control.bin)
+    std::string reanudar;               ///< Punto de control desde el que se reanuda (vacío = desde t = 0)
+    bool traza;                         ///< Guardar la línea de tiempo de las fases (compilado con INSTRUMENTACION)
+    int eventos_traza;                  ///< Capacidad de la línea de tiempo en eventos
+    bool contadores;                    ///< Leer contadores de hardware por fase (compilado con INSTRUMENTACION)
+    int conjunto;                       ///< Miembros M del conjunto de sistemas perturbados (0 = una sola simulación)
+    double perturbacion;                ///< Amplitud relativa de la perturbación de los miembros
+    int semilla;                        ///< Semilla de las perturbaciones
+    double radio_escape;                ///< Distancia al centro de masa que termina a un miembro (0 = sin límite)
+    std::vector<DimensionBarrido> barrido; ///< Dimensiones del barrido de parámetros (vacío = una sola simulación)
+    int hilos_barrido;                  ///< Hilos del barrido (0 = todos los núcleos)
+};
+
+/// Escenario sin cuerpos con los mismos valores por defecto que el modo interactivo
+Escenario escenarioPorDefecto();
+
+/**
+ * @brief Lee un archivo de escenario
+ * @param ruta Ruta del archivo
+ * @param escenario Escenario que se completa; las claves ausentes conservan su valor
+ * @param error Descripción del problema (con número de línea) si la lectura falla
+ * @return true si el archivo se leyó completo
+ * @details Formato: una entrada `clave = valor` por línea; `#` inicia un
+ *          comentario. Cada cuerpo es una línea
+ *          `cuerpo = masa radio x y z vx vy vz`. Las claves válidas son las
+ *          de aplicarOpcionEscenario().
+ */
+bool cargarEscenario(const std::string& ruta, Escenario& escenario, std::string& error);
+
+/**
+ * @brief Aplica una opción `clave = valor` a un escenario
+ * @param escenario Escenario a modificar
+ * @param clave dt, t_max, motor (directo | barnes-hut | fmm), hilos,
+ *        precision (doble | mixta), theta,
+ *        orden_fmm, integrador (verlet | bloques | hermite | composicion |
+ *        wisdom-holman | ias15 | respa),
+ *        niveles_bloques, eta_bloques, orden_composicion (4 | 6 | 8),
+ *        tolerancia_ias15, radio_interior_respa, radio_exterior_respa,
+ *        subpasos_respa,
+ *        cadencia_diagnosticos, formato (texto | binario),
+ *        campos (letras p, v, r, e), cuerpos_salida (primero último, 0 0 = todos),
+ *        cada_pasos, intervalo_salida, bufer_salida,
+ *        saturacion (esperar | descartar), salida (directorio),
+ *        punto_control_cada, punto_control (archivo), reanudar (archivo),
+ *        traza (0 | 1), eventos_traza, contadores (0 | 1),
+ *        conjunto (miembros), perturbacion, semilla, radio_escape,
+ *        barrido (una dimensión por uso: `dt v...`, `masa k m...` o
+ *        `velocidad k f...`), hilos_barrido,
+ *        cuerpo o cuerpos_archivo (archivo de cargarCuerpos())
+ * @param valor Texto del valor
+ * @param error Descripción del problema si la clave o el valor no son válidos
+ * @return true si la opción se aplicó
+ * @note La línea de comandos usa las mismas claves (`--motor fmm`, `--t-max 10`)
+ */
+bool aplicarOpcionEscenario(Escenario& escenario, const std::string& clave, const std::string& valor,
+                            std::string& error);
+
+/**
+ * @brief Interpreta una selección de campos de salida
+ * @param texto Letras p (posiciones), v (velocidades), r (rapidez), e (energías), o "0" para los campos por defecto
+ * @param campos Combinación de CampoSalida resultante
+ * @return false si el texto está vacío o contiene otras letras
+ */
+bool interpretarCamposSalida(const std::string& texto, unsigned& campos);
+
+/**
+ * @brief Crea un directorio y los que falten en su ruta (como mkdir -p)
+ * @param ruta Directorio a crear
+ * @return true si el directorio existe al terminar
+ */
+bool crearDirectorios(const std::string& ruta);
+
+#endif // ESCENARIO_H
@@ -0,0 +1,109 @@
+/**
+ * @file FMM.h
+ * @brief Motor de fuerzas basado en el Método Rápido de Multipolos (FMM)
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef FMM_H
+#define FMM_H
+
+#include <vector>
+#include <complex>
+#include "vector3D.h"
+#include "SistemaCuerpos.h"
+#include "Octree.h"
+
+/**
+ * @brief Calcula fuerzas y potenciales gravitacionales en O(N)
+ * @details Usa expansiones en armónicos esféricos sólidos sobre el árbol
+ *          octal: multipolos en cada celda (P2M, M2M), traslación a
+ *          expansiones locales entre celdas bien separadas (M2L) mediante un
+ *          recorrido dual del árbol, propagación descendente (L2L) y
+ *          evaluación en los cuerpos (L2P). Las celdas vecinas se evalúan
+ *          por suma directa (P2P). El potencial de cada cuerpo se obtiene en
+ *          la misma pasada que su fuerza.
+ *
+ *          Dos celdas de radios Ri, Rj cuyos centros distan d interactúan
+ *          por expansión si (Ri + Rj) < θ·d. El error decrece como θ^p con
+ *          el orden p de la expansión.
+ * @note Se evalúa en un solo hilo; la opción hilos solo afecta a la suma directa
+ * @see Octree
+ */
+class FMM {
+public:
+    /**
+     * @brief Constructor
+     * @param orden Orden p de la expansión (número de términos en n)
+     * @param theta Criterio de separación entre celdas
+     * @param max_hoja Número máximo de cuerpos por hoja del árbol
+     * @pre orden >= 1 && 0 < theta < 1
+     */
+    explicit FMM(int orden = 8, double theta = 0.5, int max_hoja = 64);
+
+    /**
+     * @brief Calcula las aceleraciones y potenciales de todos los cuerpos
+     * @param cuerpos Sistema con posiciones y masas actuales
+     * @param aceleraciones Salida con la aceleración de cada cuerpo, igual
+     *        que calcularTodasLasFuerzas
+     * @post potenciales() y energiaPotencial() corresponden a estas posiciones
+     */
+    void calcularFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones);
+
+    /// Cambia el orden p de la expansión
+    void fijarOrden(int orden);
+
+    /// Orden p actual de la expansión
+    int orden() const { return P_; }
+
+    /**
+     * @brief Potencial gravitacional de cada cuerpo de la última evaluación
+     * @return Vector con Φᵢ = -G·Σⱼ≠ᵢ mⱼ/rᵢⱼ
+     */
+    const std::vector<double>& potenciales() const { return potencial_; }
+
+    /**
+     * @brief Energía potencial total de la última evaluación
+     * @return U = ½·Σᵢ mᵢΦᵢ = -Σᵢ<ⱼ(Gmᵢmⱼ/rᵢⱼ)
+     * @note Complejidad: O(N), no requiere una segunda pasada por pares
+     */
+    double energiaPotencial() const { return energia_potencial_; }
+
+private:
+    typedef std::complex<double> complejo;
+
+    /// Multipolo de una hoja a partir de sus cuerpos
+    void P2M(int celda, const SistemaCuerpos& cuerpos);
+    /// Traslada los multipolos de los hijos al centro de la celda
+    void M2M(int celda);
+    /// Convierte el multipolo de la celda j en expansión local de la celda i
+    void M2L(int i, int j);
+    /// Traslada la expansión local de la celda a sus hijos
+    void L2L(int celda);
+    /// Evalúa la expansión local de una hoja en sus cuerpos
+    void L2P(int celda, const SistemaCuerpos& cuerpos);
+    /// Interacción directa entre los cuerpos de dos hojas
+    void P2P(int i, int j, const SistemaCuerpos& cuerpos);
+    /// Recorrido dual del árbol que decide entre M2L, P2P o descender
+    void recorridoDual(int i, int j, const SistemaCuerpos& cuerpos);
+
+    /// Armónicos sólidos regulares rⁿYₙᵐ y su derivada en θ
+    void evaluarMultipolo(double rho, double alfa, double beta);
+    /// Armónicos sólidos singulares r⁻ⁿ⁻¹Yₙᵐ
+    void evaluarLocal(double rho, double alfa, double beta);
+
+    Octree arbol_;                  ///< Árbol octal reconstruido en cada evaluación
+    int P_;                         ///< Orden de la expansión
+    int n_coef_;                    ///< Coeficientes por celda: P(P+1)/2
+    double theta_;                  ///< Criterio de separación
+    std::vector<complejo> M_;       ///< Multipolos de todas las celdas
+    std::vector<complejo> L_;       ///< Expansiones locales de todas las celdas
+    std::vector<complejo> Ynm_;     ///< Armónicos de trabajo (P² términos)
+    std::vector<complejo> YnmTheta_; ///< Derivadas en θ de los armónicos de trabajo
+    std::vector<double> phi_;       ///< Σⱼ mⱼ/rᵢⱼ acumulado por cuerpo
+    std::vector<vector3D> grad_;    ///< ∇(Σⱼ mⱼ/rᵢⱼ) acumulado por cuerpo
+    std::vector<double> potencial_; ///< Potencial gravitacional por cuerpo
+    double energia_potencial_;      ///< Energía potencial total
+};
+
+#endif // FMM_H
@@ -0,0 +1,189 @@
+/**
+ * @file Fuerzas.h
+ * @brief Núcleos de fuerza directa, energías y validación de motores aproximados
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef FUERZAS_H
+#define FUERZAS_H
+
+#include <vector>
+#include "vector3D.h"
+#include "Cuerpo.h"
+#include "SistemaCuerpos.h"
+
+/**
+ * @brief Motores disponibles para evaluar las fuerzas gravitacionales
+ * @details Los valores coinciden con las opciones del menú de configuración
+ */
+enum TipoMotorFuerzas {
+    MOTOR_DIRECTO = 1,   ///< Suma directa por pares, exacta, O(N²)
+    MOTOR_BARNES_HUT = 2, ///< Árbol octal de Barnes-Hut, aproximado, O(N log N)
+    MOTOR_FMM = 3         ///< Método Rápido de Multipolos, aproximado, O(N)
+};
+
+/**
+ * @brief Devuelve el nombre legible de un motor de fuerzas
+ * @param motor Motor a describir
+ * @return Cadena constante con el nombre del motor
+ */
+const char* nombreMotorFuerzas(TipoMotorFuerzas motor);
+
+/**
+ * @brief Calcula las aceleraciones gravitacionales de todos los cuerpos
+ * @param cuerpos Sistema con posiciones y masas actuales
+ * @param aceleraciones Salida con la aceleración de cada cuerpo (fuerza / masa)
+ * @details Implementa la suma de fuerzas N-cuerpos evitando doble conteo:
+ *          cada par i<j se evalúa una vez y se aplica a ambos cuerpos
+ * @pre aceleraciones.tamano() == cuerpos.tamano()
+ * @note Complejidad: O(N²) donde N es el número de cuerpos
+ */
+void calcularTodasLasFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones);
+
+/**
+ * @brief Calcula las aceleraciones y la energía potencial en un solo recorrido
+ * @param cuerpos Sistema con posiciones y masas actuales
+ * @param aceleraciones Salida con la aceleración de cada cuerpo
+ * @return Energía potencial total U = -Σᵢ<ⱼ(Gmᵢmⱼ/rᵢⱼ)
+ * @details Evita la segunda pasada O(N²) de calcularEnergiaPotencialTotal.
+ *          Los pares a menos de 1e-6 se omiten, igual que en las fuerzas
+ * @pre aceleraciones.tamano() == cuerpos.tamano()
+ */
+double calcularFuerzasYEnergiaPotencial(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones);
+
+/**
+ * @brief Versión sobre vectores de Cuerpo de calcularTodasLasFuerzas
+ * @param cuerpos_actuales Vector de cuerpos con posiciones actuales
+ * @param fuerzas_a_calcular Vector donde se almacenan las fuerzas calculadas
+ * @details Se conserva por compatibilidad con el código basado en Cuerpo;
+ *          también deja el resultado en el atributo F de cada cuerpo
+ * @note Complejidad: O(N²) donde N es el número de cuerpos
+ */
+void calcularTodasLasFuerzas(std::vector<Cuerpo>& cuerpos_actuales,
+                             std::vector<vector3D>& fuerzas_a_calcular);
+
+/**
+ * @brief Calcula la energía cinética total del sistema
+ * @param cuerpos Sistema con velocidades actuales
+ * @return Energía cinética total K = Σ(½mᵢvᵢ²)
+ */
+double calcularEnergiaCineticaTotal(const SistemaCuerpos& cuerpos);
+
+/**
+ * @brief Calcula la energía potencial gravitacional total
+ * @param cuerpos Sistema con posiciones actuales
+ * @return Energía potencial total U = -Σᵢ<ⱼ(Gmᵢmⱼ/rᵢⱼ)
+ * @note Complejidad: O(N²)
+ */
+double calcularEnergiaPotencialTotal(const SistemaCuerpos& cuerpos);
+
+/**
+ * @brief Cantidades conservadas y de control del sistema en un instante
+ */
+struct Diagnosticos {
+    double energia_cinetica;  ///< K = Σ ½mᵢvᵢ²
+    double energia_potencial; ///< U, tal como la entregó el motor de fuerzas
+    vector3D momento_lineal;  ///< P = Σ mᵢvᵢ
+    vector3D momento_angular; ///< L = Σ mᵢ (rᵢ × vᵢ), respecto al origen
+    vector3D centro_masa;     ///< R = Σ mᵢrᵢ / Σ mᵢ
+
+    /// Energía total K + U
+    double energiaTotal() const { return energia_cinetica + energia_potencial; }
+};
+
+/**
+ * @brief Calcula los diagnósticos del sistema en una sola pasada O(N)
+ * @param cuerpos Sistema con posiciones, velocidades y masas actuales
+ * @param energia_potencial U obtenida por el motor de fuerzas en su recorrido de pares
+ * @return Energía, momento lineal, momento angular y centro de masa
+ * @details La parte O(N²) (la energía potencial) no se recalcula: la aporta
+ *          el motor de fuerzas, que la acumula junto con las aceleraciones
+ */
+Diagnosticos calcularDiagnosticos(const SistemaCuerpos& cuerpos, double energia_potencial);
+
+/**
+ * @brief Error relativo de un conjunto de fuerzas aproximadas
+ * @details El error de cada cuerpo se define como |F_aprox - F_directa| / |F_directa|
+ *          (idéntico al de las aceleraciones, pues ambas difieren en el factor m).
+ *          También se usa para potenciales, con |Φ_aprox - Φ_directo| / |Φ_directo|
+ */
+struct ErrorFuerzas {
+    double error_rms; ///< Raíz del error relativo cuadrático medio
+    double error_max; ///< Máximo error relativo observado
+    int muestras;     ///< Número de cuerpos comparados
+};
+
+/**
+ * @brief Calcula por suma directa la aceleración total sobre un cuerpo
+ * @param i Índice del cuerpo sobre el que actúa la fuerza
+ * @param cuerpos Sistema con posiciones actuales
+ * @return Aceleración gravitacional total sobre el cuerpo i
+ * @note Complejidad: O(N)
+ */
+vector3D calcularAceleracionDirectaSobre(int i, const SistemaCuerpos& cuerpos);
+
+/**
+ * @brief Calcula por suma directa las aceleraciones de un subconjunto de cuerpos
+ * @param cuerpos Sistema con posiciones actuales
+ * @param objetivos Índices de los cuerpos cuya aceleración se calcula
+ * @param n_objetivos Número de índices
+ * @param aceleraciones Salida; solo se escriben las entradas de los objetivos
+ * @details Cada objetivo suma la atracción de todos los cuerpos, sin usar la
+ *          tercera ley: O(n_objetivos·N). Es la evaluación de los cuerpos
+ *          activos en los pasos de tiempo por bloques. Los pares a menos de
+ *          1e-6 se omiten, igual que en calcularTodasLasFuerzas.
+ */
+void calcularFuerzasSobre(const SistemaCuerpos& cuerpos, const int* objetivos, int n_objetivos,
+                          Aceleraciones& aceleraciones);
+
+/**
+ * @brief Calcula por suma directa aceleraciones y jerks en un solo recorrido de pares
+ * @param cuerpos Sistema con posiciones, velocidades y masas actuales
+ * @param aceleraciones Salida con aᵢ = G·Σⱼ mⱼ·rᵢⱼ/rᵢⱼ³
+ * @param jerks Salida con ȧᵢ = G·Σⱼ mⱼ·[vᵢⱼ/rᵢⱼ³ - 3(rᵢⱼ·vᵢⱼ)·rᵢⱼ/rᵢⱼ⁵]
+ * @param energia_potencial Si no es nulo, recibe U = -Σᵢ<ⱼ(Gmᵢmⱼ/rᵢⱼ)
+ * @details Con rᵢⱼ = rⱼ - rᵢ y vᵢⱼ = vⱼ - vᵢ. Cada par i<j se evalúa una vez y
+ *          se aplica a ambos cuerpos, como en calcularTodasLasFuerzas; los
+ *          pares a menos de 1e-6 se omiten. Es la evaluación del integrador
+ *          de Hermite.
+ * @pre aceleraciones.tamano() == jerks.tamano() == cuerpos.tamano()
+ * @note Complejidad: O(N²), un solo hilo
+ */
+void calcularAceleracionesYJerks(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                                 Aceleraciones& jerks, double* energia_potencial = 0);
+
+/**
+ * @brief Calcula por suma directa el potencial gravitacional en un cuerpo
+ * @param i Índice del cuerpo
+ * @param cuerpos Sistema con posiciones actuales
+ * @return Potencial Φᵢ = -G·Σⱼ≠ᵢ mⱼ/rᵢⱼ
+ * @note Complejidad: O(N)
+ */
+double calcularPotencialDirectoEn(int i, const SistemaCuerpos& cuerpos);
+
+/**
+ * @brief Estima el error de fuerzas aproximadas respecto a la suma directa
+ * @param cuerpos Sistema con posiciones actuales
+ * @param aceleraciones_aprox Aceleraciones calculadas por un motor aproximado
+ * @param max_muestras Número máximo de cuerpos a comparar
+ * @return Errores relativos RMS y máximo sobre la muestra
+ * @details Compara una muestra equiespaciada de cuerpos para que la
+ *          validación cueste O(N·max_muestras) y no O(N²)
+ */
+ErrorFuerzas estimarErrorFuerzas(const SistemaCuerpos& cuerpos,
+                                 const Aceleraciones& aceleraciones_aprox,
+                                 int max_muestras = 1000);
+
+/**
+ * @brief Estima el error de potenciales aproximados respecto a la suma directa
+ * @param cuerpos Sistema con posiciones actuales
+ * @param potenciales_aprox Potencial Φᵢ calculado por un motor aproximado
+ * @param max_muestras Número máximo de cuerpos a comparar
+ * @return Errores relativos RMS y máximo sobre la muestra
+ */
+ErrorFuerzas estimarErrorPotencial(const SistemaCuerpos& cuerpos,
+                                   const std::vector<double>& potenciales_aprox,
+                                   int max_muestras = 1000);
+
+#endif // FUERZAS_H
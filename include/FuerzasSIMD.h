@@ -0,0 +1,221 @@
+/**
+ * @file FuerzasSIMD.h
+ * @brief Núcleos vectorizados de suma directa con selección por CPUID
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef FUERZASSIMD_H
+#define FUERZASSIMD_H
+
+#include <vector>
+#include "SistemaCuerpos.h"
+
+/**
+ * @brief Conjuntos de instrucciones disponibles para la suma directa
+ * @details Se ordenan de menor a mayor ancho vectorial
+ */
+enum NivelSIMD {
+    SIMD_ESCALAR = 0, ///< Bucle escalar de referencia
+    SIMD_SSE2 = 1,    ///< 2 dobles por registro
+    SIMD_AVX2 = 2,    ///< 4 dobles por registro, con FMA
+    SIMD_AVX512 = 3   ///< 8 dobles por registro
+};
+
+/**
+ * @brief Tolerancia documentada de los núcleos vectorizados
+ * @details Error relativo máximo |a_simd - a_escalar| / |a_escalar| por cuerpo
+ *          frente a calcularFuerzasEscalar. La diferencia proviene del
+ *          inverso de la raíz (rsqrt + iteraciones de Newton) y del orden de
+ *          las sumas; en la práctica es del orden de 1e-15.
+ */
+const double TOLERANCIA_FUERZAS_SIMD = 1e-12;
+
+/**
+ * @brief Tolerancia documentada del núcleo de precisión mixta
+ * @details Error relativo máximo por cuerpo de calcularFuerzasMixtas frente a
+ *          calcularFuerzasEscalar. Cada par se evalúa con unos 7 dígitos
+ *          (float); las sumas por cuerpo son de doble precisión, así que el
+ *          error típico es del orden de 1e-7 y solo crece donde las fuerzas
+ *          casi se cancelan.
+ */
+const double TOLERANCIA_FUERZAS_MIXTAS = 1e-4;
+
+/**
+ * @brief Detecta el mejor conjunto de instrucciones soportado por la CPU
+ * @return Nivel más alto disponible según CPUID (y el soporte del sistema operativo)
+ */
+NivelSIMD detectarNivelSIMD();
+
+/**
+ * @brief Nivel usado actualmente por calcularTodasLasFuerzas
+ * @return El nivel detectado al arrancar, salvo que se haya fijado otro
+ */
+NivelSIMD nivelSIMDActivo();
+
+/**
+ * @brief Fuerza el uso de un nivel concreto
+ * @param nivel Nivel deseado; se limita al máximo soportado por la CPU
+ * @return Nivel efectivamente seleccionado
+ */
+NivelSIMD fijarNivelSIMD(NivelSIMD nivel);
+
+/**
+ * @brief Devuelve el nombre legible de un nivel SIMD
+ * @param nivel Nivel a describir
+ * @return Cadena constante con el nombre
+ */
+const char* nombreNivelSIMD(NivelSIMD nivel);
+
+/**
+ * @brief Número de cuerpos por bloque j del recorrido por teselas
+ * @return Tamaño de bloque elegido para que x, y, z, m y a de un bloque
+ *         quepan en la mitad de la caché L1 de datos
+ * @details Las teselas tienen un solo nivel. Mientras un bloque j está en
+ *          L1, cada cuerpo i se lee y se escribe una vez (56 bytes) para
+ *          cientos de interacciones, menos de 0.1 bytes por ns: ni L2 ni la
+ *          memoria limitan el recorrido, y un segundo nivel de teselas para
+ *          L2 no tiene nada que ahorrar. El costo por par es el mismo
+ *          (~1.45 ns con AVX-512) con N = 4096 que con N = 131072, cuando
+ *          los datos de los i ocupan 7 MB frente a 2 MB de L2.
+ */
+int tamanoBloqueJ();
+
+/**
+ * @brief Suma directa escalar (referencia de los núcleos vectorizados)
+ * @param cuerpos Sistema con posiciones y masas actuales
+ * @param aceleraciones Salida con la aceleración de cada cuerpo
+ * @note Complejidad: O(N²), aprovecha la tercera ley de Newton (pares i<j)
+ */
+void calcularFuerzasEscalar(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones);
+
+/**
+ * @brief Suma directa con un nivel SIMD concreto
+ * @param cuerpos Sistema con posiciones y masas actuales
+ * @param aceleraciones Salida con la aceleración de cada cuerpo
+ * @param nivel Conjunto de instrucciones a usar
+ * @param energia_potencial Si no es nulo, recibe la energía potencial total
+ *        -Σ G·mᵢ·mⱼ/r calculada en el mismo recorrido de pares
+ * @details Recorre los pares i<j por bloques de tamanoBloqueJ() cuerpos j,
+ *          con los j contiguos en los carriles del registro. La reacción
+ *          sobre los j se acumula con cargas y almacenamientos contiguos, por
+ *          lo que se conserva el ahorro de la tercera ley de Newton. El
+ *          inverso de la distancia se obtiene con rsqrt y refinamiento de
+ *          Newton-Raphson.
+ * @pre nivel <= detectarNivelSIMD()
+ */
+void calcularFuerzasSIMD(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones, NivelSIMD nivel,
+                         double* energia_potencial = 0);
+
+/**
+ * @brief Acumula las interacciones de un bloque rectangular de pares
+ * @param cuerpos Sistema con posiciones y masas actuales
+ * @param aceleraciones Acumulador; no se pone en cero
+ * @param nivel Conjunto de instrucciones a usar
+ * @param i0 Primer cuerpo i del bloque
+ * @param i1 Fin (exclusivo) de los cuerpos i
+ * @param j0 Primer cuerpo j del bloque
+ * @param j1 Fin (exclusivo) de los cuerpos j
+ * @param energia_potencial Si no es nulo, se le suma la energía de los pares del bloque
+ * @details Procesa los pares (i, j) con i0 <= i < i1, j0 <= j < j1 e i < j,
+ *          sumando la acción sobre i y la reacción sobre j. Permite repartir
+ *          la suma directa entre hilos con acumuladores propios.
+ */
+void acumularFuerzasBloque(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones, NivelSIMD nivel,
+                           int i0, int i1, int j0, int j1, double* energia_potencial = 0);
+
+/**
+ * @brief Copia en precisión simple de las posiciones y masas
+ * @details Las posiciones se guardan relativas al centro de masa, que se
+ *          resta en doble precisión: así la diferencia de coordenadas de un
+ *          par pierde solo los dígitos que corresponden a su distancia al
+ *          centro, no a la distancia al origen del sistema de referencia.
+ */
+struct CoordenadasSimples {
+    std::vector<float> x, y, z; ///< Posiciones relativas al centro de masa
+    std::vector<float> m;       ///< Masas
+
+    /**
+     * @brief Convierte el estado actual
+     * @param cuerpos Sistema del que se copian posiciones y masas
+     * @note Solo reserva memoria si cambia el número de cuerpos
+     */
+    void cargar(const SistemaCuerpos& cuerpos);
+
+    /// Número de cuerpos cargados
+    int tamano() const { return static_cast<int>(x.size()); }
+};
+
+/**
+ * @brief Suma directa en precisión mixta
+ * @param cuerpos Sistema con posiciones y masas actuales (doble precisión)
+ * @param simples Copia en precisión simple; se recarga aquí
+ * @param aceleraciones Salida con la aceleración de cada cuerpo
+ * @param nivel Conjunto de instrucciones a usar
+ * @param energia_potencial Si no es nulo, recibe la energía potencial total
+ * @details Diferencias de coordenadas, inverso de la distancia y fuerza de
+ *          cada par en float, con el doble de carriles por registro que los
+ *          núcleos de doble precisión y un solo paso de Newton tras rsqrt.
+ *          Cada fila suma en float solo dentro de un bloque de
+ *          tamanoBloqueJ() cuerpos j; al cerrar el bloque la suma parcial se
+ *          añade en double a la aceleración del cuerpo, de modo que las
+ *          aceleraciones, la energía y el estado del integrador siguen en
+ *          doble precisión.
+ *
+ *          A diferencia de calcularFuerzasSIMD no se aprovecha la tercera
+ *          ley: escribir la reacción en los acumuladores double de los j
+ *          obligaría a convertir cada contribución y costaría más que
+ *          evaluar cada par dos veces en float. Por eso el momento lineal
+ *          solo se conserva hasta el redondeo de float (~1e-7 relativo). Con
+ *          SSE2 se usa el bucle escalar.
+ * @see TOLERANCIA_FUERZAS_MIXTAS
+ */
+void calcularFuerzasMixtas(const SistemaCuerpos& cuerpos, CoordenadasSimples& simples,
+                           Aceleraciones& aceleraciones, NivelSIMD nivel, double* energia_potencial = 0);
+
+/**
+ * @brief Filas de la suma directa en precisión mixta
+ * @param simples Copia en precisión simple ya cargada
+ * @param aceleraciones Acumulador; no se pone en cero
+ * @param nivel Conjunto de instrucciones a usar
+ * @param i0 Primer cuerpo i
+ * @param i1 Fin (exclusivo) de los cuerpos i
+ * @param energia_potencial Si no es nulo, se le suma la energía de las filas
+ *        (la mitad de cada par, que aparece en las dos filas)
+ * @details Cada fila interactúa con todos los cuerpos y solo escribe en su
+ *          propia entrada: varios hilos pueden repartirse las filas sin
+ *          acumuladores propios.
+ */
+void acumularFuerzasFilasMixtas(const CoordenadasSimples& simples, Aceleraciones& aceleraciones, NivelSIMD nivel,
+                                int i0, int i1, double* energia_potencial = 0);
+
+/**
+ * @brief Acumula sobre un punto la atracción de una lista de fuentes puntuales
+ * @param nivel Conjunto de instrucciones a usar (SSE2 usa el bucle escalar)
+ * @param xi Coordenada x del punto
+ * @param yi Coordenada y del punto
+ * @param zi Coordenada z del punto
+ * @param x Coordenadas x de las fuentes
+ * @param y Coordenadas y de las fuentes
+ * @param z Coordenadas z de las fuentes
+ * @param gm G·masa de cada fuente
+ * @param n Número de fuentes
+ * @param aceleracion Acumulador de 3 componentes; no se pone en cero
+ * @param potencial Si no es nulo, se le resta Σ G·mⱼ/r
+ * @details Usa el mismo inverso rsqrt + Newton-Raphson que calcularFuerzasSIMD
+ *          y omite las fuentes con r² < 10⁻¹² (el propio punto incluido). Es
+ *          el núcleo de las listas de interacción de BarnesHut.
+ */
+void acumularFuentes(NivelSIMD nivel, double xi, double yi, double zi, const double* x, const double* y,
+                     const double* z, const double* gm, int n, double* aceleracion, double* potencial = 0);
+
+/**
+ * @brief Diferencia relativa máxima entre dos conjuntos de aceleraciones
+ * @param aceleraciones Aceleraciones a comparar
+ * @param referencia Aceleraciones de referencia (p. ej. calcularFuerzasEscalar)
+ * @return max_i |a_i - ref_i| / |ref_i|, omitiendo los cuerpos con ref_i = 0
+ * @see TOLERANCIA_FUERZAS_SIMD
+ */
+double diferenciaRelativaMaxima(const Aceleraciones& aceleraciones, const Aceleraciones& referencia);
+
+#endif // FUERZASSIMD_H
@@ -0,0 +1,78 @@
+/**
+ * @file GrupoHilos.h
+ * @brief Grupo persistente de hilos para ejecutar pasadas paralelas
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef GRUPOHILOS_H
+#define GRUPOHILOS_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @brief Conjunto fijo de hilos trabajadores que se reutiliza en cada paso
+ * @details Los hilos se crean una sola vez y esperan dormidos entre
+ *          llamadas, de modo que una pasada paralela no paga la creación de
+ *          hilos. El hilo que llama a ejecutar() actúa como el hilo 0.
+ */
+class GrupoHilos {
+public:
+    /**
+     * @brief Constructor
+     * @param hilos Número total de hilos, incluido el que llama (>= 1)
+     */
+    explicit GrupoHilos(int hilos = 1);
+
+    /// Detiene y une todos los hilos trabajadores
+    ~GrupoHilos();
+
+    /**
+     * @brief Cambia el número de hilos
+     * @param hilos Nuevo número total de hilos (>= 1)
+     * @pre No hay ninguna llamada a ejecutar() en curso
+     */
+    void redimensionar(int hilos);
+
+    /// Número total de hilos, incluido el que llama
+    int tamano() const { return hilos_; }
+
+    /**
+     * @brief Ejecuta tarea(h) en cada hilo h = 0..tamano()-1 y espera a todos
+     * @param tarea Función que recibe el índice del hilo
+     */
+    void ejecutar(const std::function<void(int)>& tarea);
+
+    /// Número de hilos por defecto: núcleos disponibles (al menos 1)
+    static int hilosDisponibles();
+
+private:
+    GrupoHilos(const GrupoHilos&);            // No copiable
+    GrupoHilos& operator=(const GrupoHilos&); // No asignable
+
+    /**
+     * @brief Bucle de espera y ejecución de un hilo trabajador
+     * @param h Índice del hilo
+     * @param generacion_inicial Generación vigente al crear el hilo
+     */
+    void bucleTrabajador(int h, long generacion_inicial);
+
+    /// Despierta a los trabajadores para que terminen y los une
+    void detener();
+
+    std::vector<std::thread> trabajadores_;       ///< Hilos 1..hilos_-1
+    std::mutex mutex_;                            ///< Protege el estado compartido
+    std::condition_variable hay_tarea_;           ///< Señala una nueva generación o la salida
+    std::condition_variable tarea_terminada_;     ///< Señala que el último trabajador terminó
+    const std::function<void(int)>* tarea_;       ///< Tarea de la generación actual
+    long generacion_;                             ///< Contador de llamadas a ejecutar()
+    int pendientes_;                              ///< Trabajadores que aún no terminan
+    bool salir_;                                  ///< Indica a los trabajadores que terminen
+    int hilos_;                                   ///< Número total de hilos
+};
+
+#endif // GRUPOHILOS_H
@@ -0,0 +1,89 @@
+/**
+ * @file GrupoTareas.h
+ * @brief Reparto de tareas independientes entre hilos con robo de trabajo
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef GRUPOTAREAS_H
+#define GRUPOTAREAS_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "GrupoHilos.h"
+
+/**
+ * @brief Ejecuta un lote de tareas de duración muy distinta en todos los núcleos
+ * @details Cada hilo del GrupoHilos tiene su propia cola. Las tareas se
+ *          ordenan de mayor a menor costo estimado y cada una se asigna a la
+ *          cola con menos costo acumulado (reparto LPT), de modo que las
+ *          largas empiezan primero y las cortas rellenan el final. Cada hilo
+ *          toma la primera tarea de su cola; cuando la vacía, roba la primera
+ *          de la cola con más costo pendiente. Así los errores de la
+ *          estimación (tareas que terminan antes o duran más de lo previsto)
+ *          se corrigen sobre la marcha y ningún hilo queda ocioso mientras
+ *          otro tenga tareas sin empezar.
+ *
+ *          Las colas se protegen con un mutex cada una: con tareas de
+ *          milisegundos o más, el costo de tomar una tarea es despreciable.
+ */
+class GrupoTareas {
+public:
+    /**
+     * @brief Constructor
+     * @param hilos Número de hilos (0 = GrupoHilos::hilosDisponibles())
+     */
+    explicit GrupoTareas(int hilos = 0);
+
+    /// Número de hilos
+    int tamano() const { return grupo_.tamano(); }
+
+    /**
+     * @brief Ejecuta tarea(k, h) para cada k = 0..costos.size()-1 y espera a todas
+     * @param costos Costo estimado de cada tarea (solo importa su orden relativo)
+     * @param tarea Función que recibe el índice de la tarea y el del hilo que la ejecuta
+     * @pre tarea no lanza excepciones
+     */
+    void ejecutar(const std::vector<double>& costos, const std::function<void(int, int)>& tarea);
+
+    /// Tareas robadas de la cola de otro hilo en la última ejecución
+    long robos() const { return robos_.load(); }
+
+    /// Tiempo que cada hilo pasó ejecutando tareas en la última ejecución [s]
+    const std::vector<double>& segundosOcupado() const { return ocupado_; }
+
+    /// Duración total de la última ejecución [s]
+    double segundosTotales() const { return total_; }
+
+    /// Fracción del tiempo total de todos los hilos dedicada a tareas (1 = sin esperas)
+    double eficiencia() const;
+
+private:
+    GrupoTareas(const GrupoTareas&);            // No copiable
+    GrupoTareas& operator=(const GrupoTareas&); // No asignable
+
+    /// Cola de un hilo, con el costo estimado que le queda
+    struct ColaTareas {
+        std::mutex mutex;
+        std::deque<int> tareas;
+        double pendiente;
+    };
+
+    /**
+     * @brief Toma la siguiente tarea para el hilo h: de su cola o robada
+     * @return Índice de la tarea, o -1 si no queda ninguna
+     */
+    int siguienteTarea(int h, const std::vector<double>& costos);
+
+    GrupoHilos grupo_;                       ///< Hilos trabajadores
+    std::unique_ptr<ColaTareas[]> colas_;    ///< Una cola por hilo
+    std::atomic<long> robos_;                ///< Robos de la última ejecución
+    std::vector<double> ocupado_;            ///< Segundos ocupados por hilo
+    double total_;                           ///< Duración de la última ejecución
+};
+
+#endif // GRUPOTAREAS_H
@@ -0,0 +1,89 @@
+/**
+ * @file Hermite.h
+ * @brief Integrador predictor-corrector de Hermite de cuarto orden
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef HERMITE_H
+#define HERMITE_H
+
+#include "SistemaCuerpos.h"
+
+class EstadoSerializado; // PuntoControl.h
+
+/**
+ * @brief Esquema de Hermite de cuarto orden (Makino y Aarseth, 1992) con paso global
+ * @details Además de la aceleración a usa su derivada, el jerk ȧ, que se
+ *          obtiene en el mismo recorrido de pares con calcularAceleracionesYJerks().
+ *          Un paso dt tiene tres partes:
+ *          1. Predicción por Taylor:
+ *             rₚ = r₀ + V₀·dt + a₀·dt²/2 + ȧ₀·dt³/6,  Vₚ = V₀ + a₀·dt + ȧ₀·dt²/2
+ *          2. Evaluación de a₁ y ȧ₁ con rₚ y Vₚ.
+ *          3. Corrección con el interpolante de Hermite:
+ *             V₁ = V₀ + (a₀ + a₁)·dt/2 + (ȧ₀ - ȧ₁)·dt²/12
+ *             r₁ = r₀ + (V₀ + V₁)·dt/2 + (a₀ - a₁)·dt²/12
+ *
+ *          El error local es O(dt⁵) y el global O(dt⁴), frente a O(dt²) de
+ *          Verlet, con una sola evaluación de fuerzas por paso: para el mismo
+ *          error de energía admite pasos mucho mayores.
+ *
+ *          La aceleración vive en SistemaCuerpos::ax/ay/az y se intercambia
+ *          con el buffer de a(t+dt) igual que en Verlet; el jerk se guarda
+ *          aquí con el mismo doble buffer, de modo que un paso no asigna memoria.
+ */
+class IntegradorHermite {
+public:
+    /**
+     * @brief Dimensiona los buffers para el sistema
+     * @param cuerpos Sistema a integrar
+     * @post jerk() y jerkSiguiente() tienen un elemento por cuerpo, en cero;
+     *       falta calcular ȧ(t₀) en jerk()
+     */
+    void iniciar(const SistemaCuerpos& cuerpos);
+
+    /// Jerk ȧ(t) de cada cuerpo, coherente con cuerpos.ax/ay/az
+    Aceleraciones& jerk() { return jerk_; }
+
+    /// Buffer donde se evalúa ȧ(t+dt) con las posiciones y velocidades predichas
+    Aceleraciones& jerkSiguiente() { return jerk_siguiente_; }
+
+    /**
+     * @brief Guarda r₀ y V₀ y predice el sistema al final del paso
+     * @param cuerpos Sistema con r, V, a(t) y jerk() en t; al salir tiene rₚ y Vₚ
+     * @param dt Paso de tiempo
+     */
+    void predecir(SistemaCuerpos& cuerpos, double dt);
+
+    /**
+     * @brief Corrige las posiciones y velocidades predichas
+     * @param cuerpos Sistema con rₚ, Vₚ y a(t) en ax/ay/az
+     * @param dt El mismo paso de predecir()
+     * @param a_siguiente a(t+dt) evaluada en la predicción
+     * @post cuerpos tiene r(t+dt) y V(t+dt); jerk() tiene ȧ(t+dt). Falta
+     *       intercambiar a_siguiente con las aceleraciones de cuerpos
+     */
+    void corregir(SistemaCuerpos& cuerpos, double dt, const Aceleraciones& a_siguiente);
+
+    /**
+     * @brief Añade el estado completo del integrador a un punto de control
+     * @param estado Estado serializado al que se añade
+     */
+    void guardarEstado(EstadoSerializado& estado) const;
+
+    /**
+     * @brief Recupera el estado escrito por guardarEstado()
+     * @param estado Estado serializado, en la posición de este integrador
+     * @param n Número de cuerpos esperado
+     * @return false si el estado está incompleto o no corresponde a n cuerpos
+     */
+    bool cargarEstado(EstadoSerializado& estado, int n);
+
+private:
+    VectorAlineado x0_, y0_, z0_;    ///< Posición al inicio del paso
+    VectorAlineado vx0_, vy0_, vz0_; ///< Velocidad al inicio del paso
+    Aceleraciones jerk_;             ///< ȧ(t)
+    Aceleraciones jerk_siguiente_;   ///< ȧ(t+dt)
+};
+
+#endif // HERMITE_H
@@ -0,0 +1,178 @@
+/**
+ * @file IAS15.h
+ * @brief Integrador adaptativo de Gauss-Radau de orden 15 (IAS15)
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef IAS15_H
+#define IAS15_H
+
+#include <vector>
+#include "SistemaCuerpos.h"
+
+class EstadoSerializado; // PuntoControl.h
+
+/**
+ * @brief Firma de la función que evalúa las aceleraciones (como calcularFuerzas() de main)
+ * @details evaluar(cuerpos, aceleraciones, con_potencial)
+ */
+typedef void (*EvaluadorFuerzas)(const SistemaCuerpos&, Aceleraciones&, bool);
+
+/**
+ * @brief Menor tolerancia ε útil de IAS15
+ * @details Por debajo de ~2e-12 el b₆ estimado ya es ruido de redondeo de
+ *          las diferencias divididas: no baja al reducir el paso, y el
+ *          control de error reduce el paso sin límite
+ */
+const double TOLERANCIA_MINIMA_IAS15 = 1e-11;
+
+/**
+ * @brief Integrador IAS15 (Rein y Spiegel, 2015) con control automático del paso
+ * @details Dentro de un paso h la aceleración se aproxima por un polinomio
+ *          de grado 7 en τ = (t - t₀)/h,
+ *          a(τ) = a₀ + b₀τ + b₁τ² + … + b₆τ⁷,
+ *          cuyos coeficientes se ajustan por predictor-corrector en los 7
+ *          nodos de Gauss-Radau hₙ: en cada iteración se predicen las
+ *          posiciones en los nodos integrando dos veces el polinomio, se
+ *          evalúan las fuerzas y se actualizan los bᵢ con diferencias
+ *          divididas (los gᵢ). Se itera hasta que la corrección de b₆ cae al
+ *          redondeo. El método es de orden 15.
+ *
+ *          El paso se controla con el término de mayor grado: el error
+ *          relativo max|b₆|/max|a| debe quedar por debajo de la tolerancia ε,
+ *          y el paso siguiente es h·(ε/error)^(1/7). Si ese paso es menor que
+ *          h/4, el paso se rechaza y se repite; si no, se acepta y el
+ *          siguiente puede crecer hasta 4h. Con ε ~ 1e-9 el error por paso
+ *          queda en el redondeo de doble precisión. Los bᵢ del paso aceptado
+ *          se reescalan al paso siguiente como predicción inicial, de modo
+ *          que suelen bastar dos iteraciones (unas 15 evaluaciones de
+ *          fuerzas) por paso. Las posiciones y velocidades se acumulan con
+ *          suma compensada de Kahan para que el redondeo no crezca con el
+ *          número de pasos.
+ *
+ *          Los pasos internos son independientes del dt de la simulación:
+ *          avanzar() recorre un intervalo dt completo con los pasos que haga
+ *          falta, recortando el último para terminar exactamente en t + dt.
+ *          Así dt solo fija la frecuencia de salida y diagnósticos.
+ *
+ *          El paso no baja de 1e-10·dt. Si el control de error pide menos,
+ *          es un choque de masas puntuales (o un encuentro equivalente): la
+ *          fuerza diverge y ningún integrador sin regularización lo cruza
+ *          conservando la energía. avanzar() se detiene entonces en el último
+ *          paso aceptado en lugar de seguir con un estado sin sentido físico.
+ */
+class IntegradorIAS15 {
+public:
+    /**
+     * @brief Constructor
+     * @param tolerancia Tolerancia ε del control de paso
+     */
+    explicit IntegradorIAS15(double tolerancia = 1e-9);
+
+    /**
+     * @brief Cambia la tolerancia
+     * @param tolerancia Tolerancia ε (>= TOLERANCIA_MINIMA_IAS15)
+     * @pre Se llama antes de iniciar()
+     */
+    void configurar(double tolerancia);
+
+    /**
+     * @brief Dimensiona los buffers y reinicia el control de paso y las estadísticas
+     * @param cuerpos Sistema con r, V y a(t) ya calculadas
+     * @param dt Paso de la simulación, usado como primer paso de prueba
+     * @post El paso interno no baja de 1e-10·dt
+     */
+    void iniciar(const SistemaCuerpos& cuerpos, double dt);
+
+    /**
+     * @brief Integra un intervalo con pasos adaptativos
+     * @param cuerpos Sistema con r, V y a(t); al salir tiene r, V y a en t + intervalo
+     * @param a_siguiente Buffer de aceleraciones para las evaluaciones en los nodos
+     * @param intervalo Tiempo a avanzar (> 0)
+     * @param con_potencial Si es true, la evaluación final del intervalo calcula también U
+     * @param evaluar Función que evalúa las aceleraciones con el motor elegido
+     * @return Tiempo avanzado: intervalo, o menos si un choque exigió un paso
+     *         menor que el mínimo (el sistema queda en el último paso aceptado)
+     * @post No asigna memoria
+     */
+    double avanzar(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double intervalo,
+                 bool con_potencial, EvaluadorFuerzas evaluar);
+
+    /// Tolerancia ε del control de paso
+    double tolerancia() const { return tolerancia_; }
+
+    /// Pasos aceptados desde iniciar()
+    long pasosAceptados() const { return pasos_aceptados_; }
+
+    /// Pasos rechazados (repetidos con un paso menor) desde iniciar()
+    long pasosRechazados() const { return pasos_rechazados_; }
+
+    /// Pasos en los que el predictor-corrector agotó las iteraciones sin converger
+    long pasosSinConvergencia() const { return pasos_sin_convergencia_; }
+
+    /// Iteraciones del predictor-corrector acumuladas (7 evaluaciones cada una)
+    long iteraciones() const { return iteraciones_; }
+
+    /// Menor paso aceptado (sin contar los recortados al final de un intervalo)
+    double pasoMinimo() const { return paso_minimo_; }
+
+    /// Mayor paso aceptado
+    double pasoMaximo() const { return paso_maximo_; }
+
+    /**
+     * @brief Añade el estado completo del integrador a un punto de control
+     * @param estado Estado serializado al que se añade
+     */
+    void guardarEstado(EstadoSerializado& estado) const;
+
+    /**
+     * @brief Recupera el estado escrito por guardarEstado()
+     * @param estado Estado serializado, en la posición de este integrador
+     * @param n Número de cuerpos esperado
+     * @return false si el estado está incompleto o no corresponde a n cuerpos
+     */
+    bool cargarEstado(EstadoSerializado& estado, int n);
+
+private:
+    /**
+     * @brief Intenta un paso h desde el estado actual
+     * @param h Paso a intentar
+     * @param h_propuesto Salida: paso sugerido por el control de error
+     * @return true si el paso se aceptó; si no, el sistema queda como estaba
+     * @post Si se aceptó, cuerpos tiene r y V en t + h (falta evaluar a)
+     */
+    bool intentarPaso(SistemaCuerpos& cuerpos, Aceleraciones& a_nodo, double h,
+                      EvaluadorFuerzas evaluar, double& h_propuesto);
+
+    /**
+     * @brief Reescala los b del último paso aceptado a un paso de tamaño h
+     * @details Reevalúa el polinomio a(1 + q·τ) con q = h/h_anterior y le
+     *          suma la diferencia entre los b convergidos y su predicción
+     */
+    void predecirCoeficientes(double h);
+
+    double tolerancia_;          ///< Tolerancia ε del control de paso
+    int n_;                      ///< Número de cuerpos
+    double paso_;                ///< Próximo paso interno a intentar
+    double paso_anterior_;       ///< Último paso aceptado (0 antes del primero)
+    double paso_limite_;         ///< Paso mínimo permitido
+
+    // Coeficientes por componente: índice c·N + i, c = 0, 1, 2 para x, y, z
+    std::vector<double> x0_, v0_, a0_;   ///< Estado al inicio del paso
+    std::vector<double> comp_x_, comp_v_; ///< Compensaciones de Kahan de r y V
+    std::vector<double> g_[7];   ///< Diferencias divididas de a en los nodos
+    std::vector<double> b_[7];   ///< Coeficientes del polinomio de a
+    std::vector<double> e_[7];   ///< Predicción de b con la que empezó el paso
+    std::vector<double> br_[7];  ///< b del último paso aceptado
+    std::vector<double> er_[7];  ///< Predicción e del último paso aceptado
+
+    long pasos_aceptados_;        ///< Pasos aceptados
+    long pasos_rechazados_;       ///< Pasos rechazados
+    long pasos_sin_convergencia_; ///< Pasos sin convergencia del predictor-corrector
+    long iteraciones_;            ///< Iteraciones del predictor-corrector
+    double paso_minimo_;          ///< Menor paso aceptado
+    double paso_maximo_;          ///< Mayor paso aceptado
+};
+
+#endif // IAS15_H
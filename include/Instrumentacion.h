@@ -0,0 +1,176 @@
+/**
+ * @file Instrumentacion.h
+ * @brief Tiempos por fase, contadores de hardware y línea de tiempo de una simulación
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef INSTRUMENTACION_H
+#define INSTRUMENTACION_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Fases en que se reparte el tiempo del bucle de integración
+ * @details Cada fase acumula su tiempo exclusivo: el de las fases anidadas
+ *          (por ejemplo, las fuerzas dentro del paso del integrador) se
+ *          descuenta de la fase que las contiene
+ */
+enum FaseSimulacion {
+    FASE_VERIFICACION = 0, ///< verificarDatos()
+    FASE_INICIO,           ///< Fuerzas iniciales e inicialización del integrador
+    FASE_BUCLE,            ///< Resto del bucle: cadencias, contadores, progreso
+    FASE_INTEGRADOR,       ///< Paso del integrador sin las fuerzas (Muevase_r, Muevase_V, impulsos...)
+    FASE_FUERZAS,          ///< Evaluaciones de fuerza, con el motor elegido
+    FASE_DIAGNOSTICOS,     ///< Energías, momentos y centro de masa
+    FASE_SALIDA,           ///< Entrega de cuadros al escritor y línea de diagnosticos.dat
+    FASE_PUNTO_CONTROL,    ///< Serialización de los puntos de control
+    NUM_FASES
+};
+
+/// Nombre de una fase (para el resumen y la traza)
+const char* nombreFase(FaseSimulacion fase);
+
+/// Contadores de hardware leídos con perf_event_open
+enum ContadorHardware {
+    CONTADOR_CICLOS = 0,
+    CONTADOR_INSTRUCCIONES,
+    CONTADOR_REFERENCIAS_CACHE,
+    CONTADOR_FALLOS_CACHE,
+    NUM_CONTADORES
+};
+
+/**
+ * @brief Perfil por fases de una simulación
+ * @details entrar() y salir() leen el reloj (y los contadores, si están
+ *          activos) y atribuyen el intervalo a la fase en curso. Las fases se
+ *          anidan en una pila de profundidad fija; los eventos de la traza se
+ *          guardan en un vector reservado en configurar(), de modo que medir
+ *          no asigna memoria. Si la traza se llena, los eventos siguientes se
+ *          cuentan como descartados y los tiempos siguen acumulándose.
+ *
+ *          Solo el hilo de la simulación debe usar el perfil. El código del
+ *          bucle lo llama a través de las macros MEDIR_FASE y
+ *          CONTAR_INTERACCIONES, que sin INSTRUMENTACION no generan código.
+ */
+class PerfilFases {
+public:
+    PerfilFases();
+
+    /// Cierra los descriptores de los contadores
+    ~PerfilFases();
+
+    /**
+     * @brief Elige qué se registra además de los tiempos
+     * @param traza Guardar un evento por cada intervalo de fase
+     * @param max_eventos Capacidad de la traza (se reserva aquí)
+     * @param contadores Abrir los contadores de hardware
+     * @return false si se pidieron contadores y no se pudieron abrir (el perfil sigue sin ellos)
+     */
+    bool configurar(bool traza, size_t max_eventos, bool contadores);
+
+    /// Empieza una fase anidada en la actual
+    void entrar(FaseSimulacion fase);
+
+    /// Termina la fase en curso
+    void salir();
+
+    /// Suma interacciones de pares evaluadas
+    void sumarInteracciones(double pares) { interacciones_ += pares; }
+
+    /// Motivo por el que no hay contadores (vacío si están activos o no se pidieron)
+    const std::string& errorContadores() const { return error_contadores_; }
+
+    /// Imprime la tabla de fases y las interacciones por segundo
+    void imprimirResumen(std::ostream& salida) const;
+
+    /**
+     * @brief Guarda el resumen en JSON
+     * @param ruta Archivo de salida
+     * @return false si no se pudo escribir
+     */
+    bool guardarResumen(const std::string& ruta) const;
+
+    /**
+     * @brief Guarda la línea de tiempo en el formato de eventos de Chrome
+     * @param ruta Archivo de salida (se abre con chrome://tracing o Perfetto)
+     * @return false si no se pudo escribir
+     */
+    bool guardarTraza(const std::string& ruta) const;
+
+    /// true si se pidió la traza
+    bool conTraza() const { return traza_; }
+
+private:
+    PerfilFases(const PerfilFases&);            // No copiable
+    PerfilFases& operator=(const PerfilFases&); // No asignable
+
+    typedef std::chrono::steady_clock reloj;
+
+    /// Evento completo de la traza: fase, inicio y duración [µs desde el inicio del perfil]
+    struct EventoTraza {
+        int fase;
+        double inicio;
+        double duracion;
+    };
+
+    /// Lee los contadores en lectura_ (no hace nada si no están activos)
+    void leerContadores();
+
+    /// Atribuye a la fase de la cima el intervalo desde la última marca
+    void acumular(reloj::time_point ahora);
+
+    static const int PROFUNDIDAD_MAXIMA = 16;
+
+    reloj::time_point origen_;                 ///< Instante de creación del perfil
+    reloj::time_point marca_;                  ///< Última entrada o salida
+    int pila_[PROFUNDIDAD_MAXIMA];             ///< Fases abiertas
+    reloj::time_point entrada_[PROFUNDIDAD_MAXIMA]; ///< Instante de entrada de cada fase abierta
+    int profundidad_;                          ///< Fases abiertas (las que exceden la pila no se miden)
+
+    double segundos_[NUM_FASES];               ///< Tiempo exclusivo por fase [s]
+    long llamadas_[NUM_FASES];                 ///< Entradas por fase
+    double interacciones_;                     ///< Interacciones de pares evaluadas
+
+    bool traza_;                               ///< Registrar eventos
+    std::vector<EventoTraza> eventos_;         ///< Eventos (capacidad fija)
+    long eventos_descartados_;                 ///< Eventos que no cupieron
+
+    int descriptor_grupo_;                     ///< Líder del grupo de contadores (-1 = sin contadores)
+    int descriptores_[NUM_CONTADORES];         ///< Descriptor de cada contador
+    unsigned long long lectura_[NUM_CONTADORES];  ///< Última lectura
+    unsigned long long anterior_[NUM_CONTADORES]; ///< Lectura en la marca anterior
+    unsigned long long cuentas_[NUM_FASES][NUM_CONTADORES]; ///< Cuentas exclusivas por fase
+    std::string error_contadores_;             ///< Motivo por el que no se abrieron
+};
+
+/// Mide una fase durante la vida del objeto (entrar() al construir, salir() al destruir)
+class MedicionFase {
+public:
+    MedicionFase(PerfilFases& perfil, FaseSimulacion fase) : perfil_(perfil) { perfil_.entrar(fase); }
+    ~MedicionFase() { perfil_.salir(); }
+
+private:
+    MedicionFase(const MedicionFase&);            // No copiable
+    MedicionFase& operator=(const MedicionFase&); // No asignable
+
+    PerfilFases& perfil_; ///< Perfil donde se acumula
+};
+
+#define MEDICION_FASE_UNIR2(a, b) a##b
+#define MEDICION_FASE_UNIR(a, b) MEDICION_FASE_UNIR2(a, b)
+
+#ifdef INSTRUMENTACION
+/// Mide la fase hasta el final del bloque actual
+#define MEDIR_FASE(perfil, fase) MedicionFase MEDICION_FASE_UNIR(medicion_fase_, __LINE__)((perfil), (fase))
+/// Suma interacciones de pares al perfil
+#define CONTAR_INTERACCIONES(perfil, pares) (perfil).sumarInteracciones(pares)
+#else
+#define MEDIR_FASE(perfil, fase) ((void)0)
+#define CONTAR_INTERACCIONES(perfil, pares) ((void)0)
+#endif
+
+#endif // INSTRUMENTACION_H
@@ -0,0 +1,32 @@
+/**
+ * @file Integradores.h
+ * @brief Integradores temporales disponibles para la simulación
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef INTEGRADORES_H
+#define INTEGRADORES_H
+
+/**
+ * @brief Esquemas de integración temporal
+ * @details Los valores coinciden con las opciones del menú de configuración
+ */
+enum TipoIntegrador {
+    INTEGRADOR_VERLET = 1, ///< Verlet de velocidades con paso global dt
+    INTEGRADOR_BLOQUES = 2, ///< Verlet con pasos individuales por bloques de potencias de dos
+    INTEGRADOR_HERMITE = 3, ///< Predictor-corrector de Hermite de cuarto orden con jerk, paso global dt
+    INTEGRADOR_COMPOSICION = 4, ///< Composición simpléctica de Forest-Ruth o Yoshida (orden 4, 6 u 8)
+    INTEGRADOR_WISDOM_HOLMAN = 5, ///< Wisdom-Holman: Kepler analítico más impulsos de interacción
+    INTEGRADOR_IAS15 = 6, ///< IAS15: Gauss-Radau de orden 15 con paso adaptativo
+    INTEGRADOR_RESPA = 7 ///< RESPA: subpasos para las fuerzas cercanas, paso dt para las lejanas
+};
+
+/**
+ * @brief Devuelve el nombre legible de un integrador
+ * @param integrador Integrador a describir
+ * @return Cadena constante con el nombre del integrador
+ */
+const char* nombreIntegrador(TipoIntegrador integrador);
+
+#endif // INTEGRADORES_H
@@ -0,0 +1,78 @@
+/**
+ * @file Octree.h
+ * @brief Definición del árbol octal usado por los motores de fuerza jerárquicos
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef OCTREE_H
+#define OCTREE_H
+
+#include <vector>
+#include "vector3D.h"
+#include "SistemaCuerpos.h"
+
+/**
+ * @brief Celda del árbol octal
+ * @details Cada celda referencia un rango contiguo del arreglo de índices
+ *          ordenados, de modo que una hoja se recorre sin saltos en memoria.
+ *          Los hijos de una celda se almacenan de forma contigua.
+ */
+struct NodoOctree {
+    vector3D centro;      ///< Centro geométrico de la celda
+    double semilado;      ///< Mitad del lado de la celda cúbica
+    vector3D centro_masa; ///< Centro de masa de los cuerpos contenidos
+    double masa;          ///< Masa total contenida en la celda
+    int inicio;           ///< Primer índice en Octree::indices()
+    int cuenta;           ///< Número de cuerpos contenidos
+    int primer_hijo;      ///< Índice del primer hijo (-1 si es hoja)
+    int n_hijos;          ///< Número de hijos no vacíos
+
+    /// Indica si la celda es una hoja (sin subdivisión)
+    bool esHoja() const { return primer_hijo < 0; }
+};
+
+/**
+ * @brief Árbol octal adaptativo sobre las posiciones de los cuerpos
+ * @details Se construye particionando recursivamente un arreglo de índices
+ *          en octantes hasta que cada hoja contiene a lo sumo max_hoja cuerpos.
+ *          La memoria de nodos e índices se reutiliza entre construcciones.
+ * @note Complejidad de construcción: O(N log N)
+ */
+class Octree {
+public:
+    /**
+     * @brief Constructor
+     * @param max_hoja Número máximo de cuerpos por hoja
+     * @pre max_hoja >= 1
+     */
+    explicit Octree(int max_hoja = 8);
+
+    /**
+     * @brief Construye el árbol a partir de las posiciones y masas actuales
+     * @param cuerpos Sistema cuyos cuerpos se organizan en el árbol
+     * @post nodos()[0] es la raíz que contiene a todos los cuerpos
+     */
+    void construir(const SistemaCuerpos& cuerpos);
+
+    /// Nodos del árbol; el nodo 0 es la raíz
+    const std::vector<NodoOctree>& nodos() const { return nodos_; }
+
+    /// Índices de cuerpos ordenados según las hojas del árbol
+    const std::vector<int>& indices() const { return indices_; }
+
+    /// Número máximo de cuerpos por hoja
+    int maxHoja() const { return max_hoja_; }
+
+private:
+    /// Subdivide el nodo k y calcula su masa y centro de masa
+    void subdividir(int k, const SistemaCuerpos& cuerpos, int profundidad);
+
+    std::vector<NodoOctree> nodos_; ///< Almacenamiento de nodos
+    std::vector<int> indices_;      ///< Permutación de cuerpos por hoja
+    std::vector<int> buffer_;       ///< Octante asignado a cada posición durante la partición
+    std::vector<int> temporal_;     ///< Copia auxiliar de índices durante la partición
+    int max_hoja_;                  ///< Capacidad de las hojas
+};
+
+#endif // OCTREE_H
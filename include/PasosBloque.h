@@ -0,0 +1,144 @@
+/**
+ * @file PasosBloque.h
+ * @brief Pasos de tiempo individuales por bloques de potencias de dos (Aarseth)
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef PASOSBLOQUE_H
+#define PASOSBLOQUE_H
+
+#include <vector>
+#include "SistemaCuerpos.h"
+
+class EstadoSerializado; // PuntoControl.h
+
+/**
+ * @brief Integrador de Verlet con un paso de tiempo propio para cada cuerpo
+ * @details Cada cuerpo i está en un nivel kᵢ ∈ [0, K] y avanza con
+ *          dtᵢ = dt / 2^kᵢ, donde dt es el paso de la simulación. El tiempo se
+ *          recorre en subpasos ("tics") de dt / 2^K; en cada tic son activos
+ *          los cuerpos cuyo paso termina en él, y solo para ellos se evalúan
+ *          fuerzas. Como los pasos son potencias de dos y cada cuerpo empieza
+ *          su paso en un múltiplo de él, al final de cada paso dt todos los
+ *          cuerpos están sincronizados.
+ *
+ *          Los tics sin cuerpos activos no se recorren: se salta directamente
+ *          al siguiente tic en que termina el paso de algún cuerpo.
+ *
+ *          Cada cuerpo guarda el estado del inicio de su paso (r₀, V₀, a₀, t₀).
+ *          En cada tic visitado las posiciones de todos los cuerpos (fuentes de
+ *          la fuerza) se predicen al tiempo actual con la fórmula de
+ *          Cuerpo::Muevase_r, r = r₀ + V₀·τ + a₀·τ²/2, con τ = t - t₀; las
+ *          fuerzas sobre los activos se calculan con esas posiciones y su
+ *          velocidad se corrige con la de Cuerpo::Muevase_V,
+ *          V = V₀ + (a₀ + a₁)·dtᵢ/2. Con un solo nivel el resultado es
+ *          idéntico, bit a bit, al de SistemaCuerpos::Muevase_r/Muevase_V.
+ *
+ *          Tras cada paso el nivel se elige con el criterio de Aarseth
+ *          dtᵢ <= η·|a|/|ȧ|, con el jerk ȧ estimado como (a₁ - a₀)/dtᵢ. Un
+ *          cuerpo puede pasar a cualquier nivel más fino de inmediato, pero
+ *          solo sube un nivel a la vez y cuando el tic actual es múltiplo del
+ *          paso nuevo. Todos los cuerpos empiezan en el nivel más fino K.
+ */
+class IntegradorBloques {
+public:
+    /**
+     * @brief Constructor
+     * @param niveles Número de niveles K por debajo de dt (dt mínimo = dt / 2^K)
+     * @param eta Parámetro de precisión η del criterio de Aarseth
+     */
+    explicit IntegradorBloques(int niveles = 10, double eta = 0.02);
+
+    /**
+     * @brief Cambia los parámetros
+     * @param niveles Número de niveles K (0-30)
+     * @param eta Parámetro de precisión η (> 0)
+     * @pre Se llama antes de iniciar()
+     */
+    void configurar(int niveles, double eta);
+
+    /**
+     * @brief Toma el estado actual como inicio del paso de todos los cuerpos
+     * @param cuerpos Sistema con r, V y a(t) ya calculadas
+     * @param dt Paso de la simulación (el de nivel 0)
+     */
+    void iniciar(const SistemaCuerpos& cuerpos, double dt);
+
+    /// Subpasos (tics) por cada paso dt: 2^K
+    long subpasos() const { return 1L << niveles_; }
+
+    /**
+     * @brief Avanza hasta el próximo tic con cuerpos activos y predice las posiciones
+     * @param cuerpos Sistema; al salir tiene las posiciones predichas (las
+     *        velocidades de los inactivos no se actualizan hasta su corrección)
+     * @return true si todos los cuerpos son activos en este tic
+     * @post activos() contiene los cuerpos cuyo paso termina en este tic (al menos uno)
+     */
+    bool siguienteSubpaso(SistemaCuerpos& cuerpos);
+
+    /// true si el tic actual es el final de un paso dt (todos sincronizados)
+    bool finDePaso() const { return tic_ % subpasos() == 0; }
+
+    /// Índices de los cuerpos activos en el tic actual
+    const std::vector<int>& activos() const { return activos_; }
+
+    /**
+     * @brief Corrige los cuerpos activos y elige su nuevo nivel
+     * @param cuerpos Sistema con las posiciones predichas
+     * @param a_nuevas Aceleraciones a₁ de los activos en el tic actual
+     * @post r₀, V₀, a₀ y t₀ de los activos pasan a ser los del tic actual;
+     *       cuerpos.ax/ay/az de los activos contienen a₁
+     */
+    void corregir(SistemaCuerpos& cuerpos, const Aceleraciones& a_nuevas);
+
+    /// Evaluaciones de aceleración de un cuerpo realizadas (suma de activos en los tics visitados)
+    long evaluaciones() const { return evaluaciones_; }
+
+    /**
+     * @brief Evaluaciones que habría hecho un paso global que cumpla el criterio para todos
+     * @details N · (tics transcurridos) / 2^(K - nivelMasFino())
+     */
+    long evaluacionesPasoGlobal() const;
+
+    /// Nivel más fino que ha pedido el criterio para algún cuerpo
+    int nivelMasFino() const { return nivel_mas_fino_; }
+
+    /// Número de cuerpos en cada nivel 0..K
+    std::vector<int> histogramaNiveles() const;
+
+    /// Número de niveles K
+    int niveles() const { return niveles_; }
+
+    /// Parámetro de precisión η
+    double eta() const { return eta_; }
+
+    /**
+     * @brief Añade el estado completo del integrador a un punto de control
+     * @param estado Estado serializado al que se añade
+     */
+    void guardarEstado(EstadoSerializado& estado) const;
+
+    /**
+     * @brief Recupera el estado escrito por guardarEstado()
+     * @param estado Estado serializado, en la posición de este integrador
+     * @param n Número de cuerpos esperado
+     * @return false si el estado está incompleto o no corresponde a n cuerpos
+     */
+    bool cargarEstado(EstadoSerializado& estado, int n);
+
+private:
+    int niveles_;                 ///< K
+    double eta_;                  ///< η
+    double dt_min_;               ///< dt / 2^K
+    long tic_;                    ///< Tics transcurridos desde iniciar()
+    VectorAlineado x0_, y0_, z0_;    ///< Posición al inicio del paso de cada cuerpo
+    VectorAlineado vx0_, vy0_, vz0_; ///< Velocidad al inicio del paso de cada cuerpo
+    std::vector<long> tic0_;      ///< Tic de inicio del paso de cada cuerpo
+    std::vector<int> nivel_;      ///< Nivel de cada cuerpo
+    std::vector<int> activos_;    ///< Cuerpos activos en el tic actual (capacidad N reservada)
+    long evaluaciones_;           ///< Suma de activos
+    int nivel_mas_fino_;          ///< Máximo nivel pedido por el criterio
+};
+
+#endif // PASOSBLOQUE_H
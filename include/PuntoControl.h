@@ -0,0 +1,193 @@
+/**
+ * @file PuntoControl.h
+ * @brief Puntos de control binarios del estado completo para reanudar una simulación
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef PUNTOCONTROL_H
+#define PUNTOCONTROL_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief Búfer de bytes donde cada módulo guarda o recupera su estado
+ * @details Los valores se copian en binario, en el orden de la máquina, sin
+ *          conversión: un punto de control solo se lee en el mismo tipo de
+ *          máquina y con el mismo ejecutable, y a cambio la reanudación es
+ *          exacta bit a bit. Los vectores se guardan como número de
+ *          elementos seguido de los datos. Tras limpiar() el búfer conserva
+ *          su capacidad, de modo que los puntos de control siguientes no
+ *          asignan memoria.
+ */
+class EstadoSerializado {
+public:
+    EstadoSerializado() : posicion_(0), valido_(true) {}
+
+    /// Vacía el búfer (conserva la capacidad) para escribir un estado nuevo
+    void limpiar() { datos_.clear(); posicion_ = 0; valido_ = true; }
+
+    /// Vuelve al principio para leer
+    void reiniciarLectura() { posicion_ = 0; valido_ = true; }
+
+    /// Añade un valor de tipo trivial
+    template <typename T>
+    void escribir(const T& valor) { escribirBytes(&valor, sizeof(T)); }
+
+    /// Añade un vector: número de elementos y datos
+    template <typename V>
+    void escribirVector(const V& v) {
+        escribir(static_cast<unsigned long long>(v.size()));
+        if (!v.empty()) escribirBytes(v.data(), v.size() * sizeof(v[0]));
+    }
+
+    /// Lee un valor de tipo trivial; devuelve false si el estado se acabó
+    template <typename T>
+    bool leer(T& valor) { return leerBytes(&valor, sizeof(T)); }
+
+    /**
+     * @brief Lee un vector escrito con escribirVector()
+     * @param v Vector que se redimensiona y se llena
+     * @param maximo Número máximo de elementos aceptado (protege de archivos corruptos)
+     */
+    template <typename V>
+    bool leerVector(V& v, unsigned long long maximo) {
+        unsigned long long n = 0;
+        if (!leer(n) || n > maximo || n * sizeof(v[0]) > datos_.size() - posicion_) { valido_ = false; return false; }
+        v.resize(static_cast<size_t>(n));
+        return n == 0 || leerBytes(&v[0], static_cast<size_t>(n) * sizeof(v[0]));
+    }
+
+    /// false si alguna lectura se salió del estado o encontró un tamaño imposible
+    bool valido() const { return valido_; }
+
+    /// true si la lectura llegó exactamente al final
+    bool completo() const { return valido_ && posicion_ == datos_.size(); }
+
+    /// Bytes del estado
+    std::vector<char>& datos() { return datos_; }
+
+    /// Bytes del estado (solo lectura)
+    const std::vector<char>& datos() const { return datos_; }
+
+private:
+    void escribirBytes(const void* origen, size_t bytes) {
+        const size_t inicio = datos_.size();
+        datos_.resize(inicio + bytes);
+        std::memcpy(&datos_[inicio], origen, bytes);
+    }
+
+    bool leerBytes(void* destino, size_t bytes) {
+        if (!valido_ || bytes > datos_.size() - posicion_) { valido_ = false; return false; }
+        std::memcpy(destino, &datos_[posicion_], bytes);
+        posicion_ += bytes;
+        return true;
+    }
+
+    std::vector<char> datos_; ///< Bytes del estado
+    size_t posicion_;         ///< Posición de lectura
+    bool valido_;             ///< Ninguna lectura ha fallado
+};
+
+/**
+ * @brief Escribe puntos de control en un hilo aparte, de forma atómica
+ * @details La simulación serializa su estado en un EstadoSerializado (solo
+ *          copias en memoria) y lo entrega con publicar(), que intercambia
+ *          el búfer con el del escritor sin copiarlo. El hilo escritor lo
+ *          guarda en RUTA.tmp con una cabecera de control, hace fsync y lo
+ *          renombra a RUTA: si el proceso muere a mitad de la escritura, el
+ *          punto de control anterior sigue intacto.
+ *
+ *          Mientras el escritor guarda un punto, ocupado() es true y la
+ *          simulación aplaza el siguiente en lugar de esperar: lo serializa
+ *          en el primer paso en que el escritor esté libre. La escritura usa
+ *          llamadas POSIX sin búferes intermedios, así que el escritor no
+ *          asigna memoria.
+ *
+ *          Formato: "NCPUNTOC" (8 bytes), versión uint32, reservado uint32,
+ *          tamaño del estado uint64, suma FNV-1a de 64 bits del estado y
+ *          después los bytes del estado.
+ */
+class EscritorPuntosControl {
+public:
+    EscritorPuntosControl();
+
+    /// Espera a que termine la escritura en curso y detiene el hilo
+    ~EscritorPuntosControl();
+
+    /**
+     * @brief Fija la ruta y arranca el hilo escritor
+     * @param ruta Archivo del punto de control
+     * @param reserva Bytes reservados en el búfer del escritor, para que los
+     *        intercambios de publicar() no obliguen a asignar memoria
+     */
+    void abrir(const std::string& ruta, size_t reserva = 0);
+
+    /// true mientras el escritor guarda el último estado entregado
+    bool ocupado();
+
+    /**
+     * @brief Entrega un estado al escritor
+     * @param estado Estado serializado; al salir contiene el búfer anterior del escritor (vacío)
+     * @param esperar Si es true, espera a que el escritor termine el punto anterior
+     * @return false si el escritor estaba ocupado (y no se esperó): el estado no se entregó
+     */
+    bool publicar(EstadoSerializado& estado, bool esperar = false);
+
+    /// Espera a que se escriba el punto pendiente y detiene el hilo
+    void cerrar();
+
+    /// Puntos de control escritos
+    long escritos() const { return escritos_; }
+
+    /// Escrituras fallidas (disco lleno, directorio inexistente...)
+    long fallidos() const { return fallidos_; }
+
+    /// Bytes del último punto de control escrito
+    size_t bytesUltimo() const { return bytes_ultimo_; }
+
+    /// Tiempo total del hilo escritor escribiendo [s]
+    double tiempoEscritura() const { return tiempo_escritura_; }
+
+    /// Ruta del archivo
+    const std::string& ruta() const { return ruta_; }
+
+private:
+    EscritorPuntosControl(const EscritorPuntosControl&);            // No copiable
+    EscritorPuntosControl& operator=(const EscritorPuntosControl&); // No asignable
+
+    /// Bucle del hilo escritor
+    void bucleEscritor();
+
+    /// Escribe en ruta_temporal_, hace fsync y renombra; true si todo funcionó
+    bool escribirArchivo(const std::vector<char>& datos);
+
+    std::string ruta_;            ///< Archivo del punto de control
+    std::string ruta_temporal_;   ///< ruta_ + ".tmp"
+    std::vector<char> pendiente_; ///< Estado entregado que el escritor guarda
+    bool hay_pendiente_;          ///< pendiente_ tiene un estado por escribir
+    bool terminar_;               ///< Pide al escritor que termine
+    std::thread hilo_;            ///< Hilo escritor
+    std::mutex mutex_;            ///< Protege pendiente_, hay_pendiente_ y terminar_
+    std::condition_variable aviso_; ///< Avisa de un estado nuevo, de una escritura terminada o del cierre
+    long escritos_;               ///< Puntos escritos
+    long fallidos_;               ///< Escrituras fallidas
+    size_t bytes_ultimo_;         ///< Tamaño del último punto escrito
+    double tiempo_escritura_;     ///< Tiempo escribiendo [s]
+};
+
+/**
+ * @brief Lee y verifica un punto de control
+ * @param ruta Archivo escrito por EscritorPuntosControl
+ * @param estado Estado leído, listo para leer desde el principio
+ * @param error Descripción del problema si la lectura falla
+ * @return true si la cabecera, el tamaño y la suma de control son correctos
+ */
+bool leerPuntoControl(const std::string& ruta, EstadoSerializado& estado, std::string& error);
+
+#endif // PUNTOCONTROL_H
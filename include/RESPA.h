@@ -0,0 +1,178 @@
+/**
+ * @file RESPA.h
+ * @brief Integrador de pasos múltiples RESPA con separación de fuerzas cercanas y lejanas
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef RESPA_H
+#define RESPA_H
+
+#include <vector>
+#include "SistemaCuerpos.h"
+
+class EstadoSerializado; // PuntoControl.h
+
+/**
+ * @brief Función de conmutación S(r) entre fuerza cercana y lejana
+ * @param r Distancia entre los dos cuerpos
+ * @param radio_interior Por debajo, S = 1 (toda la fuerza es cercana)
+ * @param radio_exterior Por encima, S = 0 (toda la fuerza es lejana)
+ * @return S(r) = 1 - 10x³ + 15x⁴ - 6x⁵ con x = (r - r₁)/(r₂ - r₁)
+ * @details El polinomio quíntico tiene primera y segunda derivada nulas en
+ *          r₁ y r₂, de modo que las dos partes de la fuerza son suaves y el
+ *          paso largo no ve saltos al cruzar la zona de transición
+ */
+double conmutacionRESPA(double r, double radio_interior, double radio_exterior);
+
+/**
+ * @brief Integrador RESPA (Tuckerman, Berne y Martyna, 1992) de dos escalas de tiempo
+ * @details La fuerza de cada par se separa con la función de conmutación:
+ *          F = S(r)·F + (1 - S(r))·F = F_cerca + F_lejos. Como ambas partes
+ *          son centrales y dependen solo de r, cada una deriva de un
+ *          potencial y el esquema de impulsos es simpléctico:
+ *
+ *          impulso_lejos(dt/2) · [Verlet con F_cerca, paso dt/M]^M · impulso_lejos(dt/2)
+ *
+ *          Las fuerzas cercanas se evalúan en los M subpasos solo sobre una
+ *          lista de pares con r < r₂ + piel; la evaluación completa, con el
+ *          motor de fuerzas elegido, solo se hace una vez por paso dt, y la
+ *          parte lejana se obtiene como F_total - F_cerca. En un cúmulo con
+ *          binarias o subgrupos compactos la lista tiene pocos pares, y las
+ *          interacciones de pares por unidad de tiempo bajan casi en un
+ *          factor M frente a Verlet con el paso dt/M.
+ *
+ *          La piel es r₂/2. La lista se rehace cuando algún cuerpo se mueve
+ *          más de piel/2 desde la última construcción: así ningún par fuera
+ *          de la lista puede haber entrado en r₂. La construcción reparte los
+ *          cuerpos en celdas de lado r₂ + piel y solo mide las distancias
+ *          entre cuerpos de la misma celda o de celdas vecinas, O(N) con
+ *          densidad acotada; esas comprobaciones se cuentan aparte de las
+ *          interacciones para que el ahorro informado incluya su coste.
+ *
+ *          Las aceleraciones de SistemaCuerpos::ax/ay/az son siempre las
+ *          totales al final del paso; las partes cercana y lejana las guarda
+ *          el integrador.
+ */
+class IntegradorRESPA {
+public:
+    /**
+     * @brief Constructor
+     * @param radio_interior Radio r₁ bajo el que la fuerza es toda cercana
+     * @param radio_exterior Radio r₂ sobre el que la fuerza es toda lejana
+     * @param subpasos Subpasos M de las fuerzas cercanas por paso dt
+     */
+    explicit IntegradorRESPA(double radio_interior = 0.5, double radio_exterior = 1.0, int subpasos = 8);
+
+    /**
+     * @brief Cambia los parámetros
+     * @param radio_interior Radio r₁ (> 0)
+     * @param radio_exterior Radio r₂ (> r₁)
+     * @param subpasos Subpasos M (>= 1)
+     * @pre Se llama antes de iniciar()
+     */
+    void configurar(double radio_interior, double radio_exterior, int subpasos);
+
+    /**
+     * @brief Construye la lista de pares y separa las aceleraciones iniciales
+     * @param cuerpos Sistema con r, V y las aceleraciones totales a(t) ya calculadas
+     */
+    void iniciar(const SistemaCuerpos& cuerpos);
+
+    /// Subpasos M de las fuerzas cercanas por paso dt
+    int subpasos() const { return subpasos_; }
+
+    /// Radio r₁ de la función de conmutación
+    double radioInterior() const { return radio_interior_; }
+
+    /// Radio r₂ de la función de conmutación
+    double radioExterior() const { return radio_exterior_; }
+
+    /**
+     * @brief Suma a V el impulso de las fuerzas lejanas: V += a_lejos·dt (salvo los cuerpos sin masa)
+     * @param cuerpos Sistema a modificar
+     * @param dt Duración del impulso
+     */
+    void impulsoLejano(SistemaCuerpos& cuerpos, double dt) const;
+
+    /**
+     * @brief Suma a V el impulso de las fuerzas cercanas: V += a_cerca·dt (salvo los cuerpos sin masa)
+     * @param cuerpos Sistema a modificar
+     * @param dt Duración del impulso
+     */
+    void impulsoCercano(SistemaCuerpos& cuerpos, double dt) const;
+
+    /**
+     * @brief Mueve las posiciones con la velocidad actual: r += V·dt (salvo los cuerpos sin masa)
+     * @param cuerpos Sistema a modificar
+     * @param dt Duración de la deriva
+     */
+    void deriva(SistemaCuerpos& cuerpos, double dt) const;
+
+    /**
+     * @brief Evalúa las aceleraciones cercanas sobre la lista de pares
+     * @param cuerpos Sistema con las posiciones actuales
+     * @post Rehace la lista antes si algún cuerpo se movió más de piel/2;
+     *       solo asigna memoria si la lista supera el doble de la inicial más N pares
+     */
+    void evaluarCercanas(const SistemaCuerpos& cuerpos);
+
+    /**
+     * @brief Obtiene las aceleraciones lejanas como total menos cercanas
+     * @param total Aceleraciones totales en las posiciones de la última evaluarCercanas()
+     */
+    void separarLejanas(const Aceleraciones& total);
+
+    /// Pares en la lista cercana
+    long paresLista() const { return static_cast<long>(pares_.size() / 2); }
+
+    /// Interacciones de pares evaluadas en las pasadas cercanas desde iniciar()
+    long interaccionesCercanas() const { return interacciones_cercanas_; }
+
+    /// Pasadas cercanas desde iniciar()
+    long pasadasCercanas() const { return pasadas_cercanas_; }
+
+    /// Veces que se construyó la lista desde iniciar() (incluida la inicial)
+    long construccionesLista() const { return construcciones_lista_; }
+
+    /// Distancias de pares medidas al construir la lista desde iniciar()
+    long comprobacionesLista() const { return comprobaciones_lista_; }
+
+    /**
+     * @brief Añade el estado completo del integrador a un punto de control
+     * @param estado Estado serializado al que se añade
+     */
+    void guardarEstado(EstadoSerializado& estado) const;
+
+    /**
+     * @brief Recupera el estado escrito por guardarEstado()
+     * @param estado Estado serializado, en la posición de este integrador
+     * @param n Número de cuerpos esperado
+     * @return false si el estado está incompleto o no corresponde a n cuerpos
+     */
+    bool cargarEstado(EstadoSerializado& estado, int n);
+
+private:
+    /// Reúne los pares con r < r₂ + piel y guarda las posiciones de referencia
+    void construirLista(const SistemaCuerpos& cuerpos);
+
+    double radio_interior_;   ///< Radio r₁ de la función de conmutación
+    double radio_exterior_;   ///< Radio r₂ de la función de conmutación
+    int subpasos_;            ///< Subpasos M por paso dt
+    double piel_;             ///< Margen de la lista sobre r₂
+
+    Aceleraciones cerca_;     ///< Aceleraciones de las fuerzas cercanas
+    Aceleraciones lejos_;     ///< Aceleraciones de las fuerzas lejanas
+    std::vector<int> pares_;  ///< Lista de pares cercanos: i, j consecutivos
+    VectorAlineado x_lista_, y_lista_, z_lista_; ///< Posiciones al construir la lista
+    std::vector<unsigned long long> celda_; ///< Clave de la celda de cada cuerpo
+    std::vector<int> orden_;                ///< Cuerpos ordenados por celda
+    std::vector<unsigned long long> claves_pares_; ///< Pares hallados, como i·N + j, para ordenarlos
+
+    long interacciones_cercanas_; ///< Interacciones de pares en las pasadas cercanas
+    long pasadas_cercanas_;       ///< Evaluaciones de las fuerzas cercanas
+    long construcciones_lista_;   ///< Construcciones de la lista de pares
+    long comprobaciones_lista_;   ///< Distancias medidas al construir la lista
+};
+
+#endif // RESPA_H
@@ -0,0 +1,132 @@
+/**
+ * @file SalidaAsincrona.h
+ * @brief Escritura de la trayectoria en un hilo dedicado mediante un anillo de cuadros
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef SALIDAASINCRONA_H
+#define SALIDAASINCRONA_H
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Trayectoria.h"
+
+/// Qué hacer cuando el anillo de cuadros está lleno
+enum PoliticaSaturacion {
+    SATURACION_ESPERAR = 1,  ///< La simulación espera a que el escritor libere un cuadro
+    SATURACION_DESCARTAR = 2 ///< El cuadro se descarta y se cuenta
+};
+
+/**
+ * @brief Envía los cuadros de la trayectoria a un hilo escritor
+ * @details El hilo de la simulación copia cada cuadro en un anillo de
+ *          capacidad fija reservado al abrir y sigue integrando; un hilo
+ *          escritor formatea y guarda los cuadros con EscritorTrayectoria.
+ *          El anillo tiene un solo productor y un solo consumidor, que se
+ *          coordinan con dos contadores atómicos: la copia de cada cuadro se
+ *          hace sin cerrojo. El mutex y las variables de condición sirven
+ *          para dormir cuando el anillo está vacío (escritor) o lleno
+ *          (simulación, con la política de esperar). Cada hilo marca con un
+ *          indicador atómico que va a dormir; quien avanza un contador solo
+ *          toma el mutex y notifica si el otro hilo está marcado, así que en
+ *          régimen normal ninguno de los dos toma cerrojos.
+ *          Publicar un cuadro no reserva memoria.
+ */
+class SalidaAsincrona {
+public:
+    SalidaAsincrona();
+
+    /// Vacía el anillo, detiene el escritor y cierra el archivo
+    ~SalidaAsincrona();
+
+    /**
+     * @brief Crea el archivo, reserva el anillo y arranca el hilo escritor
+     * @param ruta Ruta del archivo de trayectoria
+     * @param formato Texto o binario
+     * @param n_cuerpos Número de cuerpos N
+     * @param dt Paso de tiempo
+     * @param seleccion Cuerpos y campos que se escriben
+     * @param capacidad Cuadros del anillo (0 = capacidadAutomatica())
+     * @param politica Comportamiento cuando el anillo está lleno
+     * @return true si el archivo se pudo abrir
+     */
+    bool abrir(const std::string& ruta, FormatoTrayectoria formato, int n_cuerpos, double dt,
+               const SeleccionSalida& seleccion, int capacidad, PoliticaSaturacion politica);
+
+    /**
+     * @brief Copia el estado actual en el anillo para que lo escriba el hilo escritor
+     * @param t Tiempo del cuadro
+     * @param cuerpos Sistema con posiciones y velocidades actuales
+     * @param K Energía cinética (NaN si no se calculó en este paso)
+     * @param U Energía potencial (NaN si no se calculó en este paso)
+     * @param E Energía total (NaN si no se calculó en este paso)
+     * @return false si el cuadro se descartó por estar lleno el anillo
+     */
+    bool publicar(double t, const SistemaCuerpos& cuerpos, double K, double U, double E);
+
+    /// Espera a que se escriban los cuadros pendientes, detiene el escritor y cierra el archivo
+    void cerrar();
+
+    /// Cuadros que llegaron al archivo
+    long cuadrosEscritos() const { return escritor_.cuadros(); }
+
+    /// Cuadros descartados con la política SATURACION_DESCARTAR
+    long cuadrosDescartados() const { return descartados_; }
+
+    /// Veces que la simulación encontró el anillo lleno y tuvo que esperar
+    long esperas() const { return esperas_; }
+
+    /// Tiempo total que la simulación esperó por el anillo lleno [s]
+    double tiempoEspera() const { return tiempo_espera_; }
+
+    /// Tiempo que cerrar() esperó a que el escritor vaciara el anillo [s]
+    double tiempoVaciado() const { return tiempo_vaciado_; }
+
+    /// Capacidad del anillo en cuadros
+    int capacidad() const { return static_cast<int>(capacidad_); }
+
+    /**
+     * @brief Capacidad por defecto: hasta 256 cuadros dentro de 64 MiB, mínimo 2
+     * @param dobles_cuadro Tamaño de un cuadro en dobles
+     */
+    static int capacidadAutomatica(size_t dobles_cuadro);
+
+private:
+    SalidaAsincrona(const SalidaAsincrona&);            // No copiable
+    SalidaAsincrona& operator=(const SalidaAsincrona&); // No asignable
+
+    /// Bucle del hilo escritor: consume cuadros hasta que se pide terminar y el anillo queda vacío
+    void bucleEscritor();
+
+    /// Marca que el hilo actual va a dormir; se llama con el mutex tomado, antes de esperar
+    static void anunciarEspera(std::atomic<bool>& dormido);
+
+    /// Despierta al hilo que espera en la condición, tomando el mutex solo si está marcado como dormido
+    void notificar(std::condition_variable& condicion, const std::atomic<bool>& dormido);
+
+    EscritorTrayectoria escritor_;        ///< Escribe en el hilo escritor; la simulación solo empaqueta
+    PoliticaSaturacion politica_;         ///< Comportamiento con el anillo lleno
+    std::vector<double> anillo_;          ///< capacidad_ cuadros de tam_cuadro_ dobles
+    size_t tam_cuadro_;                   ///< Dobles por cuadro
+    size_t capacidad_;                    ///< Cuadros del anillo
+    std::atomic<size_t> publicados_;      ///< Cuadros publicados (solo lo escribe la simulación)
+    char relleno_[64];                    ///< Separa los contadores en líneas de caché distintas
+    std::atomic<size_t> consumidos_;      ///< Cuadros escritos (solo lo escribe el escritor)
+    std::atomic<bool> terminar_;          ///< Pide al escritor que termine al vaciar el anillo
+    std::atomic<bool> escritor_dormido_;  ///< El escritor espera en hay_cuadros_
+    std::atomic<bool> productor_dormido_; ///< La simulación espera en hay_espacio_
+    std::thread hilo_;                    ///< Hilo escritor
+    std::mutex mutex_;                    ///< Protege las esperas y notificaciones de las variables de condición
+    std::condition_variable hay_cuadros_; ///< Despierta al escritor
+    std::condition_variable hay_espacio_; ///< Despierta a la simulación
+    long descartados_;                    ///< Cuadros descartados
+    long esperas_;                        ///< Publicaciones que encontraron el anillo lleno
+    double tiempo_espera_;                ///< Tiempo de espera acumulado [s]
+    double tiempo_vaciado_;               ///< Tiempo de vaciado al cerrar [s]
+};
+
+#endif // SALIDAASINCRONA_H
@@ -0,0 +1,179 @@
+/**
+ * @file SistemaCuerpos.h
+ * @brief Almacenamiento en estructura de arreglos (SoA) de todos los cuerpos
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef SISTEMACUERPOS_H
+#define SISTEMACUERPOS_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "vector3D.h"
+#include "Cuerpo.h"
+#include "ContadorAsignaciones.h"
+
+/// Alineación en bytes de los arreglos de cuerpos (una línea de caché)
+const std::size_t ALINEACION_CUERPOS = 64;
+
+/**
+ * @brief Asignador de memoria alineada para contenedores estándar
+ * @tparam T Tipo de los elementos
+ * @tparam Alineacion Alineación en bytes (potencia de 2, múltiplo de sizeof(void*))
+ */
+template <typename T, std::size_t Alineacion = ALINEACION_CUERPOS>
+struct AsignadorAlineado {
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind { typedef AsignadorAlineado<U, Alineacion> other; };
+
+    AsignadorAlineado() {}
+    template <typename U>
+    AsignadorAlineado(const AsignadorAlineado<U, Alineacion>&) {}
+
+    T* allocate(std::size_t n) {
+        void* p = 0;
+        if (posix_memalign(&p, Alineacion, n * sizeof(T) + (n == 0 ? Alineacion : 0)) != 0) {
+            throw std::bad_alloc();
+        }
+        registrarAsignacion();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t) { std::free(p); }
+};
+
+template <typename T, typename U, std::size_t A>
+bool operator==(const AsignadorAlineado<T, A>&, const AsignadorAlineado<U, A>&) { return true; }
+template <typename T, typename U, std::size_t A>
+bool operator!=(const AsignadorAlineado<T, A>&, const AsignadorAlineado<U, A>&) { return false; }
+
+/// Arreglo contiguo de doubles alineado a ALINEACION_CUERPOS bytes
+typedef std::vector<double, AsignadorAlineado<double> > VectorAlineado;
+
+/**
+ * @brief Aceleraciones de todos los cuerpos en arreglos separados por componente
+ * @details Es la salida de los motores de fuerza y el equivalente SoA de
+ *          las fuerzas F(t+dt) que recibe Cuerpo::Muevase_V
+ */
+struct Aceleraciones {
+    VectorAlineado x; ///< Componente X de la aceleración
+    VectorAlineado y; ///< Componente Y de la aceleración
+    VectorAlineado z; ///< Componente Z de la aceleración
+
+    /// Ajusta el tamaño a n cuerpos y pone todas las componentes en cero
+    void redimensionar(int n) { x.assign(n, 0.0); y.assign(n, 0.0); z.assign(n, 0.0); }
+
+    /// Pone todas las componentes en cero sin cambiar el tamaño
+    void borrar();
+
+    /// Número de cuerpos
+    int tamano() const { return static_cast<int>(x.size()); }
+};
+
+/**
+ * @brief Conjunto de N cuerpos almacenado como estructura de arreglos
+ * @details Cada magnitud (posición, velocidad, aceleración, masa, radio) se
+ *          guarda en un arreglo contiguo alineado a 64 bytes, de modo que los
+ *          núcleos de fuerza solo recorren posiciones y masas, y los bucles
+ *          del integrador se pueden vectorizar. Se almacena la aceleración en
+ *          lugar de la fuerza y se precalcula el inverso de cada masa.
+ *
+ *          La clase Cuerpo se conserva como vista por cuerpo: fijarCuerpo()
+ *          y cuerpo() convierten entre ambas representaciones.
+ * @note Las masas deben modificarse con fijarMasa() para mantener inv_m
+ * @see Cuerpo
+ */
+class SistemaCuerpos {
+public:
+    VectorAlineado x, y, z;    ///< Posiciones [unidades de longitud]
+    VectorAlineado vx, vy, vz; ///< Velocidades [unidades de velocidad]
+    VectorAlineado ax, ay, az; ///< Aceleraciones actuales a(t) [unidades de aceleración]
+    VectorAlineado m;          ///< Masas [unidades de masa]
+    VectorAlineado inv_m;      ///< Inversos de las masas (0 para masa nula)
+    VectorAlineado R;          ///< Radios [unidades de longitud] - Solo referencia
+
+    /// Constructor por defecto (sistema vacío)
+    SistemaCuerpos() {}
+
+    /**
+     * @brief Crea un sistema de n cuerpos con todos los valores en cero
+     * @param n Número de cuerpos
+     */
+    explicit SistemaCuerpos(int n) { redimensionar(n); }
+
+    /**
+     * @brief Ajusta el número de cuerpos
+     * @param n Nuevo número de cuerpos
+     * @post Todos los valores quedan en cero
+     */
+    void redimensionar(int n);
+
+    /// Número de cuerpos
+    int tamano() const { return static_cast<int>(m.size()); }
+
+    /**
+     * @brief Copia el estado de un Cuerpo en la posición i
+     * @param i Índice del cuerpo
+     * @param c Cuerpo de origen; su fuerza F se convierte en aceleración F/m
+     */
+    void fijarCuerpo(int i, const Cuerpo& c);
+
+    /**
+     * @brief Devuelve una vista Cuerpo del cuerpo i
+     * @param i Índice del cuerpo
+     * @return Copia con r, V, m, R y la fuerza F = m·a
+     */
+    Cuerpo cuerpo(int i) const;
+
+    /// Reemplaza todo el sistema por los cuerpos dados
+    void cargarDesde(const std::vector<Cuerpo>& cuerpos);
+
+    /// Devuelve todos los cuerpos como vector de Cuerpo
+    std::vector<Cuerpo> aCuerpos() const;
+
+    /// Cambia la masa del cuerpo i y actualiza su inverso
+    void fijarMasa(int i, double masa);
+
+    /// Posición del cuerpo i como vector3D
+    vector3D posicion(int i) const { return vector3D(x[i], y[i], z[i]); }
+
+    /// Velocidad del cuerpo i como vector3D
+    vector3D velocidad(int i) const { return vector3D(vx[i], vy[i], vz[i]); }
+
+    /// Magnitud de la velocidad del cuerpo i
+    double normaVelocidad(int i) const;
+
+    /// Copia las aceleraciones dadas como aceleraciones actuales a(t)
+    void fijarAceleraciones(const Aceleraciones& a);
+
+    /**
+     * @brief Intercambia las aceleraciones actuales con las dadas, sin copiar
+     * @param a Aceleraciones a(t+dt); al volver contiene las antiguas a(t)
+     * @details Solo intercambia los punteros de los arreglos (O(1), sin
+     *          asignar memoria). Es el cierre del paso de Verlet con doble buffer.
+     * @pre a.tamano() == tamano()
+     */
+    void intercambiarAceleraciones(Aceleraciones& a) { ax.swap(a.x); ay.swap(a.y); az.swap(a.z); }
+
+    /**
+     * @brief Actualiza las posiciones usando el algoritmo de Verlet
+     * @param dt Paso de tiempo [unidades de tiempo]
+     * @details r(t+dt) = r(t) + V(t)*dt + a(t)*dt²/2, igual que Cuerpo::Muevase_r
+     */
+    void Muevase_r(double dt);
+
+    /**
+     * @brief Actualiza las velocidades usando el algoritmo de Verlet
+     * @param dt Paso de tiempo [unidades de tiempo]
+     * @param a_siguiente Aceleraciones a(t+dt)
+     * @details V(t+dt) = V(t) + (a(t) + a(t+dt))*dt/2, igual que Cuerpo::Muevase_V
+     */
+    void Muevase_V(double dt, const Aceleraciones& a_siguiente);
+};
+
+#endif // SISTEMACUERPOS_H
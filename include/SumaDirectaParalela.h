@@ -0,0 +1,109 @@
+/**
+ * @file SumaDirectaParalela.h
+ * @brief Suma directa O(N²) repartida entre varios hilos
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef SUMADIRECTAPARALELA_H
+#define SUMADIRECTAPARALELA_H
+
+#include <vector>
+#include <atomic>
+#include "SistemaCuerpos.h"
+#include "GrupoHilos.h"
+#include "FuerzasSIMD.h"
+
+/**
+ * @brief Motor de suma directa multihilo que conserva el ahorro de la tercera ley
+ * @details El triángulo de pares i<j se divide en bloques (tramo de cuerpos i,
+ *          bloque de cuerpos j) que los hilos toman dinámicamente de un
+ *          contador atómico. Cada hilo acumula acción y reacción en su propio
+ *          arreglo de aceleraciones, por lo que no hay escrituras
+ *          compartidas; al final los arreglos se reducen en paralelo, cada
+ *          hilo sobre un rango de cuerpos. Con un solo hilo equivale a
+ *          calcularTodasLasFuerzas.
+ *
+ *          En precisión mixta (fijarPrecisionMixta) los pares se evalúan en
+ *          float con calcularFuerzasMixtas: cada hilo toma tramos de filas
+ *          completas y escribe solo en ellas, sin acumuladores propios ni
+ *          reducción.
+ * @note Memoria adicional: cada hilo salvo el primero guarda en parciales_
+ *       un arreglo completo de 3·N dobles, O(T·N) en total (con 64 hilos y
+ *       N = 10⁶, 1.5 GB), y la reducción lee los T arreglos. En precisión
+ *       mixta se añaden 4·N float compartidos. Solo la suma directa usa
+ *       varios hilos: BarnesHut y FMM se evalúan en un solo núcleo.
+ */
+class SumaDirectaParalela {
+public:
+    /**
+     * @brief Constructor
+     * @param hilos Número de hilos (>= 1)
+     */
+    explicit SumaDirectaParalela(int hilos = 1);
+
+    /**
+     * @brief Calcula las aceleraciones de todos los cuerpos
+     * @param cuerpos Sistema con posiciones y masas actuales
+     * @param aceleraciones Salida con la aceleración de cada cuerpo
+     * @param energia_potencial Si no es nulo, recibe la energía potencial
+     *        total calculada en el mismo recorrido de pares
+     * @pre aceleraciones.tamano() == cuerpos.tamano()
+     */
+    void calcularFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                         double* energia_potencial = 0);
+
+    /**
+     * @brief Calcula las aceleraciones de un subconjunto de cuerpos
+     * @param cuerpos Sistema con posiciones y masas actuales
+     * @param objetivos Índices de los cuerpos cuya aceleración se calcula
+     * @param n_objetivos Número de índices
+     * @param aceleraciones Salida; solo se escriben las entradas de los objetivos
+     * @details Reparte los objetivos en tramos contiguos, uno por hilo, con
+     *          calcularFuerzasSobre(); como cada hilo escribe solo sus
+     *          objetivos no hace falta reducción
+     */
+    void calcularFuerzasSobre(const SistemaCuerpos& cuerpos, const int* objetivos, int n_objetivos,
+                              Aceleraciones& aceleraciones);
+
+    /// Cambia el número de hilos (crea o detiene trabajadores)
+    void fijarHilos(int hilos);
+
+    /**
+     * @brief Elige la precisión de calcularFuerzas()
+     * @param mixta true: pares en float y sumas en double; false: todo en double
+     * @note calcularFuerzasSobre() (pasos por bloques) sigue en doble precisión
+     */
+    void fijarPrecisionMixta(bool mixta) { precision_mixta_ = mixta; }
+
+    /// true si calcularFuerzas() usa el núcleo de precisión mixta
+    bool precisionMixta() const { return precision_mixta_; }
+
+    /// Número de hilos actual
+    int hilos() const { return grupo_.tamano(); }
+
+private:
+    /// Bloque de pares asignable a un hilo
+    struct BloquePares {
+        int i0, i1; ///< Tramo de cuerpos i
+        int j0, j1; ///< Bloque de cuerpos j
+    };
+
+    /// Recalcula la lista de bloques para n cuerpos
+    void prepararBloques(int n);
+
+    /// calcularFuerzas() en precisión mixta, repartiendo tramos de filas
+    void calcularFuerzasMixtas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                               double* energia_potencial);
+
+    GrupoHilos grupo_;                     ///< Hilos reutilizados entre pasos
+    std::vector<Aceleraciones> parciales_; ///< Acumuladores de los hilos 1..hilos-1
+    std::vector<double> energias_;         ///< Energía parcial de cada hilo (separadas una línea de caché)
+    std::vector<BloquePares> bloques_;     ///< Reparto del triángulo i<j
+    int n_bloques_;                        ///< Número de cuerpos para el que se calculó bloques_
+    std::atomic<int> siguiente_;           ///< Próximo bloque por asignar
+    bool precision_mixta_;                 ///< Evaluar los pares en float
+    CoordenadasSimples simples_;           ///< Posiciones y masas en float (precisión mixta)
+};
+
+#endif // SUMADIRECTAPARALELA_H
@@ -0,0 +1,222 @@
+/**
+ * @file Trayectoria.h
+ * @brief Escritura de la trayectoria en texto o en formato binario por columnas
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef TRAYECTORIA_H
+#define TRAYECTORIA_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "SistemaCuerpos.h"
+
+/// Formatos de salida de la trayectoria
+enum FormatoTrayectoria {
+    TRAYECTORIA_TEXTO = 1,  ///< Texto separado por tabuladores (results/sim_data.dat)
+    TRAYECTORIA_BINARIA = 2 ///< Binario por columnas, little-endian (results/sim_data.bin)
+};
+
+/// Grupos de campos que se pueden escribir en cada cuadro (combinables con |)
+enum CampoSalida {
+    CAMPO_POSICIONES = 1,  ///< x, y, z de cada cuerpo
+    CAMPO_VELOCIDADES = 2, ///< vx, vy, vz de cada cuerpo
+    CAMPO_RAPIDEZ = 4,     ///< |v| de cada cuerpo
+    CAMPO_ENERGIAS = 8     ///< K, U, E del sistema
+};
+
+/// Campos del formato histórico de sim_data.dat, el que leen los scripts de graficación
+const unsigned CAMPOS_POR_DEFECTO = CAMPO_POSICIONES | CAMPO_RAPIDEZ | CAMPO_ENERGIAS;
+
+/**
+ * @brief Qué parte del estado se escribe en cada cuadro
+ * @details Los cuerpos escritos son el rango contiguo
+ *          [primer_cuerpo, primer_cuerpo + cuerpos) del sistema
+ */
+struct SeleccionSalida {
+    int primer_cuerpo; ///< Índice (desde 0) del primer cuerpo escrito
+    int cuerpos;       ///< Número de cuerpos escritos
+    unsigned campos;   ///< Combinación de CampoSalida
+};
+
+/**
+ * @brief Selección con todos los cuerpos y los campos por defecto
+ * @param n_cuerpos Número de cuerpos del sistema
+ */
+SeleccionSalida seleccionCompleta(int n_cuerpos);
+
+/// Identificador al inicio de todo archivo binario de trayectoria
+const char MAGIA_TRAYECTORIA[9] = "NCUERPOS";
+
+/// Versión actual del formato binario
+const std::uint32_t VERSION_TRAYECTORIA = 2;
+
+/// Longitud fija del nombre de un campo en la cabecera binaria
+const int LONGITUD_NOMBRE_CAMPO = 16;
+
+/**
+ * @brief Descripción de un campo de cada cuadro binario
+ * @details Cada campo ocupa `elementos` dobles (float64 little-endian)
+ *          consecutivos dentro del cuadro
+ */
+struct CampoTrayectoria {
+    std::string nombre;      ///< Nombre del campo (t, x, y, z, vx, vy, vz, v, K, U, E)
+    std::uint32_t elementos; ///< 1 para campos globales, N para campos por cuerpo
+};
+
+/**
+ * @brief Cabecera de un archivo binario de trayectoria
+ * @details Disposición en disco (little-endian):
+ *          | desplazamiento | tipo      | contenido                         |
+ *          |----------------|-----------|-----------------------------------|
+ *          | 0              | char[8]   | "NCUERPOS"                        |
+ *          | 8              | uint32    | versión (2)                       |
+ *          | 12             | uint32    | tamaño de la cabecera en bytes    |
+ *          | 16             | uint64    | N (número de cuerpos escritos)    |
+ *          | 24             | float64   | dt                                |
+ *          | 32             | uint64    | número de cuadros (0 = sin cerrar)|
+ *          | 40             | uint32    | número de campos                  |
+ *          | 44             | uint32    | tamaño de un cuadro en bytes      |
+ *          | 48             | uint64    | índice del primer cuerpo escrito  |
+ *          | 56             | uint64    | número total de cuerpos simulados |
+ *          | 64             | campos    | por campo: char[16] nombre, uint32 elementos, uint32 tipo (1 = float64) |
+ *          Tras la cabecera, rellenada hasta múltiplo de 64 bytes, vienen los
+ *          cuadros de tamaño fijo, cada uno con sus campos uno tras otro.
+ *          La versión 1 no tenía los campos de los desplazamientos 48 y 56
+ *          (la lista de campos empezaba en 48) y siempre incluía todos los cuerpos.
+ */
+struct CabeceraTrayectoria {
+    std::uint32_t version;               ///< Versión del formato
+    std::uint32_t tam_cabecera;          ///< Desplazamiento del primer cuadro
+    std::uint64_t n_cuerpos;             ///< Número de cuerpos escritos N
+    double dt;                           ///< Paso de tiempo de la simulación
+    std::uint64_t n_cuadros;             ///< Número de cuadros escritos
+    std::uint32_t tam_cuadro;            ///< Bytes por cuadro
+    std::uint64_t primer_cuerpo;         ///< Índice del primer cuerpo escrito
+    std::uint64_t n_total;               ///< Cuerpos de la simulación completa
+    std::vector<CampoTrayectoria> campos; ///< Campos de cada cuadro, en orden
+};
+
+/**
+ * @brief Desplazamiento (en dobles) de cada campo dentro de un cuadro
+ * @details Vale -1 para los campos que no se escriben. Sirve tanto para
+ *          armar cuadros como para leerlos y pasarlos a texto.
+ */
+struct DisposicionCuadro {
+    int cuerpos;       ///< Cuerpos escritos
+    int primer_cuerpo; ///< Índice del primer cuerpo escrito
+    long t, x, y, z, vx, vy, vz, v, K, U, E;
+    size_t dobles;     ///< Tamaño del cuadro en dobles
+};
+
+/**
+ * @brief Escribe la trayectoria cuadro a cuadro en el formato elegido
+ * @details Cada cuadro contiene t y, según la selección, las posiciones,
+ *          velocidades y rapidez de un rango de cuerpos y las energías
+ *          K, U, E. En texto, con la selección por defecto, se conserva el
+ *          formato histórico de sim_data.dat; en binario cada cuadro es un
+ *          bloque de dobles por columnas que se puede leer directamente con
+ *          mmap o np.memmap. El búfer del cuadro se reserva al abrir, por lo
+ *          que escribir no asigna memoria.
+ */
+class EscritorTrayectoria {
+public:
+    EscritorTrayectoria();
+
+    /// Cierra el archivo si sigue abierto
+    ~EscritorTrayectoria();
+
+    /**
+     * @brief Crea el archivo de salida y escribe la cabecera
+     * @param ruta Ruta del archivo
+     * @param formato Texto o binario
+     * @param n_cuerpos Número de cuerpos del sistema
+     * @param dt Paso de tiempo (se guarda en la cabecera binaria)
+     * @param seleccion Cuerpos y campos que se escriben
+     * @return true si el archivo se pudo abrir
+     * @pre seleccion describe un rango no vacío dentro de [0, n_cuerpos)
+     */
+    bool abrir(const std::string& ruta, FormatoTrayectoria formato, int n_cuerpos, double dt,
+               const SeleccionSalida& seleccion);
+
+    /**
+     * @brief Agrega un cuadro con el estado actual
+     * @param t Tiempo del cuadro
+     * @param cuerpos Sistema con posiciones y velocidades actuales
+     * @param K Energía cinética (NaN si no se calculó en este paso)
+     * @param U Energía potencial (NaN si no se calculó en este paso)
+     * @param E Energía total (NaN si no se calculó en este paso)
+     */
+    void escribirCuadro(double t, const SistemaCuerpos& cuerpos, double K, double U, double E);
+
+    /**
+     * @brief Agrega un cuadro ya armado con empaquetarCuadro
+     * @param cuadro doblesPorCuadro() valores con la disposición del archivo
+     */
+    void escribirCuadroEmpaquetado(const double* cuadro);
+
+    /**
+     * @brief Copia los campos seleccionados del estado actual en un cuadro
+     * @param cuadro Destino de doblesPorCuadro() valores
+     * @param t Tiempo del cuadro
+     * @param cuerpos Sistema con posiciones y velocidades actuales
+     * @param K Energía cinética
+     * @param U Energía potencial
+     * @param E Energía total
+     * @note Solo lee la configuración fijada en abrir(), por lo que puede
+     *       llamarse desde otro hilo mientras se escriben cuadros anteriores
+     */
+    void empaquetarCuadro(double* cuadro, double t, const SistemaCuerpos& cuerpos,
+                          double K, double U, double E) const;
+
+    /// Número de dobles de cada cuadro con la selección actual
+    size_t doblesPorCuadro() const { return disposicion_.dobles; }
+
+    /// Vacía el búfer, completa la cabecera binaria y cierra el archivo
+    void cerrar();
+
+    /// Número de cuadros escritos
+    long cuadros() const { return cuadros_; }
+
+private:
+    std::ofstream archivo_;         ///< Archivo de salida
+    FormatoTrayectoria formato_;    ///< Formato elegido al abrir
+    DisposicionCuadro disposicion_; ///< Campos seleccionados y su posición en el cuadro
+    long cuadros_;                  ///< Cuadros escritos
+    std::vector<double> cuadro_;    ///< Cuadro en construcción
+};
+
+/**
+ * @brief Campos de un cuadro para una selección, en el orden en que se escriben
+ * @param seleccion Cuerpos y campos seleccionados
+ * @return Lista con t y los campos seleccionados entre x, y, z, vx, vy, vz, v, K, U, E
+ */
+std::vector<CampoTrayectoria> camposTrayectoria(const SeleccionSalida& seleccion);
+
+/**
+ * @brief Lee y valida la cabecera de un archivo binario de trayectoria
+ * @param entrada Flujo binario posicionado al inicio del archivo
+ * @param cabecera Cabecera leída
+ * @param error Descripción del problema si la lectura falla
+ * @return true si la cabecera es válida
+ * @post Si el número de cuadros es 0 (archivo sin cerrar) se deduce del tamaño
+ */
+bool leerCabeceraTrayectoria(std::ifstream& entrada, CabeceraTrayectoria& cabecera, std::string& error);
+
+/**
+ * @brief Convierte un archivo binario de trayectoria al formato de texto
+ * @param ruta_binaria Archivo de entrada (p. ej. results/sim_data.bin)
+ * @param ruta_texto Archivo de salida (p. ej. results/sim_data.dat)
+ * @param error Descripción del problema si la conversión falla
+ * @return true si la conversión terminó
+ * @details El resultado es idéntico al que se obtiene con salida de texto
+ *          y la misma selección, por lo que los scripts de graficación
+ *          funcionan sin cambios
+ */
+bool convertirTrayectoriaATexto(const std::string& ruta_binaria, const std::string& ruta_texto,
+                                std::string& error);
+
+#endif // TRAYECTORIA_H
@@ -0,0 +1,121 @@
+/**
+ * @file WisdomHolman.h
+ * @brief Integrador simpléctico de Wisdom-Holman en coordenadas de Jacobi
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#ifndef WISDOMHOLMAN_H
+#define WISDOMHOLMAN_H
+
+#include <vector>
+#include "SistemaCuerpos.h"
+
+class EstadoSerializado; // PuntoControl.h
+
+/**
+ * @brief Propaga analíticamente una órbita kepleriana con variables universales
+ * @param mu Parámetro gravitacional G·M del problema de dos cuerpos
+ * @param dt Tiempo a avanzar (puede ser negativo)
+ * @param x,y,z Posición relativa; al salir, la posición en t + dt
+ * @param vx,vy,vz Velocidad relativa; al salir, la velocidad en t + dt
+ * @return false si la ecuación de Kepler no convergió (el estado no cambia)
+ * @details Resuelve la ecuación de Kepler universal en la anomalía χ con las
+ *          funciones de Stumpff C(z), S(z), z = αχ², α = 2/r₀ - v₀²/μ, por
+ *          lo que sirve igual para órbitas elípticas, parabólicas e
+ *          hiperbólicas. La iteración es la de Laguerre-Conway, que converge
+ *          desde cualquier valor inicial. El estado final se obtiene con los
+ *          coeficientes de Lagrange f, g, ḟ, ġ.
+ */
+bool propagarKepler(double mu, double dt, double& x, double& y, double& z,
+                    double& vx, double& vy, double& vz);
+
+/**
+ * @brief Integrador de Wisdom-Holman (1991) para sistemas con una masa central dominante
+ * @details Separa el hamiltoniano en una parte kepleriana, que se integra
+ *          exactamente con propagarKepler(), y la interacción entre los
+ *          cuerpos que orbitan, que se aplica como impulsos:
+ *          impulso(dt/2) · Kepler(dt) · impulso(dt/2).
+ *
+ *          Usa coordenadas de Jacobi: el cuerpo central es el de mayor masa;
+ *          los demás se ordenan por distancia inicial a él, y cada uno se
+ *          mide respecto al centro de masa de los anteriores. El cuerpo k de
+ *          ese orden sigue una órbita de Kepler con μₖ = G·Mₖ, donde Mₖ es la
+ *          masa de los cuerpos 0..k. Su impulso es la aceleración inercial
+ *          llevada a Jacobi, menos el término kepleriano -G·Mₖ·qₖ/|qₖ|³ que
+ *          ya integra la deriva. Las aceleraciones inerciales las calcula el
+ *          motor de fuerzas seleccionado.
+ *
+ *          Con dos cuerpos la interacción es nula y la órbita es exacta
+ *          salvo redondeo. Con planetas, el error es del orden de
+ *          (m_planetas/m_central)·dt², no dt²: el paso puede ser una fracción
+ *          apreciable del periodo orbital más corto.
+ *
+ *          El estado de Jacobi es persistente y sincronizar() lo copia a las
+ *          coordenadas inerciales del sistema.
+ */
+class IntegradorWisdomHolman {
+public:
+    /// Constructor: sin cuerpos
+    IntegradorWisdomHolman() : fallos_kepler_(0) {}
+
+    /**
+     * @brief Elige el cuerpo central y el orden de Jacobi y convierte el estado
+     * @param cuerpos Sistema en coordenadas inerciales
+     * @return Cociente entre la masa de los demás cuerpos y la del central
+     *         (el método supone que es pequeño)
+     */
+    double iniciar(const SistemaCuerpos& cuerpos);
+
+    /**
+     * @brief Aplica el impulso de la interacción durante dt
+     * @param cuerpos Sistema con las aceleraciones inerciales en ax/ay/az,
+     *        evaluadas en las posiciones actuales
+     * @param dt Duración del impulso
+     */
+    void impulso(const SistemaCuerpos& cuerpos, double dt);
+
+    /**
+     * @brief Avanza cada coordenada de Jacobi por su órbita de Kepler y el centro de masa en línea recta
+     * @param dt Duración de la deriva
+     * @note Si la ecuación de Kepler no converge para un cuerpo (p. ej. en
+     *       una colisión), ese cuerpo no se mueve y se cuenta en fallosKepler()
+     */
+    void derivaKepler(double dt);
+
+    /**
+     * @brief Escribe posiciones y velocidades inerciales en el sistema
+     * @param cuerpos Sistema que se actualiza
+     */
+    void sincronizar(SistemaCuerpos& cuerpos) const;
+
+    /// Índice del cuerpo central
+    int central() const { return orden_.empty() ? -1 : orden_[0]; }
+
+    /// Derivas de Kepler que no convergieron desde iniciar()
+    long fallosKepler() const { return fallos_kepler_; }
+
+    /**
+     * @brief Añade el estado completo del integrador a un punto de control
+     * @param estado Estado serializado al que se añade
+     */
+    void guardarEstado(EstadoSerializado& estado) const;
+
+    /**
+     * @brief Recupera el estado escrito por guardarEstado()
+     * @param estado Estado serializado, en la posición de este integrador
+     * @param n Número de cuerpos esperado
+     * @return false si el estado está incompleto o no corresponde a n cuerpos
+     */
+    bool cargarEstado(EstadoSerializado& estado, int n);
+
+private:
+    std::vector<int> orden_;          ///< Índices de los cuerpos en el orden de Jacobi (central primero)
+    std::vector<double> masa_;        ///< Masa de cada cuerpo, en orden de Jacobi
+    std::vector<double> masa_acum_;   ///< Mₖ = masa de los cuerpos 0..k
+    VectorAlineado qx_, qy_, qz_;     ///< Posiciones de Jacobi (k = 0: centro de masa)
+    VectorAlineado ux_, uy_, uz_;     ///< Velocidades de Jacobi (k = 0: del centro de masa)
+    long fallos_kepler_;              ///< Derivas de Kepler sin convergencia
+};
+
+#endif // WISDOMHOLMAN_H
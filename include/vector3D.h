@@ -1,91 +1,119 @@
 /**
  * @file vector3D.h
- * @brief Definición de la clase vector3D para álgebra vectorial 3D
- * @author Isabel Nieto & Camilo Huertas  
+ * @brief Definición de la plantilla vector3DT para álgebra vectorial 3D
+ * @author Isabel Nieto & Camilo Huertas
  * @date 2025
  */
 
 #ifndef VECTOR3D_H
 #define VECTOR3D_H
 
+#include <cmath>
 #include <iostream>
 
 /**
- * @brief Clase para manipular vectores tridimensionales
+ * @brief Plantilla para manipular vectores tridimensionales
+ * @tparam T Tipo de las componentes (double o float)
  * @details Proporciona operaciones básicas de álgebra vectorial necesarias
- *          para simulaciones físicas en 3D
+ *          para simulaciones físicas en 3D. Todo está definido en este
+ *          encabezado para que el compilador pueda expandir en línea cadenas
+ *          como V * dt + a * (0.5 * dt * dt) y mantener las componentes en
+ *          registros, sin llamadas ni temporales en memoria.
  */
-class vector3D {
+template <typename T>
+class vector3DT {
 private:
-    double X, Y, Z; ///< Componentes cartesianas del vector
+    T X, Y, Z; ///< Componentes cartesianas del vector
 
 public:
-    vector3D();
-    vector3D(double x0, double y0, double z0);
+    typedef T escalar; ///< Tipo de las componentes
+
+    constexpr vector3DT() : X(0), Y(0), Z(0) {}
+    constexpr vector3DT(T x0, T y0, T z0) : X(x0), Y(y0), Z(z0) {}
+
+    /// Conversión explícita entre precisiones (p. ej. de float a double)
+    template <typename U>
+    constexpr explicit vector3DT(const vector3DT<U>& v)
+        : X(static_cast<T>(v.x())), Y(static_cast<T>(v.y())), Z(static_cast<T>(v.z())) {}
+
     /**
      * @brief Inicializa el vector con componentes específicas
      * @param x0 Componente X
-     * @param y0 Componente Y  
+     * @param y0 Componente Y
      * @param z0 Componente Z
      * @post El vector queda inicializado con (x0, y0, z0)
      */
-    void load(double x0, double y0, double z0);
+    void load(T x0, T y0, T z0) { X = x0; Y = y0; Z = z0; }
 
     /**
      * @brief Obtiene la componente X del vector
      * @return Componente X
-     */    
-    double x() const;
+     */
+    constexpr T x() const { return X; }
     /**
      * @brief Obtiene la componente Y del vector
      * @return Componente Y
-     */    
-    double y() const;
+     */
+    constexpr T y() const { return Y; }
     /**
      * @brief Obtiene la componente Z del vector
      * @return Componente Z
-     */    
-    double z() const;
-  
+     */
+    constexpr T z() const { return Z; }
+
     /// Muestra el vector por consola
-    void show() const;
+    void show() const { std::cout << "(" << X << ", " << Y << ", " << Z << ")"; }
 
     // --- Sobrecarga de Operadores ---
     // operator= se elimina para usar la versión generada por el compilador
 
     /// Sobrecarga de suma
-    vector3D operator+(const vector3D& v2) const;
-    void operator+=(const vector3D& v2);
+    constexpr vector3DT operator+(const vector3DT& v2) const { return vector3DT(X + v2.X, Y + v2.Y, Z + v2.Z); }
+    void operator+=(const vector3DT& v2) { X += v2.X; Y += v2.Y; Z += v2.Z; }
 
     /// Sobrecarga de resta
-    vector3D operator-(const vector3D& v2) const;
-    void operator-=(const vector3D& v2);
+    constexpr vector3DT operator-(const vector3DT& v2) const { return vector3DT(X - v2.X, Y - v2.Y, Z - v2.Z); }
+    void operator-=(const vector3DT& v2) { X -= v2.X; Y -= v2.Y; Z -= v2.Z; }
 
     /// Producto por escalar
-    vector3D operator*(double a) const;
-    void operator*=(double a);
-    
+    constexpr vector3DT operator*(T a) const { return vector3DT(X * a, Y * a, Z * a); }
+    void operator*=(T a) { X *= a; Y *= a; Z *= a; }
+
+    /// Producto por escalar a la izquierda (a * v)
+    friend constexpr vector3DT operator*(T a, const vector3DT& v1) { return v1 * a; }
+
     /// División por escalar
-    vector3D operator/(double a) const;
-    void operator/=(double a);
+    constexpr vector3DT operator/(T a) const { return vector3DT(X / a, Y / a, Z / a); }
+    void operator/=(T a) { X /= a; Y /= a; Z /= a; }
 
     /// Producto punto
-    double operator*(const vector3D& v2) const;
+    constexpr T operator*(const vector3DT& v2) const { return X * v2.X + Y * v2.Y + Z * v2.Z; }
 
     /// Producto cruz
-    vector3D operator^(const vector3D& v2) const;
+    constexpr vector3DT operator^(const vector3DT& v2) const {
+        return vector3DT(Y * v2.Z - Z * v2.Y,
+                         Z * v2.X - X * v2.Z,
+                         X * v2.Y - Y * v2.X);
+    }
 
     // --- Métodos de Cálculo ---
     /// Norma al cuadrado
-    double norm2() const;
+    constexpr T norm2() const { return X * X + Y * Y + Z * Z; }
     /// Norma (módulo)
-    double norm() const;
+    T norm() const { return std::sqrt(norm2()); }
 };
 
-// --- Funciones Amigas (friend) ahora definidas como funciones libres ---
-// No necesitan ser 'friend' si solo usan la interfaz pública (x(), y(), z())
-vector3D operator*(double a, const vector3D& v1);
-double angle(const vector3D& v1, const vector3D& v2);
+/// Ángulo entre dos vectores [rad]; 0 si alguno es nulo
+template <typename T>
+inline T angle(const vector3DT<T>& v1, const vector3DT<T>& v2) {
+    T norm_product = v1.norm() * v2.norm();
+    // Evitar división por cero si uno de los vectores es nulo
+    if (norm_product == 0) return 0;
+    return std::acos((v1 * v2) / norm_product);
+}
+
+typedef vector3DT<double> vector3D; ///< Vector de doble precisión (el de toda la simulación)
+typedef vector3DT<float> vector3Df; ///< Vector de precisión simple
 
 
 #endif // VECTOR3D_H
@@ -13,8 +13,8 @@ print sprintf("Archivo de datos: %s", FILENAME)
 stats FILENAME using 1 nooutput
 
 # --- Calcular N automáticamente ---
-TOTAL_COLS = int(system(sprintf("head -n 1 %s | wc -w", FILENAME)))
-N_BODIES = (TOTAL_COLS - 4) / 4
+# Una columna x<i> por cuerpo escrito (puede ser solo un rango de cuerpos)
+N_BODIES = int(system(sprintf("head -n 1 %s | tr '\\t' '\\n' | grep -c '^x[0-9][0-9]*$'", FILENAME)))
 
 print sprintf("Cuerpos detectados N=%d", N_BODIES)
 
@@ -2,6 +2,7 @@ import numpy as np
 import matplotlib.pyplot as plt
 import matplotlib.animation as animation
 import os
+import re
 
 # --- Constantes y Configuración ---
 Z_THRESHOLD = 1e-6  # Umbral para considerar el movimiento como 2D
@@ -48,8 +49,10 @@ def get_num_bodies_from_header(filepath):
     try:
         with open(filepath, 'r') as f:
             header = f.readline()
-            num_cols = len(header.lstrip('#').split())
-            num_bodies = (num_cols - 4) // 4
+            columns = header.lstrip('#').split()
+            # Una columna x<i> por cuerpo escrito (la salida puede incluir solo
+            # un rango de cuerpos y otros campos además de x, y, z, |v|, K, U, E)
+            num_bodies = sum(1 for c in columns if re.fullmatch(r'x\d+', c))
             return num_bodies
     except Exception as e:
         print(f"Error al leer la cabecera del archivo para determinar N: {e}")
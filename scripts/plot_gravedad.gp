@@ -22,8 +22,8 @@ print sprintf("Directorio de resultados: %s", RESULTS_DIR)
 
 # --- Paso 2: Calcular N automáticamente ---
 # Contamos las columnas en la cabecera para deducir N
-TOTAL_COLS = int(system(sprintf("head -n 1 %s | wc -w", FILENAME)))
-N_BODIES = (TOTAL_COLS - 4) / 4
+# Una columna x<i> por cuerpo escrito (puede ser solo un rango de cuerpos)
+N_BODIES = int(system(sprintf("head -n 1 %s | tr '\\t' '\\n' | grep -c '^x[0-9][0-9]*$'", FILENAME)))
 
 if (N_BODIES <= 0) {
     print sprintf("ERROR: Número de cuerpos calculado no válido: N=%d", N_BODIES)
@@ -127,19 +127,25 @@ if (Z_RANGE < Z_THRESHOLD) {
 
 print sprintf("Gráfica de trayectorias guardada en: %strayectorias_gnuplot_%s_%d.png", RESULTS_DIR, (Z_RANGE < Z_THRESHOLD ? "2D" : "3D"), N_BODIES)
 
-# --- Paso 5: Graficar Energías (siempre se genera) ---
+# --- Paso 5: Graficar Energías (si el archivo las incluye) ---
 set output sprintf("%senergias_gnuplot_%d.png", RESULTS_DIR, N_BODIES)
 set title sprintf("Energías del Sistema (N=%d Cuerpos)", N_BODIES)
 set xlabel "Tiempo"; set ylabel "Energía"
 set key top right
 
-COL_K = 4*N_BODIES + 2
-COL_U = 4*N_BODIES + 3
-COL_E = 4*N_BODIES + 4
+# Columnas de energía localizadas por nombre en la cabecera
+columna(nombre) = int(system(sprintf("awk -F'\\t' -v n=%s 'NR==1{for(i=1;i<=NF;i++) if($i==n) c=i; print c+0; exit}' %s", nombre, FILENAME)))
+COL_K = columna("K_total")
+COL_U = columna("U_total")
+COL_E = columna("E_total")
 
-plot FILENAME using 1:COL_K with lines title "Energía Cinética Total" lw 2 lc rgb "red", \
-     FILENAME using 1:COL_U with lines title "Energía Potencial Total" lw 2 lc rgb "blue", \
-     FILENAME using 1:COL_E with lines title "Energía Total del Sistema" lw 2 lc rgb "green"
+if (COL_K > 0 && COL_U > 0 && COL_E > 0) {
+    plot FILENAME using 1:COL_K with lines title "Energía Cinética Total" lw 2 lc rgb "red", \
+         FILENAME using 1:COL_U with lines title "Energía Potencial Total" lw 2 lc rgb "blue", \
+         FILENAME using 1:COL_E with lines title "Energía Total del Sistema" lw 2 lc rgb "green"
+} else {
+    print "No se encontraron columnas de energía en el archivo de datos."
+}
 
 print sprintf("Gráfica de energías guardada en: %senergias_gnuplot_%d.png", RESULTS_DIR, N_BODIES)
 print "Proceso de graficación completado."
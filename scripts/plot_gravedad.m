@@ -79,7 +79,8 @@ try
     
     columns = strsplit(strtrim(header_line(2:end))); 
     TOTAL_COLS = numel(columns);
-    N_BODIES = (TOTAL_COLS - 4) / 4;
+    % Una columna x<i> por cuerpo escrito (puede ser solo un rango de cuerpos)
+    N_BODIES = sum(~cellfun(@isempty, regexp(columns, '^x\d+$')));
     
     if (mod(N_BODIES, 1) ~= 0 || N_BODIES <= 0)
         error('El número de cuerpos calculado desde la cabecera no es un entero positivo.');
@@ -146,11 +147,11 @@ print(output_path_traj, '-dpng');
 disp(['Gráfica de trayectorias guardada en: ', output_path_traj]);
 
 % --- Paso 5: Graficar Energías ---
-col_k_idx = 1 + 4*N_BODIES + 1;
-col_u_idx = col_k_idx + 1;
-col_e_idx = col_k_idx + 2;
+col_k_idx = find(strcmp(columns, 'K_total'));
+col_u_idx = find(strcmp(columns, 'U_total'));
+col_e_idx = find(strcmp(columns, 'E_total'));
 
-if col_e_idx <= size(data, 2)
+if ~isempty(col_k_idx) && ~isempty(col_u_idx) && ~isempty(col_e_idx)
     figure('visible', 'off');
     hold on;
     plot(data(:,1), data(:,col_k_idx), 'r', 'LineWidth', 2, 'DisplayName', 'Energía Cinética Total');
@@ -1,6 +1,7 @@
 import numpy as np
 import matplotlib.pyplot as plt
 import os
+import re
 
 # --- Constantes y Configuración ---
 FILENAME = "results/sim_data.dat"
@@ -54,8 +55,10 @@ def get_num_bodies_from_header(filepath):
     try:
         with open(filepath, 'r') as f:
             header = f.readline()
-            num_cols = len(header.lstrip('#').split())
-            num_bodies = (num_cols - 4) // 4
+            columns = header.lstrip('#').split()
+            # Una columna x<i> por cuerpo escrito (la salida puede incluir solo
+            # un rango de cuerpos y otros campos además de x, y, z, |v|, K, U, E)
+            num_bodies = sum(1 for c in columns if re.fullmatch(r'x\d+', c))
             return num_bodies
     except Exception as e:
         print(f"Error al leer la cabecera del archivo para determinar N: {e}")
@@ -133,11 +136,12 @@ def plot_simulation_data():
     plt.close(fig)
 
     # --- Gráfica de Energías ---
-    col_k_idx = 1 + num_bodies * 4 
-    col_u_idx = col_k_idx + 1
-    col_e_idx = col_k_idx + 2
-    
-    if col_e_idx < data.shape[1]:
+    with open(data_file, 'r') as f:
+        columns = f.readline().lstrip('#').split()
+    energy_columns = ['K_total', 'U_total', 'E_total']
+
+    if all(c in columns for c in energy_columns):
+        col_k_idx, col_u_idx, col_e_idx = (columns.index(c) for c in energy_columns)
         fig_energy, ax_energy = plt.subplots(figsize=(8, 6))
         ax_energy.plot(time, data[:, col_k_idx], label='Energía Cinética Total', color='red', lw=2)
         ax_energy.plot(time, data[:, col_u_idx], label='Energía Potencial Total', color='blue', lw=2)
@@ -153,6 +157,8 @@ def plot_simulation_data():
         plt.savefig(output_path_energy)
         print(f"Gráfica de energías guardada en: {output_path_energy}")
         plt.close(fig_energy)
-    
+    else:
+        print("No se encontraron columnas de energía en el archivo de datos.")
+
 if __name__ == "__main__":
     plot_simulation_data()
@@ -0,0 +1,119 @@
+#include "BarnesHut.h"
+#include "utilidades.h" // Para G
+#include "FuerzasSIMD.h"
+#include <algorithm>
+#include <cmath>
+
+// Cuerpos máximos de un grupo que comparte recorrido del árbol
+static const int TAMANO_GRUPO = 64;
+
+BarnesHut::BarnesHut(double theta, int max_hoja) : arbol_(max_hoja), theta_(theta) {}
+
+void BarnesHut::calcularFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                                double* energia_potencial) {
+    arbol_.construir(cuerpos);
+    const std::vector<NodoOctree>& nodos = arbol_.nodos();
+    const std::vector<int>& indices = arbol_.indices();
+    double energia = 0.0;
+    if (cuerpos.tamano() > 0) {
+        // Los grupos son las celdas más altas con a lo sumo TAMANO_GRUPO cuerpos
+        pila_.clear();
+        pila_.push_back(0);
+        while (!pila_.empty()) {
+            const NodoOctree& nodo = nodos[pila_.back()];
+            pila_.pop_back();
+            if (nodo.esHoja() || nodo.cuenta <= TAMANO_GRUPO) {
+                energia += evaluarGrupo(&indices[nodo.inicio], nodo.cuenta, cuerpos, aceleraciones,
+                                        energia_potencial != 0);
+            } else {
+                for (int c = nodo.primer_hijo; c < nodo.primer_hijo + nodo.n_hijos; ++c) { pila_.push_back(c); }
+            }
+        }
+    }
+    if (energia_potencial) { *energia_potencial = energia; }
+}
+
+void BarnesHut::calcularFuerzasSobre(const SistemaCuerpos& cuerpos, const int* objetivos, int n_objetivos,
+                                     Aceleraciones& aceleraciones) {
+    arbol_.construir(cuerpos);
+    for (int k = 0; k < n_objetivos; ++k) {
+        evaluarGrupo(&objetivos[k], 1, cuerpos, aceleraciones, false);
+    }
+}
+
+void BarnesHut::construirLista(const double* minimo, const double* maximo, const SistemaCuerpos& cuerpos) {
+    const std::vector<NodoOctree>& nodos = arbol_.nodos();
+    const std::vector<int>& indices = arbol_.indices();
+    const double theta2 = theta_ * theta_;
+    lista_x_.clear(); lista_y_.clear(); lista_z_.clear(); lista_gm_.clear();
+
+    recorrido_.clear();
+    recorrido_.push_back(0);
+    while (!recorrido_.empty()) {
+        const NodoOctree& nodo = nodos[recorrido_.back()];
+        recorrido_.pop_back();
+
+        if (nodo.esHoja()) {
+            for (int b = nodo.inicio; b < nodo.inicio + nodo.cuenta; ++b) {
+                const int j = indices[b];
+                lista_x_.push_back(cuerpos.x[j]);
+                lista_y_.push_back(cuerpos.y[j]);
+                lista_z_.push_back(cuerpos.z[j]);
+                lista_gm_.push_back(G * cuerpos.m[j]);
+            }
+            continue;
+        }
+
+        // Distancia del centro de masa de la celda a la caja del grupo (la del cuerpo más cercano o menos)
+        const double centro_masa[3] = {nodo.centro_masa.x(), nodo.centro_masa.y(), nodo.centro_masa.z()};
+        const double centro[3] = {nodo.centro.x(), nodo.centro.y(), nodo.centro.z()};
+        double d2 = 0.0;
+        bool solapa = true;
+        for (int e = 0; e < 3; ++e) {
+            const double fuera = std::max(0.0, std::max(minimo[e] - centro_masa[e], centro_masa[e] - maximo[e]));
+            d2 += fuera * fuera;
+            // Una celda que se superpone con la caja del grupo siempre se abre
+            solapa = solapa && centro[e] - nodo.semilado <= maximo[e] && centro[e] + nodo.semilado >= minimo[e];
+        }
+        const double lado = 2.0 * nodo.semilado;
+        if (!solapa && lado * lado < theta2 * d2) {
+            lista_x_.push_back(nodo.centro_masa.x());
+            lista_y_.push_back(nodo.centro_masa.y());
+            lista_z_.push_back(nodo.centro_masa.z());
+            lista_gm_.push_back(G * nodo.masa);
+        } else {
+            for (int c = nodo.primer_hijo; c < nodo.primer_hijo + nodo.n_hijos; ++c) { recorrido_.push_back(c); }
+        }
+    }
+}
+
+double BarnesHut::evaluarGrupo(const int* grupo, int n_grupo, const SistemaCuerpos& cuerpos,
+                               Aceleraciones& aceleraciones, bool con_potencial) {
+    double minimo[3] = {cuerpos.x[grupo[0]], cuerpos.y[grupo[0]], cuerpos.z[grupo[0]]};
+    double maximo[3] = {minimo[0], minimo[1], minimo[2]};
+    for (int k = 1; k < n_grupo; ++k) {
+        const int i = grupo[k];
+        minimo[0] = std::min(minimo[0], cuerpos.x[i]); maximo[0] = std::max(maximo[0], cuerpos.x[i]);
+        minimo[1] = std::min(minimo[1], cuerpos.y[i]); maximo[1] = std::max(maximo[1], cuerpos.y[i]);
+        minimo[2] = std::min(minimo[2], cuerpos.z[i]); maximo[2] = std::max(maximo[2], cuerpos.z[i]);
+    }
+    construirLista(minimo, maximo, cuerpos);
+
+    // Cada cuerpo del grupo contra la lista común: monopolos aceptados y cuerpos de
+    // las hojas abiertas (él mismo incluido, que acumularFuentes descarta por r² = 0)
+    const int n_lista = static_cast<int>(lista_gm_.size());
+    const NivelSIMD nivel = nivelSIMDActivo();
+    double energia = 0.0;
+    for (int k = 0; k < n_grupo; ++k) {
+        const int i = grupo[k];
+        double a[3] = {0.0, 0.0, 0.0};
+        double potencial = 0.0;
+        acumularFuentes(nivel, cuerpos.x[i], cuerpos.y[i], cuerpos.z[i], lista_x_.data(), lista_y_.data(),
+                        lista_z_.data(), lista_gm_.data(), n_lista, a, con_potencial ? &potencial : 0);
+        aceleraciones.x[i] = a[0];
+        aceleraciones.y[i] = a[1];
+        aceleraciones.z[i] = a[2];
+        energia += 0.5 * cuerpos.m[i] * potencial;
+    }
+    return energia;
+}
@@ -0,0 +1,246 @@
+#include "BarridoParametros.h"
+#include "Fuerzas.h"
+#include "GrupoTareas.h"
+#include "SistemaCuerpos.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+bool interpretarDimensionBarrido(const std::string& texto, DimensionBarrido& dimension, std::string& error) {
+    std::istringstream entrada(texto);
+    std::string nombre;
+    if (!(entrada >> nombre)) {
+        error = "dimensión de barrido vacía";
+        return false;
+    }
+    dimension.valores.clear();
+    dimension.cuerpo = -1;
+    if (nombre == "dt") {
+        dimension.parametro = BARRIDO_DT;
+    } else if (nombre == "masa" || nombre == "velocidad") {
+        dimension.parametro = nombre == "masa" ? BARRIDO_MASA : BARRIDO_VELOCIDAD;
+        int cuerpo;
+        if (!(entrada >> cuerpo) || cuerpo < 0 || (cuerpo == 0 && dimension.parametro == BARRIDO_MASA)) {
+            error = "'" + nombre + "' espera el número del cuerpo (desde 1" +
+                    (dimension.parametro == BARRIDO_VELOCIDAD ? std::string("; 0 = todos") : std::string()) +
+                    ") y sus valores";
+            return false;
+        }
+        dimension.cuerpo = cuerpo - 1;
+    } else {
+        error = "parámetro de barrido desconocido '" + nombre + "' (dt, masa o velocidad)";
+        return false;
+    }
+    std::string palabra;
+    while (entrada >> palabra) {
+        char* fin = 0;
+        const double valor = std::strtod(palabra.c_str(), &fin);
+        if (fin == palabra.c_str() || *fin != '\0' || !std::isfinite(valor)) {
+            error = "valor inválido '" + palabra + "' en la dimensión " + nombre;
+            return false;
+        }
+        if (dimension.parametro != BARRIDO_VELOCIDAD && valor <= 0) {
+            error = "los valores de " + nombre + " deben ser positivos";
+            return false;
+        }
+        dimension.valores.push_back(valor);
+    }
+    if (dimension.valores.empty()) {
+        error = "la dimensión " + nombre + " no tiene valores";
+        return false;
+    }
+    return true;
+}
+
+std::string nombreDimensionBarrido(const DimensionBarrido& dimension) {
+    switch (dimension.parametro) {
+        case BARRIDO_DT: return "dt";
+        case BARRIDO_MASA: return "masa_" + std::to_string(dimension.cuerpo + 1);
+        case BARRIDO_VELOCIDAD:
+            return dimension.cuerpo < 0 ? std::string("velocidad_todos") : "velocidad_" + std::to_string(dimension.cuerpo + 1);
+    }
+    return "?";
+}
+
+BarridoParametros::BarridoParametros()
+    : dt_(0.0), t_max_(0.0), hilos_(0), segundos_totales_(0.0), eficiencia_(0.0), robos_(0) {}
+
+bool BarridoParametros::configurar(const std::vector<Cuerpo>& cuerpos, double dt, double t_max,
+                                   const std::vector<DimensionBarrido>& dimensiones, std::string& error) {
+    if (dimensiones.empty()) {
+        error = "el barrido no tiene dimensiones";
+        return false;
+    }
+    long total = 1;
+    for (size_t d = 0; d < dimensiones.size(); ++d) {
+        if (dimensiones[d].cuerpo >= static_cast<int>(cuerpos.size())) {
+            error = "la dimensión " + nombreDimensionBarrido(dimensiones[d]) + " se refiere a un cuerpo que no existe";
+            return false;
+        }
+        total *= static_cast<long>(dimensiones[d].valores.size());
+        if (total > 1000000) {
+            error = "el barrido tiene demasiados trabajos (más de un millón)";
+            return false;
+        }
+    }
+    cuerpos_ = cuerpos;
+    dt_ = dt;
+    t_max_ = t_max;
+    dimensiones_ = dimensiones;
+    resultados_.assign(total, ResultadoTrabajo());
+    archivos_.assign(total, std::string());
+    return true;
+}
+
+double BarridoParametros::valor(int k, int d) const {
+    // Base mixta: se descuentan las dimensiones posteriores, que varían más rápido
+    for (size_t e = dimensiones_.size() - 1; static_cast<int>(e) > d; --e) {
+        k /= static_cast<int>(dimensiones_[e].valores.size());
+    }
+    return dimensiones_[d].valores[k % dimensiones_[d].valores.size()];
+}
+
+double BarridoParametros::dtTrabajo(int k) const {
+    double dt = dt_;
+    for (size_t d = 0; d < dimensiones_.size(); ++d) {
+        if (dimensiones_[d].parametro == BARRIDO_DT) dt = valor(k, static_cast<int>(d));
+    }
+    return dt;
+}
+
+int BarridoParametros::ejecutar(const std::string& directorio, FormatoTrayectoria formato, int cada_pasos, int hilos) {
+    const int n = trabajos();
+    const char* extension = formato == TRAYECTORIA_BINARIA ? ".bin" : ".dat";
+    std::vector<double> costos(n);
+    for (int k = 0; k < n; ++k) {
+        char nombre[32];
+        std::snprintf(nombre, sizeof(nombre), "/trabajo_%04d", k);
+        archivos_[k] = directorio + nombre + extension;
+        costos[k] = t_max_ / dtTrabajo(k); // Pasos: todos los trabajos tienen los mismos N cuerpos
+    }
+
+    GrupoTareas grupo(hilos);
+    grupo.ejecutar(costos, [this, formato, cada_pasos](int k, int h) {
+        resultados_[k] = ejecutarTrabajo(k, formato, cada_pasos);
+        resultados_[k].hilo = h;
+    });
+    hilos_ = grupo.tamano();
+    segundos_totales_ = grupo.segundosTotales();
+    eficiencia_ = grupo.eficiencia();
+    robos_ = grupo.robos();
+
+    int fallidos = 0;
+    for (int k = 0; k < n; ++k) {
+        if (!resultados_[k].escrito) fallidos++;
+    }
+    return fallidos;
+}
+
+ResultadoTrabajo BarridoParametros::ejecutarTrabajo(int k, FormatoTrayectoria formato, int cada_pasos) const {
+    typedef std::chrono::steady_clock reloj;
+    const reloj::time_point inicio = reloj::now();
+
+    std::vector<Cuerpo> cuerpos = cuerpos_;
+    for (size_t d = 0; d < dimensiones_.size(); ++d) {
+        const DimensionBarrido& dimension = dimensiones_[d];
+        const double v = valor(k, static_cast<int>(d));
+        if (dimension.parametro == BARRIDO_MASA) {
+            cuerpos[dimension.cuerpo].m = v;
+        } else if (dimension.parametro == BARRIDO_VELOCIDAD) {
+            for (size_t i = 0; i < cuerpos.size(); ++i) {
+                if (dimension.cuerpo < 0 || dimension.cuerpo == static_cast<int>(i)) cuerpos[i].V = cuerpos[i].V * v;
+            }
+        }
+    }
+    const double dt = dtTrabajo(k);
+    const int n = static_cast<int>(cuerpos.size());
+
+    // Estado propio del trabajo: nada se comparte con los demás hilos
+    SistemaCuerpos sistema;
+    sistema.cargarDesde(cuerpos);
+    Aceleraciones a_siguiente;
+    a_siguiente.redimensionar(n);
+    double U = calcularFuerzasYEnergiaPotencial(sistema, a_siguiente);
+    sistema.intercambiarAceleraciones(a_siguiente);
+    double K = calcularEnergiaCineticaTotal(sistema);
+
+    ResultadoTrabajo resultado;
+    resultado.energia_inicial = K + U;
+    resultado.hilo = -1;
+    EscritorTrayectoria escritor;
+    resultado.escrito = escritor.abrir(archivos_[k], formato, n, dt, seleccionCompleta(n));
+    if (resultado.escrito) escritor.escribirCuadro(0.0, sistema, K, U, K + U);
+
+    // Mismo final que el bucle de la simulación principal: un paso por cada t <= t_max
+    double t = 0.0;
+    long pasos = 0;
+    while (t <= t_max_) {
+        t += dt;
+        pasos++;
+        const bool ultimo = !(t <= t_max_);
+        // La energía solo se calcula en los pasos que se escriben y en el último
+        const bool escribir = resultado.escrito && (pasos % cada_pasos == 0 || ultimo);
+        const bool con_energia = escribir || ultimo;
+        sistema.Muevase_r(dt);
+        if (con_energia) {
+            U = calcularFuerzasYEnergiaPotencial(sistema, a_siguiente);
+        } else {
+            calcularTodasLasFuerzas(sistema, a_siguiente);
+        }
+        sistema.Muevase_V(dt, a_siguiente);
+        sistema.intercambiarAceleraciones(a_siguiente);
+        if (con_energia) {
+            K = calcularEnergiaCineticaTotal(sistema);
+            if (escribir) escritor.escribirCuadro(t, sistema, K, U, K + U);
+        }
+    }
+    if (resultado.escrito) escritor.cerrar();
+
+    resultado.pasos = pasos;
+    resultado.energia_final = pasos > 0 ? K + U : resultado.energia_inicial;
+    resultado.error_energia = resultado.energia_inicial != 0.0
+        ? std::fabs((resultado.energia_final - resultado.energia_inicial) / resultado.energia_inicial)
+        : std::fabs(resultado.energia_final);
+    resultado.segundos = std::chrono::duration<double>(reloj::now() - inicio).count();
+    return resultado;
+}
+
+bool BarridoParametros::guardarResumen(const std::string& ruta) const {
+    std::ofstream archivo(ruta.c_str());
+    if (!archivo.is_open()) return false;
+    archivo << "# Trabajo";
+    for (size_t d = 0; d < dimensiones_.size(); ++d) { archivo << "\t" << nombreDimensionBarrido(dimensiones_[d]); }
+    archivo << "\tPasos\tError_E\tSegundos\tHilo\tArchivo" << std::endl;
+    archivo << std::scientific << std::setprecision(12);
+    for (int k = 0; k < trabajos(); ++k) {
+        const ResultadoTrabajo& r = resultados_[k];
+        archivo << k;
+        for (size_t d = 0; d < dimensiones_.size(); ++d) { archivo << "\t" << valor(k, static_cast<int>(d)); }
+        archivo << "\t" << r.pasos << "\t" << r.error_energia << "\t" << std::setprecision(4) << r.segundos
+                << std::setprecision(12) << "\t" << r.hilo << "\t" << (r.escrito ? archivos_[k] : std::string("-"))
+                << "\n";
+    }
+    return archivo.good();
+}
+
+void BarridoParametros::imprimirReparto(std::ostream& salida) const {
+    double suma = 0.0;
+    double mayor = 0.0;
+    for (int k = 0; k < trabajos(); ++k) {
+        suma += resultados_[k].segundos;
+        if (resultados_[k].segundos > mayor) mayor = resultados_[k].segundos;
+    }
+    const std::ios::fmtflags formato = salida.flags();
+    const std::streamsize precision = salida.precision();
+    salida << std::defaultfloat << std::setprecision(4)
+           << "Barrido: " << trabajos() << " trabajos en " << hilos_ << " hilos, " << segundos_totales_
+           << " s (suma de trabajos " << suma << " s, el más largo " << mayor << " s)" << std::endl;
+    salida << "Ocupación de los hilos: " << std::fixed << std::setprecision(1) << 100.0 * eficiencia_
+           << "%; trabajos robados: " << robos_ << std::endl;
+    salida.flags(formato);
+    salida.precision(precision);
+}
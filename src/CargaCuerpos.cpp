@@ -0,0 +1,412 @@
+#include "CargaCuerpos.h"
+#include "GrupoHilos.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Tamaño mínimo del bloque de cada hilo; los archivos pequeños se leen con un solo hilo
+static const size_t BLOQUE_MINIMO_CARGA = 1u << 20;
+
+// Bytes de la parte fija de la cabecera binaria
+static const size_t CABECERA_FIJA_CUERPOS = 24;
+
+// Columnas por cuerpo: m, R, x, y, z, vx, vy, vz
+static const int COLUMNAS_CUERPO = 8;
+
+// Potencias exactas de 10 en double (10^22 es la mayor representable sin redondeo)
+static const double POTENCIAS_EXACTAS_10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief Archivo proyectado en memoria de solo lectura
+ * @details Se desproyecta al salir de alcance
+ */
+class ProyeccionArchivo {
+public:
+    ProyeccionArchivo() : datos_(0), tam_(0) {}
+    ~ProyeccionArchivo() { if (datos_) munmap(const_cast<char*>(datos_), tam_); }
+
+    bool abrir(const std::string& ruta, std::string& error) {
+        int fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "no se pudo abrir " + ruta;
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            error = ruta + " está vacío o no se puede leer";
+            return false;
+        }
+        tam_ = static_cast<size_t>(info.st_size);
+        void* p = mmap(0, tam_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // La proyección sigue siendo válida sin el descriptor
+        if (p == MAP_FAILED) {
+            tam_ = 0;
+            error = "no se pudo proyectar en memoria " + ruta;
+            return false;
+        }
+        datos_ = static_cast<const char*>(p);
+        return true;
+    }
+
+    const char* datos() const { return datos_; }
+    size_t tamano() const { return tam_; }
+
+private:
+    ProyeccionArchivo(const ProyeccionArchivo&);            // No copiable
+    ProyeccionArchivo& operator=(const ProyeccionArchivo&); // No asignable
+
+    const char* datos_;
+    size_t tam_;
+};
+
+/// Primer error encontrado por un hilo (linea = LONG_MAX si no hubo)
+struct ErrorCarga {
+    long linea;
+    std::string mensaje;
+};
+
+static bool esSeparador(char c) { return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r'; }
+
+static const char* saltarEspacios(const char* p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+static const char* finDeLinea(const char* p, const char* fin) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', fin - p));
+    return nl ? nl : fin;
+}
+
+/**
+ * @brief Lee un número real en [p, fin) y avanza p hasta el final del número
+ * @details Camino rápido exacto (Clinger) cuando la mantisa cabe en 53 bits y
+ *          el exponente en ±22: un solo producto o cociente por una potencia
+ *          exacta de 10 da el resultado correctamente redondeado. Los demás
+ *          casos se delegan en strtod sobre una copia terminada en nulo,
+ *          porque el archivo proyectado no lo está.
+ */
+static bool leerNumero(const char*& p, const char* fin, double& valor) {
+    const char* inicio = p;
+    const char* q = p;
+    bool negativo = false;
+    if (q < fin && (*q == '+' || *q == '-')) { negativo = (*q == '-'); ++q; }
+    std::uint64_t mantisa = 0;
+    int digitos = 0, exponente = 0;
+    bool hay_digitos = false, desborde = false;
+    for (; q < fin && *q >= '0' && *q <= '9'; ++q) {
+        hay_digitos = true;
+        if (mantisa == 0 && *q == '0') continue;
+        if (digitos < 19) { mantisa = mantisa * 10 + (*q - '0'); digitos++; }
+        else { exponente++; desborde = true; }
+    }
+    if (q < fin && *q == '.') {
+        for (++q; q < fin && *q >= '0' && *q <= '9'; ++q) {
+            hay_digitos = true;
+            if (mantisa == 0 && *q == '0') { exponente--; continue; }
+            if (digitos < 19) { mantisa = mantisa * 10 + (*q - '0'); digitos++; exponente--; }
+            else desborde = true;
+        }
+    }
+    if (hay_digitos && q < fin && (*q == 'e' || *q == 'E')) {
+        const char* e = q + 1;
+        bool exp_negativo = false;
+        if (e < fin && (*e == '+' || *e == '-')) { exp_negativo = (*e == '-'); ++e; }
+        if (e < fin && *e >= '0' && *e <= '9') {
+            int exp_escrito = 0;
+            for (; e < fin && *e >= '0' && *e <= '9'; ++e) {
+                if (exp_escrito < 100000) exp_escrito = exp_escrito * 10 + (*e - '0');
+            }
+            exponente += exp_negativo ? -exp_escrito : exp_escrito;
+            q = e;
+        }
+    }
+    if (hay_digitos && (q == fin || esSeparador(*q) || *q == '\n' || *q == '#') &&
+        !desborde && mantisa <= (std::uint64_t(1) << 53) && exponente >= -22 && exponente <= 22) {
+        double v = static_cast<double>(mantisa);
+        v = (exponente < 0) ? v / POTENCIAS_EXACTAS_10[-exponente] : v * POTENCIAS_EXACTAS_10[exponente];
+        valor = negativo ? -v : v;
+        p = q;
+        return true;
+    }
+
+    // Camino general: el texto hasta el siguiente separador
+    const char* fin_token = inicio;
+    while (fin_token < fin && !esSeparador(*fin_token) && *fin_token != '\n' && *fin_token != '#') ++fin_token;
+    char copia[64];
+    size_t longitud = static_cast<size_t>(fin_token - inicio);
+    if (longitud == 0 || longitud >= sizeof(copia)) return false;
+    std::memcpy(copia, inicio, longitud);
+    copia[longitud] = '\0';
+    char* fin_lectura = 0;
+    valor = std::strtod(copia, &fin_lectura);
+    if (fin_lectura != copia + longitud) return false;
+    p = fin_token;
+    return true;
+}
+
+/// true si la línea [p, fin) contiene datos (no está vacía ni es un comentario)
+static bool esLineaDeDatos(const char* p, const char* fin) {
+    p = saltarEspacios(p, fin);
+    return p < fin && *p != '#';
+}
+
+/// true si la línea de datos empieza como un número (si no, es un encabezado)
+static bool empiezaComoNumero(const char* p, const char* fin) {
+    p = saltarEspacios(p, fin);
+    return p < fin && ((*p >= '0' && *p <= '9') || *p == '+' || *p == '-' || *p == '.');
+}
+
+/**
+ * @brief Lee un cuerpo de una línea CSV y lo escribe en la posición i
+ * @return Mensaje de error vacío si la línea es válida
+ */
+static std::string leerLineaCuerpo(const char* p, const char* fin, SistemaCuerpos& s, int i) {
+    static const char* const NOMBRES[COLUMNAS_CUERPO] = {"masa", "radio", "x", "y", "z", "vx", "vy", "vz"};
+    double v[COLUMNAS_CUERPO];
+    for (int k = 0; k < COLUMNAS_CUERPO; ++k) {
+        while (p < fin && esSeparador(*p)) ++p;
+        if (!leerNumero(p, fin, v[k]) || !std::isfinite(v[k])) {
+            return std::string("valor no válido para ") + NOMBRES[k] + " (se esperan 'masa, radio, x, y, z, vx, vy, vz')";
+        }
+    }
+    while (p < fin && esSeparador(*p)) ++p;
+    if (p < fin && *p != '#') return "sobran datos después de vz";
+    if (v[0] <= 0) return "la masa debe ser un número real positivo";
+    if (v[1] < 0) return "el radio debe ser un número real no negativo";
+    s.m[i] = v[0];
+    s.inv_m[i] = 1.0 / v[0];
+    s.R[i] = v[1];
+    s.x[i] = v[2]; s.y[i] = v[3]; s.z[i] = v[4];
+    s.vx[i] = v[5]; s.vy[i] = v[6]; s.vz[i] = v[7];
+    return "";
+}
+
+/// Devuelve el error de menor número de línea (o de cuerpo), o false si ningún hilo falló
+static bool primerError(const std::vector<ErrorCarga>& errores, const std::string& prefijo, std::string& error) {
+    const ErrorCarga* primero = 0;
+    for (size_t h = 0; h < errores.size(); ++h) {
+        if (errores[h].linea != LONG_MAX && (!primero || errores[h].linea < primero->linea)) primero = &errores[h];
+    }
+    if (!primero) return false;
+    std::ostringstream mensaje;
+    mensaje << prefijo << primero->linea << ": " << primero->mensaje;
+    error = mensaje.str();
+    return true;
+}
+
+static bool cargarCSV(const ProyeccionArchivo& archivo, const std::string& ruta, SistemaCuerpos& cuerpos,
+                      GrupoHilos& grupo, std::string& error) {
+    const char* datos = archivo.datos();
+    const char* fin = datos + archivo.tamano();
+    const int hilos = grupo.tamano();
+
+    // Bloques contiguos que empiezan al inicio de una línea
+    std::vector<const char*> limites(hilos + 1, fin);
+    limites[0] = datos;
+    for (int h = 1; h < hilos; ++h) {
+        const char* corte = std::max(limites[h - 1], datos + archivo.tamano() * h / hilos);
+        const char* nl = (corte > datos && corte[-1] == '\n') ? corte - 1 : finDeLinea(corte, fin);
+        limites[h] = (nl < fin) ? nl + 1 : fin;
+    }
+
+    // Primera pasada: líneas y cuerpos de cada bloque
+    std::vector<long> lineas(hilos, 0), cuerpos_bloque(hilos, 0);
+    std::vector<char> primera_no_numerica(hilos, 0);
+    grupo.ejecutar([&](int h) {
+        long n_lineas = 0, n_cuerpos = 0;
+        for (const char* p = limites[h]; p < limites[h + 1];) {
+            const char* fl = finDeLinea(p, limites[h + 1]);
+            if (esLineaDeDatos(p, fl)) {
+                if (n_cuerpos == 0) primera_no_numerica[h] = !empiezaComoNumero(p, fl);
+                n_cuerpos++;
+            }
+            n_lineas++;
+            p = (fl < limites[h + 1]) ? fl + 1 : fl;
+        }
+        lineas[h] = n_lineas;
+        cuerpos_bloque[h] = n_cuerpos;
+    });
+
+    // La primera línea de datos del archivo puede ser un encabezado
+    int bloque_encabezado = -1;
+    for (int h = 0; h < hilos; ++h) {
+        if (cuerpos_bloque[h] == 0) continue;
+        if (primera_no_numerica[h]) { bloque_encabezado = h; cuerpos_bloque[h]--; }
+        break;
+    }
+
+    std::vector<long> primer_cuerpo(hilos + 1, 0), primera_linea(hilos + 1, 1);
+    for (int h = 0; h < hilos; ++h) {
+        primer_cuerpo[h + 1] = primer_cuerpo[h] + cuerpos_bloque[h];
+        primera_linea[h + 1] = primera_linea[h] + lineas[h];
+    }
+    if (primer_cuerpo[hilos] == 0) {
+        error = ruta + ": no contiene cuerpos";
+        return false;
+    }
+    if (primer_cuerpo[hilos] > INT_MAX) {
+        error = ruta + ": demasiados cuerpos";
+        return false;
+    }
+    cuerpos.redimensionar(static_cast<int>(primer_cuerpo[hilos]));
+
+    // Segunda pasada: cada hilo escribe sus cuerpos a partir de su índice
+    std::vector<ErrorCarga> errores(hilos);
+    grupo.ejecutar([&](int h) {
+        errores[h].linea = LONG_MAX;
+        int i = static_cast<int>(primer_cuerpo[h]);
+        long linea = primera_linea[h];
+        bool saltar_encabezado = (h == bloque_encabezado);
+        for (const char* p = limites[h]; p < limites[h + 1]; ++linea) {
+            const char* fl = finDeLinea(p, limites[h + 1]);
+            if (esLineaDeDatos(p, fl)) {
+                if (saltar_encabezado) {
+                    saltar_encabezado = false;
+                } else {
+                    std::string problema = leerLineaCuerpo(p, fl, cuerpos, i++);
+                    if (!problema.empty()) {
+                        errores[h].linea = linea;
+                        errores[h].mensaje = problema;
+                        return;
+                    }
+                }
+            }
+            p = (fl < limites[h + 1]) ? fl + 1 : fl;
+        }
+    });
+    return !primerError(errores, ruta + ":", error);
+}
+
+static bool cargarBinario(const ProyeccionArchivo& archivo, const std::string& ruta, SistemaCuerpos& cuerpos,
+                          GrupoHilos& grupo, std::string& error) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(archivo.datos());
+    std::uint32_t version = 0, tam_cabecera = 0;
+    std::uint64_t n = 0;
+    for (int k = 3; k >= 0; --k) { version = (version << 8) | b[8 + k]; tam_cabecera = (tam_cabecera << 8) | b[12 + k]; }
+    for (int k = 7; k >= 0; --k) { n = (n << 8) | b[16 + k]; }
+    if (version != VERSION_CUERPOS) {
+        std::ostringstream mensaje;
+        mensaje << ruta << ": versión " << version << " del formato binario no soportada";
+        error = mensaje.str();
+        return false;
+    }
+    if (tam_cabecera < CABECERA_FIJA_CUERPOS || n == 0 || n > static_cast<std::uint64_t>(INT_MAX) ||
+        archivo.tamano() < tam_cabecera + n * COLUMNAS_CUERPO * sizeof(double)) {
+        error = ruta + ": cabecera no válida o archivo truncado";
+        return false;
+    }
+    const int total = static_cast<int>(n);
+    cuerpos.redimensionar(total);
+    VectorAlineado* columnas[COLUMNAS_CUERPO] = {
+        &cuerpos.m, &cuerpos.R, &cuerpos.x, &cuerpos.y, &cuerpos.z, &cuerpos.vx, &cuerpos.vy, &cuerpos.vz
+    };
+    const std::uint16_t prueba = 1;
+    unsigned char primer_byte;
+    std::memcpy(&primer_byte, &prueba, 1);
+    const bool invertir = (primer_byte != 1); // Anfitrión big-endian
+
+    std::vector<ErrorCarga> errores(grupo.tamano());
+    grupo.ejecutar([&](int h) {
+        errores[h].linea = LONG_MAX;
+        const int desde = static_cast<int>(static_cast<long>(total) * h / grupo.tamano());
+        const int hasta = static_cast<int>(static_cast<long>(total) * (h + 1) / grupo.tamano());
+        if (desde == hasta) return;
+        for (int c = 0; c < COLUMNAS_CUERPO; ++c) {
+            double* destino = &(*columnas[c])[desde];
+            std::memcpy(destino, b + tam_cabecera + (static_cast<size_t>(c) * total + desde) * sizeof(double),
+                        static_cast<size_t>(hasta - desde) * sizeof(double));
+            if (invertir) {
+                for (int i = 0; i < hasta - desde; ++i) {
+                    unsigned char* d = reinterpret_cast<unsigned char*>(destino + i);
+                    for (int k = 0; k < 4; ++k) std::swap(d[k], d[7 - k]);
+                }
+            }
+        }
+        for (int i = desde; i < hasta; ++i) {
+            bool finitos = true;
+            for (int c = 2; c < COLUMNAS_CUERPO; ++c) finitos = finitos && std::isfinite((*columnas[c])[i]);
+            const char* problema = 0;
+            if (!(cuerpos.m[i] > 0) || !std::isfinite(cuerpos.m[i])) problema = "la masa debe ser un número real positivo";
+            else if (!(cuerpos.R[i] >= 0)) problema = "el radio debe ser un número real no negativo";
+            else if (!finitos) problema = "posición o velocidad no finita";
+            if (problema) {
+                errores[h].linea = i + 1;
+                errores[h].mensaje = problema;
+                return;
+            }
+            cuerpos.inv_m[i] = 1.0 / cuerpos.m[i];
+        }
+    });
+    return !primerError(errores, ruta + ": cuerpo ", error);
+}
+
+bool cargarCuerpos(const std::string& ruta, SistemaCuerpos& cuerpos, int hilos,
+                   EstadisticasCarga& estadisticas, std::string& error) {
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    ProyeccionArchivo archivo;
+    if (!archivo.abrir(ruta, error)) return false;
+
+    const bool binario = archivo.tamano() >= CABECERA_FIJA_CUERPOS &&
+                         std::memcmp(archivo.datos(), MAGIA_CUERPOS, 8) == 0;
+    if (hilos <= 0) hilos = GrupoHilos::hilosDisponibles();
+    hilos = static_cast<int>(std::max<size_t>(1, std::min<size_t>(hilos, archivo.tamano() / BLOQUE_MINIMO_CARGA)));
+    madvise(const_cast<char*>(archivo.datos()), archivo.tamano(), MADV_WILLNEED);
+    GrupoHilos grupo(hilos);
+
+    bool correcto = binario ? cargarBinario(archivo, ruta, cuerpos, grupo, error)
+                            : cargarCSV(archivo, ruta, cuerpos, grupo, error);
+    if (!correcto) return false;
+
+    estadisticas.cuerpos = cuerpos.tamano();
+    estadisticas.bytes = static_cast<long>(archivo.tamano());
+    estadisticas.hilos = hilos;
+    estadisticas.binario = binario;
+    estadisticas.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return true;
+}
+
+bool buscarPosicionesCoincidentes(const SistemaCuerpos& cuerpos, double distancia, int& i, int& j) {
+    const int n = cuerpos.tamano();
+    if (n < 2) return false;
+
+    // Se ordena por la coordenada de mayor extensión para que la ventana sea estrecha
+    const VectorAlineado* ejes[3] = {&cuerpos.x, &cuerpos.y, &cuerpos.z};
+    const VectorAlineado* eje = ejes[0];
+    double extension_max = -1.0;
+    for (int k = 0; k < 3; ++k) {
+        std::pair<VectorAlineado::const_iterator, VectorAlineado::const_iterator> mm =
+            std::minmax_element(ejes[k]->begin(), ejes[k]->end());
+        if (*mm.second - *mm.first > extension_max) { extension_max = *mm.second - *mm.first; eje = ejes[k]; }
+    }
+    const VectorAlineado& c = *eje;
+    std::vector<int> orden(n);
+    for (int k = 0; k < n; ++k) orden[k] = k;
+    std::sort(orden.begin(), orden.end(), [&c](int a, int b) { return c[a] < c[b]; });
+
+    const double distancia2 = distancia * distancia;
+    bool encontrado = false;
+    for (int a = 0; a < n; ++a) {
+        const int p = orden[a];
+        for (int b = a + 1; b < n && c[orden[b]] - c[p] < distancia; ++b) {
+            const int q = orden[b];
+            const double dx = cuerpos.x[p] - cuerpos.x[q], dy = cuerpos.y[p] - cuerpos.y[q], dz = cuerpos.z[p] - cuerpos.z[q];
+            if (dx * dx + dy * dy + dz * dz >= distancia2) continue;
+            const int menor = std::min(p, q), mayor = std::max(p, q);
+            if (!encontrado || menor < i || (menor == i && mayor < j)) { i = menor; j = mayor; encontrado = true; }
+        }
+    }
+    return encontrado;
+}
@@ -0,0 +1,543 @@
+#include "ConjuntoSistemas.h"
+#include "utilidades.h" // Para G
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NUCLEOS_X86 1
+#include <immintrin.h>
+#endif
+
+// Mismo umbral que filaEscalar: los pares con dist³ < 1e-18 no interactúan
+static const double UMBRAL_DIST3 = 1e-18;
+
+const char* nombreEstadoMiembro(EstadoMiembro estado) {
+    switch (estado) {
+        case MIEMBRO_ACTIVO: return "activo";
+        case MIEMBRO_COMPLETO: return "completo";
+        case MIEMBRO_COLISION: return "colision";
+        case MIEMBRO_ESCAPE: return "escape";
+        default: return "desconocido";
+    }
+}
+
+double ResultadoMiembro::errorEnergia() const {
+    if (energia_inicial == 0.0) return std::fabs(energia_final);
+    return std::fabs((energia_final - energia_inicial) / energia_inicial);
+}
+
+/**
+ * @brief Arreglos que recorre un paso del conjunto
+ * @details Los eventos se codifican por carril: 1 + a·N + b para la colisión
+ *          de los cuerpos a < b y -(1 + k) para el escape del cuerpo k
+ */
+struct CarrilesPaso {
+    int n, c;                   ///< Cuerpos y carriles reservados (separación entre cuerpos)
+    double *x, *y, *z, *vx, *vy, *vz, *ax, *ay, *az, *bx, *by, *bz;
+    const double *m, *R, *paso; ///< Masas, radios y dt por carril (0 = enmascarado)
+    double radio2;              ///< Radio de escape al cuadrado (infinito = sin límite)
+    int* evento;                ///< Evento por carril (solo se escribe si vale 0)
+};
+
+/// Paso de Verlet de los carriles [s0, s1); devuelve el número de eventos nuevos
+typedef int (*NucleoPasoConjunto)(const CarrilesPaso& d, int s0, int s1);
+
+// --- Núcleo escalar ---
+
+/// a(t) del carril s en (bx, by, bz), con el mismo orden de operaciones que filaEscalar
+static void aceleracionesCarril(const CarrilesPaso& d, int s, double* bx, double* by, double* bz) {
+    const int n = d.n, c = d.c;
+    for (int k = 0; k < n; ++k) { bx[k * c + s] = 0; by[k * c + s] = 0; bz[k * c + s] = 0; }
+    for (int i = 0; i < n; ++i) {
+        const int si = i * c + s;
+        double axi = 0, ayi = 0, azi = 0;
+        for (int j = i + 1; j < n; ++j) {
+            const int sj = j * c + s;
+            double dx = d.x[sj] - d.x[si], dy = d.y[sj] - d.y[si], dz = d.z[sj] - d.z[si];
+            double r2 = dx * dx + dy * dy + dz * dz;
+            double dist_cubed = r2 * std::sqrt(r2);
+            if (dist_cubed < UMBRAL_DIST3) { continue; }
+            double f = G / dist_cubed;
+            axi += dx * (f * d.m[sj]);
+            ayi += dy * (f * d.m[sj]);
+            azi += dz * (f * d.m[sj]);
+            bx[sj] -= dx * (f * d.m[si]);
+            by[sj] -= dy * (f * d.m[si]);
+            bz[sj] -= dz * (f * d.m[si]);
+        }
+        bx[si] += axi; by[si] += ayi; bz[si] += azi;
+    }
+}
+
+static int pasoConjuntoEscalar(const CarrilesPaso& d, int s0, int s1) {
+    const int n = d.n, c = d.c;
+    int eventos = 0;
+    for (int s = s0; s < s1; ++s) {
+        const double dt = d.paso[s];
+        if (dt == 0) continue;
+        // Muevase_r
+        const double medio_dt2 = 0.5 * dt * dt;
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            d.x[i] += d.vx[i] * dt + d.ax[i] * medio_dt2;
+            d.y[i] += d.vy[i] * dt + d.ay[i] * medio_dt2;
+            d.z[i] += d.vz[i] * dt + d.az[i] * medio_dt2;
+        }
+        // Contactos y escapes con las posiciones nuevas
+        for (int a = 0; a < n && d.evento[s] == 0; ++a) {
+            for (int b = a + 1; b < n; ++b) {
+                const int sa = a * c + s, sb = b * c + s;
+                double dx = d.x[sb] - d.x[sa], dy = d.y[sb] - d.y[sa], dz = d.z[sb] - d.z[sa];
+                double contacto = d.R[sa] + d.R[sb];
+                if (dx * dx + dy * dy + dz * dz < contacto * contacto) { d.evento[s] = 1 + a * n + b; break; }
+            }
+        }
+        for (int k = 0; k < n && d.evento[s] == 0; ++k) {
+            const int i = k * c + s;
+            if (d.x[i] * d.x[i] + d.y[i] * d.y[i] + d.z[i] * d.z[i] > d.radio2) { d.evento[s] = -(1 + k); }
+        }
+        if (d.evento[s] != 0) eventos++;
+        aceleracionesCarril(d, s, d.bx, d.by, d.bz);
+        // Muevase_V y a(t) <- a(t+dt)
+        const double medio_dt = 0.5 * dt;
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            d.vx[i] += (d.ax[i] + d.bx[i]) * medio_dt;
+            d.vy[i] += (d.ay[i] + d.by[i]) * medio_dt;
+            d.vz[i] += (d.az[i] + d.bz[i]) * medio_dt;
+            d.ax[i] = d.bx[i]; d.ay[i] = d.by[i]; d.az[i] = d.bz[i];
+        }
+    }
+    return eventos;
+}
+
+/// Anota los eventos de un grupo de carriles dados por una máscara de bits
+static int anotarEventos(int* evento, unsigned mascara, int codigo) {
+    int nuevos = 0;
+    for (int b = 0; mascara != 0; ++b, mascara >>= 1) {
+        if ((mascara & 1u) && evento[b] == 0) { evento[b] = codigo; nuevos++; }
+    }
+    return nuevos;
+}
+
+// --- Núcleos vectorizados: un registro = 4 u 8 sistemas ---
+// Sin FMA y con raíz y división exactas, para que cada carril dé el mismo
+// resultado que el núcleo escalar
+
+#ifdef NUCLEOS_X86
+
+__attribute__((target("avx2")))
+static int pasoConjuntoAVX2(const CarrilesPaso& d, int s0, int s1) {
+    const int n = d.n, c = d.c;
+    const __m256d cero = _mm256_setzero_pd(), medio = _mm256_set1_pd(0.5);
+    const __m256d g = _mm256_set1_pd(G), umbral = _mm256_set1_pd(UMBRAL_DIST3);
+    const __m256d radio2 = _mm256_set1_pd(d.radio2);
+    int eventos = 0;
+    for (int s = s0; s < s1; s += 4) {
+        const __m256d dt = _mm256_loadu_pd(d.paso + s);
+        const unsigned activos = static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(dt, cero, _CMP_NEQ_OQ)));
+        if (activos == 0) continue;
+        const __m256d medio_dt = _mm256_mul_pd(medio, dt);
+        const __m256d medio_dt2 = _mm256_mul_pd(medio_dt, dt);
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            _mm256_storeu_pd(d.x + i, _mm256_add_pd(_mm256_loadu_pd(d.x + i),
+                _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(d.vx + i), dt), _mm256_mul_pd(_mm256_loadu_pd(d.ax + i), medio_dt2))));
+            _mm256_storeu_pd(d.y + i, _mm256_add_pd(_mm256_loadu_pd(d.y + i),
+                _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(d.vy + i), dt), _mm256_mul_pd(_mm256_loadu_pd(d.ay + i), medio_dt2))));
+            _mm256_storeu_pd(d.z + i, _mm256_add_pd(_mm256_loadu_pd(d.z + i),
+                _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(d.vz + i), dt), _mm256_mul_pd(_mm256_loadu_pd(d.az + i), medio_dt2))));
+            _mm256_storeu_pd(d.bx + i, cero);
+            _mm256_storeu_pd(d.by + i, cero);
+            _mm256_storeu_pd(d.bz + i, cero);
+        }
+        for (int i = 0; i < n; ++i) {
+            const int si = i * c + s;
+            const __m256d xi = _mm256_loadu_pd(d.x + si), yi = _mm256_loadu_pd(d.y + si), zi = _mm256_loadu_pd(d.z + si);
+            const __m256d mi = _mm256_loadu_pd(d.m + si), ri = _mm256_loadu_pd(d.R + si);
+            __m256d axi = cero, ayi = cero, azi = cero;
+            for (int j = i + 1; j < n; ++j) {
+                const int sj = j * c + s;
+                __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(d.x + sj), xi);
+                __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(d.y + sj), yi);
+                __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(d.z + sj), zi);
+                __m256d r2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)), _mm256_mul_pd(dz, dz));
+                __m256d contacto = _mm256_add_pd(ri, _mm256_loadu_pd(d.R + sj));
+                const unsigned choques = activos &
+                    static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(r2, _mm256_mul_pd(contacto, contacto), _CMP_LT_OQ)));
+                if (choques != 0) eventos += anotarEventos(d.evento + s, choques, 1 + i * n + j);
+                __m256d dist_cubed = _mm256_mul_pd(r2, _mm256_sqrt_pd(r2));
+                __m256d validos = _mm256_cmp_pd(dist_cubed, umbral, _CMP_GE_OQ);
+                // Los pares no válidos se excluyen con blend: no suman ni un cero con signo
+                __m256d f = _mm256_div_pd(g, _mm256_blendv_pd(medio, dist_cubed, validos));
+                __m256d mj = _mm256_loadu_pd(d.m + sj);
+                __m256d fmj = _mm256_mul_pd(f, mj), fmi = _mm256_mul_pd(f, mi);
+                axi = _mm256_blendv_pd(axi, _mm256_add_pd(axi, _mm256_mul_pd(dx, fmj)), validos);
+                ayi = _mm256_blendv_pd(ayi, _mm256_add_pd(ayi, _mm256_mul_pd(dy, fmj)), validos);
+                azi = _mm256_blendv_pd(azi, _mm256_add_pd(azi, _mm256_mul_pd(dz, fmj)), validos);
+                __m256d bxj = _mm256_loadu_pd(d.bx + sj), byj = _mm256_loadu_pd(d.by + sj), bzj = _mm256_loadu_pd(d.bz + sj);
+                _mm256_storeu_pd(d.bx + sj, _mm256_blendv_pd(bxj, _mm256_sub_pd(bxj, _mm256_mul_pd(dx, fmi)), validos));
+                _mm256_storeu_pd(d.by + sj, _mm256_blendv_pd(byj, _mm256_sub_pd(byj, _mm256_mul_pd(dy, fmi)), validos));
+                _mm256_storeu_pd(d.bz + sj, _mm256_blendv_pd(bzj, _mm256_sub_pd(bzj, _mm256_mul_pd(dz, fmi)), validos));
+            }
+            _mm256_storeu_pd(d.bx + si, _mm256_add_pd(_mm256_loadu_pd(d.bx + si), axi));
+            _mm256_storeu_pd(d.by + si, _mm256_add_pd(_mm256_loadu_pd(d.by + si), ayi));
+            _mm256_storeu_pd(d.bz + si, _mm256_add_pd(_mm256_loadu_pd(d.bz + si), azi));
+        }
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            const __m256d xk = _mm256_loadu_pd(d.x + i), yk = _mm256_loadu_pd(d.y + i), zk = _mm256_loadu_pd(d.z + i);
+            __m256d norma2 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(xk, xk), _mm256_mul_pd(yk, yk)), _mm256_mul_pd(zk, zk));
+            const unsigned escapes = activos &
+                static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(norma2, radio2, _CMP_GT_OQ)));
+            if (escapes != 0) eventos += anotarEventos(d.evento + s, escapes, -(1 + k));
+        }
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            __m256d bx = _mm256_loadu_pd(d.bx + i), by = _mm256_loadu_pd(d.by + i), bz = _mm256_loadu_pd(d.bz + i);
+            _mm256_storeu_pd(d.vx + i, _mm256_add_pd(_mm256_loadu_pd(d.vx + i), _mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(d.ax + i), bx), medio_dt)));
+            _mm256_storeu_pd(d.vy + i, _mm256_add_pd(_mm256_loadu_pd(d.vy + i), _mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(d.ay + i), by), medio_dt)));
+            _mm256_storeu_pd(d.vz + i, _mm256_add_pd(_mm256_loadu_pd(d.vz + i), _mm256_mul_pd(_mm256_add_pd(_mm256_loadu_pd(d.az + i), bz), medio_dt)));
+            _mm256_storeu_pd(d.ax + i, bx); _mm256_storeu_pd(d.ay + i, by); _mm256_storeu_pd(d.az + i, bz);
+        }
+    }
+    return eventos;
+}
+
+__attribute__((target("avx512f")))
+static int pasoConjuntoAVX512(const CarrilesPaso& d, int s0, int s1) {
+    const int n = d.n, c = d.c;
+    const __m512d cero = _mm512_setzero_pd(), medio = _mm512_set1_pd(0.5);
+    const __m512d g = _mm512_set1_pd(G), umbral = _mm512_set1_pd(UMBRAL_DIST3);
+    const __m512d radio2 = _mm512_set1_pd(d.radio2);
+    int eventos = 0;
+    for (int s = s0; s < s1; s += 8) {
+        const __m512d dt = _mm512_loadu_pd(d.paso + s);
+        const __mmask8 activos = _mm512_cmp_pd_mask(dt, cero, _CMP_NEQ_OQ);
+        if (activos == 0) continue;
+        const __m512d medio_dt = _mm512_mul_pd(medio, dt);
+        const __m512d medio_dt2 = _mm512_mul_pd(medio_dt, dt);
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            _mm512_storeu_pd(d.x + i, _mm512_add_pd(_mm512_loadu_pd(d.x + i),
+                _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(d.vx + i), dt), _mm512_mul_pd(_mm512_loadu_pd(d.ax + i), medio_dt2))));
+            _mm512_storeu_pd(d.y + i, _mm512_add_pd(_mm512_loadu_pd(d.y + i),
+                _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(d.vy + i), dt), _mm512_mul_pd(_mm512_loadu_pd(d.ay + i), medio_dt2))));
+            _mm512_storeu_pd(d.z + i, _mm512_add_pd(_mm512_loadu_pd(d.z + i),
+                _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(d.vz + i), dt), _mm512_mul_pd(_mm512_loadu_pd(d.az + i), medio_dt2))));
+            _mm512_storeu_pd(d.bx + i, cero);
+            _mm512_storeu_pd(d.by + i, cero);
+            _mm512_storeu_pd(d.bz + i, cero);
+        }
+        for (int i = 0; i < n; ++i) {
+            const int si = i * c + s;
+            const __m512d xi = _mm512_loadu_pd(d.x + si), yi = _mm512_loadu_pd(d.y + si), zi = _mm512_loadu_pd(d.z + si);
+            const __m512d mi = _mm512_loadu_pd(d.m + si), ri = _mm512_loadu_pd(d.R + si);
+            __m512d axi = cero, ayi = cero, azi = cero;
+            for (int j = i + 1; j < n; ++j) {
+                const int sj = j * c + s;
+                __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(d.x + sj), xi);
+                __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(d.y + sj), yi);
+                __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(d.z + sj), zi);
+                __m512d r2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)), _mm512_mul_pd(dz, dz));
+                __m512d contacto = _mm512_add_pd(ri, _mm512_loadu_pd(d.R + sj));
+                const __mmask8 choques = activos & _mm512_cmp_pd_mask(r2, _mm512_mul_pd(contacto, contacto), _CMP_LT_OQ);
+                if (choques != 0) eventos += anotarEventos(d.evento + s, choques, 1 + i * n + j);
+                __m512d dist_cubed = _mm512_mul_pd(r2, _mm512_maskz_sqrt_pd(0xFF, r2));
+                const __mmask8 validos = _mm512_cmp_pd_mask(dist_cubed, umbral, _CMP_GE_OQ);
+                __m512d f = _mm512_maskz_div_pd(validos, g, dist_cubed);
+                __m512d mj = _mm512_loadu_pd(d.m + sj);
+                __m512d fmj = _mm512_mul_pd(f, mj), fmi = _mm512_mul_pd(f, mi);
+                axi = _mm512_mask_add_pd(axi, validos, axi, _mm512_mul_pd(dx, fmj));
+                ayi = _mm512_mask_add_pd(ayi, validos, ayi, _mm512_mul_pd(dy, fmj));
+                azi = _mm512_mask_add_pd(azi, validos, azi, _mm512_mul_pd(dz, fmj));
+                __m512d bxj = _mm512_loadu_pd(d.bx + sj), byj = _mm512_loadu_pd(d.by + sj), bzj = _mm512_loadu_pd(d.bz + sj);
+                _mm512_storeu_pd(d.bx + sj, _mm512_mask_sub_pd(bxj, validos, bxj, _mm512_mul_pd(dx, fmi)));
+                _mm512_storeu_pd(d.by + sj, _mm512_mask_sub_pd(byj, validos, byj, _mm512_mul_pd(dy, fmi)));
+                _mm512_storeu_pd(d.bz + sj, _mm512_mask_sub_pd(bzj, validos, bzj, _mm512_mul_pd(dz, fmi)));
+            }
+            _mm512_storeu_pd(d.bx + si, _mm512_add_pd(_mm512_loadu_pd(d.bx + si), axi));
+            _mm512_storeu_pd(d.by + si, _mm512_add_pd(_mm512_loadu_pd(d.by + si), ayi));
+            _mm512_storeu_pd(d.bz + si, _mm512_add_pd(_mm512_loadu_pd(d.bz + si), azi));
+        }
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            const __m512d xk = _mm512_loadu_pd(d.x + i), yk = _mm512_loadu_pd(d.y + i), zk = _mm512_loadu_pd(d.z + i);
+            __m512d norma2 = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(xk, xk), _mm512_mul_pd(yk, yk)), _mm512_mul_pd(zk, zk));
+            const __mmask8 escapes = activos & _mm512_cmp_pd_mask(norma2, radio2, _CMP_GT_OQ);
+            if (escapes != 0) eventos += anotarEventos(d.evento + s, escapes, -(1 + k));
+        }
+        for (int k = 0; k < n; ++k) {
+            const int i = k * c + s;
+            __m512d bx = _mm512_loadu_pd(d.bx + i), by = _mm512_loadu_pd(d.by + i), bz = _mm512_loadu_pd(d.bz + i);
+            _mm512_storeu_pd(d.vx + i, _mm512_add_pd(_mm512_loadu_pd(d.vx + i), _mm512_mul_pd(_mm512_add_pd(_mm512_loadu_pd(d.ax + i), bx), medio_dt)));
+            _mm512_storeu_pd(d.vy + i, _mm512_add_pd(_mm512_loadu_pd(d.vy + i), _mm512_mul_pd(_mm512_add_pd(_mm512_loadu_pd(d.ay + i), by), medio_dt)));
+            _mm512_storeu_pd(d.vz + i, _mm512_add_pd(_mm512_loadu_pd(d.vz + i), _mm512_mul_pd(_mm512_add_pd(_mm512_loadu_pd(d.az + i), bz), medio_dt)));
+            _mm512_storeu_pd(d.ax + i, bx); _mm512_storeu_pd(d.ay + i, by); _mm512_storeu_pd(d.az + i, bz);
+        }
+    }
+    return eventos;
+}
+
+#endif // NUCLEOS_X86
+
+static NucleoPasoConjunto nucleoPasoConjunto(NivelSIMD nivel) {
+#ifdef NUCLEOS_X86
+    switch (nivel) {
+        case SIMD_AVX512: return pasoConjuntoAVX512;
+        case SIMD_AVX2: return pasoConjuntoAVX2;
+        default: break; // Con SSE2 (2 carriles) no compensa un núcleo aparte
+    }
+#else
+    (void)nivel;
+#endif
+    return pasoConjuntoEscalar;
+}
+
+// --- ConjuntoSistemas ---
+
+ConjuntoSistemas::ConjuntoSistemas()
+    : n_(0), miembros_(0), carriles_(0), recorridos_(0), activos_(0), t_(0.0), pasos_(0), radio_escape_(0.0),
+      nivel_(nivelSIMDActivo()), pasos_sistemas_(0.0), pasos_carriles_(0.0) {}
+
+void ConjuntoSistemas::fijarNivelSIMD(NivelSIMD nivel) {
+    nivel_ = (nivel > detectarNivelSIMD()) ? detectarNivelSIMD() : nivel;
+}
+
+void ConjuntoSistemas::inicializar(const std::vector<Cuerpo>& plantilla, int miembros, double perturbacion,
+                                   unsigned long semilla) {
+    n_ = static_cast<int>(plantilla.size());
+    miembros_ = miembros;
+    carriles_ = (miembros + ANCHO_CARRILES - 1) / ANCHO_CARRILES * ANCHO_CARRILES;
+    recorridos_ = carriles_;
+    activos_ = miembros;
+    t_ = 0.0;
+    pasos_ = 0;
+    pasos_sistemas_ = 0.0;
+    pasos_carriles_ = 0.0;
+
+    const size_t total = static_cast<size_t>(n_) * carriles_;
+    VectorAlineado* arreglos[] = {&x_, &y_, &z_, &vx_, &vy_, &vz_, &ax_, &ay_, &az_, &bx_, &by_, &bz_, &m_, &R_};
+    for (size_t a = 0; a < sizeof(arreglos) / sizeof(arreglos[0]); ++a) { arreglos[a]->assign(total, 0.0); }
+    paso_.assign(carriles_, 0.0);
+    evento_.assign(carriles_, 0);
+    miembro_.assign(carriles_, -1);
+    resultados_.assign(miembros_, ResultadoMiembro());
+    finales_.assign(static_cast<size_t>(miembros_) * n_ * 6, 0.0);
+
+    // Escalas de la perturbación: distancia y rapidez cuadráticas medias respecto al centro de masa
+    double masa = 0, cx = 0, cy = 0, cz = 0, cvx = 0, cvy = 0, cvz = 0;
+    for (int k = 0; k < n_; ++k) {
+        const Cuerpo& p = plantilla[k];
+        masa += p.m;
+        cx += p.m * p.r.x(); cy += p.m * p.r.y(); cz += p.m * p.r.z();
+        cvx += p.m * p.V.x(); cvy += p.m * p.V.y(); cvz += p.m * p.V.z();
+    }
+    const vector3D centro(cx / masa, cy / masa, cz / masa), velocidad_centro(cvx / masa, cvy / masa, cvz / masa);
+    double escala_r = 0, escala_v = 0;
+    for (int k = 0; k < n_; ++k) {
+        escala_r += (plantilla[k].r - centro).norm2();
+        escala_v += (plantilla[k].V - velocidad_centro).norm2();
+    }
+    escala_r = perturbacion * std::sqrt(escala_r / n_);
+    escala_v = perturbacion * std::sqrt(escala_v / n_);
+
+    std::mt19937_64 generador(semilla);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    for (int s = 0; s < carriles_; ++s) {
+        // Los carriles de relleno repiten la plantilla y quedan enmascarados
+        const bool miembro = s < miembros_;
+        const bool perturbado = miembro && s > 0;
+        masa = cx = cy = cz = cvx = cvy = cvz = 0;
+        for (int k = 0; k < n_; ++k) {
+            const Cuerpo& p = plantilla[k];
+            const int i = indice(k, s);
+            x_[i] = p.r.x(); y_[i] = p.r.y(); z_[i] = p.r.z();
+            vx_[i] = p.V.x(); vy_[i] = p.V.y(); vz_[i] = p.V.z();
+            if (perturbado) {
+                x_[i] += escala_r * normal(generador); y_[i] += escala_r * normal(generador);
+                z_[i] += escala_r * normal(generador);
+                vx_[i] += escala_v * normal(generador); vy_[i] += escala_v * normal(generador);
+                vz_[i] += escala_v * normal(generador);
+            }
+            m_[i] = p.m;
+            R_[i] = p.R;
+            masa += p.m;
+            cx += p.m * x_[i]; cy += p.m * y_[i]; cz += p.m * z_[i];
+            cvx += p.m * vx_[i]; cvy += p.m * vy_[i]; cvz += p.m * vz_[i];
+        }
+        // Sistema centro de masa: el escape se mide como distancia al origen
+        for (int k = 0; k < n_; ++k) {
+            const int i = indice(k, s);
+            x_[i] -= cx / masa; y_[i] -= cy / masa; z_[i] -= cz / masa;
+            vx_[i] -= cvx / masa; vy_[i] -= cvy / masa; vz_[i] -= cvz / masa;
+        }
+        if (miembro) {
+            miembro_[s] = s;
+            ResultadoMiembro& r = resultados_[s];
+            r.estado = MIEMBRO_ACTIVO;
+            r.t_fin = 0.0;
+            r.pasos = 0;
+            r.cuerpo_a = r.cuerpo_b = -1;
+            r.energia_inicial = r.energia_final = energiaCarril(s);
+        }
+    }
+    calcularAceleracionesIniciales();
+}
+
+void ConjuntoSistemas::calcularAceleracionesIniciales() {
+    CarrilesPaso d;
+    d.n = n_; d.c = carriles_;
+    d.x = x_.data(); d.y = y_.data(); d.z = z_.data();
+    d.m = m_.data();
+    for (int s = 0; s < recorridos_; ++s) { aceleracionesCarril(d, s, ax_.data(), ay_.data(), az_.data()); }
+}
+
+int ConjuntoSistemas::avanzar(double dt, long pasos) {
+    for (int s = 0; s < recorridos_; ++s) {
+        const int miembro = miembro_[s];
+        paso_[s] = (miembro >= 0 && resultados_[miembro].estado == MIEMBRO_ACTIVO) ? dt : 0.0;
+    }
+    CarrilesPaso d;
+    d.n = n_; d.c = carriles_;
+    d.x = x_.data(); d.y = y_.data(); d.z = z_.data();
+    d.vx = vx_.data(); d.vy = vy_.data(); d.vz = vz_.data();
+    d.ax = ax_.data(); d.ay = ay_.data(); d.az = az_.data();
+    d.bx = bx_.data(); d.by = by_.data(); d.bz = bz_.data();
+    d.m = m_.data(); d.R = R_.data(); d.paso = paso_.data();
+    d.radio2 = (radio_escape_ > 0) ? radio_escape_ * radio_escape_ : std::numeric_limits<double>::infinity();
+    d.evento = evento_.data();
+    const NucleoPasoConjunto nucleo = nucleoPasoConjunto(nivel_);
+
+    for (long p = 0; p < pasos && activos_ > 0; ++p) {
+        const int eventos = nucleo(d, 0, recorridos_);
+        t_ += dt;
+        pasos_++;
+        pasos_sistemas_ += activos_;
+        pasos_carriles_ += recorridos_;
+        if (eventos == 0) continue;
+        for (int s = 0; s < recorridos_; ++s) {
+            const int codigo = evento_[s];
+            if (codigo == 0) continue;
+            evento_[s] = 0;
+            if (codigo > 0) {
+                terminarCarril(s, MIEMBRO_COLISION, (codigo - 1) / n_, (codigo - 1) % n_);
+            } else {
+                terminarCarril(s, MIEMBRO_ESCAPE, -codigo - 1, -1);
+            }
+        }
+        if (recorridos_ > ANCHO_CARRILES && 2 * activos_ <= recorridos_) { compactar(); }
+    }
+    return activos_;
+}
+
+void ConjuntoSistemas::finalizar() {
+    for (int s = 0; s < recorridos_; ++s) {
+        const int miembro = miembro_[s];
+        if (miembro >= 0 && resultados_[miembro].estado == MIEMBRO_ACTIVO) { terminarCarril(s, MIEMBRO_COMPLETO, -1, -1); }
+    }
+}
+
+void ConjuntoSistemas::terminarCarril(int s, EstadoMiembro estado, int cuerpo_a, int cuerpo_b) {
+    const int miembro = miembro_[s];
+    ResultadoMiembro& r = resultados_[miembro];
+    r.estado = estado;
+    r.t_fin = t_;
+    r.pasos = pasos_;
+    r.cuerpo_a = cuerpo_a;
+    r.cuerpo_b = cuerpo_b;
+    r.energia_final = energiaCarril(s);
+    for (int k = 0; k < n_; ++k) {
+        const int i = indice(k, s);
+        double* final_k = &finales_[(static_cast<size_t>(miembro) * n_ + k) * 6];
+        final_k[0] = x_[i]; final_k[1] = y_[i]; final_k[2] = z_[i];
+        final_k[3] = vx_[i]; final_k[4] = vy_[i]; final_k[5] = vz_[i];
+    }
+    paso_[s] = 0.0;
+    activos_--;
+}
+
+void ConjuntoSistemas::compactar() {
+    VectorAlineado* arreglos[] = {&x_, &y_, &z_, &vx_, &vy_, &vz_, &ax_, &ay_, &az_, &m_, &R_};
+    int destino = 0;
+    for (int s = 0; s < recorridos_; ++s) {
+        if (paso_[s] == 0.0) continue;
+        if (s != destino) {
+            for (size_t a = 0; a < sizeof(arreglos) / sizeof(arreglos[0]); ++a) {
+                VectorAlineado& v = *arreglos[a];
+                for (int k = 0; k < n_; ++k) { v[indice(k, destino)] = v[indice(k, s)]; }
+            }
+            miembro_[destino] = miembro_[s];
+            paso_[destino] = paso_[s];
+        }
+        destino++;
+    }
+    const int nuevos = (destino + ANCHO_CARRILES - 1) / ANCHO_CARRILES * ANCHO_CARRILES;
+    // Los carriles sobrantes conservan datos finitos de miembros ya movidos o terminados
+    for (int s = destino; s < recorridos_; ++s) {
+        miembro_[s] = -1;
+        paso_[s] = 0.0;
+    }
+    recorridos_ = nuevos;
+}
+
+double ConjuntoSistemas::energiaCarril(int s) const {
+    double K = 0.0, U = 0.0;
+    for (int i = 0; i < n_; ++i) {
+        const int si = indice(i, s);
+        K += 0.5 * m_[si] * (vx_[si] * vx_[si] + vy_[si] * vy_[si] + vz_[si] * vz_[si]);
+        double ui = 0.0;
+        for (int j = i + 1; j < n_; ++j) {
+            const int sj = indice(j, s);
+            double dx = x_[sj] - x_[si], dy = y_[sj] - y_[si], dz = z_[sj] - z_[si];
+            double r2 = dx * dx + dy * dy + dz * dz;
+            double r = std::sqrt(r2);
+            if (r2 * r < UMBRAL_DIST3) { continue; }
+            ui += m_[sj] / r;
+        }
+        U -= G * m_[si] * ui;
+    }
+    return K + U;
+}
+
+double ConjuntoSistemas::energia(int miembro) const {
+    if (resultados_[miembro].estado != MIEMBRO_ACTIVO) return resultados_[miembro].energia_final;
+    for (int s = 0; s < recorridos_; ++s) {
+        if (miembro_[s] == miembro) return energiaCarril(s);
+    }
+    return resultados_[miembro].energia_final;
+}
+
+Cuerpo ConjuntoSistemas::cuerpo(int miembro, int k) const {
+    Cuerpo c;
+    if (resultados_[miembro].estado == MIEMBRO_ACTIVO) {
+        for (int s = 0; s < recorridos_; ++s) {
+            if (miembro_[s] != miembro) continue;
+            const int i = indice(k, s);
+            c.Inicie(x_[i], y_[i], z_[i], vx_[i], vy_[i], vz_[i], m_[i], R_[i]);
+            return c;
+        }
+    }
+    // Las masas y radios no cambian: se toman de un carril cualquiera
+    const double* final_k = &finales_[(static_cast<size_t>(miembro) * n_ + k) * 6];
+    c.Inicie(final_k[0], final_k[1], final_k[2], final_k[3], final_k[4], final_k[5], m_[indice(k, 0)], R_[indice(k, 0)]);
+    return c;
+}
+
+bool ConjuntoSistemas::guardarResultados(const std::string& ruta) const {
+    std::ofstream archivo(ruta.c_str());
+    if (!archivo.is_open()) return false;
+    archivo << "# Miembro\tEstado\tT_fin\tPasos\tCuerpo_a\tCuerpo_b\tE_inicial\tE_final\tError_E" << std::endl;
+    archivo << std::scientific << std::setprecision(12);
+    for (int k = 0; k < miembros_; ++k) {
+        const ResultadoMiembro& r = resultados_[k];
+        // Cuerpos numerados desde 1, como en los mensajes del programa (0 = ninguno)
+        archivo << k << "\t" << nombreEstadoMiembro(r.estado) << "\t" << r.t_fin << "\t" << r.pasos << "\t"
+                << r.cuerpo_a + 1 << "\t" << r.cuerpo_b + 1 << "\t" << r.energia_inicial << "\t"
+                << r.energia_final << "\t" << r.errorEnergia() << "\n";
+    }
+    return archivo.good();
+}
@@ -0,0 +1,45 @@
+#include "ContadorAsignaciones.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long> asignaciones(0); // Inicialización constante: válida antes de main
+
+long asignacionesMemoria() { return asignaciones.load(std::memory_order_relaxed); }
+
+void registrarAsignacion() { asignaciones.fetch_add(1, std::memory_order_relaxed); }
+
+// Asignación con la semántica estándar: reintenta con el new_handler instalado
+static void* asignarContando(std::size_t n) {
+    registrarAsignacion();
+    if (n == 0) n = 1;
+    for (;;) {
+        void* p = std::malloc(n);
+        if (p) return p;
+        std::new_handler manejador = std::get_new_handler();
+        if (!manejador) throw std::bad_alloc();
+        manejador();
+    }
+}
+
+// --- Reemplazo de los operadores globales ---
+
+void* operator new(std::size_t n) { return asignarContando(n); }
+
+void* operator new[](std::size_t n) { return asignarContando(n); }
+
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    try { return asignarContando(n); } catch (...) { return 0; }
+}
+
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    try { return asignarContando(n); } catch (...) { return 0; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
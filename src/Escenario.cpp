@@ -0,0 +1,261 @@
+#include "Escenario.h"
+#include "IAS15.h" // Para TOLERANCIA_MINIMA_IAS15
+#include <fstream>
+#include <sstream>
+#include <cerrno>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// --- Lectura estricta de valores: todo el texto debe ser parte del valor ---
+
+static bool leerReal(const std::string& texto, double& valor) {
+    std::istringstream entrada(texto);
+    return (entrada >> valor) && (entrada >> std::ws).eof();
+}
+
+static bool leerEntero(const std::string& texto, int& valor) {
+    std::istringstream entrada(texto);
+    return (entrada >> valor) && (entrada >> std::ws).eof();
+}
+
+static std::string recortar(const std::string& texto) {
+    const char* espacios = " \t\r\n";
+    size_t inicio = texto.find_first_not_of(espacios);
+    if (inicio == std::string::npos) return "";
+    size_t fin = texto.find_last_not_of(espacios);
+    return texto.substr(inicio, fin - inicio + 1);
+}
+
+Escenario escenarioPorDefecto() {
+    Escenario e;
+    e.dt = 0.0;
+    e.t_max = 0.0;
+    e.motor = MOTOR_DIRECTO;
+    e.hilos = 1;
+    e.precision_mixta = false;
+    e.theta = 0.5;
+    e.orden_fmm = 8;
+    e.integrador = INTEGRADOR_VERLET;
+    e.niveles_bloques = 10;
+    e.eta_bloques = 0.02;
+    e.orden_composicion = 4;
+    e.tolerancia_ias15 = 1e-9;
+    e.radio_interior_respa = 0.5;
+    e.radio_exterior_respa = 1.0;
+    e.subpasos_respa = 8;
+    e.cadencia_diagnosticos = 0;
+    e.formato = TRAYECTORIA_TEXTO;
+    e.seleccion.primer_cuerpo = 0;
+    e.seleccion.cuerpos = 0;
+    e.seleccion.campos = CAMPOS_POR_DEFECTO;
+    e.cada_pasos_salida = 1;
+    e.intervalo_salida = 0.0;
+    e.capacidad_salida = 0;
+    e.politica_salida = SATURACION_ESPERAR;
+    e.directorio_salida = "results";
+    e.punto_control_cada = 0;
+    e.traza = false;
+    e.eventos_traza = 1000000;
+    e.contadores = false;
+    e.conjunto = 0;
+    e.perturbacion = 1e-3;
+    e.semilla = 1;
+    e.radio_escape = 0.0;
+    e.hilos_barrido = 0;
+    return e;
+}
+
+bool interpretarCamposSalida(const std::string& texto, unsigned& campos) {
+    if (texto == "0") { campos = CAMPOS_POR_DEFECTO; return true; }
+    if (texto.empty()) return false;
+    unsigned seleccion = 0;
+    for (size_t k = 0; k < texto.size(); ++k) {
+        switch (texto[k]) {
+            case 'p': seleccion |= CAMPO_POSICIONES; break;
+            case 'v': seleccion |= CAMPO_VELOCIDADES; break;
+            case 'r': seleccion |= CAMPO_RAPIDEZ; break;
+            case 'e': seleccion |= CAMPO_ENERGIAS; break;
+            default: return false;
+        }
+    }
+    campos = seleccion;
+    return true;
+}
+
+bool aplicarOpcionEscenario(Escenario& e, const std::string& clave, const std::string& valor,
+                            std::string& error) {
+    bool valido = true;
+    if (clave == "cuerpo") {
+        std::istringstream entrada(valor);
+        double m, r, x, y, z, vx, vy, vz;
+        valido = (entrada >> m >> r >> x >> y >> z >> vx >> vy >> vz) && (entrada >> std::ws).eof() && m > 0 && r >= 0;
+        if (!valido) {
+            error = "cuerpo: se esperan 'masa radio x y z vx vy vz' con masa > 0 y radio >= 0";
+            return false;
+        }
+        Cuerpo cuerpo;
+        cuerpo.Inicie(x, y, z, vx, vy, vz, m, r);
+        e.cuerpos.push_back(cuerpo);
+    } else if (clave == "cuerpos_archivo") {
+        valido = !valor.empty();
+        if (valido) e.archivo_cuerpos = valor;
+    } else if (clave == "dt") {
+        valido = leerReal(valor, e.dt) && e.dt > 0;
+    } else if (clave == "t_max") {
+        valido = leerReal(valor, e.t_max) && e.t_max > 0;
+    } else if (clave == "motor") {
+        if (valor == "directo" || valor == "1") e.motor = MOTOR_DIRECTO;
+        else if (valor == "barnes-hut" || valor == "2") e.motor = MOTOR_BARNES_HUT;
+        else if (valor == "fmm" || valor == "3") e.motor = MOTOR_FMM;
+        else valido = false;
+    } else if (clave == "hilos") {
+        valido = leerEntero(valor, e.hilos) && e.hilos >= 0;
+    } else if (clave == "precision") {
+        if (valor == "doble" || valor == "1") e.precision_mixta = false;
+        else if (valor == "mixta" || valor == "2") e.precision_mixta = true;
+        else valido = false;
+    } else if (clave == "theta") {
+        valido = leerReal(valor, e.theta) && e.theta >= 0;
+    } else if (clave == "orden_fmm") {
+        valido = leerEntero(valor, e.orden_fmm) && e.orden_fmm >= 1 && e.orden_fmm <= 20;
+    } else if (clave == "integrador") {
+        if (valor == "verlet" || valor == "1") e.integrador = INTEGRADOR_VERLET;
+        else if (valor == "bloques" || valor == "2") e.integrador = INTEGRADOR_BLOQUES;
+        else if (valor == "hermite" || valor == "3") e.integrador = INTEGRADOR_HERMITE;
+        else if (valor == "composicion" || valor == "4") e.integrador = INTEGRADOR_COMPOSICION;
+        else if (valor == "wisdom-holman" || valor == "5") e.integrador = INTEGRADOR_WISDOM_HOLMAN;
+        else if (valor == "ias15" || valor == "6") e.integrador = INTEGRADOR_IAS15;
+        else if (valor == "respa" || valor == "7") e.integrador = INTEGRADOR_RESPA;
+        else valido = false;
+    } else if (clave == "niveles_bloques") {
+        valido = leerEntero(valor, e.niveles_bloques) && e.niveles_bloques >= 0 && e.niveles_bloques <= 30;
+    } else if (clave == "eta_bloques") {
+        valido = leerReal(valor, e.eta_bloques) && e.eta_bloques > 0;
+    } else if (clave == "orden_composicion") {
+        valido = leerEntero(valor, e.orden_composicion) &&
+                 (e.orden_composicion == 4 || e.orden_composicion == 6 || e.orden_composicion == 8);
+    } else if (clave == "tolerancia_ias15") {
+        valido = leerReal(valor, e.tolerancia_ias15) && e.tolerancia_ias15 >= TOLERANCIA_MINIMA_IAS15;
+    } else if (clave == "radio_interior_respa") {
+        valido = leerReal(valor, e.radio_interior_respa) && e.radio_interior_respa > 0;
+    } else if (clave == "radio_exterior_respa") {
+        valido = leerReal(valor, e.radio_exterior_respa) && e.radio_exterior_respa > 0;
+    } else if (clave == "subpasos_respa") {
+        valido = leerEntero(valor, e.subpasos_respa) && e.subpasos_respa >= 1;
+    } else if (clave == "cadencia_diagnosticos") {
+        valido = leerEntero(valor, e.cadencia_diagnosticos) && e.cadencia_diagnosticos >= 0;
+    } else if (clave == "formato") {
+        if (valor == "texto" || valor == "1") e.formato = TRAYECTORIA_TEXTO;
+        else if (valor == "binario" || valor == "2") e.formato = TRAYECTORIA_BINARIA;
+        else valido = false;
+    } else if (clave == "campos") {
+        valido = interpretarCamposSalida(valor, e.seleccion.campos);
+    } else if (clave == "cuerpos_salida") {
+        std::istringstream entrada(valor);
+        int primero, ultimo;
+        valido = (entrada >> primero >> ultimo) && (entrada >> std::ws).eof() &&
+                 ((primero == 0 && ultimo == 0) || (primero >= 1 && primero <= ultimo));
+        if (valido) {
+            e.seleccion.primer_cuerpo = (primero > 0) ? primero - 1 : 0;
+            e.seleccion.cuerpos = (primero > 0) ? ultimo - primero + 1 : 0;
+        }
+    } else if (clave == "cada_pasos") {
+        valido = leerEntero(valor, e.cada_pasos_salida) && e.cada_pasos_salida >= 1;
+    } else if (clave == "intervalo_salida") {
+        valido = leerReal(valor, e.intervalo_salida) && e.intervalo_salida >= 0;
+    } else if (clave == "bufer_salida") {
+        valido = leerEntero(valor, e.capacidad_salida) && e.capacidad_salida >= 0;
+    } else if (clave == "saturacion") {
+        if (valor == "esperar" || valor == "1") e.politica_salida = SATURACION_ESPERAR;
+        else if (valor == "descartar" || valor == "2") e.politica_salida = SATURACION_DESCARTAR;
+        else valido = false;
+    } else if (clave == "salida") {
+        valido = !valor.empty();
+        if (valido) e.directorio_salida = valor;
+    } else if (clave == "punto_control_cada") {
+        valido = leerEntero(valor, e.punto_control_cada) && e.punto_control_cada >= 0;
+    } else if (clave == "punto_control") {
+        valido = !valor.empty();
+        if (valido) e.archivo_punto_control = valor;
+    } else if (clave == "reanudar") {
+        valido = !valor.empty();
+        if (valido) e.reanudar = valor;
+    } else if (clave == "traza") {
+        valido = (valor == "0" || valor == "1");
+        if (valido) e.traza = (valor == "1");
+    } else if (clave == "eventos_traza") {
+        valido = leerEntero(valor, e.eventos_traza) && e.eventos_traza >= 1;
+    } else if (clave == "contadores") {
+        valido = (valor == "0" || valor == "1");
+        if (valido) e.contadores = (valor == "1");
+    } else if (clave == "conjunto") {
+        valido = leerEntero(valor, e.conjunto) && e.conjunto >= 0;
+    } else if (clave == "perturbacion") {
+        valido = leerReal(valor, e.perturbacion) && e.perturbacion >= 0;
+    } else if (clave == "semilla") {
+        valido = leerEntero(valor, e.semilla) && e.semilla >= 0;
+    } else if (clave == "radio_escape") {
+        valido = leerReal(valor, e.radio_escape) && e.radio_escape >= 0;
+    } else if (clave == "barrido") {
+        // Cada uso agrega una dimensión a la rejilla
+        DimensionBarrido dimension;
+        std::string detalle;
+        if (!interpretarDimensionBarrido(valor, dimension, detalle)) {
+            error = "valor no válido para barrido: " + detalle;
+            return false;
+        }
+        e.barrido.push_back(dimension);
+        valido = true;
+    } else if (clave == "hilos_barrido") {
+        valido = leerEntero(valor, e.hilos_barrido) && e.hilos_barrido >= 0;
+    } else {
+        error = "clave desconocida '" + clave + "'";
+        return false;
+    }
+    if (!valido) {
+        error = "valor no válido para " + clave + ": '" + valor + "'";
+        return false;
+    }
+    return true;
+}
+
+bool cargarEscenario(const std::string& ruta, Escenario& escenario, std::string& error) {
+    std::ifstream archivo(ruta.c_str());
+    if (!archivo.is_open()) {
+        error = "no se pudo abrir el escenario " + ruta;
+        return false;
+    }
+    std::string linea;
+    int numero = 0;
+    while (std::getline(archivo, linea)) {
+        numero++;
+        size_t comentario = linea.find('#');
+        if (comentario != std::string::npos) linea.erase(comentario);
+        linea = recortar(linea);
+        if (linea.empty()) continue;
+
+        size_t igual = linea.find('=');
+        std::string detalle;
+        if (igual == std::string::npos) {
+            detalle = "se esperaba 'clave = valor'";
+        } else if (aplicarOpcionEscenario(escenario, recortar(linea.substr(0, igual)),
+                                          recortar(linea.substr(igual + 1)), detalle)) {
+            continue;
+        }
+        std::ostringstream mensaje;
+        mensaje << ruta << ":" << numero << ": " << detalle;
+        error = mensaje.str();
+        return false;
+    }
+    return true;
+}
+
+bool crearDirectorios(const std::string& ruta) {
+    for (size_t fin = 1; fin <= ruta.size(); ++fin) {
+        if (fin < ruta.size() && ruta[fin] != '/') continue;
+        std::string parcial = ruta.substr(0, fin);
+        if (mkdir(parcial.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    }
+    struct stat info;
+    return stat(ruta.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
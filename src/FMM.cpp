@@ -0,0 +1,326 @@
+#include "FMM.h"
+#include "utilidades.h" // Para G
+#include <cmath>
+#include <algorithm>
+
+// (-1)^n
+static inline double paridad(int n) { return (n & 1) ? -1.0 : 1.0; }
+// i^(2n) restringido a n < 0, usado en la traslación M2M
+static inline double potenciaNegativa(int n) { return (n >= 0) ? 1.0 : paridad(n); }
+
+// Coordenadas esféricas (r, θ, φ) de un vector
+static void cartesianasAEsfericas(const vector3D& d, double& r, double& theta, double& phi) {
+    r = d.norm();
+    theta = (r == 0) ? 0 : std::acos(d.z() / r);
+    phi = std::atan2(d.y(), d.x());
+}
+
+FMM::FMM(int orden, double theta, int max_hoja)
+    : arbol_(max_hoja), P_(1), n_coef_(1), theta_(theta), energia_potencial_(0) {
+    fijarOrden(orden);
+}
+
+void FMM::fijarOrden(int orden) {
+    P_ = std::max(1, orden);
+    n_coef_ = P_ * (P_ + 1) / 2;
+    Ynm_.assign(P_ * P_, complejo(0, 0));
+    YnmTheta_.assign(P_ * P_, complejo(0, 0));
+}
+
+void FMM::calcularFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones) {
+    const int n = cuerpos.tamano();
+    arbol_.construir(cuerpos);
+    const std::vector<NodoOctree>& nodos = arbol_.nodos();
+    int n_celdas = static_cast<int>(nodos.size());
+
+    M_.assign(static_cast<size_t>(n_celdas) * n_coef_, complejo(0, 0));
+    L_.assign(static_cast<size_t>(n_celdas) * n_coef_, complejo(0, 0));
+    phi_.assign(n, 0.0);
+    grad_.assign(n, vector3D());
+    potencial_.resize(n);
+    if (n == 0) { energia_potencial_ = 0; return; }
+
+    // Pasada ascendente: los hijos siempre tienen índice mayor que su padre
+    for (int k = n_celdas - 1; k >= 0; --k) {
+        if (nodos[k].esHoja()) { P2M(k, cuerpos); }
+        else { M2M(k); }
+    }
+
+    recorridoDual(0, 0, cuerpos);
+
+    // Pasada descendente
+    for (int k = 0; k < n_celdas; ++k) {
+        if (nodos[k].esHoja()) { L2P(k, cuerpos); }
+        else { L2L(k); }
+    }
+
+    energia_potencial_ = 0;
+    for (int i = 0; i < n; ++i) {
+        potencial_[i] = -G * phi_[i];
+        energia_potencial_ += 0.5 * cuerpos.m[i] * potencial_[i];
+        aceleraciones.x[i] = G * grad_[i].x();
+        aceleraciones.y[i] = G * grad_[i].y();
+        aceleraciones.z[i] = G * grad_[i].z();
+    }
+}
+
+void FMM::recorridoDual(int i, int j, const SistemaCuerpos& cuerpos) {
+    const std::vector<NodoOctree>& nodos = arbol_.nodos();
+    const NodoOctree& Ci = nodos[i];
+    const NodoOctree& Cj = nodos[j];
+    const double raiz3 = std::sqrt(3.0);
+    double Ri = raiz3 * Ci.semilado;
+    double Rj = raiz3 * Cj.semilado;
+    double d2 = (Ci.centro - Cj.centro).norm2();
+
+    if ((Ri + Rj) * (Ri + Rj) < theta_ * theta_ * d2) {
+        M2L(i, j);
+    } else if (Ci.esHoja() && Cj.esHoja()) {
+        P2P(i, j, cuerpos);
+    } else if (Cj.esHoja() || (Ri >= Rj && !Ci.esHoja())) {
+        for (int c = Ci.primer_hijo; c < Ci.primer_hijo + Ci.n_hijos; ++c) { recorridoDual(c, j, cuerpos); }
+    } else {
+        for (int c = Cj.primer_hijo; c < Cj.primer_hijo + Cj.n_hijos; ++c) { recorridoDual(i, c, cuerpos); }
+    }
+}
+
+void FMM::P2P(int i, int j, const SistemaCuerpos& cuerpos) {
+    const std::vector<int>& indices = arbol_.indices();
+    const NodoOctree& Ci = arbol_.nodos()[i];
+    const NodoOctree& Cj = arbol_.nodos()[j];
+    for (int a = Ci.inicio; a < Ci.inicio + Ci.cuenta; ++a) {
+        int bi = indices[a];
+        double phi = 0;
+        vector3D grad;
+        for (int b = Cj.inicio; b < Cj.inicio + Cj.cuenta; ++b) {
+            int bj = indices[b];
+            vector3D dr = cuerpos.posicion(bj) - cuerpos.posicion(bi);
+            double r2 = dr.norm2();
+            if (r2 < 1e-12) { continue; } // Mismo umbral que calcularTodasLasFuerzas (incluye i == j)
+            double inv_r = 1.0 / std::sqrt(r2);
+            phi += cuerpos.m[bj] * inv_r;
+            grad += dr * (cuerpos.m[bj] * inv_r * inv_r * inv_r);
+        }
+        phi_[bi] += phi;
+        grad_[bi] += grad;
+    }
+}
+
+void FMM::evaluarMultipolo(double rho, double alfa, double beta) {
+    double x = std::cos(alfa);
+    double y = std::sin(alfa);
+    double inv_y = (y == 0) ? 0 : 1 / y;
+    double fact = 1;
+    double pn = 1;
+    double rhom = 1;
+    complejo ei = std::exp(complejo(0, beta));
+    complejo eim = 1.0;
+    for (int m = 0; m < P_; ++m) {
+        double p = pn;
+        int npn = m * m + 2 * m;
+        int nmn = m * m;
+        Ynm_[npn] = rhom * p * eim;
+        Ynm_[nmn] = std::conj(Ynm_[npn]);
+        double p1 = p;
+        p = x * (2 * m + 1) * p1;
+        YnmTheta_[npn] = rhom * (p - (m + 1) * x * p1) * inv_y * eim;
+        rhom *= rho;
+        double rhon = rhom;
+        for (int n = m + 1; n < P_; ++n) {
+            int npm = n * n + n + m;
+            int nmm = n * n + n - m;
+            rhon /= -(n + m);
+            Ynm_[npm] = rhon * p * eim;
+            Ynm_[nmm] = std::conj(Ynm_[npm]);
+            double p2 = p1;
+            p1 = p;
+            p = (x * (2 * n + 1) * p1 - (n + m) * p2) / (n - m + 1);
+            YnmTheta_[npm] = rhon * ((n - m + 1) * p - (n + 1) * x * p1) * inv_y * eim;
+            rhon *= rho;
+        }
+        rhom /= -(2 * m + 2) * (2 * m + 1);
+        pn = -pn * fact * y;
+        fact += 2;
+        eim *= ei;
+    }
+}
+
+void FMM::evaluarLocal(double rho, double alfa, double beta) {
+    double x = std::cos(alfa);
+    double y = std::sin(alfa);
+    double fact = 1;
+    double pn = 1;
+    double inv_r = -1.0 / rho;
+    double rhom = -inv_r;
+    complejo ei = std::exp(complejo(0, beta));
+    complejo eim = 1.0;
+    for (int m = 0; m < P_; ++m) {
+        double p = pn;
+        int npn = m * m + 2 * m;
+        int nmn = m * m;
+        Ynm_[npn] = rhom * p * eim;
+        Ynm_[nmn] = std::conj(Ynm_[npn]);
+        double p1 = p;
+        p = x * (2 * m + 1) * p1;
+        rhom *= inv_r;
+        double rhon = rhom;
+        for (int n = m + 1; n < P_; ++n) {
+            int npm = n * n + n + m;
+            int nmm = n * n + n - m;
+            Ynm_[npm] = rhon * p * eim;
+            Ynm_[nmm] = std::conj(Ynm_[npm]);
+            double p2 = p1;
+            p1 = p;
+            p = (x * (2 * n + 1) * p1 - (n + m) * p2) / (n - m + 1);
+            rhon *= inv_r * (n - m + 1);
+        }
+        pn = -pn * fact * y;
+        fact += 2;
+        eim *= ei;
+    }
+}
+
+void FMM::P2M(int celda, const SistemaCuerpos& cuerpos) {
+    const NodoOctree& C = arbol_.nodos()[celda];
+    const std::vector<int>& indices = arbol_.indices();
+    complejo* M = &M_[static_cast<size_t>(celda) * n_coef_];
+    for (int b = C.inicio; b < C.inicio + C.cuenta; ++b) {
+        int i = indices[b];
+        double rho, alfa, beta;
+        cartesianasAEsfericas(cuerpos.posicion(i) - C.centro, rho, alfa, beta);
+        evaluarMultipolo(rho, alfa, beta);
+        for (int n = 0; n < P_; ++n) {
+            for (int m = 0; m <= n; ++m) {
+                M[n * (n + 1) / 2 + m] += cuerpos.m[i] * Ynm_[n * n + n - m];
+            }
+        }
+    }
+}
+
+void FMM::M2M(int celda) {
+    const NodoOctree& Ci = arbol_.nodos()[celda];
+    complejo* Mi = &M_[static_cast<size_t>(celda) * n_coef_];
+    for (int hijo = Ci.primer_hijo; hijo < Ci.primer_hijo + Ci.n_hijos; ++hijo) {
+        const NodoOctree& Cj = arbol_.nodos()[hijo];
+        const complejo* Mj = &M_[static_cast<size_t>(hijo) * n_coef_];
+        double rho, alfa, beta;
+        cartesianasAEsfericas(Ci.centro - Cj.centro, rho, alfa, beta);
+        evaluarMultipolo(rho, alfa, beta);
+        for (int j = 0; j < P_; ++j) {
+            for (int k = 0; k <= j; ++k) {
+                complejo suma = 0;
+                for (int n = 0; n <= j; ++n) {
+                    for (int m = std::max(-n, -j + k + n); m <= std::min(k - 1, n); ++m) {
+                        int jnkms = (j - n) * (j - n + 1) / 2 + k - m;
+                        suma += Mj[jnkms] * Ynm_[n * n + n - m] * (potenciaNegativa(m) * paridad(n));
+                    }
+                    for (int m = k; m <= std::min(n, j + k - n); ++m) {
+                        int jnkms = (j - n) * (j - n + 1) / 2 - k + m;
+                        suma += std::conj(Mj[jnkms]) * Ynm_[n * n + n - m] * paridad(k + n + m);
+                    }
+                }
+                Mi[j * (j + 1) / 2 + k] += suma;
+            }
+        }
+    }
+}
+
+void FMM::M2L(int i, int j) {
+    const NodoOctree& Ci = arbol_.nodos()[i];
+    const NodoOctree& Cj = arbol_.nodos()[j];
+    complejo* Li = &L_[static_cast<size_t>(i) * n_coef_];
+    const complejo* Mj = &M_[static_cast<size_t>(j) * n_coef_];
+    double rho, alfa, beta;
+    cartesianasAEsfericas(Ci.centro - Cj.centro, rho, alfa, beta);
+    evaluarLocal(rho, alfa, beta);
+    for (int jj = 0; jj < P_; ++jj) {
+        double Cnm = paridad(jj);
+        for (int k = 0; k <= jj; ++k) {
+            complejo suma = 0;
+            for (int n = 0; n < P_ - jj; ++n) {
+                for (int m = -n; m < 0; ++m) {
+                    int jnkm = (jj + n) * (jj + n) + jj + n + m - k;
+                    suma += std::conj(Mj[n * (n + 1) / 2 - m]) * Cnm * Ynm_[jnkm];
+                }
+                for (int m = 0; m <= n; ++m) {
+                    int jnkm = (jj + n) * (jj + n) + jj + n + m - k;
+                    double Cnm2 = Cnm * paridad((k - m) * (k < m) + m);
+                    suma += Mj[n * (n + 1) / 2 + m] * Cnm2 * Ynm_[jnkm];
+                }
+            }
+            Li[jj * (jj + 1) / 2 + k] += suma;
+        }
+    }
+}
+
+void FMM::L2L(int celda) {
+    const NodoOctree& Cj = arbol_.nodos()[celda];
+    const complejo* Lj = &L_[static_cast<size_t>(celda) * n_coef_];
+    for (int hijo = Cj.primer_hijo; hijo < Cj.primer_hijo + Cj.n_hijos; ++hijo) {
+        const NodoOctree& Ci = arbol_.nodos()[hijo];
+        complejo* Li = &L_[static_cast<size_t>(hijo) * n_coef_];
+        double rho, alfa, beta;
+        cartesianasAEsfericas(Ci.centro - Cj.centro, rho, alfa, beta);
+        evaluarMultipolo(rho, alfa, beta);
+        for (int j = 0; j < P_; ++j) {
+            for (int k = 0; k <= j; ++k) {
+                complejo suma = 0;
+                for (int n = j; n < P_; ++n) {
+                    for (int m = j + k - n; m < 0; ++m) {
+                        int jnkm = (n - j) * (n - j) + n - j + m - k;
+                        suma += std::conj(Lj[n * (n + 1) / 2 - m]) * Ynm_[jnkm] * paridad(k);
+                    }
+                    for (int m = 0; m <= n; ++m) {
+                        if (n - j >= std::abs(m - k)) {
+                            int jnkm = (n - j) * (n - j) + n - j + m - k;
+                            suma += Lj[n * (n + 1) / 2 + m] * Ynm_[jnkm] * paridad((m - k) * (m < k));
+                        }
+                    }
+                }
+                Li[j * (j + 1) / 2 + k] += suma;
+            }
+        }
+    }
+}
+
+void FMM::L2P(int celda, const SistemaCuerpos& cuerpos) {
+    const NodoOctree& C = arbol_.nodos()[celda];
+    const std::vector<int>& indices = arbol_.indices();
+    const complejo* L = &L_[static_cast<size_t>(celda) * n_coef_];
+    const complejo I(0, 1);
+    for (int b = C.inicio; b < C.inicio + C.cuenta; ++b) {
+        int i = indices[b];
+        vector3D d = cuerpos.posicion(i) - C.centro;
+        // Sobre el eje z las derivadas angulares son indeterminadas (0·∞); un
+        // desplazamiento despreciable frente a la celda evita el caso singular
+        if (d.x() == 0 && d.y() == 0) { d.load(1e-12 * C.semilado, 0, d.z()); }
+        double r, theta, phi;
+        cartesianasAEsfericas(d, r, theta, phi);
+        evaluarMultipolo(r, theta, phi);
+        double potencial = 0;
+        double esf_r = 0, esf_theta = 0, esf_phi = 0; // Gradiente en coordenadas esféricas
+        for (int n = 0; n < P_; ++n) {
+            int nm = n * n + n;
+            int nms = n * (n + 1) / 2;
+            potencial += std::real(L[nms] * Ynm_[nm]);
+            esf_r += std::real(L[nms] * Ynm_[nm]) / r * n;
+            esf_theta += std::real(L[nms] * YnmTheta_[nm]);
+            for (int m = 1; m <= n; ++m) {
+                nm = n * n + n + m;
+                nms = n * (n + 1) / 2 + m;
+                potencial += 2 * std::real(L[nms] * Ynm_[nm]);
+                esf_r += 2 * std::real(L[nms] * Ynm_[nm]) / r * n;
+                esf_theta += 2 * std::real(L[nms] * YnmTheta_[nm]);
+                esf_phi += 2 * std::real(L[nms] * Ynm_[nm] * I) * m;
+            }
+        }
+        phi_[i] += potencial;
+
+        double st = std::sin(theta), ct = std::cos(theta);
+        double sp = std::sin(phi), cp = std::cos(phi);
+        double inv_st = 1 / st;
+        grad_[i] += vector3D(st * cp * esf_r + ct * cp / r * esf_theta - sp / r * inv_st * esf_phi,
+                             st * sp * esf_r + ct * sp / r * esf_theta + cp / r * inv_st * esf_phi,
+                             ct * esf_r - st / r * esf_theta);
+    }
+}
@@ -0,0 +1,235 @@
+#include "Fuerzas.h"
+#include "FuerzasSIMD.h"
+#include "utilidades.h" // Para G
+#include <cmath>
+#include <algorithm>
+
+const char* nombreMotorFuerzas(TipoMotorFuerzas motor) {
+    switch (motor) {
+        case MOTOR_DIRECTO: return "Suma directa";
+        case MOTOR_BARNES_HUT: return "Barnes-Hut";
+        case MOTOR_FMM: return "FMM";
+    }
+    return "Desconocido";
+}
+
+void calcularTodasLasFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones) {
+    calcularFuerzasSIMD(cuerpos, aceleraciones, nivelSIMDActivo());
+}
+
+double calcularFuerzasYEnergiaPotencial(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones) {
+    double energia_potencial = 0.0;
+    calcularFuerzasSIMD(cuerpos, aceleraciones, nivelSIMDActivo(), &energia_potencial);
+    return energia_potencial;
+}
+
+void calcularTodasLasFuerzas(std::vector<Cuerpo>& cuerpos_actuales, std::vector<vector3D>& fuerzas_a_calcular) {
+    int n = static_cast<int>(cuerpos_actuales.size());
+    for (int i = 0; i < n; ++i) { cuerpos_actuales[i].BorreFuerza(); }
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            vector3D dr = cuerpos_actuales[j].r - cuerpos_actuales[i].r;
+            double dist_cubed = std::pow(dr.norm(), 3);
+            if (dist_cubed < 1e-18) { continue; }
+            vector3D F_ij = dr * (G * cuerpos_actuales[i].m * cuerpos_actuales[j].m / dist_cubed);
+            cuerpos_actuales[i].F += F_ij;
+            cuerpos_actuales[j].F -= F_ij;
+        }
+    }
+    for (int i = 0; i < n; ++i) { fuerzas_a_calcular[i] = cuerpos_actuales[i].F; }
+}
+
+double calcularEnergiaCineticaTotal(const SistemaCuerpos& cuerpos) {
+    double K_total = 0.0;
+    const int n = cuerpos.tamano();
+    for (int i = 0; i < n; ++i) {
+        K_total += 0.5 * cuerpos.m[i] * (cuerpos.vx[i] * cuerpos.vx[i] + cuerpos.vy[i] * cuerpos.vy[i] + cuerpos.vz[i] * cuerpos.vz[i]);
+    }
+    return K_total;
+}
+
+double calcularEnergiaPotencialTotal(const SistemaCuerpos& cuerpos) {
+    double U_total = 0.0;
+    const int n = cuerpos.tamano();
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            double dx = cuerpos.x[i] - cuerpos.x[j];
+            double dy = cuerpos.y[i] - cuerpos.y[j];
+            double dz = cuerpos.z[i] - cuerpos.z[j];
+            double distancia = std::sqrt(dx * dx + dy * dy + dz * dz);
+            if (distancia < 1e-9) {
+                U_total -= G * cuerpos.m[i] * cuerpos.m[j] / 1e-9;
+            } else {
+                U_total -= G * cuerpos.m[i] * cuerpos.m[j] / distancia;
+            }
+        }
+    }
+    return U_total;
+}
+
+Diagnosticos calcularDiagnosticos(const SistemaCuerpos& cuerpos, double energia_potencial) {
+    double K = 0.0, masa_total = 0.0;
+    double px = 0, py = 0, pz = 0; // Momento lineal
+    double lx = 0, ly = 0, lz = 0; // Momento angular
+    double rx = 0, ry = 0, rz = 0; // Σ m·r
+    const int n = cuerpos.tamano();
+    for (int i = 0; i < n; ++i) {
+        const double m = cuerpos.m[i];
+        const double x = cuerpos.x[i], y = cuerpos.y[i], z = cuerpos.z[i];
+        const double vx = cuerpos.vx[i], vy = cuerpos.vy[i], vz = cuerpos.vz[i];
+        K += 0.5 * m * (vx * vx + vy * vy + vz * vz);
+        px += m * vx; py += m * vy; pz += m * vz;
+        lx += m * (y * vz - z * vy);
+        ly += m * (z * vx - x * vz);
+        lz += m * (x * vy - y * vx);
+        rx += m * x; ry += m * y; rz += m * z;
+        masa_total += m;
+    }
+    Diagnosticos d;
+    d.energia_cinetica = K;
+    d.energia_potencial = energia_potencial;
+    d.momento_lineal.load(px, py, pz);
+    d.momento_angular.load(lx, ly, lz);
+    if (masa_total > 0) { d.centro_masa.load(rx / masa_total, ry / masa_total, rz / masa_total); }
+    return d;
+}
+
+vector3D calcularAceleracionDirectaSobre(int i, const SistemaCuerpos& cuerpos) {
+    vector3D a_total;
+    const int n = cuerpos.tamano();
+    for (int j = 0; j < n; ++j) {
+        if (j == i) continue;
+        vector3D dr = cuerpos.posicion(j) - cuerpos.posicion(i);
+        double dist_cubed = std::pow(dr.norm(), 3);
+        if (dist_cubed < 1e-18) { continue; } // Mismo umbral que calcularTodasLasFuerzas
+        a_total += dr * (G * cuerpos.m[j] / dist_cubed);
+    }
+    return a_total;
+}
+
+void calcularFuerzasSobre(const SistemaCuerpos& cuerpos, const int* objetivos, int n_objetivos,
+                          Aceleraciones& aceleraciones) {
+    const int n = cuerpos.tamano();
+    const double* x = cuerpos.x.data();
+    const double* y = cuerpos.y.data();
+    const double* z = cuerpos.z.data();
+    const double* m = cuerpos.m.data();
+    for (int k = 0; k < n_objetivos; ++k) {
+        const int i = objetivos[k];
+        const double xi = x[i], yi = y[i], zi = z[i];
+        double ax = 0.0, ay = 0.0, az = 0.0;
+        for (int j = 0; j < n; ++j) {
+            const double dx = x[j] - xi, dy = y[j] - yi, dz = z[j] - zi;
+            const double r2 = dx * dx + dy * dy + dz * dz;
+            // r² < 1e-12 (incluido el propio cuerpo) se omite, como dist³ < 1e-18 en la suma completa
+            const double w = (r2 < 1e-12) ? 0.0 : G * m[j] / (r2 * std::sqrt(r2));
+            ax += dx * w; ay += dy * w; az += dz * w;
+        }
+        aceleraciones.x[i] = ax;
+        aceleraciones.y[i] = ay;
+        aceleraciones.z[i] = az;
+    }
+}
+
+void calcularAceleracionesYJerks(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                                 Aceleraciones& jerks, double* energia_potencial) {
+    const int n = cuerpos.tamano();
+    const double* x = cuerpos.x.data();
+    const double* y = cuerpos.y.data();
+    const double* z = cuerpos.z.data();
+    const double* vx = cuerpos.vx.data();
+    const double* vy = cuerpos.vy.data();
+    const double* vz = cuerpos.vz.data();
+    const double* m = cuerpos.m.data();
+    double* ax = aceleraciones.x.data();
+    double* ay = aceleraciones.y.data();
+    double* az = aceleraciones.z.data();
+    double* jx = jerks.x.data();
+    double* jy = jerks.y.data();
+    double* jz = jerks.z.data();
+    aceleraciones.borrar();
+    jerks.borrar();
+    double U = 0.0;
+    for (int i = 0; i < n; ++i) {
+        double axi = 0.0, ayi = 0.0, azi = 0.0;
+        double jxi = 0.0, jyi = 0.0, jzi = 0.0;
+        for (int j = i + 1; j < n; ++j) {
+            const double dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+            const double r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 < 1e-12) continue; // Mismo umbral que dist³ < 1e-18 en calcularTodasLasFuerzas
+            const double dvx = vx[j] - vx[i], dvy = vy[j] - vy[i], dvz = vz[j] - vz[i];
+            const double inv_r = 1.0 / std::sqrt(r2);
+            const double inv_r3 = G * inv_r * inv_r * inv_r;
+            const double rv = 3.0 * (dx * dvx + dy * dvy + dz * dvz) / r2;
+            // Aceleración y jerk por unidad de masa del otro cuerpo
+            const double fx = dx * inv_r3, fy = dy * inv_r3, fz = dz * inv_r3;
+            const double gx = (dvx - rv * dx) * inv_r3;
+            const double gy = (dvy - rv * dy) * inv_r3;
+            const double gz = (dvz - rv * dz) * inv_r3;
+            axi += m[j] * fx; ayi += m[j] * fy; azi += m[j] * fz;
+            jxi += m[j] * gx; jyi += m[j] * gy; jzi += m[j] * gz;
+            ax[j] -= m[i] * fx; ay[j] -= m[i] * fy; az[j] -= m[i] * fz;
+            jx[j] -= m[i] * gx; jy[j] -= m[i] * gy; jz[j] -= m[i] * gz;
+            U -= G * m[i] * m[j] * inv_r;
+        }
+        ax[i] += axi; ay[i] += ayi; az[i] += azi;
+        jx[i] += jxi; jy[i] += jyi; jz[i] += jzi;
+    }
+    if (energia_potencial) { *energia_potencial = U; }
+}
+
+double calcularPotencialDirectoEn(int i, const SistemaCuerpos& cuerpos) {
+    double potencial = 0.0;
+    const int n = cuerpos.tamano();
+    for (int j = 0; j < n; ++j) {
+        if (j == i) continue;
+        double distancia = (cuerpos.posicion(j) - cuerpos.posicion(i)).norm();
+        if (distancia < 1e-6) { continue; }
+        potencial -= G * cuerpos.m[j] / distancia;
+    }
+    return potencial;
+}
+
+ErrorFuerzas estimarErrorFuerzas(const SistemaCuerpos& cuerpos,
+                                 const Aceleraciones& aceleraciones_aprox,
+                                 int max_muestras) {
+    ErrorFuerzas error = {0.0, 0.0, 0};
+    const int n = cuerpos.tamano();
+    if (n == 0 || max_muestras <= 0) return error;
+
+    int paso = std::max(1, n / max_muestras);
+    double suma_cuadrados = 0.0;
+    for (int i = 0; i < n && error.muestras < max_muestras; i += paso) {
+        vector3D a_directa = calcularAceleracionDirectaSobre(i, cuerpos);
+        double norma = a_directa.norm();
+        if (norma == 0) continue; // Cuerpo aislado: el error relativo no está definido
+        vector3D a_aprox(aceleraciones_aprox.x[i], aceleraciones_aprox.y[i], aceleraciones_aprox.z[i]);
+        double relativo = (a_aprox - a_directa).norm() / norma;
+        suma_cuadrados += relativo * relativo;
+        error.error_max = std::max(error.error_max, relativo);
+        error.muestras++;
+    }
+    if (error.muestras > 0) { error.error_rms = std::sqrt(suma_cuadrados / error.muestras); }
+    return error;
+}
+
+ErrorFuerzas estimarErrorPotencial(const SistemaCuerpos& cuerpos,
+                                   const std::vector<double>& potenciales_aprox,
+                                   int max_muestras) {
+    ErrorFuerzas error = {0.0, 0.0, 0};
+    const int n = cuerpos.tamano();
+    if (n == 0 || max_muestras <= 0) return error;
+
+    int paso = std::max(1, n / max_muestras);
+    double suma_cuadrados = 0.0;
+    for (int i = 0; i < n && error.muestras < max_muestras; i += paso) {
+        double directo = calcularPotencialDirectoEn(i, cuerpos);
+        if (directo == 0) continue;
+        double relativo = std::fabs(potenciales_aprox[i] - directo) / std::fabs(directo);
+        suma_cuadrados += relativo * relativo;
+        error.error_max = std::max(error.error_max, relativo);
+        error.muestras++;
+    }
+    if (error.muestras > 0) { error.error_rms = std::sqrt(suma_cuadrados / error.muestras); }
+    return error;
+}
@@ -0,0 +1,648 @@
+#include "FuerzasSIMD.h"
+#include "utilidades.h" // Para G
+#include <cmath>
+#include <algorithm>
+#include <unistd.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NUCLEOS_X86 1
+#include <immintrin.h>
+#endif
+
+// dist³ < 1e-18 equivale a r² < 1e-12: mismo umbral que la versión escalar
+static const double UMBRAL_R2 = 1e-12;
+
+// Bytes por cuerpo que un bloque j mantiene en caché: x, y, z, m, ax, ay, az
+static const int BYTES_POR_CUERPO_BLOQUE = 7 * sizeof(double);
+
+/// Núcleo que acumula las interacciones del cuerpo i con los j de [j_ini, j_fin)
+/// y, si se instancia con potencial, resta su energía -G·mᵢ·Σ mⱼ/r en *energia
+typedef void (*NucleoFila)(int i, int j_ini, int j_fin,
+                           const double* x, const double* y, const double* z, const double* m,
+                           double* ax, double* ay, double* az, double* energia);
+
+static NivelSIMD nivel_activo = detectarNivelSIMD(); // Elegido al arrancar el programa
+
+NivelSIMD detectarNivelSIMD() {
+#ifdef NUCLEOS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+    return SIMD_ESCALAR;
+}
+
+NivelSIMD nivelSIMDActivo() { return nivel_activo; }
+
+NivelSIMD fijarNivelSIMD(NivelSIMD nivel) {
+    nivel_activo = std::min(nivel, detectarNivelSIMD());
+    return nivel_activo;
+}
+
+const char* nombreNivelSIMD(NivelSIMD nivel) {
+    switch (nivel) {
+        case SIMD_ESCALAR: return "Escalar";
+        case SIMD_SSE2: return "SSE2";
+        case SIMD_AVX2: return "AVX2";
+        case SIMD_AVX512: return "AVX-512";
+    }
+    return "Desconocido";
+}
+
+static int calcularTamanoBloqueJ() {
+    long l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (l1 <= 0) l1 = 32 * 1024;
+    // Se reserva la mitad de L1 para el bloque; el resto queda para los cuerpos i
+    int tamano = static_cast<int>(l1 / 2 / BYTES_POR_CUERPO_BLOQUE);
+    return std::max(64, tamano - tamano % 8);
+}
+
+int tamanoBloqueJ() {
+    // Estático local: se inicializa una sola vez aunque lo llamen varios hilos a la vez
+    static const int tamano = calcularTamanoBloqueJ();
+    return tamano;
+}
+
+// --- Núcleo escalar ---
+
+template <bool CON_POTENCIAL>
+static void filaEscalar(int i, int j_ini, int j_fin,
+                        const double* x, const double* y, const double* z, const double* m,
+                        double* ax, double* ay, double* az, double* energia) {
+    double axi = 0, ayi = 0, azi = 0, ui = 0;
+    for (int j = j_ini; j < j_fin; ++j) {
+        double dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+        double r2 = dx * dx + dy * dy + dz * dz;
+        double r = std::sqrt(r2);
+        double dist_cubed = r2 * r;
+        if (dist_cubed < 1e-18) { continue; }
+        double f = G / dist_cubed; // Fuerza del par dividida por mᵢmⱼ
+        if (CON_POTENCIAL) { ui += m[j] / r; }
+        axi += dx * (f * m[j]);
+        ayi += dy * (f * m[j]);
+        azi += dz * (f * m[j]);
+        ax[j] -= dx * (f * m[i]);
+        ay[j] -= dy * (f * m[i]);
+        az[j] -= dz * (f * m[i]);
+    }
+    ax[i] += axi; ay[i] += ayi; az[i] += azi;
+    if (CON_POTENCIAL) { *energia -= G * m[i] * ui; }
+}
+
+void calcularFuerzasEscalar(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones) {
+    const int n = cuerpos.tamano();
+    aceleraciones.borrar();
+    for (int i = 0; i < n; ++i) {
+        filaEscalar<false>(i, i + 1, n, cuerpos.x.data(), cuerpos.y.data(), cuerpos.z.data(), cuerpos.m.data(),
+                           aceleraciones.x.data(), aceleraciones.y.data(), aceleraciones.z.data(), 0);
+    }
+}
+
+// --- Núcleos vectorizados ---
+
+#ifdef NUCLEOS_X86
+
+template <bool CON_POTENCIAL>
+__attribute__((target("sse2")))
+static void filaSSE2(int i, int j_ini, int j_fin,
+                     const double* x, const double* y, const double* z, const double* m,
+                     double* ax, double* ay, double* az, double* energia) {
+    const __m128d xi = _mm_set1_pd(x[i]), yi = _mm_set1_pd(y[i]), zi = _mm_set1_pd(z[i]);
+    const __m128d mi = _mm_set1_pd(m[i]);
+    const __m128d g = _mm_set1_pd(G);
+    const __m128d umbral = _mm_set1_pd(UMBRAL_R2);
+    const __m128d tres_medios = _mm_set1_pd(1.5), medio = _mm_set1_pd(0.5);
+    __m128d axi = _mm_setzero_pd(), ayi = _mm_setzero_pd(), azi = _mm_setzero_pd(), ui = _mm_setzero_pd();
+
+    int j = j_ini;
+    for (; j + 2 <= j_fin; j += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + j), xi);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + j), yi);
+        __m128d dz = _mm_sub_pd(_mm_loadu_pd(z + j), zi);
+        __m128d r2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(dz, dz));
+        // Aproximación de 12 bits en precisión simple y tres pasos de Newton
+        __m128d inv_r = _mm_cvtps_pd(_mm_rsqrt_ps(_mm_cvtpd_ps(r2)));
+        for (int k = 0; k < 3; ++k) {
+            inv_r = _mm_mul_pd(inv_r, _mm_sub_pd(tres_medios, _mm_mul_pd(_mm_mul_pd(medio, r2), _mm_mul_pd(inv_r, inv_r))));
+        }
+        __m128d f = _mm_mul_pd(g, _mm_mul_pd(inv_r, _mm_mul_pd(inv_r, inv_r)));
+        __m128d validos = _mm_cmpge_pd(r2, umbral);
+        f = _mm_and_pd(f, validos);
+        __m128d mj = _mm_loadu_pd(m + j);
+        __m128d fmj = _mm_mul_pd(f, mj);
+        if (CON_POTENCIAL) { ui = _mm_add_pd(ui, _mm_and_pd(_mm_mul_pd(inv_r, mj), validos)); }
+        axi = _mm_add_pd(axi, _mm_mul_pd(dx, fmj));
+        ayi = _mm_add_pd(ayi, _mm_mul_pd(dy, fmj));
+        azi = _mm_add_pd(azi, _mm_mul_pd(dz, fmj));
+        __m128d fmi = _mm_mul_pd(f, mi);
+        _mm_storeu_pd(ax + j, _mm_sub_pd(_mm_loadu_pd(ax + j), _mm_mul_pd(dx, fmi)));
+        _mm_storeu_pd(ay + j, _mm_sub_pd(_mm_loadu_pd(ay + j), _mm_mul_pd(dy, fmi)));
+        _mm_storeu_pd(az + j, _mm_sub_pd(_mm_loadu_pd(az + j), _mm_mul_pd(dz, fmi)));
+    }
+    double tx[2], ty[2], tz[2];
+    _mm_storeu_pd(tx, axi); _mm_storeu_pd(ty, ayi); _mm_storeu_pd(tz, azi);
+    ax[i] += tx[0] + tx[1]; ay[i] += ty[0] + ty[1]; az[i] += tz[0] + tz[1];
+    if (CON_POTENCIAL) {
+        double tu[2];
+        _mm_storeu_pd(tu, ui);
+        *energia -= G * m[i] * (tu[0] + tu[1]);
+    }
+    if (j < j_fin) { filaEscalar<CON_POTENCIAL>(i, j, j_fin, x, y, z, m, ax, ay, az, energia); }
+}
+
+template <bool CON_POTENCIAL>
+__attribute__((target("avx2,fma")))
+static void filaAVX2(int i, int j_ini, int j_fin,
+                     const double* x, const double* y, const double* z, const double* m,
+                     double* ax, double* ay, double* az, double* energia) {
+    const __m256d xi = _mm256_set1_pd(x[i]), yi = _mm256_set1_pd(y[i]), zi = _mm256_set1_pd(z[i]);
+    const __m256d mi = _mm256_set1_pd(m[i]);
+    const __m256d g = _mm256_set1_pd(G);
+    const __m256d umbral = _mm256_set1_pd(UMBRAL_R2);
+    const __m256d tres_medios = _mm256_set1_pd(1.5), medio = _mm256_set1_pd(0.5);
+    __m256d axi = _mm256_setzero_pd(), ayi = _mm256_setzero_pd(), azi = _mm256_setzero_pd();
+    __m256d ui = _mm256_setzero_pd();
+
+    int j = j_ini;
+    for (; j + 4 <= j_fin; j += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), xi);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), yi);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + j), zi);
+        __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+        // Aproximación de 12 bits en precisión simple y tres pasos de Newton
+        __m256d inv_r = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(r2)));
+        __m256d medio_r2 = _mm256_mul_pd(medio, r2);
+        for (int k = 0; k < 3; ++k) {
+            inv_r = _mm256_mul_pd(inv_r, _mm256_fnmadd_pd(medio_r2, _mm256_mul_pd(inv_r, inv_r), tres_medios));
+        }
+        __m256d f = _mm256_mul_pd(g, _mm256_mul_pd(inv_r, _mm256_mul_pd(inv_r, inv_r)));
+        __m256d validos = _mm256_cmp_pd(r2, umbral, _CMP_GE_OQ);
+        f = _mm256_and_pd(f, validos);
+        __m256d mj = _mm256_loadu_pd(m + j);
+        __m256d fmj = _mm256_mul_pd(f, mj);
+        if (CON_POTENCIAL) { ui = _mm256_add_pd(ui, _mm256_and_pd(_mm256_mul_pd(inv_r, mj), validos)); }
+        axi = _mm256_fmadd_pd(dx, fmj, axi);
+        ayi = _mm256_fmadd_pd(dy, fmj, ayi);
+        azi = _mm256_fmadd_pd(dz, fmj, azi);
+        __m256d fmi = _mm256_mul_pd(f, mi);
+        _mm256_storeu_pd(ax + j, _mm256_fnmadd_pd(dx, fmi, _mm256_loadu_pd(ax + j)));
+        _mm256_storeu_pd(ay + j, _mm256_fnmadd_pd(dy, fmi, _mm256_loadu_pd(ay + j)));
+        _mm256_storeu_pd(az + j, _mm256_fnmadd_pd(dz, fmi, _mm256_loadu_pd(az + j)));
+    }
+    double tx[4], ty[4], tz[4];
+    _mm256_storeu_pd(tx, axi); _mm256_storeu_pd(ty, ayi); _mm256_storeu_pd(tz, azi);
+    ax[i] += (tx[0] + tx[1]) + (tx[2] + tx[3]);
+    ay[i] += (ty[0] + ty[1]) + (ty[2] + ty[3]);
+    az[i] += (tz[0] + tz[1]) + (tz[2] + tz[3]);
+    if (CON_POTENCIAL) {
+        double tu[4];
+        _mm256_storeu_pd(tu, ui);
+        *energia -= G * m[i] * ((tu[0] + tu[1]) + (tu[2] + tu[3]));
+    }
+    if (j < j_fin) { filaEscalar<CON_POTENCIAL>(i, j, j_fin, x, y, z, m, ax, ay, az, energia); }
+}
+
+template <bool CON_POTENCIAL>
+__attribute__((target("avx512f")))
+static void filaAVX512(int i, int j_ini, int j_fin,
+                       const double* x, const double* y, const double* z, const double* m,
+                       double* ax, double* ay, double* az, double* energia) {
+    const __m512d xi = _mm512_set1_pd(x[i]), yi = _mm512_set1_pd(y[i]), zi = _mm512_set1_pd(z[i]);
+    const __m512d mi = _mm512_set1_pd(m[i]);
+    const __m512d g = _mm512_set1_pd(G);
+    const __m512d umbral = _mm512_set1_pd(UMBRAL_R2);
+    const __m512d tres_medios = _mm512_set1_pd(1.5), medio = _mm512_set1_pd(0.5);
+    __m512d axi = _mm512_setzero_pd(), ayi = _mm512_setzero_pd(), azi = _mm512_setzero_pd();
+    __m512d ui = _mm512_setzero_pd();
+
+    // El último grupo incompleto se procesa con carriles enmascarados
+    for (int j = j_ini; j < j_fin; j += 8) {
+        __mmask8 carriles = (j_fin - j >= 8) ? 0xFF : static_cast<__mmask8>((1u << (j_fin - j)) - 1);
+        __m512d dx = _mm512_sub_pd(_mm512_maskz_loadu_pd(carriles, x + j), xi);
+        __m512d dy = _mm512_sub_pd(_mm512_maskz_loadu_pd(carriles, y + j), yi);
+        __m512d dz = _mm512_sub_pd(_mm512_maskz_loadu_pd(carriles, z + j), zi);
+        __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+        // Aproximación de 14 bits y dos pasos de Newton
+        __m512d inv_r = _mm512_maskz_rsqrt14_pd(carriles, r2);
+        __m512d medio_r2 = _mm512_mul_pd(medio, r2);
+        for (int k = 0; k < 2; ++k) {
+            inv_r = _mm512_mul_pd(inv_r, _mm512_fnmadd_pd(medio_r2, _mm512_mul_pd(inv_r, inv_r), tres_medios));
+        }
+        __mmask8 validos = carriles & _mm512_cmp_pd_mask(r2, umbral, _CMP_GE_OQ);
+        __m512d f = _mm512_maskz_mul_pd(validos, g, _mm512_mul_pd(inv_r, _mm512_mul_pd(inv_r, inv_r)));
+        __m512d mj = _mm512_maskz_loadu_pd(carriles, m + j);
+        __m512d fmj = _mm512_mul_pd(f, mj);
+        if (CON_POTENCIAL) { ui = _mm512_add_pd(ui, _mm512_maskz_mul_pd(validos, inv_r, mj)); }
+        axi = _mm512_fmadd_pd(dx, fmj, axi);
+        ayi = _mm512_fmadd_pd(dy, fmj, ayi);
+        azi = _mm512_fmadd_pd(dz, fmj, azi);
+        __m512d fmi = _mm512_mul_pd(f, mi);
+        _mm512_mask_storeu_pd(ax + j, carriles, _mm512_fnmadd_pd(dx, fmi, _mm512_maskz_loadu_pd(carriles, ax + j)));
+        _mm512_mask_storeu_pd(ay + j, carriles, _mm512_fnmadd_pd(dy, fmi, _mm512_maskz_loadu_pd(carriles, ay + j)));
+        _mm512_mask_storeu_pd(az + j, carriles, _mm512_fnmadd_pd(dz, fmi, _mm512_maskz_loadu_pd(carriles, az + j)));
+    }
+    double tx[8], ty[8], tz[8];
+    _mm512_storeu_pd(tx, axi); _mm512_storeu_pd(ty, ayi); _mm512_storeu_pd(tz, azi);
+    ax[i] += ((tx[0] + tx[1]) + (tx[2] + tx[3])) + ((tx[4] + tx[5]) + (tx[6] + tx[7]));
+    ay[i] += ((ty[0] + ty[1]) + (ty[2] + ty[3])) + ((ty[4] + ty[5]) + (ty[6] + ty[7]));
+    az[i] += ((tz[0] + tz[1]) + (tz[2] + tz[3])) + ((tz[4] + tz[5]) + (tz[6] + tz[7]));
+    if (CON_POTENCIAL) {
+        double tu[8];
+        _mm512_storeu_pd(tu, ui);
+        *energia -= G * m[i] * (((tu[0] + tu[1]) + (tu[2] + tu[3])) + ((tu[4] + tu[5]) + (tu[6] + tu[7])));
+    }
+}
+
+#endif // NUCLEOS_X86
+
+static NucleoFila nucleoFila(NivelSIMD nivel, bool con_potencial) {
+#ifdef NUCLEOS_X86
+    switch (nivel) {
+        case SIMD_AVX512: return con_potencial ? filaAVX512<true> : filaAVX512<false>;
+        case SIMD_AVX2: return con_potencial ? filaAVX2<true> : filaAVX2<false>;
+        case SIMD_SSE2: return con_potencial ? filaSSE2<true> : filaSSE2<false>;
+        case SIMD_ESCALAR: break;
+    }
+#else
+    (void)nivel;
+#endif
+    return con_potencial ? filaEscalar<true> : filaEscalar<false>;
+}
+
+void acumularFuerzasBloque(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones, NivelSIMD nivel,
+                           int i0, int i1, int j0, int j1, double* energia_potencial) {
+    NucleoFila fila = nucleoFila(nivel, energia_potencial != 0);
+    const double* x = cuerpos.x.data();
+    const double* y = cuerpos.y.data();
+    const double* z = cuerpos.z.data();
+    const double* m = cuerpos.m.data();
+    double* ax = aceleraciones.x.data();
+    double* ay = aceleraciones.y.data();
+    double* az = aceleraciones.z.data();
+    i1 = std::min(i1, j1 - 1);
+    for (int i = i0; i < i1; ++i) {
+        fila(i, std::max(i + 1, j0), j1, x, y, z, m, ax, ay, az, energia_potencial);
+    }
+}
+
+void calcularFuerzasSIMD(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones, NivelSIMD nivel,
+                         double* energia_potencial) {
+    const int n = cuerpos.tamano();
+    aceleraciones.borrar();
+    if (energia_potencial) { *energia_potencial = 0.0; }
+
+    // Recorrido por teselas: cada bloque de cuerpos j permanece en L1 mientras
+    // se recorren todos los i < j que interactúan con él (un solo nivel: los i
+    // se leen una vez por bloque y no hace falta retenerlos en L2)
+    const int bloque = tamanoBloqueJ();
+    for (int j0 = 0; j0 < n; j0 += bloque) {
+        int j1 = std::min(n, j0 + bloque);
+        acumularFuerzasBloque(cuerpos, aceleraciones, nivel, 0, j1, j0, j1, energia_potencial);
+    }
+}
+
+// --- Precisión mixta: pares en float, sumas por cuerpo en double ---
+
+/// Núcleo de precisión mixta: suma a la fila i las interacciones con los j
+/// de [j_ini, j_fin) (incluido j = i, que el umbral descarta); sin reacción
+typedef void (*NucleoFilaMixta)(int i, int j_ini, int j_fin,
+                                const float* x, const float* y, const float* z, const float* m,
+                                double* ax, double* ay, double* az, double* energia);
+
+void CoordenadasSimples::cargar(const SistemaCuerpos& cuerpos) {
+    const int n = cuerpos.tamano();
+    if (tamano() != n) {
+        x.resize(n); y.resize(n); z.resize(n); m.resize(n);
+    }
+    double masa = 0.0, cx = 0.0, cy = 0.0, cz = 0.0;
+    for (int i = 0; i < n; ++i) {
+        masa += cuerpos.m[i];
+        cx += cuerpos.m[i] * cuerpos.x[i];
+        cy += cuerpos.m[i] * cuerpos.y[i];
+        cz += cuerpos.m[i] * cuerpos.z[i];
+    }
+    if (masa > 0) { cx /= masa; cy /= masa; cz /= masa; }
+    for (int i = 0; i < n; ++i) {
+        x[i] = static_cast<float>(cuerpos.x[i] - cx);
+        y[i] = static_cast<float>(cuerpos.y[i] - cy);
+        z[i] = static_cast<float>(cuerpos.z[i] - cz);
+        m[i] = static_cast<float>(cuerpos.m[i]);
+    }
+}
+
+template <bool CON_POTENCIAL>
+static void filaMixtaEscalar(int i, int j_ini, int j_fin,
+                             const float* x, const float* y, const float* z, const float* m,
+                             double* ax, double* ay, double* az, double* energia) {
+    const float g = static_cast<float>(G), umbral = static_cast<float>(UMBRAL_R2);
+    float axi = 0, ayi = 0, azi = 0, ui = 0;
+    for (int j = j_ini; j < j_fin; ++j) {
+        float dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+        float r2 = dx * dx + dy * dy + dz * dz;
+        if (r2 < umbral) { continue; }
+        float inv_r = 1.0f / std::sqrt(r2);
+        float fmj = g * inv_r * inv_r * inv_r * m[j];
+        if (CON_POTENCIAL) { ui += m[j] * inv_r; }
+        axi += dx * fmj;
+        ayi += dy * fmj;
+        azi += dz * fmj;
+    }
+    ax[i] += static_cast<double>(axi);
+    ay[i] += static_cast<double>(ayi);
+    az[i] += static_cast<double>(azi);
+    // Cada par aparece en las filas de sus dos cuerpos: la mitad de la energía en cada una
+    if (CON_POTENCIAL) { *energia -= 0.5 * G * static_cast<double>(m[i]) * static_cast<double>(ui); }
+}
+
+#ifdef NUCLEOS_X86
+
+/// Suma de los 8 carriles de un registro float, en double
+__attribute__((target("avx2,fma")))
+static inline double sumarCarriles(__m256 v) {
+    __m256d d = _mm256_add_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+    double t[4];
+    _mm256_storeu_pd(t, d);
+    return (t[0] + t[1]) + (t[2] + t[3]);
+}
+
+template <bool CON_POTENCIAL>
+__attribute__((target("avx2,fma")))
+static void filaMixtaAVX2(int i, int j_ini, int j_fin,
+                          const float* x, const float* y, const float* z, const float* m,
+                          double* ax, double* ay, double* az, double* energia) {
+    const __m256 xi = _mm256_set1_ps(x[i]), yi = _mm256_set1_ps(y[i]), zi = _mm256_set1_ps(z[i]);
+    const __m256 g = _mm256_set1_ps(static_cast<float>(G));
+    const __m256 umbral = _mm256_set1_ps(static_cast<float>(UMBRAL_R2));
+    const __m256 tres_medios = _mm256_set1_ps(1.5f), medio = _mm256_set1_ps(0.5f);
+    __m256 axi = _mm256_setzero_ps(), ayi = _mm256_setzero_ps(), azi = _mm256_setzero_ps();
+    __m256 ui = _mm256_setzero_ps();
+
+    int j = j_ini;
+    for (; j + 8 <= j_fin; j += 8) {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + j), xi);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + j), yi);
+        __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + j), zi);
+        __m256 r2 = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, _mm256_mul_ps(dz, dz)));
+        // Aproximación de 12 bits y un paso de Newton (precisión simple completa);
+        // los pares bajo el umbral (entre ellos j = i) quedan con 1/r = 0
+        __m256 validos = _mm256_cmp_ps(r2, umbral, _CMP_GE_OQ);
+        __m256 inv_r = _mm256_and_ps(_mm256_rsqrt_ps(r2), validos);
+        inv_r = _mm256_mul_ps(inv_r, _mm256_fnmadd_ps(_mm256_mul_ps(medio, r2), _mm256_mul_ps(inv_r, inv_r), tres_medios));
+        __m256 mj = _mm256_loadu_ps(m + j);
+        __m256 fmj = _mm256_mul_ps(_mm256_mul_ps(g, mj), _mm256_mul_ps(inv_r, _mm256_mul_ps(inv_r, inv_r)));
+        if (CON_POTENCIAL) { ui = _mm256_fmadd_ps(inv_r, mj, ui); }
+        axi = _mm256_fmadd_ps(dx, fmj, axi);
+        ayi = _mm256_fmadd_ps(dy, fmj, ayi);
+        azi = _mm256_fmadd_ps(dz, fmj, azi);
+    }
+    ax[i] += sumarCarriles(axi);
+    ay[i] += sumarCarriles(ayi);
+    az[i] += sumarCarriles(azi);
+    if (CON_POTENCIAL) { *energia -= 0.5 * G * static_cast<double>(m[i]) * sumarCarriles(ui); }
+    if (j < j_fin) { filaMixtaEscalar<CON_POTENCIAL>(i, j, j_fin, x, y, z, m, ax, ay, az, energia); }
+}
+
+/// Suma de los 16 carriles de un registro float, en double
+__attribute__((target("avx512f")))
+static inline double sumarCarriles(__m512 v) {
+    // Las variantes enmascaradas con cero evitan un aviso espurio de GCC sobre
+    // los registros "undefined" de las versiones sin máscara
+    __m512d bajos = _mm512_maskz_cvtps_pd(0xFF, _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(v), 0)));
+    __m512d altos = _mm512_maskz_cvtps_pd(0xFF, _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(v), 1)));
+    double t[8];
+    _mm512_storeu_pd(t, _mm512_add_pd(bajos, altos));
+    return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+}
+
+template <bool CON_POTENCIAL>
+__attribute__((target("avx512f")))
+static void filaMixtaAVX512(int i, int j_ini, int j_fin,
+                            const float* x, const float* y, const float* z, const float* m,
+                            double* ax, double* ay, double* az, double* energia) {
+    const __m512 xi = _mm512_set1_ps(x[i]), yi = _mm512_set1_ps(y[i]), zi = _mm512_set1_ps(z[i]);
+    const __m512 g = _mm512_set1_ps(static_cast<float>(G));
+    const __m512 umbral = _mm512_set1_ps(static_cast<float>(UMBRAL_R2));
+    const __m512 tres_medios = _mm512_set1_ps(1.5f), medio = _mm512_set1_ps(0.5f);
+    __m512 axi = _mm512_setzero_ps(), ayi = _mm512_setzero_ps(), azi = _mm512_setzero_ps();
+    __m512 ui = _mm512_setzero_ps();
+
+    // El último grupo incompleto se procesa con carriles enmascarados
+    for (int j = j_ini; j < j_fin; j += 16) {
+        __mmask16 carriles = (j_fin - j >= 16) ? 0xFFFF : static_cast<__mmask16>((1u << (j_fin - j)) - 1);
+        __m512 dx = _mm512_sub_ps(_mm512_maskz_loadu_ps(carriles, x + j), xi);
+        __m512 dy = _mm512_sub_ps(_mm512_maskz_loadu_ps(carriles, y + j), yi);
+        __m512 dz = _mm512_sub_ps(_mm512_maskz_loadu_ps(carriles, z + j), zi);
+        __m512 r2 = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, _mm512_mul_ps(dz, dz)));
+        // Aproximación de 14 bits y un paso de Newton (precisión simple completa);
+        // los pares bajo el umbral (entre ellos j = i) quedan con 1/r = 0
+        __mmask16 validos = carriles & _mm512_cmp_ps_mask(r2, umbral, _CMP_GE_OQ);
+        __m512 inv_r = _mm512_maskz_rsqrt14_ps(validos, r2);
+        inv_r = _mm512_mul_ps(inv_r, _mm512_fnmadd_ps(_mm512_mul_ps(medio, r2), _mm512_mul_ps(inv_r, inv_r), tres_medios));
+        __m512 mj = _mm512_maskz_loadu_ps(carriles, m + j);
+        __m512 fmj = _mm512_mul_ps(_mm512_mul_ps(g, mj), _mm512_mul_ps(inv_r, _mm512_mul_ps(inv_r, inv_r)));
+        if (CON_POTENCIAL) { ui = _mm512_fmadd_ps(inv_r, mj, ui); }
+        axi = _mm512_fmadd_ps(dx, fmj, axi);
+        ayi = _mm512_fmadd_ps(dy, fmj, ayi);
+        azi = _mm512_fmadd_ps(dz, fmj, azi);
+    }
+    ax[i] += sumarCarriles(axi);
+    ay[i] += sumarCarriles(ayi);
+    az[i] += sumarCarriles(azi);
+    if (CON_POTENCIAL) { *energia -= 0.5 * G * static_cast<double>(m[i]) * sumarCarriles(ui); }
+}
+
+#endif // NUCLEOS_X86
+
+static NucleoFilaMixta nucleoFilaMixta(NivelSIMD nivel, bool con_potencial) {
+#ifdef NUCLEOS_X86
+    switch (nivel) {
+        case SIMD_AVX512: return con_potencial ? filaMixtaAVX512<true> : filaMixtaAVX512<false>;
+        case SIMD_AVX2: return con_potencial ? filaMixtaAVX2<true> : filaMixtaAVX2<false>;
+        case SIMD_SSE2:
+        case SIMD_ESCALAR: break;
+    }
+#else
+    (void)nivel;
+#endif
+    return con_potencial ? filaMixtaEscalar<true> : filaMixtaEscalar<false>;
+}
+
+void acumularFuerzasFilasMixtas(const CoordenadasSimples& simples, Aceleraciones& aceleraciones, NivelSIMD nivel,
+                                int i0, int i1, double* energia_potencial) {
+    NucleoFilaMixta fila = nucleoFilaMixta(nivel, energia_potencial != 0);
+    const int n = simples.tamano();
+    const float* x = simples.x.data();
+    const float* y = simples.y.data();
+    const float* z = simples.z.data();
+    const float* m = simples.m.data();
+    double* ax = aceleraciones.x.data();
+    double* ay = aceleraciones.y.data();
+    double* az = aceleraciones.z.data();
+    // Un bloque j en L1 por vez; al cerrar cada bloque la suma parcial en
+    // float de cada fila pasa a la suma en double del cuerpo. Un bloque de
+    // x, y, z, m en float ocupa 16 bytes por cuerpo frente a los 56 de
+    // calcularFuerzasSIMD: caben el triple de cuerpos
+    const int bloque = 3 * tamanoBloqueJ();
+    for (int j0 = 0; j0 < n; j0 += bloque) {
+        const int j1 = std::min(n, j0 + bloque);
+        for (int i = i0; i < i1; ++i) {
+            fila(i, j0, j1, x, y, z, m, ax, ay, az, energia_potencial);
+        }
+    }
+}
+
+void calcularFuerzasMixtas(const SistemaCuerpos& cuerpos, CoordenadasSimples& simples,
+                           Aceleraciones& aceleraciones, NivelSIMD nivel, double* energia_potencial) {
+    simples.cargar(cuerpos);
+    aceleraciones.borrar();
+    if (energia_potencial) { *energia_potencial = 0.0; }
+    acumularFuerzasFilasMixtas(simples, aceleraciones, nivel, 0, cuerpos.tamano(), energia_potencial);
+}
+
+// --- Listas de fuentes puntuales (grupos de Barnes-Hut) ---
+
+template <bool CON_POTENCIAL>
+static void fuentesEscalar(double xi, double yi, double zi, const double* x, const double* y, const double* z,
+                           const double* gm, int n, double* a, double* potencial) {
+    double axi = 0, ayi = 0, azi = 0, ui = 0;
+    for (int j = 0; j < n; ++j) {
+        double dx = x[j] - xi, dy = y[j] - yi, dz = z[j] - zi;
+        double r2 = dx * dx + dy * dy + dz * dz;
+        if (r2 < UMBRAL_R2) { continue; }
+        double r = std::sqrt(r2);
+        double f = gm[j] / (r2 * r);
+        if (CON_POTENCIAL) { ui += gm[j] / r; }
+        axi += dx * f;
+        ayi += dy * f;
+        azi += dz * f;
+    }
+    a[0] += axi; a[1] += ayi; a[2] += azi;
+    if (CON_POTENCIAL) { *potencial -= ui; }
+}
+
+#ifdef NUCLEOS_X86
+
+template <bool CON_POTENCIAL>
+__attribute__((target("avx2,fma")))
+static void fuentesAVX2(double xi_, double yi_, double zi_, const double* x, const double* y, const double* z,
+                        const double* gm, int n, double* a, double* potencial) {
+    const __m256d xi = _mm256_set1_pd(xi_), yi = _mm256_set1_pd(yi_), zi = _mm256_set1_pd(zi_);
+    const __m256d umbral = _mm256_set1_pd(UMBRAL_R2);
+    const __m256d tres_medios = _mm256_set1_pd(1.5), medio = _mm256_set1_pd(0.5);
+    __m256d axi = _mm256_setzero_pd(), ayi = _mm256_setzero_pd(), azi = _mm256_setzero_pd();
+    __m256d ui = _mm256_setzero_pd();
+
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), xi);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), yi);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + j), zi);
+        __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, _mm256_mul_pd(dz, dz)));
+        // Mismo inverso que filaAVX2: 12 bits en precisión simple y tres pasos de Newton
+        __m256d inv_r = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(r2)));
+        __m256d medio_r2 = _mm256_mul_pd(medio, r2);
+        for (int k = 0; k < 3; ++k) {
+            inv_r = _mm256_mul_pd(inv_r, _mm256_fnmadd_pd(medio_r2, _mm256_mul_pd(inv_r, inv_r), tres_medios));
+        }
+        // Con r² = 0 el inverso es NaN: se enmascaran los productos, no los factores
+        __m256d validos = _mm256_cmp_pd(r2, umbral, _CMP_GE_OQ);
+        __m256d gm_r = _mm256_and_pd(_mm256_mul_pd(_mm256_loadu_pd(gm + j), inv_r), validos);
+        __m256d f = _mm256_and_pd(_mm256_mul_pd(gm_r, _mm256_mul_pd(inv_r, inv_r)), validos);
+        if (CON_POTENCIAL) { ui = _mm256_add_pd(ui, gm_r); }
+        axi = _mm256_fmadd_pd(dx, f, axi);
+        ayi = _mm256_fmadd_pd(dy, f, ayi);
+        azi = _mm256_fmadd_pd(dz, f, azi);
+    }
+    double tx[4], ty[4], tz[4];
+    _mm256_storeu_pd(tx, axi); _mm256_storeu_pd(ty, ayi); _mm256_storeu_pd(tz, azi);
+    a[0] += (tx[0] + tx[1]) + (tx[2] + tx[3]);
+    a[1] += (ty[0] + ty[1]) + (ty[2] + ty[3]);
+    a[2] += (tz[0] + tz[1]) + (tz[2] + tz[3]);
+    if (CON_POTENCIAL) {
+        double tu[4];
+        _mm256_storeu_pd(tu, ui);
+        *potencial -= (tu[0] + tu[1]) + (tu[2] + tu[3]);
+    }
+    if (j < n) { fuentesEscalar<CON_POTENCIAL>(xi_, yi_, zi_, x + j, y + j, z + j, gm + j, n - j, a, potencial); }
+}
+
+template <bool CON_POTENCIAL>
+__attribute__((target("avx512f")))
+static void fuentesAVX512(double xi_, double yi_, double zi_, const double* x, const double* y, const double* z,
+                          const double* gm, int n, double* a, double* potencial) {
+    const __m512d xi = _mm512_set1_pd(xi_), yi = _mm512_set1_pd(yi_), zi = _mm512_set1_pd(zi_);
+    const __m512d umbral = _mm512_set1_pd(UMBRAL_R2);
+    const __m512d tres_medios = _mm512_set1_pd(1.5), medio = _mm512_set1_pd(0.5);
+    __m512d axi = _mm512_setzero_pd(), ayi = _mm512_setzero_pd(), azi = _mm512_setzero_pd();
+    __m512d ui = _mm512_setzero_pd();
+
+    for (int j = 0; j < n; j += 8) {
+        __mmask8 carriles = (n - j >= 8) ? 0xFF : static_cast<__mmask8>((1u << (n - j)) - 1);
+        __m512d dx = _mm512_sub_pd(_mm512_maskz_loadu_pd(carriles, x + j), xi);
+        __m512d dy = _mm512_sub_pd(_mm512_maskz_loadu_pd(carriles, y + j), yi);
+        __m512d dz = _mm512_sub_pd(_mm512_maskz_loadu_pd(carriles, z + j), zi);
+        __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, _mm512_mul_pd(dz, dz)));
+        // Mismo inverso que filaAVX512: 14 bits y dos pasos de Newton
+        __m512d inv_r = _mm512_maskz_rsqrt14_pd(carriles, r2);
+        __m512d medio_r2 = _mm512_mul_pd(medio, r2);
+        for (int k = 0; k < 2; ++k) {
+            inv_r = _mm512_mul_pd(inv_r, _mm512_fnmadd_pd(medio_r2, _mm512_mul_pd(inv_r, inv_r), tres_medios));
+        }
+        __mmask8 validos = carriles & _mm512_cmp_pd_mask(r2, umbral, _CMP_GE_OQ);
+        __m512d gm_r = _mm512_maskz_mul_pd(validos, _mm512_maskz_loadu_pd(carriles, gm + j), inv_r);
+        __m512d f = _mm512_maskz_mul_pd(validos, gm_r, _mm512_mul_pd(inv_r, inv_r));
+        if (CON_POTENCIAL) { ui = _mm512_add_pd(ui, gm_r); }
+        axi = _mm512_fmadd_pd(dx, f, axi);
+        ayi = _mm512_fmadd_pd(dy, f, ayi);
+        azi = _mm512_fmadd_pd(dz, f, azi);
+    }
+    double tx[8], ty[8], tz[8];
+    _mm512_storeu_pd(tx, axi); _mm512_storeu_pd(ty, ayi); _mm512_storeu_pd(tz, azi);
+    a[0] += ((tx[0] + tx[1]) + (tx[2] + tx[3])) + ((tx[4] + tx[5]) + (tx[6] + tx[7]));
+    a[1] += ((ty[0] + ty[1]) + (ty[2] + ty[3])) + ((ty[4] + ty[5]) + (ty[6] + ty[7]));
+    a[2] += ((tz[0] + tz[1]) + (tz[2] + tz[3])) + ((tz[4] + tz[5]) + (tz[6] + tz[7]));
+    if (CON_POTENCIAL) {
+        double tu[8];
+        _mm512_storeu_pd(tu, ui);
+        *potencial -= ((tu[0] + tu[1]) + (tu[2] + tu[3])) + ((tu[4] + tu[5]) + (tu[6] + tu[7]));
+    }
+}
+
+#endif // NUCLEOS_X86
+
+void acumularFuentes(NivelSIMD nivel, double xi, double yi, double zi, const double* x, const double* y,
+                     const double* z, const double* gm, int n, double* aceleracion, double* potencial) {
+#ifdef NUCLEOS_X86
+    switch (nivel) {
+        case SIMD_AVX512:
+            if (potencial) fuentesAVX512<true>(xi, yi, zi, x, y, z, gm, n, aceleracion, potencial);
+            else fuentesAVX512<false>(xi, yi, zi, x, y, z, gm, n, aceleracion, 0);
+            return;
+        case SIMD_AVX2:
+            if (potencial) fuentesAVX2<true>(xi, yi, zi, x, y, z, gm, n, aceleracion, potencial);
+            else fuentesAVX2<false>(xi, yi, zi, x, y, z, gm, n, aceleracion, 0);
+            return;
+        case SIMD_SSE2:
+        case SIMD_ESCALAR:
+            break;
+    }
+#else
+    (void)nivel;
+#endif
+    if (potencial) fuentesEscalar<true>(xi, yi, zi, x, y, z, gm, n, aceleracion, potencial);
+    else fuentesEscalar<false>(xi, yi, zi, x, y, z, gm, n, aceleracion, 0);
+}
+
+double diferenciaRelativaMaxima(const Aceleraciones& aceleraciones, const Aceleraciones& referencia) {
+    double maximo = 0.0;
+    const int n = referencia.tamano();
+    for (int i = 0; i < n; ++i) {
+        double rx = referencia.x[i], ry = referencia.y[i], rz = referencia.z[i];
+        double norma2 = rx * rx + ry * ry + rz * rz;
+        if (norma2 == 0) continue;
+        double dx = aceleraciones.x[i] - rx, dy = aceleraciones.y[i] - ry, dz = aceleraciones.z[i] - rz;
+        maximo = std::max(maximo, std::sqrt((dx * dx + dy * dy + dz * dz) / norma2));
+    }
+    return maximo;
+}
@@ -0,0 +1,67 @@
+#include "GrupoHilos.h"
+#include <algorithm>
+
+GrupoHilos::GrupoHilos(int hilos)
+    : tarea_(0), generacion_(0), pendientes_(0), salir_(false), hilos_(1) {
+    redimensionar(hilos);
+}
+
+GrupoHilos::~GrupoHilos() { detener(); }
+
+void GrupoHilos::redimensionar(int hilos) {
+    hilos = std::max(1, hilos);
+    if (hilos == hilos_ && static_cast<int>(trabajadores_.size()) == hilos_ - 1) return;
+    detener();
+    hilos_ = hilos;
+    salir_ = false;
+    for (int h = 1; h < hilos_; ++h) {
+        trabajadores_.push_back(std::thread(&GrupoHilos::bucleTrabajador, this, h, generacion_));
+    }
+}
+
+void GrupoHilos::ejecutar(const std::function<void(int)>& tarea) {
+    if (hilos_ == 1) { tarea(0); return; }
+    {
+        std::lock_guard<std::mutex> cerrojo(mutex_);
+        tarea_ = &tarea;
+        pendientes_ = hilos_ - 1;
+        generacion_++;
+    }
+    hay_tarea_.notify_all();
+    tarea(0);
+    std::unique_lock<std::mutex> cerrojo(mutex_);
+    tarea_terminada_.wait(cerrojo, [this] { return pendientes_ == 0; });
+    tarea_ = 0;
+}
+
+int GrupoHilos::hilosDisponibles() {
+    unsigned int nucleos = std::thread::hardware_concurrency();
+    return nucleos == 0 ? 1 : static_cast<int>(nucleos);
+}
+
+void GrupoHilos::bucleTrabajador(int h, long generacion_inicial) {
+    long vista = generacion_inicial; // Última generación vista por este hilo
+    for (;;) {
+        const std::function<void(int)>* tarea;
+        {
+            std::unique_lock<std::mutex> cerrojo(mutex_);
+            hay_tarea_.wait(cerrojo, [this, vista] { return salir_ || generacion_ != vista; });
+            if (salir_) return;
+            vista = generacion_;
+            tarea = tarea_;
+        }
+        (*tarea)(h);
+        std::lock_guard<std::mutex> cerrojo(mutex_);
+        if (--pendientes_ == 0) { tarea_terminada_.notify_one(); }
+    }
+}
+
+void GrupoHilos::detener() {
+    {
+        std::lock_guard<std::mutex> cerrojo(mutex_);
+        salir_ = true;
+    }
+    hay_tarea_.notify_all();
+    for (size_t k = 0; k < trabajadores_.size(); ++k) { trabajadores_[k].join(); }
+    trabajadores_.clear();
+}
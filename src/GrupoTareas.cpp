@@ -0,0 +1,87 @@
+#include "GrupoTareas.h"
+#include <algorithm>
+#include <chrono>
+
+GrupoTareas::GrupoTareas(int hilos)
+    : grupo_(hilos > 0 ? hilos : GrupoHilos::hilosDisponibles()), robos_(0), total_(0.0) {
+    colas_.reset(new ColaTareas[grupo_.tamano()]);
+    ocupado_.assign(grupo_.tamano(), 0.0);
+}
+
+double GrupoTareas::eficiencia() const {
+    double ocupado = 0.0;
+    for (size_t h = 0; h < ocupado_.size(); ++h) { ocupado += ocupado_[h]; }
+    return total_ > 0 ? ocupado / (total_ * ocupado_.size()) : 1.0;
+}
+
+void GrupoTareas::ejecutar(const std::vector<double>& costos, const std::function<void(int, int)>& tarea) {
+    typedef std::chrono::steady_clock reloj;
+    const int hilos = grupo_.tamano();
+    const int n = static_cast<int>(costos.size());
+
+    // Reparto LPT: de la más costosa a la más barata, a la cola con menos costo acumulado
+    std::vector<int> orden(n);
+    for (int k = 0; k < n; ++k) { orden[k] = k; }
+    std::stable_sort(orden.begin(), orden.end(), [&costos](int a, int b) { return costos[a] > costos[b]; });
+    for (int h = 0; h < hilos; ++h) {
+        colas_[h].tareas.clear();
+        colas_[h].pendiente = 0.0;
+    }
+    for (int k = 0; k < n; ++k) {
+        int destino = 0;
+        for (int h = 1; h < hilos; ++h) {
+            if (colas_[h].pendiente < colas_[destino].pendiente) destino = h;
+        }
+        colas_[destino].tareas.push_back(orden[k]);
+        colas_[destino].pendiente += costos[orden[k]];
+    }
+    robos_.store(0);
+    ocupado_.assign(hilos, 0.0);
+
+    const reloj::time_point inicio = reloj::now();
+    grupo_.ejecutar([this, &costos, &tarea](int h) {
+        for (int k = siguienteTarea(h, costos); k >= 0; k = siguienteTarea(h, costos)) {
+            const reloj::time_point inicio_tarea = reloj::now();
+            tarea(k, h);
+            ocupado_[h] += std::chrono::duration<double>(reloj::now() - inicio_tarea).count();
+        }
+    });
+    total_ = std::chrono::duration<double>(reloj::now() - inicio).count();
+}
+
+int GrupoTareas::siguienteTarea(int h, const std::vector<double>& costos) {
+    {
+        ColaTareas& propia = colas_[h];
+        std::lock_guard<std::mutex> cerrojo(propia.mutex);
+        if (!propia.tareas.empty()) {
+            const int k = propia.tareas.front();
+            propia.tareas.pop_front();
+            propia.pendiente -= costos[k];
+            return k;
+        }
+    }
+    // Cola propia vacía: se roba de la que más costo tiene pendiente. Las tareas
+    // no crean tareas nuevas, así que si todas están vacías el hilo termina.
+    for (;;) {
+        const int hilos = grupo_.tamano();
+        int victima = -1;
+        double mayor = 0.0;
+        for (int v = 0; v < hilos; ++v) {
+            if (v == h) continue;
+            std::lock_guard<std::mutex> cerrojo(colas_[v].mutex);
+            if (!colas_[v].tareas.empty() && (victima < 0 || colas_[v].pendiente > mayor)) {
+                victima = v;
+                mayor = colas_[v].pendiente;
+            }
+        }
+        if (victima < 0) return -1;
+        ColaTareas& cola = colas_[victima];
+        std::lock_guard<std::mutex> cerrojo(cola.mutex);
+        if (cola.tareas.empty()) continue; // Otro hilo se adelantó: se busca otra víctima
+        const int k = cola.tareas.front();
+        cola.tareas.pop_front();
+        cola.pendiente -= costos[k];
+        robos_++;
+        return k;
+    }
+}
@@ -0,0 +1,63 @@
+#include "Hermite.h"
+#include "PuntoControl.h"
+
+void IntegradorHermite::iniciar(const SistemaCuerpos& cuerpos) {
+    const int n = cuerpos.tamano();
+    x0_.assign(n, 0.0); y0_.assign(n, 0.0); z0_.assign(n, 0.0);
+    vx0_.assign(n, 0.0); vy0_.assign(n, 0.0); vz0_.assign(n, 0.0);
+    jerk_.redimensionar(n);
+    jerk_siguiente_.redimensionar(n);
+}
+
+void IntegradorHermite::predecir(SistemaCuerpos& cuerpos, double dt) {
+    const int n = cuerpos.tamano();
+    const double medio_dt2 = 0.5 * dt * dt;
+    const double sexto_dt3 = medio_dt2 * dt / 3.0;
+    for (int i = 0; i < n; ++i) {
+        x0_[i] = cuerpos.x[i]; y0_[i] = cuerpos.y[i]; z0_[i] = cuerpos.z[i];
+        vx0_[i] = cuerpos.vx[i]; vy0_[i] = cuerpos.vy[i]; vz0_[i] = cuerpos.vz[i];
+        if (cuerpos.inv_m[i] == 0) continue; // Como en Muevase_r, los cuerpos sin masa no se mueven
+        cuerpos.x[i] += cuerpos.vx[i] * dt + cuerpos.ax[i] * medio_dt2 + jerk_.x[i] * sexto_dt3;
+        cuerpos.y[i] += cuerpos.vy[i] * dt + cuerpos.ay[i] * medio_dt2 + jerk_.y[i] * sexto_dt3;
+        cuerpos.z[i] += cuerpos.vz[i] * dt + cuerpos.az[i] * medio_dt2 + jerk_.z[i] * sexto_dt3;
+        cuerpos.vx[i] += cuerpos.ax[i] * dt + jerk_.x[i] * medio_dt2;
+        cuerpos.vy[i] += cuerpos.ay[i] * dt + jerk_.y[i] * medio_dt2;
+        cuerpos.vz[i] += cuerpos.az[i] * dt + jerk_.z[i] * medio_dt2;
+    }
+}
+
+void IntegradorHermite::corregir(SistemaCuerpos& cuerpos, double dt, const Aceleraciones& a_siguiente) {
+    const int n = cuerpos.tamano();
+    const double medio_dt = 0.5 * dt;
+    const double dt2_12 = dt * dt / 12.0;
+    for (int i = 0; i < n; ++i) {
+        if (cuerpos.inv_m[i] == 0) continue;
+        cuerpos.vx[i] = vx0_[i] + (cuerpos.ax[i] + a_siguiente.x[i]) * medio_dt + (jerk_.x[i] - jerk_siguiente_.x[i]) * dt2_12;
+        cuerpos.vy[i] = vy0_[i] + (cuerpos.ay[i] + a_siguiente.y[i]) * medio_dt + (jerk_.y[i] - jerk_siguiente_.y[i]) * dt2_12;
+        cuerpos.vz[i] = vz0_[i] + (cuerpos.az[i] + a_siguiente.z[i]) * medio_dt + (jerk_.z[i] - jerk_siguiente_.z[i]) * dt2_12;
+        cuerpos.x[i] = x0_[i] + (vx0_[i] + cuerpos.vx[i]) * medio_dt + (cuerpos.ax[i] - a_siguiente.x[i]) * dt2_12;
+        cuerpos.y[i] = y0_[i] + (vy0_[i] + cuerpos.vy[i]) * medio_dt + (cuerpos.ay[i] - a_siguiente.y[i]) * dt2_12;
+        cuerpos.z[i] = z0_[i] + (vz0_[i] + cuerpos.vz[i]) * medio_dt + (cuerpos.az[i] - a_siguiente.z[i]) * dt2_12;
+    }
+    jerk_.x.swap(jerk_siguiente_.x);
+    jerk_.y.swap(jerk_siguiente_.y);
+    jerk_.z.swap(jerk_siguiente_.z);
+}
+
+void IntegradorHermite::guardarEstado(EstadoSerializado& estado) const {
+    estado.escribirVector(x0_); estado.escribirVector(y0_); estado.escribirVector(z0_);
+    estado.escribirVector(vx0_); estado.escribirVector(vy0_); estado.escribirVector(vz0_);
+    estado.escribirVector(jerk_.x); estado.escribirVector(jerk_.y); estado.escribirVector(jerk_.z);
+    estado.escribirVector(jerk_siguiente_.x); estado.escribirVector(jerk_siguiente_.y);
+    estado.escribirVector(jerk_siguiente_.z);
+}
+
+bool IntegradorHermite::cargarEstado(EstadoSerializado& estado, int n) {
+    const unsigned long long maximo = static_cast<unsigned long long>(n);
+    estado.leerVector(x0_, maximo); estado.leerVector(y0_, maximo); estado.leerVector(z0_, maximo);
+    estado.leerVector(vx0_, maximo); estado.leerVector(vy0_, maximo); estado.leerVector(vz0_, maximo);
+    estado.leerVector(jerk_.x, maximo); estado.leerVector(jerk_.y, maximo); estado.leerVector(jerk_.z, maximo);
+    estado.leerVector(jerk_siguiente_.x, maximo); estado.leerVector(jerk_siguiente_.y, maximo);
+    estado.leerVector(jerk_siguiente_.z, maximo);
+    return estado.valido() && jerk_.tamano() == n && jerk_siguiente_.tamano() == n;
+}
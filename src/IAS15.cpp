@@ -0,0 +1,336 @@
+#include "IAS15.h"
+#include "PuntoControl.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/// Nodos de Gauss-Radau en [0, 1] (raíces de P₇ + P₈ en 2τ - 1), con h₀ = 0
+const double NODOS[8] = {
+    0.0,
+    0.0562625605369221464656521910318,
+    0.180240691736892364987579942780,
+    0.352624717113169637373907769648,
+    0.547153626330555383001448554766,
+    0.734210177215410531523210605558,
+    0.885320946839095768090359771030,
+    0.977520613561287501891174488626
+};
+
+const double SEGURIDAD = 0.25;      ///< Rechazo si el paso propuesto es menor que h/4; crecimiento máximo 4h
+const double CONVERGENCIA = 1e-16;  ///< Corrección relativa de b₆ a la que se detiene el predictor-corrector
+const int MAX_ITERACIONES = 12;     ///< Iteraciones máximas del predictor-corrector
+const double PASO_LIMITE = 1e-10;   ///< Paso mínimo, relativo al dt de la simulación
+
+/**
+ * @brief Matrices de cambio entre las bases de Newton (g) y de potencias (b)
+ * @details Con Pⱼ(τ) = τ·(τ - h₁)···(τ - hⱼ), a(τ) - a₀ = Σ gⱼ·Pⱼ(τ) = Σ bₖ·τ^(k+1).
+ *          Se obtienen por recurrencia a partir de los nodos en lugar de copiar
+ *          las tablas de 21 coeficientes de la literatura.
+ */
+struct TablasRadau {
+    double c[7][7];        ///< bₖ = Σ_{j≥k} c[j][k]·gⱼ  (coeficiente de τ^(k+1) en Pⱼ)
+    double d[7][7];        ///< gⱼ = Σ_{k≥j} d[k][j]·bₖ  (coeficiente de Pⱼ en τ^(k+1))
+    double binomial[8][8]; ///< Coeficientes binomiales para reescalar los b
+
+    TablasRadau() {
+        for (int j = 0; j < 7; ++j) {
+            for (int k = 0; k < 7; ++k) { c[j][k] = 0.0; d[j][k] = 0.0; }
+        }
+        // Pⱼ = Pⱼ₋₁·(τ - hⱼ)
+        c[0][0] = 1.0;
+        for (int j = 1; j < 7; ++j) {
+            for (int k = 0; k <= j; ++k) {
+                c[j][k] = (k > 0 ? c[j - 1][k - 1] : 0.0) - NODOS[j] * c[j - 1][k];
+            }
+        }
+        // τ·Pⱼ = Pⱼ₊₁ + hⱼ₊₁·Pⱼ
+        d[0][0] = 1.0;
+        for (int k = 1; k < 7; ++k) {
+            for (int j = 0; j <= k; ++j) {
+                d[k][j] = (j > 0 ? d[k - 1][j - 1] : 0.0) + NODOS[j + 1] * d[k - 1][j];
+            }
+        }
+        for (int n = 0; n < 8; ++n) {
+            binomial[n][0] = 1.0;
+            for (int k = 1; k <= n; ++k) {
+                binomial[n][k] = binomial[n][k - 1] * (n - k + 1) / k;
+            }
+            for (int k = n + 1; k < 8; ++k) binomial[n][k] = 0.0;
+        }
+    }
+};
+
+const TablasRadau& tablas() {
+    static const TablasRadau t;
+    return t;
+}
+
+/// Suma compensada de Kahan: p += incremento, acumulando el error de redondeo en comp
+inline void sumarCompensado(double& p, double& comp, double incremento) {
+    const double y = incremento - comp;
+    const double t = p + y;
+    comp = (t - p) - y;
+    p = t;
+}
+
+} // namespace
+
+IntegradorIAS15::IntegradorIAS15(double tolerancia)
+    : tolerancia_(tolerancia), n_(0), paso_(0.0), paso_anterior_(0.0), paso_limite_(0.0),
+      pasos_aceptados_(0), pasos_rechazados_(0), pasos_sin_convergencia_(0),
+      iteraciones_(0), paso_minimo_(0.0), paso_maximo_(0.0) {}
+
+void IntegradorIAS15::configurar(double tolerancia) {
+    tolerancia_ = tolerancia;
+}
+
+void IntegradorIAS15::iniciar(const SistemaCuerpos& cuerpos, double dt) {
+    n_ = cuerpos.tamano();
+    const int total = 3 * n_;
+    x0_.assign(total, 0.0); v0_.assign(total, 0.0); a0_.assign(total, 0.0);
+    comp_x_.assign(total, 0.0); comp_v_.assign(total, 0.0);
+    for (int k = 0; k < 7; ++k) {
+        g_[k].assign(total, 0.0);
+        b_[k].assign(total, 0.0);
+        e_[k].assign(total, 0.0);
+        br_[k].assign(total, 0.0);
+        er_[k].assign(total, 0.0);
+    }
+    tablas(); // Las tablas se construyen aquí y no en el primer paso
+    paso_ = dt;
+    paso_anterior_ = 0.0;
+    paso_limite_ = PASO_LIMITE * dt;
+    pasos_aceptados_ = 0;
+    pasos_rechazados_ = 0;
+    pasos_sin_convergencia_ = 0;
+    iteraciones_ = 0;
+    paso_minimo_ = std::numeric_limits<double>::infinity();
+    paso_maximo_ = 0.0;
+}
+
+void IntegradorIAS15::predecirCoeficientes(double h) {
+    const int total = 3 * n_;
+    if (paso_anterior_ == 0.0) {
+        // Primer paso: sin información previa se parte de a constante
+        for (int k = 0; k < 7; ++k) {
+            std::fill(b_[k].begin(), b_[k].end(), 0.0);
+            std::fill(e_[k].begin(), e_[k].end(), 0.0);
+        }
+        return;
+    }
+    // a(1 + q·τ) = a₁ + Σᵢ [q^(i+1)·Σ_{j≥i} C(j+1, i+1)·bⱼ]·τ^(i+1)
+    const TablasRadau& t = tablas();
+    const double q = h / paso_anterior_;
+    double potencia_q[7];
+    potencia_q[0] = q;
+    for (int i = 1; i < 7; ++i) potencia_q[i] = potencia_q[i - 1] * q;
+    for (int idx = 0; idx < total; ++idx) {
+        for (int i = 0; i < 7; ++i) {
+            double suma = 0.0;
+            for (int j = i; j < 7; ++j) suma += t.binomial[j + 1][i + 1] * br_[j][idx];
+            e_[i][idx] = potencia_q[i] * suma;
+            // Se conserva la corrección que el predictor-corrector aplicó a la predicción anterior
+            b_[i][idx] = e_[i][idx] + (br_[i][idx] - er_[i][idx]);
+        }
+    }
+}
+
+bool IntegradorIAS15::intentarPaso(SistemaCuerpos& cuerpos, Aceleraciones& a_nodo, double h,
+                                   EvaluadorFuerzas evaluar, double& h_propuesto) {
+    const TablasRadau& t = tablas();
+    const int n = n_;
+    const int total = 3 * n;
+    double* const pos[3] = {cuerpos.x.data(), cuerpos.y.data(), cuerpos.z.data()};
+    double* const vel[3] = {cuerpos.vx.data(), cuerpos.vy.data(), cuerpos.vz.data()};
+    const double* const acel[3] = {cuerpos.ax.data(), cuerpos.ay.data(), cuerpos.az.data()};
+
+    predecirCoeficientes(h);
+    for (int c = 0; c < 3; ++c) {
+        for (int i = 0; i < n; ++i) {
+            const int idx = c * n + i;
+            x0_[idx] = pos[c][i];
+            v0_[idx] = vel[c][i];
+            a0_[idx] = acel[c][i];
+        }
+    }
+    for (int idx = 0; idx < total; ++idx) {
+        for (int j = 0; j < 7; ++j) {
+            double suma = 0.0;
+            for (int k = j; k < 7; ++k) suma += t.d[k][j] * b_[k][idx];
+            g_[j][idx] = suma;
+        }
+    }
+
+    // Predictor-corrector: se detiene al llegar al redondeo o cuando la corrección deja de bajar
+    double error_pc = std::numeric_limits<double>::infinity();
+    double error_pc_anterior = 2.0;
+    double max_a = 0.0;
+    int iteraciones = 0;
+    while (true) {
+        if (error_pc < CONVERGENCIA) break;
+        if (iteraciones > 2 && error_pc_anterior <= error_pc) break;
+        if (iteraciones >= MAX_ITERACIONES) { pasos_sin_convergencia_++; break; }
+        error_pc_anterior = error_pc;
+        iteraciones++;
+
+        for (int nodo = 1; nodo <= 7; ++nodo) {
+            // Posiciones en el nodo: r₀ + V₀·s·h + (s·h)²·(a₀/2 + b₀s/6 + b₁s²/12 + … + b₆s⁷/72)
+            const double s = NODOS[nodo];
+            const double sh = s * h;
+            for (int c = 0; c < 3; ++c) {
+                for (int i = 0; i < n; ++i) {
+                    if (cuerpos.inv_m[i] == 0) continue; // Como en Muevase_r, los cuerpos sin masa no se mueven
+                    const int idx = c * n + i;
+                    const double polinomio =
+                        a0_[idx] / 2.0 + s * (b_[0][idx] / 6.0 + s * (b_[1][idx] / 12.0 + s * (b_[2][idx] / 20.0
+                        + s * (b_[3][idx] / 30.0 + s * (b_[4][idx] / 42.0 + s * (b_[5][idx] / 56.0
+                        + s * b_[6][idx] / 72.0))))));
+                    pos[c][i] = x0_[idx] + sh * (v0_[idx] + sh * polinomio);
+                }
+            }
+            evaluar(cuerpos, a_nodo, false);
+
+            // Diferencia dividida g_{nodo-1} y su efecto en b₀..b_{nodo-1}
+            const double* const a_n[3] = {a_nodo.x.data(), a_nodo.y.data(), a_nodo.z.data()};
+            const double* const r = NODOS;
+            const int fila = nodo - 1;
+            double max_correccion = 0.0;
+            if (nodo == 7) max_a = 0.0;
+            for (int c = 0; c < 3; ++c) {
+                for (int i = 0; i < n; ++i) {
+                    const int idx = c * n + i;
+                    double dif = (a_n[c][i] - a0_[idx]) / r[nodo];
+                    for (int j = 0; j < fila; ++j) dif = (dif - g_[j][idx]) / (r[nodo] - r[j + 1]);
+                    const double correccion = dif - g_[fila][idx];
+                    g_[fila][idx] = dif;
+                    for (int k = 0; k <= fila; ++k) b_[k][idx] += correccion * t.c[fila][k];
+                    if (nodo == 7 && cuerpos.inv_m[i] != 0) {
+                        max_correccion = std::max(max_correccion, std::fabs(correccion));
+                        max_a = std::max(max_a, std::fabs(a_n[c][i]));
+                    }
+                }
+            }
+            if (nodo == 7) error_pc = (max_a > 0) ? max_correccion / max_a : 0.0;
+        }
+    }
+    iteraciones_ += iteraciones;
+
+    // Control de paso con el término de mayor grado
+    double max_b6 = 0.0;
+    for (int c = 0; c < 3; ++c) {
+        for (int i = 0; i < n; ++i) {
+            if (cuerpos.inv_m[i] != 0) max_b6 = std::max(max_b6, std::fabs(b_[6][c * n + i]));
+        }
+    }
+    const double error = (max_a > 0) ? max_b6 / max_a : 0.0;
+    if (!(error == error)) {
+        h_propuesto = 0.5 * SEGURIDAD * h; // NaN: el paso cruzó una singularidad
+    } else if (error > 0) {
+        h_propuesto = h * std::pow(tolerancia_ / error, 1.0 / 7.0);
+    } else {
+        h_propuesto = h / SEGURIDAD;
+    }
+    if (std::fabs(h_propuesto / h) < SEGURIDAD || !(error == error)) {
+        for (int c = 0; c < 3; ++c) {
+            for (int i = 0; i < n; ++i) pos[c][i] = x0_[c * n + i];
+        }
+        pasos_rechazados_++;
+        return false;
+    }
+
+    // Paso aceptado: r y V al final del paso, con suma compensada
+    for (int c = 0; c < 3; ++c) {
+        for (int i = 0; i < n; ++i) {
+            const int idx = c * n + i;
+            pos[c][i] = x0_[idx];
+            if (cuerpos.inv_m[i] == 0) continue;
+            const double dx = h * (v0_[idx] + h * (a0_[idx] / 2.0 + b_[0][idx] / 6.0 + b_[1][idx] / 12.0
+                              + b_[2][idx] / 20.0 + b_[3][idx] / 30.0 + b_[4][idx] / 42.0
+                              + b_[5][idx] / 56.0 + b_[6][idx] / 72.0));
+            const double dv = h * (a0_[idx] + b_[0][idx] / 2.0 + b_[1][idx] / 3.0 + b_[2][idx] / 4.0
+                              + b_[3][idx] / 5.0 + b_[4][idx] / 6.0 + b_[5][idx] / 7.0 + b_[6][idx] / 8.0);
+            sumarCompensado(pos[c][i], comp_x_[idx], dx);
+            sumarCompensado(vel[c][i], comp_v_[idx], dv);
+        }
+    }
+    // Los b convergidos y su predicción sirven para predecir el paso siguiente
+    for (int k = 0; k < 7; ++k) {
+        br_[k].swap(b_[k]);
+        er_[k].swap(e_[k]);
+    }
+    paso_anterior_ = h;
+    pasos_aceptados_++;
+    return true;
+}
+
+double IntegradorIAS15::avanzar(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double intervalo,
+                              bool con_potencial, EvaluadorFuerzas evaluar) {
+    double t = 0.0;
+    while (t < intervalo) {
+        const double restante = intervalo - t;
+        // Pasos iguales hasta el final del intervalo, en lugar de uno largo y otro muy corto
+        const double pasos_restantes = std::ceil(restante / paso_);
+        const double h = (pasos_restantes <= 1.0) ? restante : restante / pasos_restantes;
+        const bool recortado = pasos_restantes <= 1.0 && h < paso_;
+        double h_propuesto = 0.0;
+        if (!intentarPaso(cuerpos, a_siguiente, h, evaluar, h_propuesto)) {
+            paso_ = h_propuesto;
+            if (paso_ < paso_limite_) return t; // Choque: no se puede resolver con el paso mínimo
+            continue;
+        }
+        if (!recortado) {
+            paso_minimo_ = std::min(paso_minimo_, h);
+            paso_maximo_ = std::max(paso_maximo_, h);
+        }
+        t = (h == restante) ? intervalo : t + h;
+        // Un paso recortado no limita el crecimiento del siguiente
+        paso_ = std::min(h_propuesto, paso_ / SEGURIDAD);
+        evaluar(cuerpos, a_siguiente, con_potencial && t >= intervalo);
+        cuerpos.intercambiarAceleraciones(a_siguiente);
+    }
+    return intervalo;
+}
+
+void IntegradorIAS15::guardarEstado(EstadoSerializado& estado) const {
+    estado.escribir(tolerancia_);
+    estado.escribir(n_);
+    estado.escribir(paso_);
+    estado.escribir(paso_anterior_);
+    estado.escribir(paso_limite_);
+    estado.escribirVector(x0_); estado.escribirVector(v0_); estado.escribirVector(a0_);
+    estado.escribirVector(comp_x_); estado.escribirVector(comp_v_);
+    for (int k = 0; k < 7; ++k) {
+        estado.escribirVector(g_[k]); estado.escribirVector(b_[k]); estado.escribirVector(e_[k]);
+        estado.escribirVector(br_[k]); estado.escribirVector(er_[k]);
+    }
+    estado.escribir(pasos_aceptados_);
+    estado.escribir(pasos_rechazados_);
+    estado.escribir(pasos_sin_convergencia_);
+    estado.escribir(iteraciones_);
+    estado.escribir(paso_minimo_);
+    estado.escribir(paso_maximo_);
+}
+
+bool IntegradorIAS15::cargarEstado(EstadoSerializado& estado, int n) {
+    const unsigned long long maximo = 3ULL * static_cast<unsigned long long>(n);
+    estado.leer(tolerancia_);
+    estado.leer(n_);
+    estado.leer(paso_);
+    estado.leer(paso_anterior_);
+    estado.leer(paso_limite_);
+    estado.leerVector(x0_, maximo); estado.leerVector(v0_, maximo); estado.leerVector(a0_, maximo);
+    estado.leerVector(comp_x_, maximo); estado.leerVector(comp_v_, maximo);
+    for (int k = 0; k < 7; ++k) {
+        estado.leerVector(g_[k], maximo); estado.leerVector(b_[k], maximo); estado.leerVector(e_[k], maximo);
+        estado.leerVector(br_[k], maximo); estado.leerVector(er_[k], maximo);
+    }
+    estado.leer(pasos_aceptados_);
+    estado.leer(pasos_rechazados_);
+    estado.leer(pasos_sin_convergencia_);
+    estado.leer(iteraciones_);
+    estado.leer(paso_minimo_);
+    estado.leer(paso_maximo_);
+    return estado.valido() && n_ == n && static_cast<int>(er_[6].size()) == 3 * n;
+}
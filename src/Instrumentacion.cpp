@@ -0,0 +1,236 @@
+#include "Instrumentacion.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+const char* nombreFase(FaseSimulacion fase) {
+    switch (fase) {
+        case FASE_VERIFICACION: return "verificacion";
+        case FASE_INICIO: return "inicio";
+        case FASE_BUCLE: return "bucle";
+        case FASE_INTEGRADOR: return "integrador";
+        case FASE_FUERZAS: return "fuerzas";
+        case FASE_DIAGNOSTICOS: return "diagnosticos";
+        case FASE_SALIDA: return "salida";
+        case FASE_PUNTO_CONTROL: return "punto_control";
+        default: return "desconocida";
+    }
+}
+
+/// Nombre de un contador de hardware
+static const char* nombreContador(int contador) {
+    switch (contador) {
+        case CONTADOR_CICLOS: return "ciclos";
+        case CONTADOR_INSTRUCCIONES: return "instrucciones";
+        case CONTADOR_REFERENCIAS_CACHE: return "referencias_cache";
+        case CONTADOR_FALLOS_CACHE: return "fallos_cache";
+        default: return "desconocido";
+    }
+}
+
+PerfilFases::PerfilFases()
+    : origen_(reloj::now()), marca_(origen_), profundidad_(0), interacciones_(0.0), traza_(false),
+      eventos_descartados_(0), descriptor_grupo_(-1) {
+    for (int f = 0; f < NUM_FASES; ++f) {
+        segundos_[f] = 0.0;
+        llamadas_[f] = 0;
+        for (int k = 0; k < NUM_CONTADORES; ++k) { cuentas_[f][k] = 0; }
+    }
+    for (int k = 0; k < NUM_CONTADORES; ++k) {
+        descriptores_[k] = -1;
+        lectura_[k] = 0;
+        anterior_[k] = 0;
+    }
+}
+
+PerfilFases::~PerfilFases() {
+    for (int k = 0; k < NUM_CONTADORES; ++k) {
+        if (descriptores_[k] >= 0) ::close(descriptores_[k]);
+    }
+}
+
+bool PerfilFases::configurar(bool traza, size_t max_eventos, bool contadores) {
+    traza_ = traza;
+    eventos_.clear();
+    if (traza_) eventos_.reserve(max_eventos);
+    if (!contadores || descriptor_grupo_ >= 0) return true;
+#ifdef __linux__
+    static const unsigned long long configuraciones[NUM_CONTADORES] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+    for (int k = 0; k < NUM_CONTADORES; ++k) {
+        perf_event_attr atributos;
+        std::memset(&atributos, 0, sizeof(atributos));
+        atributos.type = PERF_TYPE_HARDWARE;
+        atributos.size = sizeof(atributos);
+        atributos.config = configuraciones[k];
+        atributos.disabled = (k == 0); // El grupo se habilita entero a través del líder
+        atributos.exclude_kernel = 1;  // Solo espacio de usuario: basta con perf_event_paranoid <= 2
+        atributos.exclude_hv = 1;
+        atributos.read_format = PERF_FORMAT_GROUP;
+        const int grupo = (k == 0) ? -1 : descriptores_[0];
+        descriptores_[k] = static_cast<int>(::syscall(__NR_perf_event_open, &atributos, 0, -1, grupo, 0));
+        if (descriptores_[k] < 0) {
+            const int error = errno;
+            error_contadores_ = std::string("perf_event_open (") + nombreContador(k) + "): " + std::strerror(error);
+            if (error == EACCES || error == EPERM) { error_contadores_ += "; revise /proc/sys/kernel/perf_event_paranoid"; }
+            for (int j = 0; j < k; ++j) { ::close(descriptores_[j]); descriptores_[j] = -1; }
+            descriptores_[k] = -1;
+            return false;
+        }
+    }
+    descriptor_grupo_ = descriptores_[0];
+    ::ioctl(descriptor_grupo_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(descriptor_grupo_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    leerContadores();
+    for (int k = 0; k < NUM_CONTADORES; ++k) { anterior_[k] = lectura_[k]; }
+    return true;
+#else
+    error_contadores_ = "los contadores de hardware solo están disponibles en Linux";
+    return false;
+#endif
+}
+
+void PerfilFases::leerContadores() {
+    if (descriptor_grupo_ < 0) return;
+    // Con PERF_FORMAT_GROUP una lectura devuelve el número de contadores y sus valores
+    unsigned long long valores[1 + NUM_CONTADORES];
+    const ssize_t leidos = ::read(descriptor_grupo_, valores, sizeof(valores));
+    if (leidos < static_cast<ssize_t>(sizeof(valores))) return;
+    for (int k = 0; k < NUM_CONTADORES; ++k) { lectura_[k] = valores[1 + k]; }
+}
+
+void PerfilFases::acumular(reloj::time_point ahora) {
+    if (profundidad_ > 0) {
+        const int cima = pila_[(profundidad_ < PROFUNDIDAD_MAXIMA ? profundidad_ : PROFUNDIDAD_MAXIMA) - 1];
+        segundos_[cima] += std::chrono::duration<double>(ahora - marca_).count();
+        for (int k = 0; k < NUM_CONTADORES; ++k) { cuentas_[cima][k] += lectura_[k] - anterior_[k]; }
+    }
+    for (int k = 0; k < NUM_CONTADORES; ++k) { anterior_[k] = lectura_[k]; }
+    marca_ = ahora;
+}
+
+void PerfilFases::entrar(FaseSimulacion fase) {
+    leerContadores();
+    const reloj::time_point ahora = reloj::now();
+    acumular(ahora);
+    if (profundidad_ < PROFUNDIDAD_MAXIMA) {
+        pila_[profundidad_] = fase;
+        entrada_[profundidad_] = ahora;
+        llamadas_[fase]++;
+    }
+    profundidad_++;
+}
+
+void PerfilFases::salir() {
+    if (profundidad_ == 0) return;
+    leerContadores();
+    const reloj::time_point ahora = reloj::now();
+    acumular(ahora);
+    profundidad_--;
+    if (traza_ && profundidad_ < PROFUNDIDAD_MAXIMA) {
+        if (eventos_.size() < eventos_.capacity()) {
+            EventoTraza evento;
+            evento.fase = pila_[profundidad_];
+            evento.inicio = std::chrono::duration<double, std::micro>(entrada_[profundidad_] - origen_).count();
+            evento.duracion = std::chrono::duration<double, std::micro>(ahora - entrada_[profundidad_]).count();
+            eventos_.push_back(evento);
+        } else {
+            eventos_descartados_++;
+        }
+    }
+}
+
+void PerfilFases::imprimirResumen(std::ostream& salida) const {
+    double total = 0.0;
+    for (int f = 0; f < NUM_FASES; ++f) { total += segundos_[f]; }
+    const bool con_contadores = descriptor_grupo_ >= 0;
+    salida << "Perfil por fases (tiempo exclusivo, " << std::defaultfloat << std::setprecision(4) << total
+           << " s medidos):" << std::endl;
+    salida << std::left << std::setw(15) << "  fase" << std::right << std::setw(12) << "llamadas"
+           << std::setw(12) << "s" << std::setw(8) << "%";
+    if (con_contadores) {
+        salida << std::setw(14) << "ciclos" << std::setw(8) << "IPC" << std::setw(14) << "fallos caché"
+               << std::setw(10) << "% fallos";
+    }
+    salida << std::endl;
+    for (int f = 0; f < NUM_FASES; ++f) {
+        if (llamadas_[f] == 0) continue;
+        salida << "  " << std::left << std::setw(13) << nombreFase(static_cast<FaseSimulacion>(f)) << std::right
+               << std::setw(12) << llamadas_[f] << std::setw(12) << std::setprecision(4) << segundos_[f]
+               << std::setw(8) << std::fixed << std::setprecision(1) << 100.0 * segundos_[f] / (total > 0 ? total : 1.0)
+               << std::defaultfloat;
+        if (con_contadores) {
+            const double ciclos = static_cast<double>(cuentas_[f][CONTADOR_CICLOS]);
+            const double referencias = static_cast<double>(cuentas_[f][CONTADOR_REFERENCIAS_CACHE]);
+            const double fallos = static_cast<double>(cuentas_[f][CONTADOR_FALLOS_CACHE]);
+            salida << std::setprecision(4) << std::setw(14) << ciclos << std::setw(8) << std::setprecision(3)
+                   << static_cast<double>(cuentas_[f][CONTADOR_INSTRUCCIONES]) / (ciclos > 0 ? ciclos : 1.0)
+                   << std::setw(14) << std::setprecision(4) << fallos << std::setw(10) << std::fixed
+                   << std::setprecision(1) << 100.0 * fallos / (referencias > 0 ? referencias : 1.0) << std::defaultfloat;
+        }
+        salida << std::endl;
+    }
+    if (interacciones_ > 0 && segundos_[FASE_FUERZAS] > 0) {
+        salida << std::setprecision(4) << "Interacciones de pares: " << interacciones_ << " en "
+               << segundos_[FASE_FUERZAS] << " s de fuerzas (" << interacciones_ / segundos_[FASE_FUERZAS]
+               << " por segundo)" << std::endl;
+    }
+    if (traza_ && eventos_descartados_ > 0) {
+        salida << "Aviso: la traza se llenó; " << eventos_descartados_ << " eventos no se guardaron" << std::endl;
+    }
+}
+
+bool PerfilFases::guardarResumen(const std::string& ruta) const {
+    std::ofstream archivo(ruta.c_str());
+    if (!archivo.is_open()) return false;
+    double total = 0.0;
+    for (int f = 0; f < NUM_FASES; ++f) { total += segundos_[f]; }
+    archivo << std::setprecision(9) << "{\n  \"segundos_medidos\": " << total
+            << ",\n  \"interacciones_pares\": " << interacciones_
+            << ",\n  \"interacciones_por_segundo\": "
+            << (segundos_[FASE_FUERZAS] > 0 ? interacciones_ / segundos_[FASE_FUERZAS] : 0.0)
+            << ",\n  \"contadores\": " << (descriptor_grupo_ >= 0 ? "true" : "false")
+            << ",\n  \"eventos_traza\": " << eventos_.size()
+            << ",\n  \"eventos_descartados\": " << eventos_descartados_
+            << ",\n  \"fases\": [\n";
+    bool primera = true;
+    for (int f = 0; f < NUM_FASES; ++f) {
+        if (llamadas_[f] == 0) continue;
+        archivo << (primera ? "" : ",\n") << "    {\"fase\": \"" << nombreFase(static_cast<FaseSimulacion>(f))
+                << "\", \"llamadas\": " << llamadas_[f] << ", \"segundos\": " << segundos_[f]
+                << ", \"fraccion\": " << segundos_[f] / (total > 0 ? total : 1.0);
+        if (descriptor_grupo_ >= 0) {
+            for (int k = 0; k < NUM_CONTADORES; ++k) {
+                archivo << ", \"" << nombreContador(k) << "\": " << cuentas_[f][k];
+            }
+        }
+        archivo << "}";
+        primera = false;
+    }
+    archivo << "\n  ]\n}\n";
+    return archivo.good();
+}
+
+bool PerfilFases::guardarTraza(const std::string& ruta) const {
+    std::ofstream archivo(ruta.c_str());
+    if (!archivo.is_open()) return false;
+    archivo << std::fixed << std::setprecision(3)
+            << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n"
+            << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"simulacion\"}}";
+    for (size_t k = 0; k < eventos_.size(); ++k) {
+        archivo << ",\n{\"name\": \"" << nombreFase(static_cast<FaseSimulacion>(eventos_[k].fase))
+                << "\", \"cat\": \"fase\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " << eventos_[k].inicio
+                << ", \"dur\": " << eventos_[k].duracion << "}";
+    }
+    archivo << "\n]}\n";
+    return archivo.good();
+}
@@ -0,0 +1,14 @@
+#include "Integradores.h"
+
+const char* nombreIntegrador(TipoIntegrador integrador) {
+    switch (integrador) {
+        case INTEGRADOR_VERLET: return "Verlet";
+        case INTEGRADOR_BLOQUES: return "Verlet por bloques";
+        case INTEGRADOR_HERMITE: return "Hermite de 4º orden";
+        case INTEGRADOR_COMPOSICION: return "Composición simpléctica";
+        case INTEGRADOR_WISDOM_HOLMAN: return "Wisdom-Holman";
+        case INTEGRADOR_IAS15: return "IAS15";
+        case INTEGRADOR_RESPA: return "RESPA";
+    }
+    return "Desconocido";
+}
@@ -0,0 +1,112 @@
+#include "Octree.h"
+#include <algorithm>
+#include <cmath>
+
+// Profundidad a partir de la cual no se subdivide más (cuerpos casi coincidentes)
+static const int PROFUNDIDAD_MAXIMA = 40;
+
+Octree::Octree(int max_hoja) : max_hoja_(max_hoja < 1 ? 1 : max_hoja) {}
+
+void Octree::construir(const SistemaCuerpos& cuerpos) {
+    int n = cuerpos.tamano();
+    nodos_.clear();
+    indices_.resize(n);
+    buffer_.resize(n);
+    temporal_.resize(n);
+    for (int i = 0; i < n; ++i) { indices_[i] = i; }
+    if (n == 0) return;
+
+    // Caja envolvente cúbica de todos los cuerpos
+    double xmin = cuerpos.x[0], xmax = xmin;
+    double ymin = cuerpos.y[0], ymax = ymin;
+    double zmin = cuerpos.z[0], zmax = zmin;
+    for (int i = 1; i < n; ++i) {
+        xmin = std::min(xmin, cuerpos.x[i]); xmax = std::max(xmax, cuerpos.x[i]);
+        ymin = std::min(ymin, cuerpos.y[i]); ymax = std::max(ymax, cuerpos.y[i]);
+        zmin = std::min(zmin, cuerpos.z[i]); zmax = std::max(zmax, cuerpos.z[i]);
+    }
+    double semilado = 0.5 * std::max(xmax - xmin, std::max(ymax - ymin, zmax - zmin));
+    if (semilado <= 0) semilado = 1.0;
+    semilado *= 1.0 + 1e-9; // Margen para que ningún cuerpo quede sobre el borde
+
+    NodoOctree raiz;
+    raiz.centro.load(0.5 * (xmin + xmax), 0.5 * (ymin + ymax), 0.5 * (zmin + zmax));
+    raiz.semilado = semilado;
+    raiz.masa = 0;
+    raiz.inicio = 0;
+    raiz.cuenta = n;
+    raiz.primer_hijo = -1;
+    raiz.n_hijos = 0;
+    nodos_.push_back(raiz);
+
+    subdividir(0, cuerpos, 0);
+}
+
+void Octree::subdividir(int k, const SistemaCuerpos& cuerpos, int profundidad) {
+    // Se copian los datos necesarios: push_back puede invalidar referencias a nodos_
+    const int inicio = nodos_[k].inicio;
+    const int cuenta = nodos_[k].cuenta;
+    const vector3D centro = nodos_[k].centro;
+    const double semilado = nodos_[k].semilado;
+
+    if (cuenta <= max_hoja_ || profundidad >= PROFUNDIDAD_MAXIMA) {
+        double masa = 0;
+        vector3D momento;
+        for (int b = inicio; b < inicio + cuenta; ++b) {
+            int i = indices_[b];
+            masa += cuerpos.m[i];
+            momento += cuerpos.posicion(i) * cuerpos.m[i];
+        }
+        nodos_[k].masa = masa;
+        nodos_[k].centro_masa = (masa > 0) ? momento / masa : centro;
+        return;
+    }
+
+    // Partición por octantes (ordenamiento por conteo sobre el rango del nodo)
+    int conteo[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (int b = inicio; b < inicio + cuenta; ++b) {
+        int i = indices_[b];
+        int octante = (cuerpos.x[i] > centro.x() ? 1 : 0) | (cuerpos.y[i] > centro.y() ? 2 : 0) | (cuerpos.z[i] > centro.z() ? 4 : 0);
+        buffer_[b] = octante;
+    }
+    for (int b = inicio; b < inicio + cuenta; ++b) { conteo[buffer_[b]]++; }
+    int desplazamiento[8];
+    desplazamiento[0] = inicio;
+    for (int o = 1; o < 8; ++o) { desplazamiento[o] = desplazamiento[o - 1] + conteo[o - 1]; }
+    int siguiente[8];
+    std::copy(desplazamiento, desplazamiento + 8, siguiente);
+    std::copy(indices_.begin() + inicio, indices_.begin() + inicio + cuenta, temporal_.begin() + inicio);
+    for (int b = inicio; b < inicio + cuenta; ++b) { indices_[siguiente[buffer_[b]]++] = temporal_[b]; }
+
+    // Los hijos no vacíos se crean de forma contigua antes de descender
+    const int primer_hijo = static_cast<int>(nodos_.size());
+    int n_hijos = 0;
+    const double h = 0.5 * semilado;
+    for (int o = 0; o < 8; ++o) {
+        if (conteo[o] == 0) continue;
+        NodoOctree hijo;
+        hijo.centro.load(centro.x() + ((o & 1) ? h : -h),
+                         centro.y() + ((o & 2) ? h : -h),
+                         centro.z() + ((o & 4) ? h : -h));
+        hijo.semilado = h;
+        hijo.masa = 0;
+        hijo.inicio = desplazamiento[o];
+        hijo.cuenta = conteo[o];
+        hijo.primer_hijo = -1;
+        hijo.n_hijos = 0;
+        nodos_.push_back(hijo);
+        ++n_hijos;
+    }
+    nodos_[k].primer_hijo = primer_hijo;
+    nodos_[k].n_hijos = n_hijos;
+
+    double masa = 0;
+    vector3D momento;
+    for (int c = primer_hijo; c < primer_hijo + n_hijos; ++c) {
+        subdividir(c, cuerpos, profundidad + 1);
+        masa += nodos_[c].masa;
+        momento += nodos_[c].centro_masa * nodos_[c].masa;
+    }
+    nodos_[k].masa = masa;
+    nodos_[k].centro_masa = (masa > 0) ? momento / masa : centro;
+}
@@ -0,0 +1,129 @@
+#include "PasosBloque.h"
+#include "PuntoControl.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+IntegradorBloques::IntegradorBloques(int niveles, double eta)
+    : niveles_(niveles), eta_(eta), dt_min_(0.0), tic_(0), evaluaciones_(0), nivel_mas_fino_(0) {}
+
+void IntegradorBloques::configurar(int niveles, double eta) {
+    niveles_ = std::max(0, std::min(30, niveles));
+    eta_ = eta;
+}
+
+void IntegradorBloques::iniciar(const SistemaCuerpos& cuerpos, double dt) {
+    const int n = cuerpos.tamano();
+    dt_min_ = dt / static_cast<double>(subpasos());
+    tic_ = 0;
+    x0_ = cuerpos.x; y0_ = cuerpos.y; z0_ = cuerpos.z;
+    vx0_ = cuerpos.vx; vy0_ = cuerpos.vy; vz0_ = cuerpos.vz;
+    tic0_.assign(n, 0);
+    nivel_.assign(n, niveles_); // Sin jerk inicial se empieza por el paso más fino
+    activos_.clear();
+    activos_.reserve(n);
+    evaluaciones_ = 0;
+    nivel_mas_fino_ = 0;
+}
+
+bool IntegradorBloques::siguienteSubpaso(SistemaCuerpos& cuerpos) {
+    const int n = cuerpos.tamano();
+    // Salto directo al próximo tic en que termina el paso de algún cuerpo; como
+    // todos se sincronizan al final del paso dt, nunca se pasa de ese tic
+    long siguiente = tic_ + subpasos();
+    for (int i = 0; i < n; ++i) {
+        siguiente = std::min(siguiente, tic0_[i] + (1L << (niveles_ - nivel_[i])));
+    }
+    tic_ = siguiente;
+    activos_.clear();
+    for (int i = 0; i < n; ++i) {
+        if (tic0_[i] + (1L << (niveles_ - nivel_[i])) == tic_) activos_.push_back(i);
+        if (cuerpos.inv_m[i] == 0) continue; // Como en Muevase_r, los cuerpos sin masa no se mueven
+        // Predicción de Cuerpo::Muevase_r desde el inicio del paso del cuerpo. Las
+        // fuerzas usan las posiciones de todos; la velocidad no se predice porque
+        // corregir() parte de V₀ y al final del paso dt todos están corregidos
+        const double tau = static_cast<double>(tic_ - tic0_[i]) * dt_min_;
+        const double medio_tau2 = 0.5 * tau * tau;
+        cuerpos.x[i] = x0_[i] + (vx0_[i] * tau + cuerpos.ax[i] * medio_tau2);
+        cuerpos.y[i] = y0_[i] + (vy0_[i] * tau + cuerpos.ay[i] * medio_tau2);
+        cuerpos.z[i] = z0_[i] + (vz0_[i] * tau + cuerpos.az[i] * medio_tau2);
+    }
+    evaluaciones_ += static_cast<long>(activos_.size());
+    return static_cast<int>(activos_.size()) == n;
+}
+
+void IntegradorBloques::corregir(SistemaCuerpos& cuerpos, const Aceleraciones& a_nuevas) {
+    const double dt = dt_min_ * static_cast<double>(subpasos());
+    for (size_t k = 0; k < activos_.size(); ++k) {
+        const int i = activos_[k];
+        const double dt_i = static_cast<double>(1L << (niveles_ - nivel_[i])) * dt_min_;
+        const double ax1 = a_nuevas.x[i], ay1 = a_nuevas.y[i], az1 = a_nuevas.z[i];
+        if (cuerpos.inv_m[i] != 0) {
+            // Corrección de Cuerpo::Muevase_V
+            const double medio_dt = 0.5 * dt_i;
+            cuerpos.vx[i] = vx0_[i] + (cuerpos.ax[i] + ax1) * medio_dt;
+            cuerpos.vy[i] = vy0_[i] + (cuerpos.ay[i] + ay1) * medio_dt;
+            cuerpos.vz[i] = vz0_[i] + (cuerpos.az[i] + az1) * medio_dt;
+        }
+
+        // Criterio de Aarseth con el jerk de diferencias finitas
+        const double jx = ax1 - cuerpos.ax[i], jy = ay1 - cuerpos.ay[i], jz = az1 - cuerpos.az[i];
+        const double j2 = (jx * jx + jy * jy + jz * jz) / (dt_i * dt_i);
+        const double a2 = ax1 * ax1 + ay1 * ay1 + az1 * az1;
+        const double dt_criterio = (j2 > 0) ? eta_ * std::sqrt(a2 / j2) : std::numeric_limits<double>::infinity();
+        int deseado = 0;
+        while (deseado < niveles_ && dt / static_cast<double>(1L << deseado) > dt_criterio) deseado++;
+        if (deseado > nivel_[i]) {
+            nivel_[i] = deseado;
+        } else if (deseado < nivel_[i] && tic_ % (1L << (niveles_ - nivel_[i] + 1)) == 0) {
+            nivel_[i]--; // Subir un nivel solo cuando el paso nuevo queda alineado con el bloque
+        }
+        nivel_mas_fino_ = std::max(nivel_mas_fino_, deseado);
+
+        x0_[i] = cuerpos.x[i]; y0_[i] = cuerpos.y[i]; z0_[i] = cuerpos.z[i];
+        vx0_[i] = cuerpos.vx[i]; vy0_[i] = cuerpos.vy[i]; vz0_[i] = cuerpos.vz[i];
+        cuerpos.ax[i] = ax1; cuerpos.ay[i] = ay1; cuerpos.az[i] = az1;
+        tic0_[i] = tic_;
+    }
+}
+
+long IntegradorBloques::evaluacionesPasoGlobal() const {
+    return static_cast<long>(nivel_.size()) * (tic_ >> (niveles_ - nivel_mas_fino_));
+}
+
+std::vector<int> IntegradorBloques::histogramaNiveles() const {
+    std::vector<int> histograma(niveles_ + 1, 0);
+    for (size_t i = 0; i < nivel_.size(); ++i) histograma[nivel_[i]]++;
+    return histograma;
+}
+
+void IntegradorBloques::guardarEstado(EstadoSerializado& estado) const {
+    estado.escribir(niveles_);
+    estado.escribir(eta_);
+    estado.escribir(dt_min_);
+    estado.escribir(tic_);
+    estado.escribirVector(x0_); estado.escribirVector(y0_); estado.escribirVector(z0_);
+    estado.escribirVector(vx0_); estado.escribirVector(vy0_); estado.escribirVector(vz0_);
+    estado.escribirVector(tic0_);
+    estado.escribirVector(nivel_);
+    estado.escribirVector(activos_);
+    estado.escribir(evaluaciones_);
+    estado.escribir(nivel_mas_fino_);
+}
+
+bool IntegradorBloques::cargarEstado(EstadoSerializado& estado, int n) {
+    const unsigned long long maximo = static_cast<unsigned long long>(n);
+    estado.leer(niveles_);
+    estado.leer(eta_);
+    estado.leer(dt_min_);
+    estado.leer(tic_);
+    estado.leerVector(x0_, maximo); estado.leerVector(y0_, maximo); estado.leerVector(z0_, maximo);
+    estado.leerVector(vx0_, maximo); estado.leerVector(vy0_, maximo); estado.leerVector(vz0_, maximo);
+    estado.leerVector(tic0_, maximo);
+    estado.leerVector(nivel_, maximo);
+    estado.leerVector(activos_, maximo);
+    activos_.reserve(n); // Como en iniciar(): los tics no asignan memoria
+    estado.leer(evaluaciones_);
+    estado.leer(nivel_mas_fino_);
+    return estado.valido() && static_cast<int>(nivel_.size()) == n;
+}
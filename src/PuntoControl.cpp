@@ -0,0 +1,172 @@
+#include "PuntoControl.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const char MAGIA_PUNTO_CONTROL[8] = {'N', 'C', 'P', 'U', 'N', 'T', 'O', 'C'};
+// 2: la configuración incluye la precisión y los parámetros de bloques, IAS15 y RESPA
+// 3: RESPA guarda las distancias medidas al construir la lista
+static const std::uint32_t VERSION_PUNTO_CONTROL = 3;
+static const size_t CABECERA_PUNTO_CONTROL = 32;
+
+/// Suma FNV-1a de 64 bits
+static std::uint64_t sumaFNV1a(const char* datos, size_t bytes) {
+    std::uint64_t suma = 14695981039346656037ULL;
+    for (size_t k = 0; k < bytes; ++k) {
+        suma ^= static_cast<unsigned char>(datos[k]);
+        suma *= 1099511628211ULL;
+    }
+    return suma;
+}
+
+/// write() completo, reintentando escrituras parciales e interrupciones
+static bool escribirTodo(int descriptor, const char* datos, size_t bytes) {
+    while (bytes > 0) {
+        const ssize_t escritos = ::write(descriptor, datos, bytes);
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += escritos;
+        bytes -= static_cast<size_t>(escritos);
+    }
+    return true;
+}
+
+EscritorPuntosControl::EscritorPuntosControl()
+    : hay_pendiente_(false), terminar_(false), escritos_(0), fallidos_(0),
+      bytes_ultimo_(0), tiempo_escritura_(0.0) {}
+
+EscritorPuntosControl::~EscritorPuntosControl() { cerrar(); }
+
+void EscritorPuntosControl::abrir(const std::string& ruta, size_t reserva) {
+    cerrar();
+    ruta_ = ruta;
+    ruta_temporal_ = ruta + ".tmp";
+    pendiente_.clear();
+    pendiente_.reserve(reserva);
+    hay_pendiente_ = false;
+    terminar_ = false;
+    escritos_ = 0;
+    fallidos_ = 0;
+    bytes_ultimo_ = 0;
+    tiempo_escritura_ = 0.0;
+    hilo_ = std::thread(&EscritorPuntosControl::bucleEscritor, this);
+}
+
+bool EscritorPuntosControl::ocupado() {
+    std::lock_guard<std::mutex> cerrojo(mutex_);
+    return hay_pendiente_;
+}
+
+bool EscritorPuntosControl::publicar(EstadoSerializado& estado, bool esperar) {
+    {
+        std::unique_lock<std::mutex> cerrojo(mutex_);
+        if (hay_pendiente_ && !esperar) return false;
+        while (hay_pendiente_) { aviso_.wait(cerrojo); }
+        pendiente_.swap(estado.datos());
+        hay_pendiente_ = true;
+    }
+    aviso_.notify_all();
+    estado.limpiar();
+    return true;
+}
+
+void EscritorPuntosControl::cerrar() {
+    if (!hilo_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> cerrojo(mutex_);
+        terminar_ = true;
+    }
+    aviso_.notify_all();
+    hilo_.join();
+}
+
+void EscritorPuntosControl::bucleEscritor() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> cerrojo(mutex_);
+            while (!hay_pendiente_ && !terminar_) { aviso_.wait(cerrojo); }
+            if (!hay_pendiente_) break; // Terminar sin nada pendiente
+        }
+        // Mientras hay_pendiente_ sea true la simulación no toca pendiente_: se escribe sin el cerrojo
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        if (escribirArchivo(pendiente_)) {
+            escritos_++;
+            bytes_ultimo_ = CABECERA_PUNTO_CONTROL + pendiente_.size();
+        } else {
+            fallidos_++;
+        }
+        tiempo_escritura_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        {
+            std::lock_guard<std::mutex> cerrojo(mutex_);
+            hay_pendiente_ = false;
+        }
+        aviso_.notify_all(); // Por si la simulación espera en publicar()
+    }
+}
+
+bool EscritorPuntosControl::escribirArchivo(const std::vector<char>& datos) {
+    char cabecera[CABECERA_PUNTO_CONTROL];
+    const std::uint32_t reservado = 0;
+    const std::uint64_t tamano = datos.size();
+    const std::uint64_t suma = sumaFNV1a(datos.data(), datos.size());
+    std::memcpy(cabecera, MAGIA_PUNTO_CONTROL, 8);
+    std::memcpy(cabecera + 8, &VERSION_PUNTO_CONTROL, 4);
+    std::memcpy(cabecera + 12, &reservado, 4);
+    std::memcpy(cabecera + 16, &tamano, 8);
+    std::memcpy(cabecera + 24, &suma, 8);
+
+    const int descriptor = ::open(ruta_temporal_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) return false;
+    bool correcto = escribirTodo(descriptor, cabecera, sizeof(cabecera)) &&
+                    escribirTodo(descriptor, datos.data(), datos.size()) &&
+                    ::fsync(descriptor) == 0;
+    correcto = (::close(descriptor) == 0) && correcto;
+    // rename() reemplaza el punto anterior de forma atómica
+    return correcto && std::rename(ruta_temporal_.c_str(), ruta_.c_str()) == 0;
+}
+
+bool leerPuntoControl(const std::string& ruta, EstadoSerializado& estado, std::string& error) {
+    std::ifstream archivo(ruta.c_str(), std::ios::binary);
+    if (!archivo.is_open()) {
+        error = "no se pudo abrir el punto de control " + ruta;
+        return false;
+    }
+    char cabecera[CABECERA_PUNTO_CONTROL];
+    if (!archivo.read(cabecera, sizeof(cabecera)) || std::memcmp(cabecera, MAGIA_PUNTO_CONTROL, 8) != 0) {
+        error = ruta + " no es un punto de control";
+        return false;
+    }
+    std::uint32_t version;
+    std::uint64_t tamano, suma;
+    std::memcpy(&version, cabecera + 8, 4);
+    std::memcpy(&tamano, cabecera + 16, 8);
+    std::memcpy(&suma, cabecera + 24, 8);
+    if (version != VERSION_PUNTO_CONTROL) {
+        error = ruta + ": versión de punto de control no soportada";
+        return false;
+    }
+    archivo.seekg(0, std::ios::end);
+    if (static_cast<std::uint64_t>(archivo.tellg()) != CABECERA_PUNTO_CONTROL + tamano) {
+        error = ruta + ": tamaño incorrecto (archivo truncado)";
+        return false;
+    }
+    archivo.seekg(CABECERA_PUNTO_CONTROL);
+    estado.limpiar();
+    estado.datos().resize(static_cast<size_t>(tamano));
+    if (tamano > 0 && !archivo.read(&estado.datos()[0], static_cast<std::streamsize>(tamano))) {
+        error = ruta + ": no se pudo leer el estado";
+        return false;
+    }
+    if (sumaFNV1a(estado.datos().data(), estado.datos().size()) != suma) {
+        error = ruta + ": la suma de control no coincide (archivo dañado)";
+        return false;
+    }
+    estado.reiniciarLectura();
+    return true;
+}
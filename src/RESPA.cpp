@@ -0,0 +1,249 @@
+#include "RESPA.h"
+#include "PuntoControl.h"
+#include "utilidades.h" // Para G
+#include <algorithm>
+#include <cmath>
+
+double conmutacionRESPA(double r, double radio_interior, double radio_exterior) {
+    if (r <= radio_interior) return 1.0;
+    if (r >= radio_exterior) return 0.0;
+    const double x = (r - radio_interior) / (radio_exterior - radio_interior);
+    return 1.0 - x * x * x * (10.0 - 15.0 * x + 6.0 * x * x);
+}
+
+IntegradorRESPA::IntegradorRESPA(double radio_interior, double radio_exterior, int subpasos)
+    : radio_interior_(radio_interior), radio_exterior_(radio_exterior), subpasos_(subpasos),
+      piel_(0.5 * radio_exterior), interacciones_cercanas_(0), pasadas_cercanas_(0),
+      construcciones_lista_(0), comprobaciones_lista_(0) {}
+
+void IntegradorRESPA::configurar(double radio_interior, double radio_exterior, int subpasos) {
+    radio_interior_ = radio_interior;
+    radio_exterior_ = radio_exterior;
+    subpasos_ = subpasos;
+    piel_ = 0.5 * radio_exterior;
+}
+
+void IntegradorRESPA::iniciar(const SistemaCuerpos& cuerpos) {
+    const int n = cuerpos.tamano();
+    cerca_.redimensionar(n);
+    lejos_.redimensionar(n);
+    x_lista_.assign(n, 0.0); y_lista_.assign(n, 0.0); z_lista_.assign(n, 0.0);
+    pares_.clear();
+    interacciones_cercanas_ = 0;
+    pasadas_cercanas_ = 0;
+    construcciones_lista_ = 0;
+    comprobaciones_lista_ = 0;
+    construirLista(cuerpos);
+    // Margen para que la lista pueda crecer durante la simulación sin asignar memoria
+    pares_.reserve(2 * pares_.size() + 2 * static_cast<size_t>(n));
+    evaluarCercanas(cuerpos);
+    for (int i = 0; i < n; ++i) {
+        lejos_.x[i] = cuerpos.ax[i] - cerca_.x[i];
+        lejos_.y[i] = cuerpos.ay[i] - cerca_.y[i];
+        lejos_.z[i] = cuerpos.az[i] - cerca_.z[i];
+    }
+}
+
+void IntegradorRESPA::construirLista(const SistemaCuerpos& cuerpos) {
+    const int n = cuerpos.tamano();
+    const double* x = cuerpos.x.data();
+    const double* y = cuerpos.y.data();
+    const double* z = cuerpos.z.data();
+    const double radio_lista = radio_exterior_ + piel_;
+    const double radio_lista2 = radio_lista * radio_lista;
+    pares_.clear();
+    claves_pares_.clear();
+    if (n > 0) {
+        // Celdas de lado >= radio_lista: los pares de la lista están en la misma celda o en
+        // celdas adyacentes. Cada eje admite 2²¹ celdas; en un sistema muy disperso las celdas
+        // se agrandan, lo que solo añade comprobaciones
+        double minimo[3] = {x[0], y[0], z[0]}, maximo[3] = {x[0], y[0], z[0]};
+        for (int i = 1; i < n; ++i) {
+            minimo[0] = std::min(minimo[0], x[i]); maximo[0] = std::max(maximo[0], x[i]);
+            minimo[1] = std::min(minimo[1], y[i]); maximo[1] = std::max(maximo[1], y[i]);
+            minimo[2] = std::min(minimo[2], z[i]); maximo[2] = std::max(maximo[2], z[i]);
+        }
+        const double celdas_por_eje = 2097150.0;
+        const double extension = std::max(maximo[0] - minimo[0], std::max(maximo[1] - minimo[1], maximo[2] - minimo[2]));
+        const double inverso_lado = 1.0 / std::max(radio_lista, extension / celdas_por_eje);
+        celda_.resize(n);
+        orden_.resize(n);
+        for (int i = 0; i < n; ++i) {
+            const unsigned long long cx = static_cast<unsigned long long>((x[i] - minimo[0]) * inverso_lado);
+            const unsigned long long cy = static_cast<unsigned long long>((y[i] - minimo[1]) * inverso_lado);
+            const unsigned long long cz = static_cast<unsigned long long>((z[i] - minimo[2]) * inverso_lado);
+            celda_[i] = (cx << 42) | (cy << 21) | cz;
+            orden_[i] = i;
+        }
+        const std::vector<unsigned long long>& celda = celda_;
+        std::sort(orden_.begin(), orden_.end(), [&celda](int a, int b) {
+            return celda[a] != celda[b] ? celda[a] < celda[b] : a < b;
+        });
+
+        // Cada celda se compara consigo misma y con las 13 vecinas "posteriores" (media capa),
+        // de modo que cada par de celdas adyacentes se recorre una sola vez
+        const unsigned long long mascara = (1ULL << 21) - 1;
+        long comprobaciones = 0;
+        for (int inicio = 0; inicio < n;) {
+            const unsigned long long clave = celda_[orden_[inicio]];
+            int fin = inicio + 1;
+            while (fin < n && celda_[orden_[fin]] == clave) fin++;
+            const long long cx = static_cast<long long>(clave >> 42);
+            const long long cy = static_cast<long long>((clave >> 21) & mascara);
+            const long long cz = static_cast<long long>(clave & mascara);
+            for (int desplazamiento = 13; desplazamiento < 27; ++desplazamiento) {
+                const long long vx = cx + desplazamiento / 9 - 1;
+                const long long vy = cy + (desplazamiento / 3) % 3 - 1;
+                const long long vz = cz + desplazamiento % 3 - 1;
+                if (vx < 0 || vy < 0 || vz < 0 || vx > static_cast<long long>(mascara) ||
+                    vy > static_cast<long long>(mascara) || vz > static_cast<long long>(mascara)) continue;
+                const unsigned long long vecina = (static_cast<unsigned long long>(vx) << 42) |
+                                                  (static_cast<unsigned long long>(vy) << 21) |
+                                                  static_cast<unsigned long long>(vz);
+                int inicio_vecina = fin, fin_vecina = fin;
+                if (desplazamiento > 13) {
+                    // Las claves crecen con el desplazamiento: la vecina está después de esta celda
+                    inicio_vecina = static_cast<int>(std::lower_bound(orden_.begin() + fin, orden_.end(), vecina,
+                        [&celda](int a, unsigned long long c) { return celda[a] < c; }) - orden_.begin());
+                    fin_vecina = inicio_vecina;
+                    while (fin_vecina < n && celda_[orden_[fin_vecina]] == vecina) fin_vecina++;
+                }
+                for (int a = inicio; a < fin; ++a) {
+                    const int i = orden_[a];
+                    // En la propia celda, solo los cuerpos siguientes
+                    for (int b = desplazamiento == 13 ? a + 1 : inicio_vecina; b < fin_vecina; ++b) {
+                        const int j = orden_[b];
+                        const double dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+                        comprobaciones++;
+                        if (dx * dx + dy * dy + dz * dz < radio_lista2) {
+                            const unsigned long long menor = static_cast<unsigned long long>(std::min(i, j));
+                            claves_pares_.push_back(menor * n + static_cast<unsigned long long>(std::max(i, j)));
+                        }
+                    }
+                }
+            }
+            inicio = fin;
+        }
+        comprobaciones_lista_ += comprobaciones;
+
+        // Mismo orden (i, j) que el recorrido de todos los pares: la suma de las fuerzas cercanas
+        // no depende de cómo se repartan los cuerpos en celdas
+        std::sort(claves_pares_.begin(), claves_pares_.end());
+        for (size_t k = 0; k < claves_pares_.size(); ++k) {
+            pares_.push_back(static_cast<int>(claves_pares_[k] / n));
+            pares_.push_back(static_cast<int>(claves_pares_[k] % n));
+        }
+    }
+    for (int i = 0; i < n; ++i) { x_lista_[i] = x[i]; y_lista_[i] = y[i]; z_lista_[i] = z[i]; }
+    construcciones_lista_++;
+}
+
+void IntegradorRESPA::evaluarCercanas(const SistemaCuerpos& cuerpos) {
+    const int n = cuerpos.tamano();
+    const double* x = cuerpos.x.data();
+    const double* y = cuerpos.y.data();
+    const double* z = cuerpos.z.data();
+    const double* m = cuerpos.m.data();
+
+    // Con un desplazamiento máximo de piel/2, un par fuera de la lista se acercó como mucho piel
+    const double limite2 = 0.25 * piel_ * piel_;
+    for (int i = 0; i < n; ++i) {
+        const double dx = x[i] - x_lista_[i], dy = y[i] - y_lista_[i], dz = z[i] - z_lista_[i];
+        if (dx * dx + dy * dy + dz * dz > limite2) {
+            construirLista(cuerpos);
+            break;
+        }
+    }
+
+    double* ax = cerca_.x.data();
+    double* ay = cerca_.y.data();
+    double* az = cerca_.z.data();
+    cerca_.borrar();
+    const int n_pares = static_cast<int>(pares_.size() / 2);
+    const double radio_exterior2 = radio_exterior_ * radio_exterior_;
+    for (int k = 0; k < n_pares; ++k) {
+        const int i = pares_[2 * k], j = pares_[2 * k + 1];
+        const double dx = x[j] - x[i], dy = y[j] - y[i], dz = z[j] - z[i];
+        const double r2 = dx * dx + dy * dy + dz * dz;
+        // Mismo umbral que la suma directa; fuera de r₂ la parte cercana es nula
+        if (r2 < 1e-12 || r2 >= radio_exterior2) continue;
+        const double r = std::sqrt(r2);
+        const double w = G * conmutacionRESPA(r, radio_interior_, radio_exterior_) / (r2 * r);
+        ax[i] += m[j] * w * dx; ay[i] += m[j] * w * dy; az[i] += m[j] * w * dz;
+        ax[j] -= m[i] * w * dx; ay[j] -= m[i] * w * dy; az[j] -= m[i] * w * dz;
+    }
+    interacciones_cercanas_ += n_pares;
+    pasadas_cercanas_++;
+}
+
+void IntegradorRESPA::separarLejanas(const Aceleraciones& total) {
+    const int n = total.tamano();
+    for (int i = 0; i < n; ++i) {
+        lejos_.x[i] = total.x[i] - cerca_.x[i];
+        lejos_.y[i] = total.y[i] - cerca_.y[i];
+        lejos_.z[i] = total.z[i] - cerca_.z[i];
+    }
+}
+
+void IntegradorRESPA::impulsoLejano(SistemaCuerpos& cuerpos, double dt) const {
+    const int n = cuerpos.tamano();
+    for (int i = 0; i < n; ++i) {
+        if (cuerpos.inv_m[i] == 0) continue;
+        cuerpos.vx[i] += lejos_.x[i] * dt;
+        cuerpos.vy[i] += lejos_.y[i] * dt;
+        cuerpos.vz[i] += lejos_.z[i] * dt;
+    }
+}
+
+void IntegradorRESPA::impulsoCercano(SistemaCuerpos& cuerpos, double dt) const {
+    const int n = cuerpos.tamano();
+    for (int i = 0; i < n; ++i) {
+        if (cuerpos.inv_m[i] == 0) continue;
+        cuerpos.vx[i] += cerca_.x[i] * dt;
+        cuerpos.vy[i] += cerca_.y[i] * dt;
+        cuerpos.vz[i] += cerca_.z[i] * dt;
+    }
+}
+
+void IntegradorRESPA::deriva(SistemaCuerpos& cuerpos, double dt) const {
+    const int n = cuerpos.tamano();
+    for (int i = 0; i < n; ++i) {
+        if (cuerpos.inv_m[i] == 0) continue; // Los cuerpos sin masa no se mueven, como en Muevase_r
+        cuerpos.x[i] += cuerpos.vx[i] * dt;
+        cuerpos.y[i] += cuerpos.vy[i] * dt;
+        cuerpos.z[i] += cuerpos.vz[i] * dt;
+    }
+}
+
+void IntegradorRESPA::guardarEstado(EstadoSerializado& estado) const {
+    estado.escribir(radio_interior_);
+    estado.escribir(radio_exterior_);
+    estado.escribir(subpasos_);
+    estado.escribir(piel_);
+    estado.escribirVector(cerca_.x); estado.escribirVector(cerca_.y); estado.escribirVector(cerca_.z);
+    estado.escribirVector(lejos_.x); estado.escribirVector(lejos_.y); estado.escribirVector(lejos_.z);
+    estado.escribirVector(pares_);
+    estado.escribirVector(x_lista_); estado.escribirVector(y_lista_); estado.escribirVector(z_lista_);
+    estado.escribir(interacciones_cercanas_);
+    estado.escribir(pasadas_cercanas_);
+    estado.escribir(construcciones_lista_);
+    estado.escribir(comprobaciones_lista_);
+}
+
+bool IntegradorRESPA::cargarEstado(EstadoSerializado& estado, int n) {
+    const unsigned long long maximo = static_cast<unsigned long long>(n);
+    estado.leer(radio_interior_);
+    estado.leer(radio_exterior_);
+    estado.leer(subpasos_);
+    estado.leer(piel_);
+    estado.leerVector(cerca_.x, maximo); estado.leerVector(cerca_.y, maximo); estado.leerVector(cerca_.z, maximo);
+    estado.leerVector(lejos_.x, maximo); estado.leerVector(lejos_.y, maximo); estado.leerVector(lejos_.z, maximo);
+    estado.leerVector(pares_, maximo * (maximo > 0 ? maximo - 1 : 0));
+    pares_.reserve(2 * pares_.size() + 2 * static_cast<size_t>(n)); // Mismo margen que iniciar()
+    estado.leerVector(x_lista_, maximo); estado.leerVector(y_lista_, maximo); estado.leerVector(z_lista_, maximo);
+    estado.leer(interacciones_cercanas_);
+    estado.leer(pasadas_cercanas_);
+    estado.leer(construcciones_lista_);
+    estado.leer(comprobaciones_lista_);
+    return estado.valido() && lejos_.tamano() == n && static_cast<int>(z_lista_.size()) == n;
+}
@@ -0,0 +1,116 @@
+#include "SalidaAsincrona.h"
+#include <algorithm>
+#include <chrono>
+
+// Presupuesto de memoria del anillo con capacidad automática
+static const size_t MEMORIA_ANILLO_AUTOMATICO = 64u << 20;
+
+// Tope de cuadros del anillo con capacidad automática
+static const int CAPACIDAD_MAXIMA_AUTOMATICA = 256;
+
+SalidaAsincrona::SalidaAsincrona()
+    : politica_(SATURACION_ESPERAR), tam_cuadro_(0), capacidad_(0), publicados_(0), consumidos_(0),
+      terminar_(false), escritor_dormido_(false), productor_dormido_(false), descartados_(0), esperas_(0), tiempo_espera_(0.0), tiempo_vaciado_(0.0) {}
+
+SalidaAsincrona::~SalidaAsincrona() { cerrar(); }
+
+int SalidaAsincrona::capacidadAutomatica(size_t dobles_cuadro) {
+    const size_t bytes_cuadro = std::max<size_t>(1, dobles_cuadro) * sizeof(double);
+    const size_t cuadros = MEMORIA_ANILLO_AUTOMATICO / bytes_cuadro;
+    return static_cast<int>(std::max<size_t>(2, std::min<size_t>(CAPACIDAD_MAXIMA_AUTOMATICA, cuadros)));
+}
+
+bool SalidaAsincrona::abrir(const std::string& ruta, FormatoTrayectoria formato, int n_cuerpos, double dt,
+                            const SeleccionSalida& seleccion, int capacidad, PoliticaSaturacion politica) {
+    cerrar();
+    if (!escritor_.abrir(ruta, formato, n_cuerpos, dt, seleccion)) return false;
+    politica_ = politica;
+    tam_cuadro_ = escritor_.doblesPorCuadro();
+    capacidad_ = static_cast<size_t>(capacidad > 0 ? capacidad : capacidadAutomatica(tam_cuadro_));
+    anillo_.assign(capacidad_ * tam_cuadro_, 0.0);
+    publicados_.store(0);
+    consumidos_.store(0);
+    terminar_.store(false);
+    escritor_dormido_.store(false);
+    productor_dormido_.store(false);
+    descartados_ = 0;
+    esperas_ = 0;
+    tiempo_espera_ = 0.0;
+    tiempo_vaciado_ = 0.0;
+    hilo_ = std::thread(&SalidaAsincrona::bucleEscritor, this);
+    return true;
+}
+
+bool SalidaAsincrona::publicar(double t, const SistemaCuerpos& cuerpos, double K, double U, double E) {
+    const size_t publicados = publicados_.load(std::memory_order_relaxed);
+    if (publicados - consumidos_.load(std::memory_order_acquire) == capacidad_) {
+        if (politica_ == SATURACION_DESCARTAR) {
+            descartados_++;
+            return false;
+        }
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        esperas_++;
+        std::unique_lock<std::mutex> cerrojo(mutex_);
+        anunciarEspera(productor_dormido_);
+        hay_espacio_.wait(cerrojo, [this, publicados]() {
+            return publicados - consumidos_.load(std::memory_order_acquire) != capacidad_;
+        });
+        productor_dormido_.store(false, std::memory_order_relaxed);
+        tiempo_espera_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+    escritor_.empaquetarCuadro(&anillo_[(publicados % capacidad_) * tam_cuadro_], t, cuerpos, K, U, E);
+    publicados_.store(publicados + 1, std::memory_order_release);
+    notificar(hay_cuadros_, escritor_dormido_);
+    return true;
+}
+
+void SalidaAsincrona::anunciarEspera(std::atomic<bool>& dormido) {
+    // La barrera empareja con la de notificar(): o el predicado que se evalúa
+    // a continuación ve el contador nuevo, o quien lo avanzó ve la marca
+    dormido.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void SalidaAsincrona::notificar(std::condition_variable& condicion, const std::atomic<bool>& dormido) {
+    // Si el otro hilo no ha anunciado que espera, verá el contador nuevo al
+    // evaluar su predicado y no hace falta tomar el mutex. Si lo anunció, lo
+    // hizo con el mutex tomado, que solo suelta al dormir: tomarlo aquí
+    // garantiza que la notificación no se pierde
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!dormido.load(std::memory_order_relaxed)) return;
+    std::lock_guard<std::mutex> cerrojo(mutex_);
+    condicion.notify_one();
+}
+
+void SalidaAsincrona::bucleEscritor() {
+    for (;;) {
+        const size_t consumidos = consumidos_.load(std::memory_order_relaxed);
+        if (consumidos == publicados_.load(std::memory_order_acquire)) {
+            // terminar_ se lee antes de volver a mirar el anillo, para no perder
+            // cuadros publicados justo antes de la petición de terminar
+            if (terminar_.load(std::memory_order_acquire) &&
+                consumidos == publicados_.load(std::memory_order_acquire)) break;
+            std::unique_lock<std::mutex> cerrojo(mutex_);
+            anunciarEspera(escritor_dormido_);
+            hay_cuadros_.wait(cerrojo, [this, consumidos]() {
+                return terminar_.load(std::memory_order_acquire) ||
+                       consumidos != publicados_.load(std::memory_order_acquire);
+            });
+            escritor_dormido_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        escritor_.escribirCuadroEmpaquetado(&anillo_[(consumidos % capacidad_) * tam_cuadro_]);
+        consumidos_.store(consumidos + 1, std::memory_order_release);
+        notificar(hay_espacio_, productor_dormido_);
+    }
+}
+
+void SalidaAsincrona::cerrar() {
+    if (!hilo_.joinable()) return;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    terminar_.store(true, std::memory_order_release);
+    notificar(hay_cuadros_, escritor_dormido_);
+    hilo_.join();
+    escritor_.cerrar();
+    tiempo_vaciado_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
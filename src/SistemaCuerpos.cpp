@@ -0,0 +1,81 @@
+#include "SistemaCuerpos.h"
+#include <cmath>
+#include <algorithm>
+
+void Aceleraciones::borrar() {
+    std::fill(x.begin(), x.end(), 0.0);
+    std::fill(y.begin(), y.end(), 0.0);
+    std::fill(z.begin(), z.end(), 0.0);
+}
+
+void SistemaCuerpos::redimensionar(int n) {
+    x.assign(n, 0.0); y.assign(n, 0.0); z.assign(n, 0.0);
+    vx.assign(n, 0.0); vy.assign(n, 0.0); vz.assign(n, 0.0);
+    ax.assign(n, 0.0); ay.assign(n, 0.0); az.assign(n, 0.0);
+    m.assign(n, 0.0); inv_m.assign(n, 0.0); R.assign(n, 0.0);
+}
+
+void SistemaCuerpos::fijarCuerpo(int i, const Cuerpo& c) {
+    x[i] = c.r.x(); y[i] = c.r.y(); z[i] = c.r.z();
+    vx[i] = c.V.x(); vy[i] = c.V.y(); vz[i] = c.V.z();
+    fijarMasa(i, c.m);
+    ax[i] = c.F.x() * inv_m[i]; ay[i] = c.F.y() * inv_m[i]; az[i] = c.F.z() * inv_m[i];
+    R[i] = c.R;
+}
+
+Cuerpo SistemaCuerpos::cuerpo(int i) const {
+    Cuerpo c;
+    c.Inicie(x[i], y[i], z[i], vx[i], vy[i], vz[i], m[i], R[i]);
+    c.F.load(m[i] * ax[i], m[i] * ay[i], m[i] * az[i]);
+    return c;
+}
+
+void SistemaCuerpos::cargarDesde(const std::vector<Cuerpo>& cuerpos) {
+    int n = static_cast<int>(cuerpos.size());
+    redimensionar(n);
+    for (int i = 0; i < n; ++i) { fijarCuerpo(i, cuerpos[i]); }
+}
+
+std::vector<Cuerpo> SistemaCuerpos::aCuerpos() const {
+    int n = tamano();
+    std::vector<Cuerpo> cuerpos(n);
+    for (int i = 0; i < n; ++i) { cuerpos[i] = cuerpo(i); }
+    return cuerpos;
+}
+
+void SistemaCuerpos::fijarMasa(int i, double masa) {
+    m[i] = masa;
+    inv_m[i] = (masa != 0) ? 1.0 / masa : 0.0; // Los cuerpos sin masa no se mueven (como en Cuerpo)
+}
+
+double SistemaCuerpos::normaVelocidad(int i) const {
+    return std::sqrt(vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+}
+
+void SistemaCuerpos::fijarAceleraciones(const Aceleraciones& a) {
+    std::copy(a.x.begin(), a.x.end(), ax.begin());
+    std::copy(a.y.begin(), a.y.end(), ay.begin());
+    std::copy(a.z.begin(), a.z.end(), az.begin());
+}
+
+void SistemaCuerpos::Muevase_r(double dt) {
+    const int n = tamano();
+    const double medio_dt2 = 0.5 * dt * dt;
+    for (int i = 0; i < n; ++i) {
+        if (inv_m[i] == 0) continue;
+        x[i] += vx[i] * dt + ax[i] * medio_dt2;
+        y[i] += vy[i] * dt + ay[i] * medio_dt2;
+        z[i] += vz[i] * dt + az[i] * medio_dt2;
+    }
+}
+
+void SistemaCuerpos::Muevase_V(double dt, const Aceleraciones& a_siguiente) {
+    const int n = tamano();
+    const double medio_dt = 0.5 * dt;
+    for (int i = 0; i < n; ++i) {
+        if (inv_m[i] == 0) continue;
+        vx[i] += (ax[i] + a_siguiente.x[i]) * medio_dt;
+        vy[i] += (ay[i] + a_siguiente.y[i]) * medio_dt;
+        vz[i] += (az[i] + a_siguiente.z[i]) * medio_dt;
+    }
+}
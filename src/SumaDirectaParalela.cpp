@@ -0,0 +1,158 @@
+#include "SumaDirectaParalela.h"
+#include "Fuerzas.h"
+#include "FuerzasSIMD.h"
+#include <algorithm>
+
+// Cada bloque j se parte en este número de tramos de cuerpos i, para que
+// haya bloques suficientes que repartir incluso con N moderado
+static const int TRAMOS_I_POR_BLOQUE = 4;
+
+// Separación entre las energías parciales de los hilos (una línea de caché)
+static const int SEPARACION_ENERGIAS = 8;
+
+// Filas por tramo en precisión mixta: bastantes tramos para equilibrar la
+// carga y cada uno lo bastante largo para que el contador atómico no cueste
+static const int FILAS_POR_TRAMO_MIXTO = 64;
+
+SumaDirectaParalela::SumaDirectaParalela(int hilos)
+    : grupo_(hilos), n_bloques_(-1), siguiente_(0), precision_mixta_(false) {}
+
+void SumaDirectaParalela::fijarHilos(int hilos) { grupo_.redimensionar(hilos); }
+
+void SumaDirectaParalela::prepararBloques(int n) {
+    bloques_.clear();
+    const int bloque_j = tamanoBloqueJ();
+    const int tramo_i = std::max(8, bloque_j / TRAMOS_I_POR_BLOQUE);
+    for (int j0 = 0; j0 < n; j0 += bloque_j) {
+        int j1 = std::min(n, j0 + bloque_j);
+        for (int i0 = 0; i0 < j1 - 1; i0 += tramo_i) {
+            BloquePares b = {i0, std::min(i0 + tramo_i, j1), j0, j1};
+            bloques_.push_back(b);
+        }
+    }
+    n_bloques_ = n;
+}
+
+void SumaDirectaParalela::calcularFuerzas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                                          double* energia_potencial) {
+    if (precision_mixta_) {
+        calcularFuerzasMixtas(cuerpos, aceleraciones, energia_potencial);
+        return;
+    }
+    const int hilos = grupo_.tamano();
+    if (hilos == 1) {
+        calcularFuerzasSIMD(cuerpos, aceleraciones, nivelSIMDActivo(), energia_potencial);
+        return;
+    }
+
+    const int n = cuerpos.tamano();
+    if (n != n_bloques_) { prepararBloques(n); }
+    parciales_.resize(hilos - 1);
+    for (int h = 0; h < hilos - 1; ++h) {
+        if (parciales_[h].tamano() != n) { parciales_[h].redimensionar(n); }
+    }
+    energias_.resize(static_cast<size_t>(hilos) * SEPARACION_ENERGIAS);
+
+    // Los lambdas solo capturan this y el contexto, para que std::function
+    // los guarde sin reservar memoria en cada paso
+    struct Contexto {
+        const SistemaCuerpos* cuerpos;
+        Aceleraciones* salida;
+        NivelSIMD nivel;
+        bool con_potencial;
+        int total;
+        int n;
+        int hilos;
+    } ctx = {&cuerpos, &aceleraciones, nivelSIMDActivo(), energia_potencial != 0, static_cast<int>(bloques_.size()), n, hilos};
+    siguiente_.store(0);
+
+    // Pasada de pares: el hilo 0 escribe directamente en la salida
+    grupo_.ejecutar([this, &ctx](int h) {
+        Aceleraciones& acumulador = (h == 0) ? *ctx.salida : parciales_[h - 1];
+        acumulador.borrar();
+        double* energia = ctx.con_potencial ? &energias_[h * SEPARACION_ENERGIAS] : 0;
+        if (energia) { *energia = 0.0; }
+        for (int k = siguiente_.fetch_add(1); k < ctx.total; k = siguiente_.fetch_add(1)) {
+            const BloquePares& b = bloques_[k];
+            acumularFuerzasBloque(*ctx.cuerpos, acumulador, ctx.nivel, b.i0, b.i1, b.j0, b.j1, energia);
+        }
+    });
+
+    // Reducción: cada hilo suma los acumuladores parciales sobre su rango de cuerpos
+    grupo_.ejecutar([this, &ctx](int h) {
+        const int inicio = static_cast<int>(static_cast<long>(ctx.n) * h / ctx.hilos);
+        const int fin = static_cast<int>(static_cast<long>(ctx.n) * (h + 1) / ctx.hilos);
+        Aceleraciones& salida = *ctx.salida;
+        for (int p = 0; p < ctx.hilos - 1; ++p) {
+            const Aceleraciones& parcial = parciales_[p];
+            for (int i = inicio; i < fin; ++i) {
+                salida.x[i] += parcial.x[i];
+                salida.y[i] += parcial.y[i];
+                salida.z[i] += parcial.z[i];
+            }
+        }
+    });
+
+    if (energia_potencial) {
+        *energia_potencial = 0.0;
+        for (int h = 0; h < hilos; ++h) { *energia_potencial += energias_[h * SEPARACION_ENERGIAS]; }
+    }
+}
+
+void SumaDirectaParalela::calcularFuerzasMixtas(const SistemaCuerpos& cuerpos, Aceleraciones& aceleraciones,
+                                                double* energia_potencial) {
+    const int hilos = grupo_.tamano();
+    if (hilos == 1) {
+        ::calcularFuerzasMixtas(cuerpos, simples_, aceleraciones, nivelSIMDActivo(), energia_potencial);
+        return;
+    }
+
+    const int n = cuerpos.tamano();
+    simples_.cargar(cuerpos);
+    aceleraciones.borrar();
+    energias_.resize(static_cast<size_t>(hilos) * SEPARACION_ENERGIAS);
+    struct Contexto {
+        Aceleraciones* salida;
+        NivelSIMD nivel;
+        bool con_potencial;
+        int n;
+    } ctx = {&aceleraciones, nivelSIMDActivo(), energia_potencial != 0, n};
+    siguiente_.store(0);
+
+    // Cada fila escribe solo su propia aceleración: los hilos comparten la salida
+    grupo_.ejecutar([this, &ctx](int h) {
+        double* energia = ctx.con_potencial ? &energias_[h * SEPARACION_ENERGIAS] : 0;
+        if (energia) { *energia = 0.0; }
+        for (int i0 = siguiente_.fetch_add(FILAS_POR_TRAMO_MIXTO); i0 < ctx.n;
+             i0 = siguiente_.fetch_add(FILAS_POR_TRAMO_MIXTO)) {
+            acumularFuerzasFilasMixtas(simples_, *ctx.salida, ctx.nivel, i0,
+                                       std::min(ctx.n, i0 + FILAS_POR_TRAMO_MIXTO), energia);
+        }
+    });
+
+    if (energia_potencial) {
+        *energia_potencial = 0.0;
+        for (int h = 0; h < hilos; ++h) { *energia_potencial += energias_[h * SEPARACION_ENERGIAS]; }
+    }
+}
+
+void SumaDirectaParalela::calcularFuerzasSobre(const SistemaCuerpos& cuerpos, const int* objetivos, int n_objetivos,
+                                               Aceleraciones& aceleraciones) {
+    const int hilos = grupo_.tamano();
+    if (hilos == 1 || n_objetivos < hilos) {
+        ::calcularFuerzasSobre(cuerpos, objetivos, n_objetivos, aceleraciones);
+        return;
+    }
+    struct Contexto {
+        const SistemaCuerpos* cuerpos;
+        const int* objetivos;
+        Aceleraciones* salida;
+        int n_objetivos;
+        int hilos;
+    } ctx = {&cuerpos, objetivos, &aceleraciones, n_objetivos, hilos};
+    grupo_.ejecutar([&ctx](int h) {
+        const int inicio = static_cast<int>(static_cast<long>(ctx.n_objetivos) * h / ctx.hilos);
+        const int fin = static_cast<int>(static_cast<long>(ctx.n_objetivos) * (h + 1) / ctx.hilos);
+        ::calcularFuerzasSobre(*ctx.cuerpos, ctx.objetivos + inicio, fin - inicio, *ctx.salida);
+    });
+}
@@ -0,0 +1,387 @@
+#include "Trayectoria.h"
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+// Tipo de dato de los campos en la cabecera binaria
+static const std::uint32_t TIPO_FLOAT64 = 1;
+
+// La cabecera se rellena hasta este múltiplo para alinear los cuadros
+static const std::uint32_t ALINEACION_CABECERA = 64;
+
+// Bytes de la parte fija de la cabecera según la versión
+static const std::uint32_t CABECERA_FIJA_V1 = 48;
+static const std::uint32_t CABECERA_FIJA_V2 = 64;
+
+static bool anfitrionLittleEndian() {
+    const std::uint16_t prueba = 1;
+    unsigned char primero;
+    std::memcpy(&primero, &prueba, 1);
+    return primero == 1;
+}
+
+// --- Lectura y escritura little-endian de enteros y dobles ---
+
+static void escribirU32(std::ostream& os, std::uint32_t v) {
+    unsigned char b[4];
+    for (int k = 0; k < 4; ++k) { b[k] = static_cast<unsigned char>(v >> (8 * k)); }
+    os.write(reinterpret_cast<const char*>(b), 4);
+}
+
+static void escribirU64(std::ostream& os, std::uint64_t v) {
+    unsigned char b[8];
+    for (int k = 0; k < 8; ++k) { b[k] = static_cast<unsigned char>(v >> (8 * k)); }
+    os.write(reinterpret_cast<const char*>(b), 8);
+}
+
+static void escribirF64(std::ostream& os, double v) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, 8);
+    escribirU64(os, bits);
+}
+
+static std::uint32_t leerU32(const unsigned char* b) {
+    std::uint32_t v = 0;
+    for (int k = 3; k >= 0; --k) { v = (v << 8) | b[k]; }
+    return v;
+}
+
+static std::uint64_t leerU64(const unsigned char* b) {
+    std::uint64_t v = 0;
+    for (int k = 7; k >= 0; --k) { v = (v << 8) | b[k]; }
+    return v;
+}
+
+static double leerF64(const unsigned char* b) {
+    std::uint64_t bits = leerU64(b);
+    double v;
+    std::memcpy(&v, &bits, 8);
+    return v;
+}
+
+// Invierte el orden de bytes de cada doble (solo en anfitriones big-endian)
+static void invertirBytes(double* datos, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char* b = reinterpret_cast<unsigned char*>(datos + i);
+        for (int k = 0; k < 4; ++k) { std::swap(b[k], b[7 - k]); }
+    }
+}
+
+// --- Selección de campos y disposición del cuadro ---
+
+SeleccionSalida seleccionCompleta(int n_cuerpos) {
+    SeleccionSalida s = {0, n_cuerpos, CAMPOS_POR_DEFECTO};
+    return s;
+}
+
+std::vector<CampoTrayectoria> camposTrayectoria(const SeleccionSalida& seleccion) {
+    const std::uint32_t n = static_cast<std::uint32_t>(seleccion.cuerpos);
+    std::vector<CampoTrayectoria> campos;
+    CampoTrayectoria t = {"t", 1};
+    campos.push_back(t);
+    const struct { unsigned grupo; const char* nombres[3]; int cantidad; std::uint32_t elementos; } grupos[] = {
+        {CAMPO_POSICIONES, {"x", "y", "z"}, 3, n},
+        {CAMPO_VELOCIDADES, {"vx", "vy", "vz"}, 3, n},
+        {CAMPO_RAPIDEZ, {"v", 0, 0}, 1, n},
+        {CAMPO_ENERGIAS, {"K", "U", "E"}, 3, 1}
+    };
+    for (int g = 0; g < 4; ++g) {
+        if (!(seleccion.campos & grupos[g].grupo)) continue;
+        for (int k = 0; k < grupos[g].cantidad; ++k) {
+            CampoTrayectoria c = {grupos[g].nombres[k], grupos[g].elementos};
+            campos.push_back(c);
+        }
+    }
+    return campos;
+}
+
+/**
+ * Calcula la posición de cada campo conocido dentro del cuadro. Los campos
+ * con nombres desconocidos se saltan, para que versiones futuras puedan
+ * agregar campos sin romper a los lectores.
+ */
+static bool disposicionDesdeCampos(const std::vector<CampoTrayectoria>& campos, int cuerpos, int primer_cuerpo,
+                                   DisposicionCuadro& d, std::string& error) {
+    d.cuerpos = cuerpos;
+    d.primer_cuerpo = primer_cuerpo;
+    d.t = d.x = d.y = d.z = d.vx = d.vy = d.vz = d.v = d.K = d.U = d.E = -1;
+    const char* nombres[] = {"t", "x", "y", "z", "vx", "vy", "vz", "v", "K", "U", "E"};
+    long* destinos[] = {&d.t, &d.x, &d.y, &d.z, &d.vx, &d.vy, &d.vz, &d.v, &d.K, &d.U, &d.E};
+    const bool por_cuerpo[] = {false, true, true, true, true, true, true, true, false, false, false};
+
+    size_t desplazamiento = 0;
+    for (size_t c = 0; c < campos.size(); ++c) {
+        for (int k = 0; k < 11; ++k) {
+            if (campos[c].nombre != nombres[k]) continue;
+            std::uint32_t esperado = por_cuerpo[k] ? static_cast<std::uint32_t>(cuerpos) : 1;
+            if (campos[c].elementos != esperado) {
+                error = "tamaño inesperado del campo " + campos[c].nombre;
+                return false;
+            }
+            *destinos[k] = static_cast<long>(desplazamiento);
+        }
+        desplazamiento += campos[c].elementos;
+    }
+    if (d.t < 0) {
+        error = "falta el campo t";
+        return false;
+    }
+    d.dobles = desplazamiento;
+    return true;
+}
+
+// --- Formato de texto compartido por la salida directa y el conversor ---
+
+static void escribirCabeceraTexto(std::ostream& os, const DisposicionCuadro& d) {
+    os << "# Tiempo";
+    for (int j = 0; j < d.cuerpos; ++j) {
+        const int i = d.primer_cuerpo + j + 1; // Los nombres conservan el número original del cuerpo
+        if (d.x >= 0) { os << "\t" << "x" << i; }
+        if (d.y >= 0) { os << "\t" << "y" << i; }
+        if (d.z >= 0) { os << "\t" << "z" << i; }
+    }
+    for (int j = 0; j < d.cuerpos; ++j) {
+        const int i = d.primer_cuerpo + j + 1;
+        if (d.vx >= 0) { os << "\t" << "vx" << i; }
+        if (d.vy >= 0) { os << "\t" << "vy" << i; }
+        if (d.vz >= 0) { os << "\t" << "vz" << i; }
+    }
+    if (d.v >= 0) {
+        for (int j = 0; j < d.cuerpos; ++j) { os << "\t" << "v" << d.primer_cuerpo + j + 1; }
+    }
+    if (d.K >= 0) { os << "\tK_total"; }
+    if (d.U >= 0) { os << "\tU_total"; }
+    if (d.E >= 0) { os << "\tE_total"; }
+    os << "\n";
+    os << std::fixed << std::setprecision(8);
+}
+
+static void escribirValorTexto(std::ostream& os, double valor) {
+    if (std::isnan(valor)) { os << "nan"; } // Pasos sin diagnósticos
+    else { os << valor; }
+}
+
+static void escribirFilaTexto(std::ostream& os, const DisposicionCuadro& d, const double* cuadro) {
+    os << cuadro[d.t];
+    for (int j = 0; j < d.cuerpos; ++j) {
+        if (d.x >= 0) { os << "\t" << cuadro[d.x + j]; }
+        if (d.y >= 0) { os << "\t" << cuadro[d.y + j]; }
+        if (d.z >= 0) { os << "\t" << cuadro[d.z + j]; }
+    }
+    for (int j = 0; j < d.cuerpos; ++j) {
+        if (d.vx >= 0) { os << "\t" << cuadro[d.vx + j]; }
+        if (d.vy >= 0) { os << "\t" << cuadro[d.vy + j]; }
+        if (d.vz >= 0) { os << "\t" << cuadro[d.vz + j]; }
+    }
+    if (d.v >= 0) {
+        for (int j = 0; j < d.cuerpos; ++j) { os << "\t" << cuadro[d.v + j]; }
+    }
+    if (d.K >= 0) { os << "\t"; escribirValorTexto(os, cuadro[d.K]); }
+    if (d.U >= 0) { os << "\t"; escribirValorTexto(os, cuadro[d.U]); }
+    if (d.E >= 0) { os << "\t"; escribirValorTexto(os, cuadro[d.E]); }
+    os << "\n";
+}
+
+// --- EscritorTrayectoria ---
+
+EscritorTrayectoria::EscritorTrayectoria() : formato_(TRAYECTORIA_TEXTO), cuadros_(0) {
+    std::string error;
+    disposicionDesdeCampos(camposTrayectoria(seleccionCompleta(0)), 0, 0, disposicion_, error);
+}
+
+EscritorTrayectoria::~EscritorTrayectoria() { cerrar(); }
+
+bool EscritorTrayectoria::abrir(const std::string& ruta, FormatoTrayectoria formato, int n_cuerpos, double dt,
+                                const SeleccionSalida& seleccion) {
+    cerrar();
+    formato_ = formato;
+    cuadros_ = 0;
+    std::vector<CampoTrayectoria> campos = camposTrayectoria(seleccion);
+    std::string error;
+    disposicionDesdeCampos(campos, seleccion.cuerpos, seleccion.primer_cuerpo, disposicion_, error);
+    cuadro_.assign(disposicion_.dobles, 0.0);
+
+    if (formato_ == TRAYECTORIA_TEXTO) {
+        archivo_.open(ruta.c_str());
+        if (!archivo_.is_open()) return false;
+        escribirCabeceraTexto(archivo_, disposicion_);
+        return true;
+    }
+
+    archivo_.open(ruta.c_str(), std::ios::binary);
+    if (!archivo_.is_open()) return false;
+    std::uint32_t tam_cabecera = CABECERA_FIJA_V2 + static_cast<std::uint32_t>(campos.size()) * (LONGITUD_NOMBRE_CAMPO + 8);
+    tam_cabecera = (tam_cabecera + ALINEACION_CABECERA - 1) / ALINEACION_CABECERA * ALINEACION_CABECERA;
+
+    archivo_.write(MAGIA_TRAYECTORIA, 8);
+    escribirU32(archivo_, VERSION_TRAYECTORIA);
+    escribirU32(archivo_, tam_cabecera);
+    escribirU64(archivo_, static_cast<std::uint64_t>(seleccion.cuerpos));
+    escribirF64(archivo_, dt);
+    escribirU64(archivo_, 0); // Número de cuadros: se completa al cerrar
+    escribirU32(archivo_, static_cast<std::uint32_t>(campos.size()));
+    escribirU32(archivo_, static_cast<std::uint32_t>(cuadro_.size() * sizeof(double)));
+    escribirU64(archivo_, static_cast<std::uint64_t>(seleccion.primer_cuerpo));
+    escribirU64(archivo_, static_cast<std::uint64_t>(n_cuerpos));
+    for (size_t k = 0; k < campos.size(); ++k) {
+        char nombre[LONGITUD_NOMBRE_CAMPO] = {0};
+        std::strncpy(nombre, campos[k].nombre.c_str(), LONGITUD_NOMBRE_CAMPO - 1);
+        archivo_.write(nombre, LONGITUD_NOMBRE_CAMPO);
+        escribirU32(archivo_, campos[k].elementos);
+        escribirU32(archivo_, TIPO_FLOAT64);
+    }
+    while (static_cast<std::uint32_t>(archivo_.tellp()) < tam_cabecera) { archivo_.put('\0'); }
+    return true;
+}
+
+void EscritorTrayectoria::empaquetarCuadro(double* cuadro, double t, const SistemaCuerpos& cuerpos,
+                                           double K, double U, double E) const {
+    const DisposicionCuadro& d = disposicion_;
+    const int inicio = d.primer_cuerpo;
+    const int fin = d.primer_cuerpo + d.cuerpos;
+    cuadro[d.t] = t;
+    if (d.x >= 0) { std::copy(cuerpos.x.begin() + inicio, cuerpos.x.begin() + fin, cuadro + d.x); }
+    if (d.y >= 0) { std::copy(cuerpos.y.begin() + inicio, cuerpos.y.begin() + fin, cuadro + d.y); }
+    if (d.z >= 0) { std::copy(cuerpos.z.begin() + inicio, cuerpos.z.begin() + fin, cuadro + d.z); }
+    if (d.vx >= 0) { std::copy(cuerpos.vx.begin() + inicio, cuerpos.vx.begin() + fin, cuadro + d.vx); }
+    if (d.vy >= 0) { std::copy(cuerpos.vy.begin() + inicio, cuerpos.vy.begin() + fin, cuadro + d.vy); }
+    if (d.vz >= 0) { std::copy(cuerpos.vz.begin() + inicio, cuerpos.vz.begin() + fin, cuadro + d.vz); }
+    if (d.v >= 0) {
+        for (int i = inicio; i < fin; ++i) { cuadro[d.v + (i - inicio)] = cuerpos.normaVelocidad(i); }
+    }
+    if (d.K >= 0) { cuadro[d.K] = K; }
+    if (d.U >= 0) { cuadro[d.U] = U; }
+    if (d.E >= 0) { cuadro[d.E] = E; }
+}
+
+void EscritorTrayectoria::escribirCuadro(double t, const SistemaCuerpos& cuerpos, double K, double U, double E) {
+    if (!archivo_.is_open()) return;
+    empaquetarCuadro(cuadro_.data(), t, cuerpos, K, U, E);
+    escribirCuadroEmpaquetado(cuadro_.data());
+}
+
+void EscritorTrayectoria::escribirCuadroEmpaquetado(const double* cuadro) {
+    if (!archivo_.is_open()) return;
+    if (formato_ == TRAYECTORIA_TEXTO) {
+        escribirFilaTexto(archivo_, disposicion_, cuadro);
+    } else {
+        if (!anfitrionLittleEndian()) {
+            if (cuadro != cuadro_.data()) { std::copy(cuadro, cuadro + cuadro_.size(), cuadro_.begin()); }
+            invertirBytes(cuadro_.data(), cuadro_.size());
+            cuadro = cuadro_.data();
+        }
+        archivo_.write(reinterpret_cast<const char*>(cuadro),
+                       static_cast<std::streamsize>(cuadro_.size() * sizeof(double)));
+    }
+    cuadros_++;
+}
+
+void EscritorTrayectoria::cerrar() {
+    if (!archivo_.is_open()) return;
+    if (formato_ == TRAYECTORIA_BINARIA) {
+        archivo_.seekp(32);
+        escribirU64(archivo_, static_cast<std::uint64_t>(cuadros_));
+    }
+    archivo_.close();
+}
+
+// --- Lectura y conversión ---
+
+bool leerCabeceraTrayectoria(std::ifstream& entrada, CabeceraTrayectoria& cabecera, std::string& error) {
+    unsigned char fijo[CABECERA_FIJA_V2];
+    if (!entrada.read(reinterpret_cast<char*>(fijo), CABECERA_FIJA_V1)) {
+        error = "archivo demasiado corto para ser una trayectoria binaria";
+        return false;
+    }
+    if (std::memcmp(fijo, MAGIA_TRAYECTORIA, 8) != 0) {
+        error = "el archivo no es una trayectoria binaria (identificador incorrecto)";
+        return false;
+    }
+    cabecera.version = leerU32(fijo + 8);
+    if (cabecera.version < 1 || cabecera.version > VERSION_TRAYECTORIA) {
+        error = "versión de formato no soportada";
+        return false;
+    }
+    cabecera.tam_cabecera = leerU32(fijo + 12);
+    cabecera.n_cuerpos = leerU64(fijo + 16);
+    cabecera.dt = leerF64(fijo + 24);
+    cabecera.n_cuadros = leerU64(fijo + 32);
+    std::uint32_t n_campos = leerU32(fijo + 40);
+    cabecera.tam_cuadro = leerU32(fijo + 44);
+    cabecera.primer_cuerpo = 0;
+    cabecera.n_total = cabecera.n_cuerpos;
+    if (cabecera.version >= 2) {
+        if (!entrada.read(reinterpret_cast<char*>(fijo + CABECERA_FIJA_V1), CABECERA_FIJA_V2 - CABECERA_FIJA_V1)) {
+            error = "cabecera truncada";
+            return false;
+        }
+        cabecera.primer_cuerpo = leerU64(fijo + 48);
+        cabecera.n_total = leerU64(fijo + 56);
+    }
+
+    std::uint64_t elementos_totales = 0;
+    cabecera.campos.clear();
+    for (std::uint32_t k = 0; k < n_campos; ++k) {
+        unsigned char campo[LONGITUD_NOMBRE_CAMPO + 8];
+        if (!entrada.read(reinterpret_cast<char*>(campo), sizeof(campo))) {
+            error = "cabecera truncada";
+            return false;
+        }
+        if (leerU32(campo + LONGITUD_NOMBRE_CAMPO + 4) != TIPO_FLOAT64) {
+            error = "tipo de campo no soportado";
+            return false;
+        }
+        char nombre[LONGITUD_NOMBRE_CAMPO + 1] = {0};
+        std::memcpy(nombre, campo, LONGITUD_NOMBRE_CAMPO);
+        CampoTrayectoria c = {nombre, leerU32(campo + LONGITUD_NOMBRE_CAMPO)};
+        elementos_totales += c.elementos;
+        cabecera.campos.push_back(c);
+    }
+    if (elementos_totales * sizeof(double) != cabecera.tam_cuadro) {
+        error = "el tamaño de cuadro no coincide con la lista de campos";
+        return false;
+    }
+
+    if (cabecera.n_cuadros == 0 && cabecera.tam_cuadro > 0) {
+        // Archivo sin cerrar (p. ej. simulación interrumpida): se cuentan los cuadros completos
+        entrada.seekg(0, std::ios::end);
+        std::uint64_t tam = static_cast<std::uint64_t>(entrada.tellg());
+        if (tam > cabecera.tam_cabecera) { cabecera.n_cuadros = (tam - cabecera.tam_cabecera) / cabecera.tam_cuadro; }
+    }
+    entrada.clear();
+    entrada.seekg(cabecera.tam_cabecera);
+    return true;
+}
+
+bool convertirTrayectoriaATexto(const std::string& ruta_binaria, const std::string& ruta_texto,
+                                std::string& error) {
+    std::ifstream entrada(ruta_binaria.c_str(), std::ios::binary);
+    if (!entrada.is_open()) {
+        error = "no se pudo abrir " + ruta_binaria;
+        return false;
+    }
+    CabeceraTrayectoria cabecera;
+    if (!leerCabeceraTrayectoria(entrada, cabecera, error)) return false;
+
+    DisposicionCuadro disposicion;
+    if (!disposicionDesdeCampos(cabecera.campos, static_cast<int>(cabecera.n_cuerpos),
+                                static_cast<int>(cabecera.primer_cuerpo), disposicion, error)) return false;
+
+    std::ofstream salida(ruta_texto.c_str());
+    if (!salida.is_open()) {
+        error = "no se pudo crear " + ruta_texto;
+        return false;
+    }
+    escribirCabeceraTexto(salida, disposicion);
+
+    std::vector<double> cuadro(disposicion.dobles);
+    for (std::uint64_t c = 0; c < cabecera.n_cuadros; ++c) {
+        if (!entrada.read(reinterpret_cast<char*>(cuadro.data()), cabecera.tam_cuadro)) {
+            error = "archivo truncado: faltan cuadros";
+            return false;
+        }
+        if (!anfitrionLittleEndian()) { invertirBytes(cuadro.data(), cuadro.size()); }
+        escribirFilaTexto(salida, disposicion, cuadro.data());
+    }
+    return true;
+}
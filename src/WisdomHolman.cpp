@@ -0,0 +1,196 @@
+#include "WisdomHolman.h"
+#include "PuntoControl.h"
+#include "utilidades.h" // Para G
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Funciones de Stumpff C(z) = Σ(-z)ᵏ/(2k+2)! y S(z) = Σ(-z)ᵏ/(2k+3)!
+ * @details Cerca de z = 0 se suma la serie; lejos, las formas cerradas con
+ *          1 - cos x = 2 sen²(x/2) para evitar la cancelación
+ */
+static void stumpff(double z, double& c, double& s) {
+    if (std::fabs(z) < 1.0) {
+        double termino_c = 0.5, termino_s = 1.0 / 6.0;
+        c = 0.0; s = 0.0;
+        for (int k = 0; k < 12; ++k) {
+            c += termino_c;
+            s += termino_s;
+            termino_c *= -z / ((2 * k + 3) * (2 * k + 4));
+            termino_s *= -z / ((2 * k + 4) * (2 * k + 5));
+        }
+    } else if (z > 0) {
+        const double x = std::sqrt(z);
+        const double seno_medio = std::sin(0.5 * x);
+        c = 2.0 * seno_medio * seno_medio / z;
+        s = (x - std::sin(x)) / (z * x);
+    } else {
+        const double x = std::sqrt(-z);
+        const double senh_medio = std::sinh(0.5 * x);
+        c = 2.0 * senh_medio * senh_medio / -z;
+        s = (std::sinh(x) - x) / (-z * x);
+    }
+}
+
+bool propagarKepler(double mu, double dt, double& x, double& y, double& z,
+                    double& vx, double& vy, double& vz) {
+    const double r0 = std::sqrt(x * x + y * y + z * z);
+    if (r0 == 0 || mu <= 0) return false;
+    const double raiz_mu = std::sqrt(mu);
+    const double sigma0 = (x * vx + y * vy + z * vz) / raiz_mu;
+    const double alfa = 2.0 / r0 - (vx * vx + vy * vy + vz * vz) / mu; // 1/a
+    const double beta = 1.0 - alfa * r0;
+
+    // Laguerre-Conway (n = 5) sobre F(χ) = σ₀χ²C + (1 - αr₀)χ³S + r₀χ - √μ·dt
+    double chi = raiz_mu * dt / r0;
+    double c = 0.5, s = 1.0 / 6.0;
+    bool convergio = false;
+    for (int iteracion = 0; iteracion < 50 && !convergio; ++iteracion) {
+        const double chi2 = chi * chi;
+        const double zeta = alfa * chi2;
+        stumpff(zeta, c, s);
+        const double F = sigma0 * chi2 * c + beta * chi2 * chi * s + r0 * chi - raiz_mu * dt;
+        const double dF = sigma0 * chi * (1.0 - zeta * s) + beta * chi2 * c + r0;
+        const double ddF = sigma0 * (1.0 - zeta * c) + beta * chi * (1.0 - zeta * s);
+        const double raiz = std::sqrt(std::fabs(16.0 * dF * dF - 20.0 * F * ddF));
+        const double delta = 5.0 * F / (dF + (dF >= 0 ? raiz : -raiz));
+        chi -= delta;
+        // La convergencia es cúbica: con |δ| < 1e-9·|χ| el error restante ya está bajo el redondeo
+        convergio = std::fabs(delta) <= 1e-9 * std::fabs(chi) || delta == 0;
+    }
+    if (!convergio) return false;
+
+    const double chi2 = chi * chi;
+    const double zeta = alfa * chi2;
+    stumpff(zeta, c, s);
+    // Coeficientes de Lagrange
+    const double f = 1.0 - chi2 / r0 * c;
+    const double g = dt - chi2 * chi / raiz_mu * s;
+    const double x1 = f * x + g * vx, y1 = f * y + g * vy, z1 = f * z + g * vz;
+    const double r1 = std::sqrt(x1 * x1 + y1 * y1 + z1 * z1);
+    const double f_punto = raiz_mu / (r1 * r0) * chi * (zeta * s - 1.0);
+    const double g_punto = 1.0 - chi2 / r1 * c;
+    const double vx1 = f_punto * x + g_punto * vx;
+    const double vy1 = f_punto * y + g_punto * vy;
+    const double vz1 = f_punto * z + g_punto * vz;
+    x = x1; y = y1; z = z1;
+    vx = vx1; vy = vy1; vz = vz1;
+    return true;
+}
+
+double IntegradorWisdomHolman::iniciar(const SistemaCuerpos& cuerpos) {
+    const int n = cuerpos.tamano();
+    orden_.resize(n);
+    for (int i = 0; i < n; ++i) orden_[i] = i;
+    if (n == 0) return 0.0;
+
+    // Central: la mayor masa; los demás por distancia a él (jerarquía de Jacobi)
+    const int c = static_cast<int>(std::max_element(cuerpos.m.begin(), cuerpos.m.end()) - cuerpos.m.begin());
+    std::vector<double> distancia(n);
+    for (int i = 0; i < n; ++i) {
+        const double dx = cuerpos.x[i] - cuerpos.x[c], dy = cuerpos.y[i] - cuerpos.y[c], dz = cuerpos.z[i] - cuerpos.z[c];
+        distancia[i] = (i == c) ? -1.0 : dx * dx + dy * dy + dz * dz;
+    }
+    std::stable_sort(orden_.begin(), orden_.end(),
+                     [&distancia](int a, int b) { return distancia[a] < distancia[b]; });
+
+    fallos_kepler_ = 0;
+    masa_.resize(n);
+    masa_acum_.resize(n);
+    qx_.assign(n, 0.0); qy_.assign(n, 0.0); qz_.assign(n, 0.0);
+    ux_.assign(n, 0.0); uy_.assign(n, 0.0); uz_.assign(n, 0.0);
+
+    // Inercial → Jacobi: qₖ = xₖ - R_{k-1}, con R el centro de masa de los anteriores
+    const int i0 = orden_[0];
+    double rx = cuerpos.x[i0], ry = cuerpos.y[i0], rz = cuerpos.z[i0];
+    double wx = cuerpos.vx[i0], wy = cuerpos.vy[i0], wz = cuerpos.vz[i0];
+    double M = cuerpos.m[i0];
+    masa_[0] = M;
+    masa_acum_[0] = M;
+    for (int k = 1; k < n; ++k) {
+        const int i = orden_[k];
+        const double m = cuerpos.m[i];
+        qx_[k] = cuerpos.x[i] - rx; qy_[k] = cuerpos.y[i] - ry; qz_[k] = cuerpos.z[i] - rz;
+        ux_[k] = cuerpos.vx[i] - wx; uy_[k] = cuerpos.vy[i] - wy; uz_[k] = cuerpos.vz[i] - wz;
+        M += m;
+        const double fraccion = m / M;
+        rx += fraccion * qx_[k]; ry += fraccion * qy_[k]; rz += fraccion * qz_[k];
+        wx += fraccion * ux_[k]; wy += fraccion * uy_[k]; wz += fraccion * uz_[k];
+        masa_[k] = m;
+        masa_acum_[k] = M;
+    }
+    qx_[0] = rx; qy_[0] = ry; qz_[0] = rz;
+    ux_[0] = wx; uy_[0] = wy; uz_[0] = wz;
+    return (M - masa_[0]) / masa_[0];
+}
+
+void IntegradorWisdomHolman::impulso(const SistemaCuerpos& cuerpos, double dt) {
+    const int n = static_cast<int>(orden_.size());
+    if (n == 0) return;
+    // Las aceleraciones se llevan a Jacobi con la misma transformación que las posiciones
+    const int i0 = orden_[0];
+    double Ax = cuerpos.ax[i0], Ay = cuerpos.ay[i0], Az = cuerpos.az[i0];
+    for (int k = 1; k < n; ++k) {
+        const int i = orden_[k];
+        const double ajx = cuerpos.ax[i] - Ax, ajy = cuerpos.ay[i] - Ay, ajz = cuerpos.az[i] - Az;
+        const double fraccion = masa_[k] / masa_acum_[k];
+        Ax += fraccion * ajx; Ay += fraccion * ajy; Az += fraccion * ajz;
+
+        // Se quita el término kepleriano -G·Mₖ·qₖ/|qₖ|³, que integra la deriva
+        const double r2 = qx_[k] * qx_[k] + qy_[k] * qy_[k] + qz_[k] * qz_[k];
+        const double kepler = (r2 > 0) ? G * masa_acum_[k] / (r2 * std::sqrt(r2)) : 0.0;
+        ux_[k] += dt * (ajx + kepler * qx_[k]);
+        uy_[k] += dt * (ajy + kepler * qy_[k]);
+        uz_[k] += dt * (ajz + kepler * qz_[k]);
+    }
+    // Aceleración del centro de masa (nula salvo redondeo con un motor exacto)
+    ux_[0] += dt * Ax; uy_[0] += dt * Ay; uz_[0] += dt * Az;
+}
+
+void IntegradorWisdomHolman::derivaKepler(double dt) {
+    const int n = static_cast<int>(orden_.size());
+    if (n == 0) return;
+    qx_[0] += ux_[0] * dt; qy_[0] += uy_[0] * dt; qz_[0] += uz_[0] * dt;
+    for (int k = 1; k < n; ++k) {
+        if (!propagarKepler(G * masa_acum_[k], dt, qx_[k], qy_[k], qz_[k], ux_[k], uy_[k], uz_[k])) fallos_kepler_++;
+    }
+}
+
+void IntegradorWisdomHolman::sincronizar(SistemaCuerpos& cuerpos) const {
+    const int n = static_cast<int>(orden_.size());
+    if (n == 0) return;
+    // Jacobi → inercial, del último cuerpo al central: R_{k-1} = R_k - (mₖ/Mₖ)·qₖ, xₖ = R_{k-1} + qₖ
+    double rx = qx_[0], ry = qy_[0], rz = qz_[0];
+    double wx = ux_[0], wy = uy_[0], wz = uz_[0];
+    for (int k = n - 1; k >= 1; --k) {
+        const int i = orden_[k];
+        const double fraccion = masa_[k] / masa_acum_[k];
+        rx -= fraccion * qx_[k]; ry -= fraccion * qy_[k]; rz -= fraccion * qz_[k];
+        wx -= fraccion * ux_[k]; wy -= fraccion * uy_[k]; wz -= fraccion * uz_[k];
+        cuerpos.x[i] = rx + qx_[k]; cuerpos.y[i] = ry + qy_[k]; cuerpos.z[i] = rz + qz_[k];
+        cuerpos.vx[i] = wx + ux_[k]; cuerpos.vy[i] = wy + uy_[k]; cuerpos.vz[i] = wz + uz_[k];
+    }
+    const int i0 = orden_[0];
+    cuerpos.x[i0] = rx; cuerpos.y[i0] = ry; cuerpos.z[i0] = rz;
+    cuerpos.vx[i0] = wx; cuerpos.vy[i0] = wy; cuerpos.vz[i0] = wz;
+}
+
+void IntegradorWisdomHolman::guardarEstado(EstadoSerializado& estado) const {
+    estado.escribirVector(orden_);
+    estado.escribirVector(masa_);
+    estado.escribirVector(masa_acum_);
+    estado.escribirVector(qx_); estado.escribirVector(qy_); estado.escribirVector(qz_);
+    estado.escribirVector(ux_); estado.escribirVector(uy_); estado.escribirVector(uz_);
+    estado.escribir(fallos_kepler_);
+}
+
+bool IntegradorWisdomHolman::cargarEstado(EstadoSerializado& estado, int n) {
+    const unsigned long long maximo = static_cast<unsigned long long>(n);
+    estado.leerVector(orden_, maximo);
+    estado.leerVector(masa_, maximo);
+    estado.leerVector(masa_acum_, maximo);
+    estado.leerVector(qx_, maximo); estado.leerVector(qy_, maximo); estado.leerVector(qz_, maximo);
+    estado.leerVector(ux_, maximo); estado.leerVector(uy_, maximo); estado.leerVector(uz_, maximo);
+    estado.leer(fallos_kepler_);
+    return estado.valido() && static_cast<int>(orden_.size()) == n && static_cast<int>(uz_.size()) == n;
+}
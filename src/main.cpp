@@ -15,10 +15,34 @@
 #include <limits>
 #include <iomanip>
 #include <cstdlib>
+#include <chrono>
+#include <algorithm>
 
 #include "vector3D.h"
 #include "Cuerpo.h"
 #include "utilidades.h"
+#include "SistemaCuerpos.h"
+#include "Fuerzas.h"
+#include "FuerzasSIMD.h"
+#include "SumaDirectaParalela.h"
+#include "ContadorAsignaciones.h"
+#include "Trayectoria.h"
+#include "SalidaAsincrona.h"
+#include "Escenario.h"
+#include "CargaCuerpos.h"
+#include "Integradores.h"
+#include "PasosBloque.h"
+#include "Hermite.h"
+#include "Composicion.h"
+#include "WisdomHolman.h"
+#include "IAS15.h"
+#include "RESPA.h"
+#include "PuntoControl.h"
+#include "Instrumentacion.h"
+#include "BarnesHut.h"
+#include "FMM.h"
+#include "ConjuntoSistemas.h"
+#include "BarridoParametros.h"
 
 /**
  * @brief Variables globales para la simulación
@@ -27,8 +51,45 @@
 int N_cuerpos;                           ///< Número de cuerpos en la simulación
 double dt_sim;                          ///< Paso de tiempo [unidades de tiempo]
 double t_max_sim;                       ///< Tiempo total de simulación [unidades de tiempo]
-std::vector<Cuerpo> planetas;           ///< Contenedor de todos los cuerpos
-std::vector<vector3D> fuerzas_siguientes; ///< Fuerzas F(t+dt) para algoritmo de Verlet
+SistemaCuerpos planetas;                 ///< Contenedor SoA de todos los cuerpos
+Aceleraciones aceleraciones_siguientes;  ///< Buffer de a(t+dt) para Verlet; se intercambia con planetas.ax/ay/az
+TipoMotorFuerzas motor_fuerzas_sim = MOTOR_DIRECTO; ///< Motor usado para evaluar las fuerzas
+int hilos_sim = 1;                       ///< Hilos usados por la suma directa
+SumaDirectaParalela motor_directo;       ///< Estado reutilizable de la suma directa multihilo
+double theta_sim = 0.5;                  ///< Ángulo de apertura θ para Barnes-Hut
+BarnesHut motor_barnes_hut;              ///< Estado reutilizable del motor Barnes-Hut
+int orden_fmm_sim = 8;                   ///< Orden p de las expansiones del FMM
+FMM motor_fmm;                           ///< Estado reutilizable del motor FMM
+TipoIntegrador integrador_sim = INTEGRADOR_VERLET; ///< Esquema de integración temporal
+IntegradorBloques integrador_bloques;    ///< Niveles y estado de los pasos por bloques
+IntegradorHermite integrador_hermite;    ///< Jerks y estado del inicio del paso de Hermite
+int orden_composicion_sim = 4;           ///< Orden de la composición simpléctica (4, 6 u 8)
+IntegradorWisdomHolman integrador_wisdom_holman; ///< Coordenadas de Jacobi de Wisdom-Holman
+IntegradorIAS15 integrador_ias15;        ///< Coeficientes y control de paso de IAS15
+IntegradorRESPA integrador_respa;        ///< Lista de pares y fuerzas cercanas/lejanas de RESPA
+int cadencia_diagnosticos_sim = 0;       ///< Diagnósticos cada k pasos (0 = en cada paso de salida)
+double energia_potencial_sim = 0.0;      ///< U de la última evaluación de fuerzas que la calculó
+FormatoTrayectoria formato_trayectoria_sim = TRAYECTORIA_TEXTO; ///< Formato de results/sim_data.*
+int capacidad_salida_sim = 0;            ///< Cuadros del anillo de salida (0 = automático)
+PoliticaSaturacion politica_salida_sim = SATURACION_ESPERAR; ///< Qué hacer con el anillo de salida lleno
+SeleccionSalida seleccion_salida_sim = {0, 0, CAMPOS_POR_DEFECTO}; ///< Cuerpos y campos escritos (0 cuerpos = todos)
+int cada_pasos_salida_sim = 1;           ///< Escribir la trayectoria cada k pasos
+double intervalo_salida_sim = 0.0;       ///< Escribir cada Δt de tiempo simulado (0 = usar cada_pasos_salida_sim)
+double tiempo_fuerzas_sim = 0.0;         ///< Tiempo acumulado en evaluaciones de fuerza [s]
+long evaluaciones_fuerzas_sim = 0;       ///< Número de evaluaciones de fuerza realizadas
+int punto_control_cada_sim = 0;          ///< Punto de control cada k pasos (0 = ninguno)
+std::string archivo_punto_control_sim;   ///< Archivo de los puntos de control (vacío = en el directorio de salida)
+std::string reanudar_sim;                ///< Punto de control desde el que se reanuda (vacío = desde t = 0)
+PerfilFases perfil_sim;                  ///< Tiempos por fase (solo se mide si se compila con INSTRUMENTACION)
+bool traza_sim = false;                  ///< Guardar la línea de tiempo de las fases
+int eventos_traza_sim = 1000000;         ///< Capacidad de la línea de tiempo en eventos
+bool contadores_sim = false;             ///< Leer contadores de hardware por fase
+int conjunto_sim = 0;                    ///< Miembros del conjunto de sistemas perturbados (0 = una sola simulación)
+double perturbacion_sim = 1e-3;          ///< Amplitud relativa de la perturbación de los miembros
+int semilla_sim = 1;                     ///< Semilla de las perturbaciones
+double radio_escape_sim = 0.0;           ///< Radio de escape de los miembros (0 = sin límite)
+std::vector<DimensionBarrido> barrido_sim; ///< Dimensiones del barrido de parámetros (vacío = una sola simulación)
+int hilos_barrido_sim = 0;               ///< Hilos del barrido (0 = todos los núcleos)
 
 /**
  * @brief Solicita y valida los datos de entrada del usuario
@@ -38,36 +99,268 @@ std::vector<vector3D> fuerzas_siguientes; ///< Fuerzas F(t+dt) para algoritmo de
 
 void solicitarDatos();
 
+/**
+ * @brief Carga las condiciones iniciales de un archivo CSV o binario
+ * @param ruta Archivo con un cuerpo por línea (CSV) o por columnas (binario)
+ * @return true si todos los cuerpos son válidos
+ * @details Llena planetas directamente con cargarCuerpos(), usando todos los
+ *          núcleos, e informa el rendimiento de la carga en cuerpos/s
+ */
+bool cargarArchivoCuerpos(const std::string& ruta);
+
+/**
+ * @brief Solicita las opciones avanzadas de la simulación
+ * @details Permite elegir el motor de fuerzas y sus parámetros. Si el usuario
+ *          no desea configurarlas se conservan los valores por defecto
+ *          (suma directa)
+ */
+void solicitarOpcionesAvanzadas();
+
+/**
+ * @brief Solicita las opciones de escritura de la trayectoria
+ * @details Formato, campos, rango de cuerpos, frecuencia de escritura
+ *          (cada k pasos o cada Δt de tiempo simulado) y búfer de la
+ *          salida asíncrona. Se llama desde solicitarOpcionesAvanzadas()
+ */
+void solicitarOpcionesSalida();
+
+/**
+ * @brief Carga la configuración desde la línea de comandos, sin preguntas
+ * @param argc Número de argumentos
+ * @param argv Argumentos: `--escenario RUTA` y opciones `--clave valor` o
+ *        `--clave=valor` con las claves del archivo de escenario (los guiones
+ *        equivalen a guiones bajos); las opciones tienen prioridad sobre el archivo
+ * @param escenario Configuración resultante
+ * @param error Descripción del problema si algún argumento no es válido
+ * @return true si todos los argumentos son válidos
+ */
+bool interpretarLineaComandos(int argc, char* argv[], Escenario& escenario, std::string& error);
+
+/**
+ * @brief Copia un escenario en las variables globales de la simulación
+ * @param escenario Configuración cargada del archivo y de la línea de comandos
+ * @return false si el escenario no tiene cuerpos válidos (el error ya se informó)
+ */
+bool aplicarEscenario(const Escenario& escenario);
+
+/// Muestra la ayuda del modo por lotes
+void mostrarUso(const char* programa);
+
+/**
+ * @brief Serializa el estado completo de la simulación
+ * @param estado Búfer que se vacía y se llena (conserva su capacidad)
+ * @param t Tiempo actual
+ * @param paso Índice del paso que empieza en t
+ * @param E_inicial Energía del primer diagnóstico
+ * @param E_final Energía del último diagnóstico
+ * @details Guarda la configuración que afecta a la trayectoria (N, dt,
+ *          integrador, motor y sus parámetros), el tiempo, los contadores,
+ *          todos los arreglos de planetas, el buffer de aceleraciones y el
+ *          estado del integrador elegido. No hay generadores aleatorios que guardar.
+ */
+void guardarPuntoControl(EstadoSerializado& estado, double t, long paso, double E_inicial, double E_final);
+
+/**
+ * @brief Restaura un punto de control sobre la configuración actual
+ * @param ruta Archivo escrito por guardarPuntoControl() y EscritorPuntosControl
+ * @param t Salida: tiempo del punto de control
+ * @param paso Salida: índice del paso que empieza en t
+ * @param E_inicial Salida: energía del primer diagnóstico de la ejecución original
+ * @param E_final Salida: energía del último diagnóstico antes del punto de control
+ * @return false si el archivo no es válido o no corresponde a la configuración (el error ya se informó)
+ * @pre La simulación ya está inicializada (buffers e integrador dimensionados)
+ */
+bool cargarPuntoControl(const std::string& ruta, double& t, long& paso, double& E_inicial, double& E_final);
+
 /**
  * @brief Verifica la validez de los datos ingresados
  * @return true si todos los datos son válidos, false en caso contrario
  * @details Verifica masas positivas y que no haya cuerpos en la misma posición
+ *          (con buscarPosicionesCoincidentes(), O(N log N))
  */
 bool verificarDatos();
 
 /**
- * @brief Calcula las fuerzas gravitacionales para todos los cuerpos
- * @param cuerpos_actuales Vector de cuerpos con posiciones actuales
- * @param fuerzas_a_calcular Vector donde se almacenan las fuerzas calculadas
- * @details Implementa la suma de fuerzas N-cuerpos evitando doble conteo
- * @note Complejidad: O(N²) donde N es el número de cuerpos
+ * @brief Calcula las fuerzas con el motor seleccionado por el usuario
+ * @param cuerpos_actuales Sistema con posiciones actuales
+ * @param aceleraciones_a_calcular Salida con la aceleración de cada cuerpo
+ * @param con_potencial Si es true, el motor acumula también la energía
+ *        potencial en el mismo recorrido y la deja en energia_potencial_sim
+ * @details Despacha a la suma directa (con hilos_sim hilos), Barnes-Hut o FMM según
+ *          motor_fuerzas_sim y acumula el tiempo empleado
+ */
+void calcularFuerzas(const SistemaCuerpos& cuerpos_actuales,
+                     Aceleraciones& aceleraciones_a_calcular, bool con_potencial);
+
+/**
+ * @brief Calcula las fuerzas sobre un subconjunto de cuerpos con el motor seleccionado
+ * @param cuerpos_actuales Sistema con las posiciones de todos los cuerpos
+ * @param activos Índices de los cuerpos cuya aceleración se necesita
+ * @param aceleraciones_a_calcular Salida; al menos las entradas de los activos
+ * @details Usa la suma directa, que solo evalúa los activos (los pasos por
+ *          bloques no se admiten con Barnes-Hut ni FMM)
+ */
+void calcularFuerzasActivos(const SistemaCuerpos& cuerpos_actuales, const std::vector<int>& activos,
+                            Aceleraciones& aceleraciones_a_calcular);
+
+/**
+ * @brief Calcula aceleraciones y jerks para el integrador de Hermite
+ * @param cuerpos_actuales Sistema con posiciones y velocidades actuales
+ * @param aceleraciones_a_calcular Salida con la aceleración de cada cuerpo
+ * @param jerks_a_calcular Salida con el jerk de cada cuerpo
+ * @param con_potencial Si es true, deja U en energia_potencial_sim
+ * @details Siempre por suma directa con calcularAceleracionesYJerks(); se
+ *          contabiliza como una evaluación de fuerzas más
+ */
+void calcularFuerzasYJerks(const SistemaCuerpos& cuerpos_actuales, Aceleraciones& aceleraciones_a_calcular,
+                           Aceleraciones& jerks_a_calcular, bool con_potencial);
+
+/**
+ * @brief Calcula las fuerzas cercanas de RESPA sobre la lista de pares
+ * @param cuerpos_actuales Sistema con posiciones actuales
+ * @details Delega en integrador_respa.evaluarCercanas(); se contabiliza como
+ *          una evaluación de fuerzas más, aunque solo recorra la lista
+ */
+void calcularFuerzasCercanas(const SistemaCuerpos& cuerpos_actuales);
+
+/**
+ * @brief Indica si en un paso se escribe un cuadro de la trayectoria
+ * @param paso Índice del paso (0 = condición inicial)
+ * @return Con intervalo_salida_sim > 0, true en el primer paso de cada
+ *         intervalo Δt de tiempo simulado; si no, cada cada_pasos_salida_sim pasos
+ */
+bool esPasoSalida(long paso);
+
+/**
+ * @brief Indica si en un paso se calculan los diagnósticos
+ * @param paso Índice del paso (0 = condición inicial)
+ * @return Los pasos de salida si cadencia_diagnosticos_sim es 0, o cada
+ *         cadencia_diagnosticos_sim pasos en otro caso
+ */
+bool esPasoDiagnostico(long paso);
+
+/**
+ * @brief Avanza un paso de Verlet de velocidades con doble buffer de aceleraciones
+ * @param cuerpos Sistema a integrar; contiene a(t) al entrar y a(t+dt) al salir
+ * @param a_siguiente Buffer persistente para a(t+dt); al salir contiene a(t)
+ * @param dt Paso de tiempo [unidades de tiempo]
+ * @param con_potencial Si es true, la evaluación de fuerzas en t+dt calcula también U
+ * @details Las aceleraciones nuevas se calculan en a_siguiente y al final
+ *          se intercambian con las de cuerpos, de modo que el paso no copia
+ *          el estado ni asigna memoria
+ */
+void pasoVerlet(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial);
+
+/**
+ * @brief Avanza un paso dt con pasos individuales por bloques
+ * @param cuerpos Sistema a integrar; todos los cuerpos quedan sincronizados en t+dt
+ * @param a_siguiente Buffer de aceleraciones de los cuerpos activos
+ * @param con_potencial Si es true, la evaluación del último subpaso (con
+ *        todos los cuerpos activos) calcula también U
+ * @details Visita solo los subpasos de integrador_bloques en que hay cuerpos
+ *          activos; en cada uno se evalúan únicamente las fuerzas sobre ellos
+ */
+void pasoBloques(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, bool con_potencial);
+
+/**
+ * @brief Avanza un paso del predictor-corrector de Hermite de cuarto orden
+ * @param cuerpos Sistema a integrar; contiene a(t) al entrar y a(t+dt) al salir
+ * @param a_siguiente Buffer persistente para a(t+dt); al salir contiene a(t)
+ * @param dt Paso de tiempo [unidades de tiempo]
+ * @param con_potencial Si es true, deja en energia_potencial_sim la U de las
+ *        posiciones corregidas (una pasada O(N²) extra, solo en esos pasos)
+ * @details Mismo doble buffer que pasoVerlet(); los jerks los guarda integrador_hermite.
+ *          La U de la evaluación de fuerzas correspondería a las posiciones
+ *          predichas y no se combinaría con la K del estado corregido.
+ */
+void pasoHermite(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial);
+
+/**
+ * @brief Avanza un paso con la composición simpléctica de orden orden_composicion_sim
+ * @param cuerpos Sistema a integrar; contiene a(t) al entrar y a(t+dt) al salir
+ * @param a_siguiente Buffer persistente de aceleraciones
+ * @param dt Paso de tiempo [unidades de tiempo]
+ * @param con_potencial Si es true, la última evaluación del paso calcula también U
+ * @details Elige la instancia de pasoComposicion() (Forest-Ruth, Yoshida 6 u 8);
+ *          las fuerzas de cada etapa las evalúa calcularFuerzas() con el motor elegido
+ */
+void pasoComposicionSimplectica(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial);
+
+/**
+ * @brief Avanza un paso de Wisdom-Holman: impulso(dt/2), Kepler(dt), impulso(dt/2)
+ * @param cuerpos Sistema a integrar; contiene a(t) al entrar y a(t+dt) al salir
+ * @param a_siguiente Buffer persistente de aceleraciones
+ * @param dt Paso de tiempo [unidades de tiempo]
+ * @param con_potencial Si es true, la evaluación en t+dt calcula también U
+ * @details Una evaluación de fuerzas por paso, con el motor elegido; la
+ *          aceleración del final de un paso da el primer impulso del siguiente
+ */
+void pasoWisdomHolman(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial);
+
+/**
+ * @brief Avanza un intervalo dt con IAS15 y pasos internos adaptativos
+ * @param cuerpos Sistema a integrar; contiene a(t) al entrar y a(t+dt) al salir
+ * @param a_siguiente Buffer de aceleraciones para las evaluaciones de cada paso interno
+ * @param dt Intervalo a recorrer [unidades de tiempo]
+ * @param con_potencial Si es true, la evaluación en t+dt calcula también U
+ * @return Tiempo avanzado: dt, o menos si un choque de masas puntuales detuvo el integrador
+ * @details Los pasos internos los elige integrador_ias15 con su tolerancia;
+ *          las fuerzas las evalúa calcularFuerzas() con el motor elegido
+ */
+double pasoIAS15(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial);
+
+/**
+ * @brief Avanza un paso RESPA: fuerzas lejanas con paso dt y cercanas con M subpasos
+ * @param cuerpos Sistema a integrar; contiene a(t) al entrar y a(t+dt) al salir
+ * @param a_siguiente Buffer persistente para a(t+dt); al salir contiene a(t)
+ * @param dt Paso de tiempo de las fuerzas lejanas [unidades de tiempo]
+ * @param con_potencial Si es true, la evaluación completa en t+dt calcula también U
+ * @details Una evaluación completa por paso, con el motor elegido; los
+ *          subpasos solo recorren la lista de pares cercanos de integrador_respa
+ */
+void pasoRESPA(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial);
+
+/**
+ * @brief Informa el error de las fuerzas aproximadas frente a la suma directa
+ * @param cuerpos_actuales Sistema con posiciones actuales
+ * @param aceleraciones_calculadas Aceleraciones obtenidas con el motor seleccionado
+ * @details Con suma directa informa el núcleo SIMD elegido y su diferencia
+ *          con el núcleo escalar de referencia. Con FMM también informa el
+ *          error de los potenciales
+ */
+void reportarErrorFuerzas(const SistemaCuerpos& cuerpos_actuales,
+                          const Aceleraciones& aceleraciones_calculadas);
+
+/**
+ * @brief Integra el sistema y escribe trayectoria y diagnósticos
+ * @param directorio_salida Directorio (ya existente) para sim_data.* y diagnosticos.dat
+ * @return 0 si la simulación terminó, 1 si no se pudieron crear los archivos
  */
-void calcularTodasLasFuerzas(std::vector<Cuerpo>& cuerpos_actuales, 
-                            std::vector<vector3D>& fuerzas_a_calcular);
+int ejecutarSimulacion(const std::string& directorio_salida);
 
 /**
- * @brief Calcula la energía cinética total del sistema
- * @param cuerpos_actuales Vector de cuerpos con velocidades actuales
- * @return Energía cinética total K = Σ(½mᵢvᵢ²)
+ * @brief Integra conjunto_sim copias perturbadas del sistema en carriles SIMD
+ * @param directorio_salida Directorio (ya existente) para conjunto.dat
+ * @return 0 si la integración terminó, 1 si no se pudo escribir el resultado
+ * @details Usa ConjuntoSistemas: Verlet de paso dt_sim con suma directa en
+ *          doble precisión, con los mismos pasos que ejecutarSimulacion()
+ *          o hasta que todos los miembros choquen o escapen. verificarDatos()
+ *          rechaza otro integrador, motor o precisión. Informa los
+ *          sistemas·pasos por segundo.
  */
-double calcularEnergiaCineticaTotal(const std::vector<Cuerpo>& cuerpos_actuales);
+int ejecutarConjunto(const std::string& directorio_salida);
 
 /**
- * @brief Calcula la energía potencial gravitacional total
- * @param cuerpos_actuales Vector de cuerpos con posiciones actuales
- * @return Energía potencial total U = -Σᵢ<ⱼ(Gmᵢmⱼ/rᵢⱼ)
+ * @brief Ejecuta el barrido de parámetros de barrido_sim
+ * @param directorio_salida Directorio (ya existente) para barrido.dat y barrido/
+ * @return 0 si todos los trabajos terminaron, 1 si no se pudo escribir algún archivo
+ * @details Cada combinación de la rejilla se integra con Verlet y suma
+ *          directa (verificarDatos() rechaza otra elección), con los mismos
+ *          pasos que ejecutarSimulacion(), en un hilo de GrupoTareas, con su propia
+ *          trayectoria SALIDA/barrido/trabajo_NNNN.* escrita cada
+ *          cada_pasos_salida_sim pasos. El resumen queda en SALIDA/barrido.dat.
  */
-double calcularEnergiaPotencialTotal(const std::vector<Cuerpo>& cuerpos_actuales);
+int ejecutarBarrido(const std::string& directorio_salida);
 
 /**
  * @brief Interfaz para seleccionar herramienta de graficación
@@ -79,15 +372,26 @@ void graficarResultados();
 
 void solicitarDatos() {
     std::cout << "--- Configuración de la Simulación Gravitacional N-Cuerpos ---" << std::endl;
-    std::cout << "Ingrese el número de cuerpos (N): ";
-    while (!(std::cin >> N_cuerpos) || N_cuerpos <= 0) {
-        std::cout << "Error: Por favor, ingrese un entero positivo para N: ";
+    std::cout << "Ingrese el número de cuerpos (N; 0 = cargar desde un archivo CSV o binario): ";
+    while (!(std::cin >> N_cuerpos) || N_cuerpos < 0) {
+        std::cout << "Error: Por favor, ingrese un entero no negativo para N: ";
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
-    planetas.resize(N_cuerpos);
-    fuerzas_siguientes.resize(N_cuerpos);
-    for (int i = 0; i < N_cuerpos; ++i) {
+    const bool desde_archivo = (N_cuerpos == 0);
+    if (desde_archivo) {
+        std::cout << "Archivo de cuerpos (una línea 'masa, radio, x, y, z, vx, vy, vz' por cuerpo, o binario): ";
+        std::string ruta;
+        while (!(std::cin >> ruta) || !cargarArchivoCuerpos(ruta)) {
+            std::cout << "Ingrese otro archivo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+    } else {
+        planetas.redimensionar(N_cuerpos);
+        aceleraciones_siguientes.redimensionar(N_cuerpos);
+    }
+    for (int i = 0; i < N_cuerpos && !desde_archivo; ++i) {
         std::cout << "\n--- Datos para el Cuerpo " << i + 1 << " ---" << std::endl;
         double x, y, z, vx, vy, vz, m, r;
         std::cout << "Masa: ";
@@ -114,7 +418,9 @@ void solicitarDatos() {
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         }
-        planetas[i].Inicie(x, y, z, vx, vy, vz, m, r);
+        Cuerpo cuerpo;
+        cuerpo.Inicie(x, y, z, vx, vy, vz, m, r);
+        planetas.fijarCuerpo(i, cuerpo);
     }
     std::cout << "\n--- Parámetros de Simulación ---" << std::endl;
     std::cout << "Paso de tiempo (dt): ";
@@ -129,26 +435,217 @@ void solicitarDatos() {
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
+    solicitarOpcionesAvanzadas();
+}
+
+void solicitarOpcionesAvanzadas() {
+    std::cout << "¿Configurar opciones avanzadas (motor de fuerzas)? (s/n): ";
+    std::string respuesta;
+    std::cin >> respuesta;
+    if (respuesta != "s" && respuesta != "S") return;
+
+    std::cout << "\n--- Opciones Avanzadas ---" << std::endl;
+    std::cout << "Motor de fuerzas:" << std::endl;
+    std::cout << "1. Suma directa O(N²) (exacta)" << std::endl;
+    std::cout << "2. Barnes-Hut O(N log N) (aproximada)" << std::endl;
+    std::cout << "3. FMM O(N) (aproximada, calcula potenciales en la misma pasada)" << std::endl;
+    std::cout << "Opción: ";
+    int motor;
+    while (!(std::cin >> motor) || motor < MOTOR_DIRECTO || motor > MOTOR_FMM) {
+        std::cout << "Error: Opción no válida. Ingrese de nuevo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    motor_fuerzas_sim = static_cast<TipoMotorFuerzas>(motor);
+    if (motor_fuerzas_sim == MOTOR_DIRECTO) {
+        std::cout << "Número de hilos (0 = todos los núcleos, " << GrupoHilos::hilosDisponibles() << "): ";
+        while (!(std::cin >> hilos_sim) || hilos_sim < 0) {
+            std::cout << "Error: El número de hilos debe ser un entero no negativo. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        if (hilos_sim == 0) { hilos_sim = GrupoHilos::hilosDisponibles(); }
+        motor_directo.fijarHilos(hilos_sim);
+    }
+    if (motor_fuerzas_sim == MOTOR_BARNES_HUT) {
+        std::cout << "Ángulo de apertura θ (0 = exacto, típico 0.5): ";
+        while (!(std::cin >> theta_sim) || theta_sim < 0) {
+            std::cout << "Error: θ debe ser un número real no negativo. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        motor_barnes_hut.fijarTheta(theta_sim);
+    }
+    if (motor_fuerzas_sim == MOTOR_FMM) {
+        std::cout << "Orden de la expansión p (1-20, típico 8): ";
+        while (!(std::cin >> orden_fmm_sim) || orden_fmm_sim < 1 || orden_fmm_sim > 20) {
+            std::cout << "Error: p debe ser un entero entre 1 y 20. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        motor_fmm.fijarOrden(orden_fmm_sim);
+    }
+    std::cout << "Integrador (1 = Verlet con paso global, 2 = Verlet con pasos individuales por bloques, "
+              << "3 = Hermite de 4º orden, 4 = composición simpléctica de Forest-Ruth/Yoshida, "
+              << "5 = Wisdom-Holman para una masa central dominante, 6 = IAS15 de orden 15 con paso adaptativo, "
+              << "7 = RESPA con subpasos para las fuerzas cercanas): ";
+    int integrador;
+    while (!(std::cin >> integrador) || integrador < INTEGRADOR_VERLET || integrador > INTEGRADOR_RESPA) {
+        std::cout << "Error: Opción no válida. Ingrese de nuevo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    integrador_sim = static_cast<TipoIntegrador>(integrador);
+    if (integrador_sim == INTEGRADOR_BLOQUES) {
+        int niveles;
+        double eta;
+        std::cout << "Niveles de paso K (paso mínimo dt/2^K, 0-30, típico 10): ";
+        while (!(std::cin >> niveles) || niveles < 0 || niveles > 30) {
+            std::cout << "Error: K debe ser un entero entre 0 y 30. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        std::cout << "Precisión η del criterio de paso |a|/|da/dt| (típico 0.02): ";
+        while (!(std::cin >> eta) || eta <= 0) {
+            std::cout << "Error: η debe ser un número real positivo. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        integrador_bloques.configurar(niveles, eta);
+    }
+    if (integrador_sim == INTEGRADOR_COMPOSICION) {
+        std::cout << "Orden (4 = Forest-Ruth, 3 fuerzas por paso; 6 = Yoshida, 7; 8 = Yoshida, 15): ";
+        while (!(std::cin >> orden_composicion_sim) ||
+               (orden_composicion_sim != 4 && orden_composicion_sim != 6 && orden_composicion_sim != 8)) {
+            std::cout << "Error: El orden debe ser 4, 6 u 8. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+    }
+    if (integrador_sim == INTEGRADOR_IAS15) {
+        double tolerancia;
+        std::cout << "Tolerancia ε del paso adaptativo (típico 1e-9; dt pasa a ser el intervalo de salida): ";
+        while (!(std::cin >> tolerancia) || tolerancia < TOLERANCIA_MINIMA_IAS15) {
+            std::cout << "Error: ε debe ser al menos " << TOLERANCIA_MINIMA_IAS15 << ". Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        integrador_ias15.configurar(tolerancia);
+    }
+    if (integrador_sim == INTEGRADOR_RESPA) {
+        double radio_interior, radio_exterior;
+        int subpasos;
+        std::cout << "Radio r₁ bajo el que la fuerza de un par es toda cercana: ";
+        while (!(std::cin >> radio_interior) || radio_interior <= 0) {
+            std::cout << "Error: r₁ debe ser un número real positivo. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        std::cout << "Radio r₂ sobre el que la fuerza es toda lejana (típico 2·r₁): ";
+        while (!(std::cin >> radio_exterior) || radio_exterior <= radio_interior) {
+            std::cout << "Error: r₂ debe ser mayor que r₁. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        std::cout << "Subpasos M de las fuerzas cercanas por paso dt (típico 8): ";
+        while (!(std::cin >> subpasos) || subpasos < 1) {
+            std::cout << "Error: M debe ser un entero positivo. Ingrese de nuevo: ";
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        integrador_respa.configurar(radio_interior, radio_exterior, subpasos);
+    }
+    std::cout << "Calcular energía y momentos cada cuántos pasos (0 = en cada paso de salida): ";
+    while (!(std::cin >> cadencia_diagnosticos_sim) || cadencia_diagnosticos_sim < 0) {
+        std::cout << "Error: Ingrese un entero no negativo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    solicitarOpcionesSalida();
+}
+
+void solicitarOpcionesSalida() {
+    std::cout << "Formato de la trayectoria (1 = texto sim_data.dat, 2 = binario sim_data.bin): ";
+    int formato;
+    while (!(std::cin >> formato) || formato < TRAYECTORIA_TEXTO || formato > TRAYECTORIA_BINARIA) {
+        std::cout << "Error: Opción no válida. Ingrese de nuevo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    formato_trayectoria_sim = static_cast<FormatoTrayectoria>(formato);
+    std::cout << "Campos de la trayectoria (p = posiciones, v = velocidades, r = rapidez |v|, e = energías; 0 = pre): ";
+    std::string campos;
+    while (!(std::cin >> campos) || !interpretarCamposSalida(campos, seleccion_salida_sim.campos)) {
+        std::cout << "Error: Use solo las letras p, v, r, e (o 0). Ingrese de nuevo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    if (!(seleccion_salida_sim.campos & CAMPO_POSICIONES)) {
+        std::cout << "Aviso: sin posiciones los scripts de graficación no podrán dibujar las trayectorias." << std::endl;
+    }
+    std::cout << "Cuerpos a escribir: primero y último (1-" << N_cuerpos << "; 0 0 = todos): ";
+    int primero, ultimo;
+    while (!(std::cin >> primero >> ultimo) ||
+           !((primero == 0 && ultimo == 0) || (primero >= 1 && primero <= ultimo && ultimo <= N_cuerpos))) {
+        std::cout << "Error: Ingrese un rango 1 <= primero <= último <= " << N_cuerpos << " (o 0 0): ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    if (primero > 0) {
+        seleccion_salida_sim.primer_cuerpo = primero - 1;
+        seleccion_salida_sim.cuerpos = ultimo - primero + 1;
+    }
+    std::cout << "Escribir la trayectoria cada cuántos pasos (1 = todos): ";
+    while (!(std::cin >> cada_pasos_salida_sim) || cada_pasos_salida_sim < 1) {
+        std::cout << "Error: Ingrese un entero positivo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cout << "O bien cada cuánto tiempo simulado Δt (0 = usar los pasos): ";
+    while (!(std::cin >> intervalo_salida_sim) || intervalo_salida_sim < 0) {
+        std::cout << "Error: Δt debe ser un número real no negativo. Ingrese de nuevo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cout << "Cuadros en el búfer de salida (0 = automático): ";
+    while (!(std::cin >> capacidad_salida_sim) || capacidad_salida_sim < 0) {
+        std::cout << "Error: Ingrese un entero no negativo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cout << "Si el búfer de salida se llena (1 = esperar al escritor, 2 = descartar cuadros): ";
+    int politica;
+    while (!(std::cin >> politica) || politica < SATURACION_ESPERAR || politica > SATURACION_DESCARTAR) {
+        std::cout << "Error: Opción no válida. Ingrese de nuevo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    politica_salida_sim = static_cast<PoliticaSaturacion>(politica);
+    std::cout << "Guardar un punto de control cada cuántos pasos (0 = ninguno): ";
+    while (!(std::cin >> punto_control_cada_sim) || punto_control_cada_sim < 0) {
+        std::cout << "Error: Ingrese un entero no negativo: ";
+        std::cin.clear();
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
 }
 
 bool verificarDatos() {
+    MEDIR_FASE(perfil_sim, FASE_VERIFICACION);
     if (N_cuerpos <= 0) {
         std::cerr << "Error de Verificación: El número de cuerpos debe ser positivo." << std::endl;
         return false;
     }
     for (int i = 0; i < N_cuerpos; ++i) {
-        if (planetas[i].m <= 0) {
+        if (planetas.m[i] <= 0) {
             std::cerr << "Error de Verificación: La masa del cuerpo " << i + 1 << " debe ser estrictamente positiva." << std::endl;
             return false;
         }
-        for (int j = i + 1; j < N_cuerpos; ++j) {
-            vector3D dr = planetas[i].r - planetas[j].r;
-            if (dr.norm2() < 1e-12) {
-                std::cerr << "Error de Verificación: Los cuerpos " << i + 1 << " y " << j + 1
-                          << " no pueden tener la misma posición inicial." << std::endl;
-                return false;
-            }
-        }
+    }
+    int i, j;
+    if (buscarPosicionesCoincidentes(planetas, SEPARACION_MINIMA_CUERPOS, i, j)) {
+        std::cerr << "Error de Verificación: Los cuerpos " << i + 1 << " y " << j + 1
+                  << " no pueden tener la misma posición inicial." << std::endl;
+        return false;
     }
     if (dt_sim <= 0) {
         std::cerr << "Error de Verificación: El paso de tiempo (dt) debe ser estrictamente positivo." << std::endl;
@@ -158,47 +655,365 @@ bool verificarDatos() {
         std::cerr << "Error de Verificación: El tiempo total (t_max) debe ser positivo y mayor o igual que dt." << std::endl;
         return false;
     }
+    if (seleccion_salida_sim.primer_cuerpo + seleccion_salida_sim.cuerpos > N_cuerpos) {
+        std::cerr << "Error de Verificación: El rango de cuerpos de salida excede los " << N_cuerpos << " cuerpos." << std::endl;
+        return false;
+    }
+    if (integrador_sim == INTEGRADOR_BLOQUES && motor_fuerzas_sim != MOTOR_DIRECTO) {
+        // Barnes-Hut reconstruiría el árbol y el FMM evaluaría todos los cuerpos en cada
+        // subpaso: el costo superaría al de un paso global con el nivel más fino
+        std::cerr << "Error de Verificación: Los pasos por bloques solo admiten el motor de suma directa." << std::endl;
+        return false;
+    }
+    if (conjunto_sim > 0 && !barrido_sim.empty()) {
+        std::cerr << "Error de Verificación: conjunto y barrido no se pueden combinar." << std::endl;
+        return false;
+    }
+    if ((conjunto_sim > 0 || !barrido_sim.empty()) &&
+        (integrador_sim != INTEGRADOR_VERLET || motor_fuerzas_sim != MOTOR_DIRECTO || motor_directo.precisionMixta())) {
+        // Sus miembros y trabajos tienen su propio estado y no pasan por los motores globales
+        std::cerr << "Error de Verificación: " << (conjunto_sim > 0 ? "El conjunto" : "El barrido")
+                  << " solo admite el integrador Verlet y la suma directa en doble precisión." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool interpretarLineaComandos(int argc, char* argv[], Escenario& escenario, std::string& error) {
+    // Primero el archivo de escenario, para que las demás opciones lo sobrescriban
+    std::vector<std::pair<std::string, std::string> > opciones;
+    for (int k = 1; k < argc; ++k) {
+        std::string argumento = argv[k];
+        if (argumento.compare(0, 2, "--") != 0 || argumento.size() == 2) {
+            error = "argumento no reconocido '" + argumento + "'";
+            return false;
+        }
+        std::string clave = argumento.substr(2), valor;
+        size_t igual = clave.find('=');
+        if (igual != std::string::npos) {
+            valor = clave.substr(igual + 1);
+            clave.erase(igual);
+        } else if (k + 1 < argc) {
+            valor = argv[++k];
+        } else {
+            error = "falta el valor de --" + clave;
+            return false;
+        }
+        std::replace(clave.begin(), clave.end(), '-', '_');
+        if (clave == "restart") clave = "reanudar";
+        if (clave == "escenario") {
+            if (!cargarEscenario(valor, escenario, error)) return false;
+        } else {
+            opciones.push_back(std::make_pair(clave, valor));
+        }
+    }
+    for (size_t k = 0; k < opciones.size(); ++k) {
+        if (!aplicarOpcionEscenario(escenario, opciones[k].first, opciones[k].second, error)) {
+            error = "--" + opciones[k].first + ": " + error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool cargarArchivoCuerpos(const std::string& ruta) {
+    EstadisticasCarga carga;
+    std::string error;
+    if (!cargarCuerpos(ruta, planetas, 0, carga, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return false;
+    }
+    N_cuerpos = planetas.tamano();
+    aceleraciones_siguientes.redimensionar(N_cuerpos);
+    std::cout << std::defaultfloat << std::setprecision(4)
+              << "Cargados " << carga.cuerpos << " cuerpos desde " << ruta
+              << (carga.binario ? " (binario, " : " (CSV, ") << carga.hilos
+              << (carga.hilos == 1 ? " hilo) en " : " hilos) en ") << carga.segundos << " s: "
+              << carga.cuerposPorSegundo() << " cuerpos/s, "
+              << (carga.segundos > 0 ? carga.bytes / carga.segundos / 1e6 : 0.0) << " MB/s" << std::endl;
     return true;
 }
 
+bool aplicarEscenario(const Escenario& escenario) {
+    if (!escenario.archivo_cuerpos.empty()) {
+        if (!escenario.cuerpos.empty()) {
+            std::cerr << "Error: Use líneas 'cuerpo' o 'cuerpos_archivo', no ambas." << std::endl;
+            return false;
+        }
+        if (!cargarArchivoCuerpos(escenario.archivo_cuerpos)) return false;
+    } else {
+        N_cuerpos = static_cast<int>(escenario.cuerpos.size());
+        planetas.redimensionar(N_cuerpos);
+        aceleraciones_siguientes.redimensionar(N_cuerpos);
+        for (int i = 0; i < N_cuerpos; ++i) { planetas.fijarCuerpo(i, escenario.cuerpos[i]); }
+    }
+    dt_sim = escenario.dt;
+    t_max_sim = escenario.t_max;
 
-void calcularTodasLasFuerzas(std::vector<Cuerpo>& cuerpos_actuales, std::vector<vector3D>& fuerzas_a_calcular) {
-    for (int i = 0; i < N_cuerpos; ++i) { cuerpos_actuales[i].BorreFuerza(); }
-    for (int i = 0; i < N_cuerpos; ++i) {
-        for (int j = i + 1; j < N_cuerpos; ++j) {
-            vector3D dr = cuerpos_actuales[j].r - cuerpos_actuales[i].r;
-            double dist_cubed = std::pow(dr.norm(), 3);
-            if (dist_cubed < 1e-18) { continue; }
-            vector3D F_ij = dr * (G * cuerpos_actuales[i].m * cuerpos_actuales[j].m / dist_cubed);
-            cuerpos_actuales[i].F += F_ij;
-            cuerpos_actuales[j].F -= F_ij;
+    motor_fuerzas_sim = escenario.motor;
+    hilos_sim = (escenario.hilos == 0) ? GrupoHilos::hilosDisponibles() : escenario.hilos;
+    motor_directo.fijarHilos(hilos_sim);
+    motor_directo.fijarPrecisionMixta(escenario.precision_mixta);
+    theta_sim = escenario.theta;
+    motor_barnes_hut.fijarTheta(theta_sim);
+    orden_fmm_sim = escenario.orden_fmm;
+    motor_fmm.fijarOrden(orden_fmm_sim);
+    cadencia_diagnosticos_sim = escenario.cadencia_diagnosticos;
+    integrador_sim = escenario.integrador;
+    integrador_bloques.configurar(escenario.niveles_bloques, escenario.eta_bloques);
+    orden_composicion_sim = escenario.orden_composicion;
+    integrador_ias15.configurar(escenario.tolerancia_ias15);
+    if (escenario.radio_exterior_respa <= escenario.radio_interior_respa) {
+        std::cerr << "Error: radio_exterior_respa debe ser mayor que radio_interior_respa." << std::endl;
+        return false;
+    }
+    integrador_respa.configurar(escenario.radio_interior_respa, escenario.radio_exterior_respa,
+                                escenario.subpasos_respa);
+
+    formato_trayectoria_sim = escenario.formato;
+    seleccion_salida_sim = escenario.seleccion;
+    cada_pasos_salida_sim = escenario.cada_pasos_salida;
+    intervalo_salida_sim = escenario.intervalo_salida;
+    capacidad_salida_sim = escenario.capacidad_salida;
+    politica_salida_sim = escenario.politica_salida;
+    punto_control_cada_sim = escenario.punto_control_cada;
+    archivo_punto_control_sim = escenario.archivo_punto_control;
+    reanudar_sim = escenario.reanudar;
+    traza_sim = escenario.traza;
+    eventos_traza_sim = escenario.eventos_traza;
+    contadores_sim = escenario.contadores;
+    conjunto_sim = escenario.conjunto;
+    perturbacion_sim = escenario.perturbacion;
+    semilla_sim = escenario.semilla;
+    radio_escape_sim = escenario.radio_escape;
+    barrido_sim = escenario.barrido;
+    hilos_barrido_sim = escenario.hilos_barrido;
+    return true;
+}
+
+void mostrarUso(const char* programa) {
+    std::cout << "Uso:\n"
+              << "  " << programa << "                       modo interactivo\n"
+              << "  " << programa << " --escenario ARCHIVO [--clave valor ...]\n"
+              << "                                  modo por lotes, sin preguntas ni gráficas\n\n"
+              << "Claves (en el archivo: 'clave = valor'; en la línea de comandos: --clave valor):\n"
+              << "  cuerpo = masa radio x y z vx vy vz   (una línea por cuerpo)\n"
+              << "  cuerpos_archivo = ruta               cuerpos desde un CSV o binario (en lugar de 'cuerpo')\n"
+              << "  dt, t_max                            paso y tiempo total\n"
+              << "  motor = directo | barnes-hut | fmm   hilos, theta, orden_fmm\n"
+              << "  precision = doble | mixta            suma directa con pares en float y sumas en double\n"
+              << "  integrador = verlet | bloques | hermite | composicion | wisdom-holman | ias15 | respa\n"
+              << "                                     niveles_bloques = K, eta_bloques = η (bloques)\n"
+              << "                                     orden_composicion = 4 | 6 | 8 (composicion)\n"
+              << "                                     tolerancia_ias15 = ε (ias15)\n"
+              << "                                     radio_interior_respa = r₁, radio_exterior_respa = r₂,\n"
+              << "                                     subpasos_respa = M (respa)\n"
+              << "  cadencia_diagnosticos = k            0 = en cada paso de salida\n"
+              << "  formato = texto | binario            campos = p v r e (p. ej. pre)\n"
+              << "  cuerpos_salida = primero último      0 0 = todos\n"
+              << "  cada_pasos = k, intervalo_salida = Δt\n"
+              << "  bufer_salida = cuadros, saturacion = esperar | descartar\n"
+              << "  salida = directorio                  por defecto results\n"
+              << "  punto_control_cada = k               estado completo cada k pasos (0 = nunca)\n"
+              << "  punto_control = archivo              por defecto SALIDA/punto_control.bin\n"
+              << "  reanudar = archivo (o --restart)     continúa un punto de control con el mismo escenario\n"
+              << "  traza = 0|1, eventos_traza = n       línea de tiempo SALIDA/traza.json (make INSTRUMENTAR=1)\n"
+              << "  contadores = 0|1                     ciclos y fallos de caché por fase (make INSTRUMENTAR=1)\n"
+              << "  conjunto = M                         M copias perturbadas integradas a la vez en carriles SIMD\n"
+              << "                                     perturbacion = ε, semilla = n, radio_escape = r (0 = sin límite)\n"
+              << "  barrido = dt v1 v2 ...               una dimensión por uso; también 'masa k m1 m2 ...'\n"
+              << "                                     y 'velocidad k f1 f2 ...' (k desde 1; 0 = todos)\n"
+              << "  hilos_barrido = n                    hilos del barrido (0 = todos los núcleos)\n";
+}
+
+
+void calcularFuerzas(const SistemaCuerpos& cuerpos_actuales, Aceleraciones& aceleraciones_a_calcular,
+                     bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_FUERZAS);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    double* energia = con_potencial ? &energia_potencial_sim : 0;
+    switch (motor_fuerzas_sim) {
+        case MOTOR_BARNES_HUT:
+            motor_barnes_hut.calcularFuerzas(cuerpos_actuales, aceleraciones_a_calcular, energia);
+            break;
+        case MOTOR_FMM:
+            // El FMM obtiene siempre los potenciales en la misma pasada
+            motor_fmm.calcularFuerzas(cuerpos_actuales, aceleraciones_a_calcular);
+            if (con_potencial) { energia_potencial_sim = motor_fmm.energiaPotencial(); }
+            break;
+        case MOTOR_DIRECTO:
+        default:
+            motor_directo.calcularFuerzas(cuerpos_actuales, aceleraciones_a_calcular, energia);
+            CONTAR_INTERACCIONES(perfil_sim, 0.5 * cuerpos_actuales.tamano() * (cuerpos_actuales.tamano() - 1.0));
+            break;
+    }
+    tiempo_fuerzas_sim += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    evaluaciones_fuerzas_sim++;
+}
+
+void calcularFuerzasActivos(const SistemaCuerpos& cuerpos_actuales, const std::vector<int>& activos,
+                            Aceleraciones& aceleraciones_a_calcular) {
+    MEDIR_FASE(perfil_sim, FASE_FUERZAS);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    const int n_activos = static_cast<int>(activos.size());
+    // Solo la suma directa: verificarDatos() rechaza los pasos por bloques con Barnes-Hut y FMM
+    motor_directo.calcularFuerzasSobre(cuerpos_actuales, activos.data(), n_activos, aceleraciones_a_calcular);
+    CONTAR_INTERACCIONES(perfil_sim, n_activos * (cuerpos_actuales.tamano() - 1.0));
+    tiempo_fuerzas_sim += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    evaluaciones_fuerzas_sim++;
+}
+
+void calcularFuerzasYJerks(const SistemaCuerpos& cuerpos_actuales, Aceleraciones& aceleraciones_a_calcular,
+                           Aceleraciones& jerks_a_calcular, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_FUERZAS);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    calcularAceleracionesYJerks(cuerpos_actuales, aceleraciones_a_calcular, jerks_a_calcular,
+                                con_potencial ? &energia_potencial_sim : 0);
+    CONTAR_INTERACCIONES(perfil_sim, 0.5 * cuerpos_actuales.tamano() * (cuerpos_actuales.tamano() - 1.0));
+    tiempo_fuerzas_sim += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    evaluaciones_fuerzas_sim++;
+}
+
+void calcularFuerzasCercanas(const SistemaCuerpos& cuerpos_actuales) {
+    MEDIR_FASE(perfil_sim, FASE_FUERZAS);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    integrador_respa.evaluarCercanas(cuerpos_actuales);
+    CONTAR_INTERACCIONES(perfil_sim, static_cast<double>(integrador_respa.paresLista()));
+    tiempo_fuerzas_sim += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    evaluaciones_fuerzas_sim++;
+}
+
+bool esPasoSalida(long paso) {
+    if (intervalo_salida_sim > 0) {
+        // Se compara el número de intervalo de t = paso·dt con el del paso anterior;
+        // el margen absorbe el redondeo cuando Δt es múltiplo de dt
+        if (paso == 0) return true;
+        const double margen = 1e-9;
+        return std::floor(paso * dt_sim / intervalo_salida_sim + margen) >
+               std::floor((paso - 1) * dt_sim / intervalo_salida_sim + margen);
+    }
+    return paso % cada_pasos_salida_sim == 0;
+}
+
+bool esPasoDiagnostico(long paso) {
+    if (cadencia_diagnosticos_sim <= 0) return esPasoSalida(paso);
+    return paso % cadencia_diagnosticos_sim == 0;
+}
+
+void pasoVerlet(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_INTEGRADOR);
+    cuerpos.Muevase_r(dt);
+    calcularFuerzas(cuerpos, a_siguiente, con_potencial);
+    cuerpos.Muevase_V(dt, a_siguiente);
+    cuerpos.intercambiarAceleraciones(a_siguiente);
+}
+
+void pasoBloques(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_INTEGRADOR);
+    do {
+        if (integrador_bloques.siguienteSubpaso(cuerpos)) {
+            // Todos activos (siempre al final del paso dt): evaluación completa, con U si se pide
+            calcularFuerzas(cuerpos, a_siguiente, con_potencial && integrador_bloques.finDePaso());
+        } else {
+            calcularFuerzasActivos(cuerpos, integrador_bloques.activos(), a_siguiente);
         }
+        integrador_bloques.corregir(cuerpos, a_siguiente);
+    } while (!integrador_bloques.finDePaso());
+}
+
+void pasoHermite(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_INTEGRADOR);
+    integrador_hermite.predecir(cuerpos, dt);
+    // Las fuerzas se evalúan en las posiciones predichas: U se calcula aparte tras la corrección
+    calcularFuerzasYJerks(cuerpos, a_siguiente, integrador_hermite.jerkSiguiente(), false);
+    integrador_hermite.corregir(cuerpos, dt, a_siguiente);
+    cuerpos.intercambiarAceleraciones(a_siguiente);
+    if (con_potencial) {
+        MEDIR_FASE(perfil_sim, FASE_DIAGNOSTICOS);
+        energia_potencial_sim = calcularEnergiaPotencialTotal(cuerpos);
     }
-    for(int i=0; i<N_cuerpos; ++i) { fuerzas_a_calcular[i] = cuerpos_actuales[i].F; }
 }
 
-double calcularEnergiaCineticaTotal(const std::vector<Cuerpo>& cuerpos_actuales) {
-    double K_total = 0.0;
-    for (int i = 0; i < N_cuerpos; ++i) {
-        K_total += 0.5 * cuerpos_actuales[i].m * cuerpos_actuales[i].V.norm2();
+void pasoComposicionSimplectica(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_INTEGRADOR);
+    switch (orden_composicion_sim) {
+        case 6: pasoComposicion<Yoshida6>(cuerpos, a_siguiente, dt, con_potencial, calcularFuerzas); break;
+        case 8: pasoComposicion<Yoshida8>(cuerpos, a_siguiente, dt, con_potencial, calcularFuerzas); break;
+        default: pasoComposicion<ForestRuth4>(cuerpos, a_siguiente, dt, con_potencial, calcularFuerzas); break;
     }
-    return K_total;
 }
 
-double calcularEnergiaPotencialTotal(const std::vector<Cuerpo>& cuerpos_actuales) {
-    double U_total = 0.0;
-    for (int i = 0; i < N_cuerpos; ++i) {
-        for (int j = i + 1; j < N_cuerpos; ++j) {
-            vector3D dr = cuerpos_actuales[i].r - cuerpos_actuales[j].r;
-            double distancia = dr.norm();
-            if (distancia < 1e-9) {
-                U_total -= G * cuerpos_actuales[i].m * cuerpos_actuales[j].m / 1e-9;
-            } else {
-                U_total -= G * cuerpos_actuales[i].m * cuerpos_actuales[j].m / distancia;
-            }
+void pasoWisdomHolman(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_INTEGRADOR);
+    integrador_wisdom_holman.impulso(cuerpos, 0.5 * dt);
+    integrador_wisdom_holman.derivaKepler(dt);
+    integrador_wisdom_holman.sincronizar(cuerpos);
+    calcularFuerzas(cuerpos, a_siguiente, con_potencial);
+    cuerpos.intercambiarAceleraciones(a_siguiente);
+    integrador_wisdom_holman.impulso(cuerpos, 0.5 * dt);
+    integrador_wisdom_holman.sincronizar(cuerpos);
+}
+
+double pasoIAS15(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_INTEGRADOR);
+    return integrador_ias15.avanzar(cuerpos, a_siguiente, dt, con_potencial, calcularFuerzas);
+}
+
+void pasoRESPA(SistemaCuerpos& cuerpos, Aceleraciones& a_siguiente, double dt, bool con_potencial) {
+    MEDIR_FASE(perfil_sim, FASE_INTEGRADOR);
+    const int subpasos = integrador_respa.subpasos();
+    const double h = dt / subpasos;
+    integrador_respa.impulsoLejano(cuerpos, 0.5 * dt);
+    for (int s = 0; s < subpasos; ++s) {
+        integrador_respa.impulsoCercano(cuerpos, 0.5 * h);
+        integrador_respa.deriva(cuerpos, h);
+        calcularFuerzasCercanas(cuerpos);
+        integrador_respa.impulsoCercano(cuerpos, 0.5 * h);
+    }
+    // En t+dt, la parte lejana es lo que la evaluación completa no explica con la lista
+    calcularFuerzas(cuerpos, a_siguiente, con_potencial);
+    integrador_respa.separarLejanas(a_siguiente);
+    integrador_respa.impulsoLejano(cuerpos, 0.5 * dt);
+    cuerpos.intercambiarAceleraciones(a_siguiente);
+}
+
+void reportarErrorFuerzas(const SistemaCuerpos& cuerpos_actuales,
+                          const Aceleraciones& aceleraciones_calculadas) {
+    if (motor_fuerzas_sim == MOTOR_DIRECTO) {
+        // Hermite no pasa por motor_directo: sus fuerzas son siempre de doble precisión
+        const bool mixta = motor_directo.precisionMixta() && integrador_sim != INTEGRADOR_HERMITE;
+        std::cout << "Núcleo de suma directa: " << nombreNivelSIMD(nivelSIMDActivo())
+                  << (mixta ? " en precisión mixta" : "")
+                  << " (bloques de " << tamanoBloqueJ() << " cuerpos, " << hilos_sim
+                  << (hilos_sim == 1 ? " hilo)" : " hilos)");
+        if (nivelSIMDActivo() != SIMD_ESCALAR || mixta) {
+            Aceleraciones referencia;
+            referencia.redimensionar(cuerpos_actuales.tamano());
+            calcularFuerzasEscalar(cuerpos_actuales, referencia);
+            const double diferencia = diferenciaRelativaMaxima(aceleraciones_calculadas, referencia);
+            const double tolerancia = mixta ? TOLERANCIA_FUERZAS_MIXTAS : TOLERANCIA_FUERZAS_SIMD;
+            std::cout << ", diferencia máxima con el núcleo escalar = "
+                      << std::scientific << std::setprecision(3) << diferencia
+                      << (diferencia <= tolerancia ? " (dentro" : " (FUERA")
+                      << " de la tolerancia " << tolerancia << ")" << std::defaultfloat;
         }
+        std::cout << std::endl;
+        return;
+    }
+    ErrorFuerzas error = estimarErrorFuerzas(cuerpos_actuales, aceleraciones_calculadas);
+    std::cout << std::defaultfloat << "Error de fuerzas " << nombreMotorFuerzas(motor_fuerzas_sim);
+    if (motor_fuerzas_sim == MOTOR_FMM) { std::cout << " (p = " << orden_fmm_sim << ")"; }
+    else { std::cout << " (θ = " << theta_sim << ")"; }
+    std::cout << " frente a suma directa: RMS = "
+              << std::scientific << std::setprecision(3) << error.error_rms
+              << ", máximo = " << error.error_max << " (" << error.muestras << " cuerpos)"
+              << std::defaultfloat << std::endl;
+    if (motor_fuerzas_sim == MOTOR_FMM) {
+        ErrorFuerzas error_potencial = estimarErrorPotencial(cuerpos_actuales, motor_fmm.potenciales());
+        std::cout << "Error de potenciales FMM (p = " << orden_fmm_sim << ") frente a suma directa: RMS = "
+                  << std::scientific << std::setprecision(3) << error_potencial.error_rms
+                  << ", máximo = " << error_potencial.error_max << std::defaultfloat << std::endl;
     }
-    return U_total;
 }
 
 void graficarResultados() {
@@ -219,6 +1034,16 @@ void graficarResultados() {
     
     std::string comando;
 
+    if (formato_trayectoria_sim == TRAYECTORIA_BINARIA && opcion >= 1 && opcion <= 5) {
+        // Los scripts leen el formato de texto: se convierte antes de graficar
+        std::string error;
+        std::cout << "Convirtiendo results/sim_data.bin a results/sim_data.dat..." << std::endl;
+        if (!convertirTrayectoriaATexto("results/sim_data.bin", "results/sim_data.dat", error)) {
+            std::cerr << "Error: " << error << std::endl;
+            return;
+        }
+    }
+
     switch (opcion) {
         case 1:
             comando = "gnuplot scripts/plot_gravedad.gp";
@@ -254,51 +1079,310 @@ void graficarResultados() {
     }
 }
 
-int main() {
-    solicitarDatos();
-    
-    if (!verificarDatos()) {
-        return 1;
-    }
-
-    system("mkdir -p results");
+void guardarPuntoControl(EstadoSerializado& estado, double t, long paso, double E_inicial, double E_final) {
+    estado.limpiar();
+    // Configuración que determina la trayectoria
+    estado.escribir(N_cuerpos);
+    estado.escribir(dt_sim);
+    estado.escribir(static_cast<int>(integrador_sim));
+    estado.escribir(static_cast<int>(motor_fuerzas_sim));
+    estado.escribir(hilos_sim);
+    estado.escribir(theta_sim);
+    estado.escribir(orden_fmm_sim);
+    estado.escribir(orden_composicion_sim);
+    estado.escribir(static_cast<int>(motor_directo.precisionMixta()));
+    estado.escribir(integrador_bloques.niveles());
+    estado.escribir(integrador_bloques.eta());
+    estado.escribir(integrador_ias15.tolerancia());
+    estado.escribir(integrador_respa.radioInterior());
+    estado.escribir(integrador_respa.radioExterior());
+    estado.escribir(integrador_respa.subpasos());
+    // Tiempo y contadores
+    estado.escribir(t);
+    estado.escribir(paso);
+    estado.escribir(E_inicial);
+    estado.escribir(E_final);
+    estado.escribir(energia_potencial_sim);
+    // Estado de los cuerpos y buffer de aceleraciones
+    estado.escribirVector(planetas.x); estado.escribirVector(planetas.y); estado.escribirVector(planetas.z);
+    estado.escribirVector(planetas.vx); estado.escribirVector(planetas.vy); estado.escribirVector(planetas.vz);
+    estado.escribirVector(planetas.ax); estado.escribirVector(planetas.ay); estado.escribirVector(planetas.az);
+    estado.escribirVector(planetas.m); estado.escribirVector(planetas.inv_m); estado.escribirVector(planetas.R);
+    estado.escribirVector(aceleraciones_siguientes.x);
+    estado.escribirVector(aceleraciones_siguientes.y);
+    estado.escribirVector(aceleraciones_siguientes.z);
+    // Verlet y la composición simpléctica no guardan nada entre pasos
+    if (integrador_sim == INTEGRADOR_BLOQUES) { integrador_bloques.guardarEstado(estado); }
+    if (integrador_sim == INTEGRADOR_HERMITE) { integrador_hermite.guardarEstado(estado); }
+    if (integrador_sim == INTEGRADOR_WISDOM_HOLMAN) { integrador_wisdom_holman.guardarEstado(estado); }
+    if (integrador_sim == INTEGRADOR_IAS15) { integrador_ias15.guardarEstado(estado); }
+    if (integrador_sim == INTEGRADOR_RESPA) { integrador_respa.guardarEstado(estado); }
+}
 
-    const std::string nombre_archivo_salida = "results/sim_data.dat";
-    std::ofstream archivo_salida(nombre_archivo_salida);
+bool cargarPuntoControl(const std::string& ruta, double& t, long& paso, double& E_inicial, double& E_final) {
+    EstadoSerializado estado;
+    std::string error;
+    if (!leerPuntoControl(ruta, estado, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return false;
+    }
+    int n = 0, integrador = 0, motor = 0, hilos = 0, orden_fmm = 0, orden_composicion = 0;
+    int mixta = 0, niveles_bloques = 0, subpasos_respa = 0;
+    double dt = 0.0, theta = 0.0, eta_bloques = 0.0, tolerancia_ias15 = 0.0;
+    double radio_interior_respa = 0.0, radio_exterior_respa = 0.0;
+    estado.leer(n);
+    estado.leer(dt);
+    estado.leer(integrador);
+    estado.leer(motor);
+    estado.leer(hilos);
+    estado.leer(theta);
+    estado.leer(orden_fmm);
+    estado.leer(orden_composicion);
+    estado.leer(mixta);
+    estado.leer(niveles_bloques);
+    estado.leer(eta_bloques);
+    estado.leer(tolerancia_ias15);
+    estado.leer(radio_interior_respa);
+    estado.leer(radio_exterior_respa);
+    estado.leer(subpasos_respa);
+    if (!estado.valido()) {
+        std::cerr << "Error: " << ruta << ": estado incompleto" << std::endl;
+        return false;
+    }
+    // Solo t_max puede cambiar: así se puede prolongar una simulación terminada. Los
+    // parámetros de un integrador o motor solo cuentan si ese integrador o motor se usa
+    const bool misma_precision = motor != MOTOR_DIRECTO || integrador == INTEGRADOR_HERMITE ||
+                                 (mixta != 0) == motor_directo.precisionMixta();
+    const bool mismos_bloques = integrador != INTEGRADOR_BLOQUES ||
+        (niveles_bloques == integrador_bloques.niveles() && eta_bloques == integrador_bloques.eta());
+    const bool misma_ias15 = integrador != INTEGRADOR_IAS15 || tolerancia_ias15 == integrador_ias15.tolerancia();
+    const bool mismo_respa = integrador != INTEGRADOR_RESPA ||
+        (radio_interior_respa == integrador_respa.radioInterior() &&
+         radio_exterior_respa == integrador_respa.radioExterior() && subpasos_respa == integrador_respa.subpasos());
+    if (n != N_cuerpos || dt != dt_sim || integrador != integrador_sim || motor != motor_fuerzas_sim ||
+        (motor == MOTOR_BARNES_HUT && theta != theta_sim) || (motor == MOTOR_FMM && orden_fmm != orden_fmm_sim) ||
+        (integrador == INTEGRADOR_COMPOSICION && orden_composicion != orden_composicion_sim) ||
+        !misma_precision || !mismos_bloques || !misma_ias15 || !mismo_respa) {
+        std::cerr << "Error: " << ruta << " se guardó con otra configuración (N = " << n << ", dt = " << dt
+                  << ", integrador " << nombreIntegrador(static_cast<TipoIntegrador>(integrador)) << ", motor "
+                  << nombreMotorFuerzas(static_cast<TipoMotorFuerzas>(motor));
+        if (!misma_precision) std::cerr << ", precisión " << (mixta ? "mixta" : "doble");
+        if (!mismos_bloques) std::cerr << ", niveles_bloques = " << niveles_bloques << ", eta_bloques = " << eta_bloques;
+        if (!misma_ias15) std::cerr << ", tolerancia_ias15 = " << tolerancia_ias15;
+        if (!mismo_respa) {
+            std::cerr << ", radio_interior_respa = " << radio_interior_respa << ", radio_exterior_respa = "
+                      << radio_exterior_respa << ", subpasos_respa = " << subpasos_respa;
+        }
+        std::cerr << "); reanude con el mismo escenario" << std::endl;
+        return false;
+    }
+    if (motor == MOTOR_DIRECTO && hilos != hilos_sim) {
+        std::cout << "Aviso: el punto de control se guardó con " << hilos << " hilos y ahora se usan " << hilos_sim
+                  << "; el reparto de la suma cambia el redondeo y la continuación no será idéntica bit a bit"
+                  << std::endl;
+    }
+    const unsigned long long maximo = static_cast<unsigned long long>(N_cuerpos);
+    estado.leer(t);
+    estado.leer(paso);
+    estado.leer(E_inicial);
+    estado.leer(E_final);
+    estado.leer(energia_potencial_sim);
+    estado.leerVector(planetas.x, maximo); estado.leerVector(planetas.y, maximo); estado.leerVector(planetas.z, maximo);
+    estado.leerVector(planetas.vx, maximo); estado.leerVector(planetas.vy, maximo); estado.leerVector(planetas.vz, maximo);
+    estado.leerVector(planetas.ax, maximo); estado.leerVector(planetas.ay, maximo); estado.leerVector(planetas.az, maximo);
+    estado.leerVector(planetas.m, maximo); estado.leerVector(planetas.inv_m, maximo); estado.leerVector(planetas.R, maximo);
+    estado.leerVector(aceleraciones_siguientes.x, maximo);
+    estado.leerVector(aceleraciones_siguientes.y, maximo);
+    estado.leerVector(aceleraciones_siguientes.z, maximo);
+    bool correcto = estado.valido() && planetas.R.size() == maximo && aceleraciones_siguientes.z.size() == maximo;
+    if (correcto && integrador_sim == INTEGRADOR_BLOQUES) { correcto = integrador_bloques.cargarEstado(estado, N_cuerpos); }
+    if (correcto && integrador_sim == INTEGRADOR_HERMITE) { correcto = integrador_hermite.cargarEstado(estado, N_cuerpos); }
+    if (correcto && integrador_sim == INTEGRADOR_WISDOM_HOLMAN) {
+        correcto = integrador_wisdom_holman.cargarEstado(estado, N_cuerpos);
+    }
+    if (correcto && integrador_sim == INTEGRADOR_IAS15) { correcto = integrador_ias15.cargarEstado(estado, N_cuerpos); }
+    if (correcto && integrador_sim == INTEGRADOR_RESPA) { correcto = integrador_respa.cargarEstado(estado, N_cuerpos); }
+    if (!correcto || !estado.completo()) {
+        std::cerr << "Error: " << ruta << ": el estado no corresponde a " << N_cuerpos << " cuerpos con "
+                  << nombreIntegrador(integrador_sim) << std::endl;
+        return false;
+    }
+    return true;
+}
 
-    if (!archivo_salida.is_open()) {
+int ejecutarSimulacion(const std::string& directorio_salida) {
+    const std::string nombre_archivo_salida = (formato_trayectoria_sim == TRAYECTORIA_BINARIA)
+                                              ? directorio_salida + "/sim_data.bin" : directorio_salida + "/sim_data.dat";
+    if (seleccion_salida_sim.cuerpos == 0) { seleccion_salida_sim.cuerpos = N_cuerpos; } // Todos los cuerpos
+    const std::string nombre_archivo_diagnosticos = directorio_salida + "/diagnosticos.dat";
+    if (!reanudar_sim.empty()) {
+        // La trayectoria anterior al corte es la única copia de esa parte de la simulación
+        const std::string existentes[] = {nombre_archivo_salida, nombre_archivo_diagnosticos};
+        for (int k = 0; k < 2; ++k) {
+            if (std::ifstream(existentes[k].c_str()).good()) {
+                std::cerr << "Error: al reanudar no se sobrescribe " << existentes[k]
+                          << "; elija otro directorio de salida (--salida)" << std::endl;
+                return 1;
+            }
+        }
+    }
+    SalidaAsincrona archivo_salida; // Los cuadros se escriben en un hilo aparte
+    if (!archivo_salida.abrir(nombre_archivo_salida, formato_trayectoria_sim, N_cuerpos, dt_sim,
+                              seleccion_salida_sim, capacidad_salida_sim, politica_salida_sim)) {
         std::cerr << "Error: No se pudo abrir el archivo de salida " << nombre_archivo_salida << std::endl;
         return 1;
     }
 
-    archivo_salida << "# Tiempo";
-    for (int i = 0; i < N_cuerpos; ++i) { archivo_salida << "\t" << "x" << i+1 << "\t" << "y" << i+1 << "\t" << "z" << i+1; }
-    for (int i = 0; i < N_cuerpos; ++i) { archivo_salida << "\t" << "v" << i+1; }
-    archivo_salida << "\tK_total\tU_total\tE_total" << std::endl;
-    archivo_salida << std::fixed << std::setprecision(8);
+    std::ofstream archivo_diagnosticos(nombre_archivo_diagnosticos);
+    if (!archivo_diagnosticos.is_open()) {
+        std::cerr << "Error: No se pudo abrir el archivo de salida " << nombre_archivo_diagnosticos << std::endl;
+        return 1;
+    }
+    archivo_diagnosticos << "# Tiempo\tK_total\tU_total\tE_total\tPx\tPy\tPz\tLx\tLy\tLz\tXcm\tYcm\tZcm" << std::endl;
+    archivo_diagnosticos << std::scientific << std::setprecision(12);
 
-    calcularTodasLasFuerzas(planetas, fuerzas_siguientes);
+    if (integrador_sim == INTEGRADOR_HERMITE && motor_fuerzas_sim != MOTOR_DIRECTO) {
+        // El jerk solo lo entrega el recorrido de pares de la suma directa
+        std::cout << "Aviso: Hermite evalúa aceleraciones y jerks por suma directa; se ignora "
+                  << nombreMotorFuerzas(motor_fuerzas_sim) << "." << std::endl;
+        motor_fuerzas_sim = MOTOR_DIRECTO;
+    }
+    if (motor_directo.precisionMixta()) {
+        if (motor_fuerzas_sim != MOTOR_DIRECTO) {
+            std::cout << "Aviso: la precisión mixta solo se aplica a la suma directa; "
+                      << nombreMotorFuerzas(motor_fuerzas_sim) << " sigue en doble precisión." << std::endl;
+        } else if (integrador_sim == INTEGRADOR_HERMITE) {
+            std::cout << "Aviso: Hermite evalúa aceleraciones y jerks en doble precisión; se ignora la precisión mixta."
+                      << std::endl;
+        } else if (integrador_sim == INTEGRADOR_BLOQUES) {
+            std::cout << "Aviso: con pasos por bloques solo las evaluaciones de todos los cuerpos usan precisión mixta."
+                      << std::endl;
+        }
+    }
+    {
+        MEDIR_FASE(perfil_sim, FASE_INICIO);
+        calcularFuerzas(planetas, aceleraciones_siguientes, true);
+        reportarErrorFuerzas(planetas, aceleraciones_siguientes);
+        planetas.intercambiarAceleraciones(aceleraciones_siguientes);
+        if (integrador_sim == INTEGRADOR_BLOQUES) { integrador_bloques.iniciar(planetas, dt_sim); }
+        if (integrador_sim == INTEGRADOR_HERMITE) {
+            // a(t₀) y ȧ(t₀) del mismo núcleo que usarán los pasos
+            integrador_hermite.iniciar(planetas);
+            calcularFuerzasYJerks(planetas, aceleraciones_siguientes, integrador_hermite.jerk(), true);
+            planetas.intercambiarAceleraciones(aceleraciones_siguientes);
+        }
+        if (integrador_sim == INTEGRADOR_WISDOM_HOLMAN) {
+            const double cociente = integrador_wisdom_holman.iniciar(planetas);
+            if (cociente > 0.1) {
+                std::cout << "Aviso: Wisdom-Holman supone una masa central dominante; los demás cuerpos suman "
+                          << cociente << " veces la masa del cuerpo " << integrador_wisdom_holman.central() + 1
+                          << "." << std::endl;
+            }
+        }
+        if (integrador_sim == INTEGRADOR_IAS15) { integrador_ias15.iniciar(planetas, dt_sim); }
+        if (integrador_sim == INTEGRADOR_RESPA) { integrador_respa.iniciar(planetas); }
+    }
 
     double t_actual = 0;
     //int paso_impresion = 0;
     int pasos_totales = static_cast<int>(t_max_sim / dt_sim);
     int intervalo_impresion = pasos_totales / 10; // Imprimir progreso un 10% de las veces
     if (intervalo_impresion == 0) intervalo_impresion = 1;
+    long pasos_realizados = 0;
+    long asignaciones_bucle = 0;     // Asignaciones de memoria en todos los pasos
+    long asignaciones_max_paso = 0;  // Máximo de asignaciones en un solo paso
+    long pasos_con_asignaciones = 0;
+    double E_inicial = 0.0, E_final = 0.0;
 
+    if (!reanudar_sim.empty()) {
+        // El estado inicializado arriba solo dimensionó los buffers; se sobrescribe por completo
+        if (!cargarPuntoControl(reanudar_sim, t_actual, pasos_realizados, E_inicial, E_final)) { return 1; }
+        std::cout << std::defaultfloat << std::setprecision(10) << "Reanudando desde " << reanudar_sim
+                  << " en t = " << t_actual << " (paso " << pasos_realizados << ")" << std::endl;
+    }
+    const long paso_inicial = pasos_realizados;
+
+    EscritorPuntosControl escritor_puntos_control; // Escribe en un hilo aparte
+    EstadoSerializado estado_punto_control;
+    bool punto_control_debido = false; // Toca un punto de control y el escritor seguía ocupado
+    long puntos_control_aplazados = 0;
+    if (punto_control_cada_sim > 0) {
+        const std::string ruta = archivo_punto_control_sim.empty()
+                                 ? directorio_salida + "/punto_control.bin" : archivo_punto_control_sim;
+        // Un estado de prueba fija el tamaño; los dos búferes que se intercambian
+        // se reservan con margen (la lista de RESPA puede crecer)
+        guardarPuntoControl(estado_punto_control, t_actual, pasos_realizados, E_inicial, E_final);
+        const size_t reserva = 2 * estado_punto_control.datos().size();
+        estado_punto_control.datos().reserve(reserva);
+        escritor_puntos_control.abrir(ruta, reserva);
+    }
 
     while (t_actual <= t_max_sim) {
-        archivo_salida << t_actual;
-        for (int i = 0; i < N_cuerpos; ++i) { archivo_salida << "\t" << planetas[i].Getx() << "\t" << planetas[i].Gety() << "\t" << planetas[i].Getz(); }
-        for (int i = 0; i < N_cuerpos; ++i) { archivo_salida << "\t" << planetas[i].GetVnorm(); }
-        double K = calcularEnergiaCineticaTotal(planetas);
-        double U = calcularEnergiaPotencialTotal(planetas);
-        archivo_salida << "\t" << K << "\t" << U << "\t" << K + U << std::endl;
-
-        for (int i = 0; i < N_cuerpos; ++i) { planetas[i].Muevase_r(dt_sim); }
-        std::vector<Cuerpo> planetas_temp_para_F_siguiente = planetas;
-        calcularTodasLasFuerzas(planetas_temp_para_F_siguiente, fuerzas_siguientes);
-        for (int i = 0; i < N_cuerpos; ++i) { planetas[i].Muevase_V(dt_sim, fuerzas_siguientes[i]); }
-        for (int i = 0; i < N_cuerpos; ++i) { planetas[i].F = fuerzas_siguientes[i]; }
+        MEDIR_FASE(perfil_sim, FASE_BUCLE);
+        long asignaciones_inicio_paso = asignacionesMemoria();
+        if (punto_control_cada_sim > 0 && pasos_realizados > paso_inicial && pasos_realizados % punto_control_cada_sim == 0) {
+            punto_control_debido = true;
+        }
+        if (punto_control_debido) {
+            // Solo la copia en memoria se hace aquí; con el escritor ocupado se aplaza al paso siguiente
+            if (escritor_puntos_control.ocupado()) {
+                puntos_control_aplazados++;
+            } else {
+                MEDIR_FASE(perfil_sim, FASE_PUNTO_CONTROL);
+                guardarPuntoControl(estado_punto_control, t_actual, pasos_realizados, E_inicial, E_final);
+                escritor_puntos_control.publicar(estado_punto_control);
+                punto_control_debido = false;
+            }
+        }
+        const bool salida = esPasoSalida(pasos_realizados);
+        if (esPasoDiagnostico(pasos_realizados)) {
+            Diagnosticos d;
+            {
+                MEDIR_FASE(perfil_sim, FASE_DIAGNOSTICOS);
+                d = calcularDiagnosticos(planetas, energia_potencial_sim);
+            }
+            MEDIR_FASE(perfil_sim, FASE_SALIDA);
+            if (salida) { archivo_salida.publicar(t_actual, planetas, d.energia_cinetica, d.energia_potencial, d.energiaTotal()); }
+            archivo_diagnosticos << t_actual << "\t" << d.energia_cinetica << "\t" << d.energia_potencial << "\t" << d.energiaTotal()
+                                 << "\t" << d.momento_lineal.x() << "\t" << d.momento_lineal.y() << "\t" << d.momento_lineal.z()
+                                 << "\t" << d.momento_angular.x() << "\t" << d.momento_angular.y() << "\t" << d.momento_angular.z()
+                                 << "\t" << d.centro_masa.x() << "\t" << d.centro_masa.y() << "\t" << d.centro_masa.z() << "\n";
+            if (pasos_realizados == 0) { E_inicial = d.energiaTotal(); }
+            E_final = d.energiaTotal();
+        } else if (salida) {
+            MEDIR_FASE(perfil_sim, FASE_SALIDA);
+            const double sin_dato = std::numeric_limits<double>::quiet_NaN(); // Sin diagnósticos en este paso
+            archivo_salida.publicar(t_actual, planetas, sin_dato, sin_dato, sin_dato);
+        }
+
+        if (integrador_sim == INTEGRADOR_BLOQUES) {
+            pasoBloques(planetas, aceleraciones_siguientes, esPasoDiagnostico(pasos_realizados + 1));
+        } else if (integrador_sim == INTEGRADOR_HERMITE) {
+            pasoHermite(planetas, aceleraciones_siguientes, dt_sim, esPasoDiagnostico(pasos_realizados + 1));
+        } else if (integrador_sim == INTEGRADOR_COMPOSICION) {
+            pasoComposicionSimplectica(planetas, aceleraciones_siguientes, dt_sim, esPasoDiagnostico(pasos_realizados + 1));
+        } else if (integrador_sim == INTEGRADOR_WISDOM_HOLMAN) {
+            pasoWisdomHolman(planetas, aceleraciones_siguientes, dt_sim, esPasoDiagnostico(pasos_realizados + 1));
+        } else if (integrador_sim == INTEGRADOR_IAS15) {
+            const double avanzado = pasoIAS15(planetas, aceleraciones_siguientes, dt_sim, esPasoDiagnostico(pasos_realizados + 1));
+            if (avanzado < dt_sim) {
+                // Seguir solo daría un estado sin sentido físico: se termina con el último estado válido
+                std::cout << "Aviso: IAS15 se detuvo en t = " << std::setprecision(10) << t_actual + avanzado
+                          << ": un encuentro exige un paso menor que 1e-10·dt (choque de masas puntuales)."
+                          << " La energía se informa hasta el último diagnóstico." << std::endl;
+                break;
+            }
+        } else if (integrador_sim == INTEGRADOR_RESPA) {
+            pasoRESPA(planetas, aceleraciones_siguientes, dt_sim, esPasoDiagnostico(pasos_realizados + 1));
+        } else {
+            pasoVerlet(planetas, aceleraciones_siguientes, dt_sim, esPasoDiagnostico(pasos_realizados + 1));
+        }
+
+        long asignaciones_paso = asignacionesMemoria() - asignaciones_inicio_paso;
+        asignaciones_bucle += asignaciones_paso;
+        asignaciones_max_paso = std::max(asignaciones_max_paso, asignaciones_paso);
+        if (asignaciones_paso > 0) pasos_con_asignaciones++;
+        pasos_realizados++;
 
         t_actual += dt_sim;
         
@@ -308,10 +1392,282 @@ int main() {
         }
     }
 
-    archivo_salida.close();
-    std::cout << "Simulación completada. Resultados guardados en " << nombre_archivo_salida << std::endl;
+    if (punto_control_debido) {
+        // El último punto no llegó a entregarse: se guarda el estado final esperando al escritor
+        MEDIR_FASE(perfil_sim, FASE_PUNTO_CONTROL);
+        guardarPuntoControl(estado_punto_control, t_actual, pasos_realizados, E_inicial, E_final);
+        escritor_puntos_control.publicar(estado_punto_control, true);
+    }
+    archivo_salida.cerrar();
+    archivo_diagnosticos.close();
+    escritor_puntos_control.cerrar();
+    planetas.intercambiarAceleraciones(aceleraciones_siguientes); // a(t) final vuelve al buffer para el informe
+    if (integrador_sim == INTEGRADOR_HERMITE) {
+        // Hermite conserva la a evaluada en la posición predicha; el informe usa la corregida
+        calcularFuerzas(planetas, aceleraciones_siguientes, false);
+    }
+    reportarErrorFuerzas(planetas, aceleraciones_siguientes);
+    std::cout << std::defaultfloat << std::setprecision(4)
+              << "Salida asíncrona (" << archivo_salida.capacidad() << " cuadros en el búfer): "
+              << archivo_salida.cuadrosEscritos() << " cuadros escritos, " << archivo_salida.cuadrosDescartados()
+              << " descartados; la simulación esperó por E/S " << archivo_salida.tiempoEspera() << " s en "
+              << archivo_salida.esperas() << " ocasiones y " << archivo_salida.tiempoVaciado()
+              << " s al vaciar el búfer final" << std::endl;
+    if (punto_control_cada_sim > 0) {
+        std::cout << "Puntos de control en " << escritor_puntos_control.ruta() << ": "
+                  << escritor_puntos_control.escritos() << " escritos, " << escritor_puntos_control.fallidos()
+                  << " fallidos, " << puntos_control_aplazados << " pasos de aplazamiento (escritor ocupado); "
+                  << escritor_puntos_control.bytesUltimo() << " bytes cada uno, "
+                  << escritor_puntos_control.tiempoEscritura() << " s escribiendo en segundo plano" << std::endl;
+    }
+    std::cout << "Asignaciones de memoria en el bucle de integración: " << asignaciones_bucle
+              << " en " << pasos_realizados << " pasos (máximo " << asignaciones_max_paso
+              << " por paso, " << pasos_con_asignaciones << " pasos con asignaciones)" << std::endl;
+    if (evaluaciones_fuerzas_sim > 0) {
+        std::cout << std::defaultfloat << std::setprecision(4)
+                  << "Tiempo medio por evaluación de fuerzas (" << nombreMotorFuerzas(motor_fuerzas_sim)
+                  << ", N = " << N_cuerpos << "): " << 1e3 * tiempo_fuerzas_sim / evaluaciones_fuerzas_sim
+                  << " ms en " << evaluaciones_fuerzas_sim << " evaluaciones" << std::endl;
+    }
+    if (integrador_sim == INTEGRADOR_BLOQUES) {
+        const long globales = integrador_bloques.evaluacionesPasoGlobal();
+        std::cout << std::defaultfloat << std::setprecision(4)
+                  << "Pasos por bloques (K = " << integrador_bloques.niveles() << ", η = " << integrador_bloques.eta()
+                  << "): " << integrador_bloques.evaluaciones() << " evaluaciones de aceleración por cuerpo frente a "
+                  << globales << " con un paso global dt/2^" << integrador_bloques.nivelMasFino()
+                  << " (ahorro " << static_cast<double>(globales) / std::max(1L, integrador_bloques.evaluaciones())
+                  << "x)" << std::endl;
+        std::vector<int> histograma = integrador_bloques.histogramaNiveles();
+        std::cout << "Cuerpos por nivel de paso al final:";
+        for (size_t k = 0; k < histograma.size(); ++k) {
+            if (histograma[k] > 0) { std::cout << " dt/2^" << k << ": " << histograma[k]; }
+        }
+        std::cout << std::endl;
+    }
+    if (integrador_sim == INTEGRADOR_WISDOM_HOLMAN && integrador_wisdom_holman.fallosKepler() > 0) {
+        std::cout << "Aviso: la ecuación de Kepler no convergió en " << integrador_wisdom_holman.fallosKepler()
+                  << " derivas (encuentros muy cercanos); reduzca dt o use otro integrador" << std::endl;
+    }
+    if (integrador_sim == INTEGRADOR_IAS15) {
+        std::cout << std::defaultfloat << std::setprecision(4)
+                  << "IAS15 (ε = " << integrador_ias15.tolerancia() << "): " << integrador_ias15.pasosAceptados()
+                  << " pasos internos, " << integrador_ias15.pasosRechazados() << " rechazados, "
+                  << static_cast<double>(integrador_ias15.iteraciones()) / std::max(1L, integrador_ias15.pasosAceptados()
+                                                                           + integrador_ias15.pasosRechazados())
+                  << " iteraciones por intento";
+        if (integrador_ias15.pasoMaximo() > 0) {
+            std::cout << ", paso entre " << integrador_ias15.pasoMinimo() << " y " << integrador_ias15.pasoMaximo();
+        }
+        std::cout << std::endl;
+        if (integrador_ias15.pasosSinConvergencia() > 0) {
+            std::cout << "Aviso: el predictor-corrector de IAS15 no convergió en " << integrador_ias15.pasosSinConvergencia()
+                      << " pasos (con Barnes-Hut o FMM las fuerzas aproximadas limitan la convergencia)" << std::endl;
+        }
+    }
+    if (integrador_sim == INTEGRADOR_RESPA) {
+        // Interacciones de pares: una evaluación completa por paso, la lista en cada subpaso y
+        // las distancias medidas al reconstruir la lista
+        const double pares_completos = 0.5 * N_cuerpos * (N_cuerpos - 1.0);
+        const double interacciones = pasos_realizados * pares_completos + integrador_respa.interaccionesCercanas()
+                                     + integrador_respa.comprobacionesLista();
+        const double interacciones_verlet = pasos_realizados * integrador_respa.subpasos() * pares_completos;
+        std::cout << std::defaultfloat << std::setprecision(4)
+                  << "RESPA (r₁ = " << integrador_respa.radioInterior() << ", r₂ = " << integrador_respa.radioExterior()
+                  << ", M = " << integrador_respa.subpasos() << "): " << interacciones
+                  << " interacciones de pares frente a " << interacciones_verlet << " con Verlet de paso dt/"
+                  << integrador_respa.subpasos() << " (ahorro " << interacciones_verlet / std::max(1.0, interacciones)
+                  << "x); " << static_cast<double>(integrador_respa.interaccionesCercanas())
+                                / std::max(1L, integrador_respa.pasadasCercanas())
+                  << " pares cercanos por subpaso, lista construida " << integrador_respa.construccionesLista()
+                  << " veces (" << static_cast<double>(integrador_respa.comprobacionesLista())
+                  << " distancias medidas)" << std::endl;
+    }
+    if (E_inicial != 0) {
+        std::cout << std::scientific << std::setprecision(3)
+                  << "Variación relativa de la energía total: " << std::fabs((E_final - E_inicial) / E_inicial)
+                  << std::defaultfloat << std::endl;
+    }
+#ifdef INSTRUMENTACION
+    perfil_sim.imprimirResumen(std::cout);
+    const std::string nombre_perfil = directorio_salida + "/perfil.json";
+    if (!perfil_sim.guardarResumen(nombre_perfil)) {
+        std::cerr << "Error: No se pudo escribir " << nombre_perfil << std::endl;
+    }
+    if (perfil_sim.conTraza()) {
+        const std::string nombre_traza = directorio_salida + "/traza.json";
+        if (perfil_sim.guardarTraza(nombre_traza)) {
+            std::cout << "Línea de tiempo de las fases en " << nombre_traza << " (chrome://tracing o Perfetto)" << std::endl;
+        } else {
+            std::cerr << "Error: No se pudo escribir " << nombre_traza << std::endl;
+        }
+    }
+#endif
+    std::cout << "Simulación completada. Resultados guardados en " << nombre_archivo_salida
+              << " y " << nombre_archivo_diagnosticos << std::endl;
+    return 0;
+}
+
+int ejecutarConjunto(const std::string& directorio_salida) {
+    if (punto_control_cada_sim > 0 || !reanudar_sim.empty()) {
+        std::cout << "Aviso: el conjunto no guarda ni reanuda puntos de control." << std::endl;
+    }
+    ConjuntoSistemas conjunto;
+    conjunto.fijarRadioEscape(radio_escape_sim);
+    conjunto.inicializar(planetas.aCuerpos(), conjunto_sim, perturbacion_sim, static_cast<unsigned long>(semilla_sim));
+    std::cout << std::defaultfloat << std::setprecision(4)
+              << "Conjunto de " << conjunto.miembros() << " sistemas de " << conjunto.cuerpos() << " cuerpos (perturbación "
+              << perturbacion_sim << ", semilla " << semilla_sim << ") en carriles "
+              << nombreNivelSIMD(conjunto.nivelSIMD()) << std::endl;
 
-    graficarResultados();
-    
+    // Tantos pasos como el bucle de ejecutarSimulacion(), que avanza mientras t <= t_max
+    long pasos_totales = 0;
+    for (double t = 0.0; t <= t_max_sim; t += dt_sim) { pasos_totales++; }
+    const long tramo = std::max(1L, pasos_totales / 10); // Progreso un 10% de las veces
+    const long asignaciones_antes = asignacionesMemoria();
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (long hechos = 0; hechos < pasos_totales && conjunto.activos() > 0; hechos += tramo) {
+        conjunto.avanzar(dt_sim, std::min(tramo, pasos_totales - hechos));
+        std::cout << "Conjunto en t = " << std::fixed << std::setprecision(2) << conjunto.tiempo() << " / "
+                  << t_max_sim << " (" << conjunto.activos() << " activos)" << std::endl;
+    }
+    const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    const long asignaciones_bucle = asignacionesMemoria() - asignaciones_antes;
+    conjunto.finalizar();
+
+    const std::string nombre_archivo_conjunto = directorio_salida + "/conjunto.dat";
+    if (!conjunto.guardarResultados(nombre_archivo_conjunto)) {
+        std::cerr << "Error: No se pudo escribir " << nombre_archivo_conjunto << std::endl;
+        return 1;
+    }
+    int por_estado[4] = {0, 0, 0, 0};
+    double error_maximo = 0.0;
+    for (int k = 0; k < conjunto.miembros(); ++k) {
+        const ResultadoMiembro& r = conjunto.resultado(k);
+        por_estado[r.estado]++;
+        if (r.estado == MIEMBRO_COMPLETO) { error_maximo = std::max(error_maximo, r.errorEnergia()); }
+    }
+    std::cout << "Miembros: " << por_estado[MIEMBRO_COMPLETO] << " completos, " << por_estado[MIEMBRO_COLISION]
+              << " con colisión, " << por_estado[MIEMBRO_ESCAPE] << " con escape" << std::endl;
+    std::cout << "Asignaciones de memoria en el bucle de integración: " << asignaciones_bucle << std::endl;
+    std::cout << std::defaultfloat << std::setprecision(4)
+              << "Rendimiento: " << conjunto.pasosSistemas() / std::max(segundos, 1e-9) << " sistemas·pasos/s ("
+              << conjunto.pasosSistemas() << " pasos de sistema en " << segundos << " s; ocupación de carriles "
+              << std::fixed << std::setprecision(1)
+              << 100.0 * conjunto.pasosSistemas() / std::max(1.0, conjunto.pasosCarriles()) << "%)"
+              << std::defaultfloat << std::endl;
+    if (por_estado[MIEMBRO_COMPLETO] > 0) {
+        std::cout << std::scientific << std::setprecision(3)
+                  << "Máxima variación relativa de la energía entre los completos: " << error_maximo
+                  << std::defaultfloat << std::endl;
+    }
+    std::cout << "Resultados por miembro guardados en " << nombre_archivo_conjunto << std::endl;
     return 0;
 }
+
+int ejecutarBarrido(const std::string& directorio_salida) {
+    if (intervalo_salida_sim > 0 || punto_control_cada_sim > 0 || !reanudar_sim.empty()) {
+        std::cout << "Aviso: el barrido escribe cada cada_pasos pasos y no usa intervalo_salida ni puntos de control."
+                  << std::endl;
+    }
+    BarridoParametros barrido;
+    std::string error;
+    if (!barrido.configurar(planetas.aCuerpos(), dt_sim, t_max_sim, barrido_sim, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    const std::string directorio_trabajos = directorio_salida + "/barrido";
+    if (!crearDirectorios(directorio_trabajos)) {
+        std::cerr << "Error: No se pudo crear el directorio " << directorio_trabajos << std::endl;
+        return 1;
+    }
+    std::cout << "Barrido de " << barrido.trabajos() << " trabajos";
+    for (size_t d = 0; d < barrido_sim.size(); ++d) {
+        std::cout << (d == 0 ? " sobre " : " × ") << nombreDimensionBarrido(barrido_sim[d])
+                  << " (" << barrido_sim[d].valores.size() << ")";
+    }
+    std::cout << std::endl;
+
+    const int fallidos = barrido.ejecutar(directorio_trabajos, formato_trayectoria_sim, cada_pasos_salida_sim,
+                                          hilos_barrido_sim);
+    barrido.imprimirReparto(std::cout);
+
+    double error_maximo = 0.0;
+    for (int k = 0; k < barrido.trabajos(); ++k) {
+        error_maximo = std::max(error_maximo, barrido.resultado(k).error_energia);
+    }
+    std::cout << std::scientific << std::setprecision(3)
+              << "Máxima variación relativa de la energía entre los trabajos: " << error_maximo
+              << std::defaultfloat << std::endl;
+
+    const std::string nombre_archivo_barrido = directorio_salida + "/barrido.dat";
+    if (!barrido.guardarResumen(nombre_archivo_barrido)) {
+        std::cerr << "Error: No se pudo escribir " << nombre_archivo_barrido << std::endl;
+        return 1;
+    }
+    std::cout << "Resumen guardado en " << nombre_archivo_barrido << "; trayectorias en " << directorio_trabajos
+              << std::endl;
+    if (fallidos > 0) {
+        std::cerr << "Error: No se pudieron crear " << fallidos << " archivos de trayectoria" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Con argumentos se trabaja por lotes: sin preguntas, sin gráficas y sin system()
+    const bool por_lotes = argc > 1;
+    std::string directorio_salida = "results";
+    if (por_lotes) {
+        const std::string primero = argv[1];
+        if (primero == "--ayuda" || primero == "-h" || primero == "--help") {
+            mostrarUso(argv[0]);
+            return 0;
+        }
+        Escenario escenario = escenarioPorDefecto();
+        std::string error;
+        if (!interpretarLineaComandos(argc, argv, escenario, error)) {
+            std::cerr << "Error: " << error << std::endl;
+            mostrarUso(argv[0]);
+            return 2;
+        }
+        if (!aplicarEscenario(escenario)) {
+            return 1;
+        }
+        directorio_salida = escenario.directorio_salida;
+    } else {
+        solicitarDatos();
+    }
+
+#ifdef INSTRUMENTACION
+    // La traza se reserva aquí, antes de la primera fase medida
+    if (!perfil_sim.configurar(traza_sim, static_cast<size_t>(eventos_traza_sim), contadores_sim)) {
+        std::cout << "Aviso: sin contadores de hardware: " << perfil_sim.errorContadores() << std::endl;
+    }
+#else
+    if (traza_sim || contadores_sim) {
+        std::cout << "Aviso: traza y contadores requieren compilar con 'make INSTRUMENTAR=1'; se ignoran." << std::endl;
+    }
+#endif
+
+    if (!verificarDatos()) {
+        return 1;
+    }
+
+    if (!crearDirectorios(directorio_salida)) {
+        std::cerr << "Error: No se pudo crear el directorio de salida " << directorio_salida << std::endl;
+        return 1;
+    }
+
+    if (conjunto_sim > 0) {
+        return ejecutarConjunto(directorio_salida);
+    }
+    if (!barrido_sim.empty()) {
+        return ejecutarBarrido(directorio_salida);
+    }
+
+    int estado = ejecutarSimulacion(directorio_salida);
+    if (estado == 0 && !por_lotes) {
+        graficarResultados();
+    }
+    return estado;
+}
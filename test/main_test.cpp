@@ -14,9 +14,15 @@
 /**
  * @brief Función principal del programa de testing
  * @return Código de salida (0 = éxito)
- * @details Inicializa el sistema de testing y transfiere control a ejecutarModoTesting()
+ * @details Inicializa el sistema de testing y transfiere control a ejecutarModoTesting();
+ *          con --automatico ejecuta solo las pruebas sin menú y termina con
+ *          su resultado (make test-auto)
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--automatico") {
+        return Testing::ejecutarPruebasAutomaticas();
+    }
+    
     std::cout << "=== PROGRAMA DE TESTING - SIMULACIÓN GRAVITACIONAL ===\n";
     std::cout << "Este programa permite probar diferentes herramientas de graficación\n";
     std::cout << "con datos de simulación reales generados por el programa principal.\n";
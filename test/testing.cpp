@@ -6,6 +6,17 @@
  */
 
 #include "testing.h"
+#include "SistemaCuerpos.h"
+#include "Fuerzas.h"
+#include "FuerzasSIMD.h"
+#include "SumaDirectaParalela.h"
+#include "BarnesHut.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
 
 namespace Testing {
 
@@ -87,47 +98,82 @@ std::vector<SistemaPrueba> obtenerSistemasPredefinidos() {
         }
     });
     
+    // Sistema 7: Estrella dominante con tres planetas
+    sistemas.push_back({
+        "sistema_planetario",
+        "Estrella con tres planetas ligeros en órbitas casi circulares",
+        4, 0.01, 50.0,
+        {
+            {100.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+            {0.01, 0.05, 3.0, 0.0, 0.0, 0.0, 5.9, 0.06},
+            {0.05, 0.05, -2.1, 4.5, 0.0, -4.1, -1.9, 0.0},
+            {0.02, 0.05, -5.2, -6.1, 0.0, 2.7, -2.3, 0.0}
+        }
+    });
+    
+    // Sistema 8: Cúmulo de 16 binarias cerradas (a = 0.1, periodo ~0.14) separadas ~4
+    SistemaPrueba cumulo = {
+        "cumulo_binarias",
+        "Cúmulo frío de 16 binarias: fuerzas internas rápidas y campo lejano lento",
+        32, 0.00125, 2.5,
+        {}
+    };
+    for (int k = 0; k < 16; ++k) {
+        const double cx = 4.0 * (k % 4) - 6.0, cy = 4.0 * (k / 4) - 6.0, cz = (k * 7) % 5 - 2.0;
+        const double Vx = 0.3 * std::cos(2.4 * k), Vy = 0.3 * std::sin(2.4 * k), Vz = 0.1 * (k % 3 - 1);
+        const double a = 0.1, v = 0.5 * std::sqrt(2.0 / a); // Órbita circular de dos masas unidad
+        const double ux = std::cos(1.3 * k), uy = std::sin(1.3 * k);
+        for (int s = 1; s >= -1; s -= 2) {
+            DatosCuerpo cuerpo = {1.0, 0.01, cx + s * ux * a / 2, cy + s * uy * a / 2, cz,
+                                  Vx - s * uy * v, Vy + s * ux * v, Vz};
+            cumulo.cuerpos.push_back(cuerpo);
+        }
+    }
+    sistemas.push_back(cumulo);
+    
     return sistemas;
 }
 
 /**
- * @brief Genera archivo de entrada para el programa principal
+ * @brief Genera el archivo de escenario para el programa principal
  * @param sistema Configuración del sistema a escribir en el archivo
- * @details Genera input_temp.txt con formato: N, masas, radios, posiciones, 
- *          velocidades, dt, t_max, opción de graficación
+ * @details Genera escenario_temp.txt con una línea 'cuerpo = ...' por cuerpo
+ *          y las claves dt y t_max; el programa principal lo lee con
+ *          --escenario, sin preguntas ni menú de graficación
  */
 void generarArchivoEntrada(const SistemaPrueba& sistema) {
-    std::ofstream archivo("input_temp.txt");
+    std::ofstream archivo("escenario_temp.txt");
     if (!archivo.is_open()) {
-        archivo.open("input_temp.txt");
-        if (!archivo.is_open()) {
-            std::cout << "❌ Error: No se pudo crear archivo de entrada temporal\n";
-            return;
-        }
+        std::cout << "❌ Error: No se pudo crear archivo de escenario temporal\n";
+        return;
     }
     
-    // Escribir datos en el formato que espera el programa principal
-    archivo << sistema.n_cuerpos << "\n";
-    
+    archivo << "# Sistema de prueba: " << sistema.nombre << "\n";
     for (const auto& cuerpo : sistema.cuerpos) {
-        archivo << cuerpo.masa << "\n";
-        archivo << cuerpo.radio << "\n";
-        archivo << cuerpo.x << " " << cuerpo.y << " " << cuerpo.z << "\n";
-        archivo << cuerpo.vx << " " << cuerpo.vy << " " << cuerpo.vz << "\n";
+        archivo << "cuerpo = " << cuerpo.masa << " " << cuerpo.radio << " "
+                << cuerpo.x << " " << cuerpo.y << " " << cuerpo.z << " "
+                << cuerpo.vx << " " << cuerpo.vy << " " << cuerpo.vz << "\n";
     }
-    
-    archivo << sistema.dt << "\n";
-    archivo << sistema.t_max << "\n";
-    archivo << "6\n"; // No graficar desde el programa principal
+    archivo << "dt = " << sistema.dt << "\n";
+    archivo << "t_max = " << sistema.t_max << "\n";
     
     archivo.close();
 }
 
+bool compilarProgramaPrincipal() {
+    std::cout << "Compilando programa principal...\n";
+    if (system("make -C .. all") != 0) {
+        std::cout << "❌ Error en compilación. Verifica que el código esté correcto.\n";
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Ejecuta simulación con el programa principal usando sistema predefinido
  * @param sistema Sistema predefinido cuyos datos se usarán para la simulación
- * @details Genera archivo de entrada temporal, compila código fuente y 
- *          ejecuta simulación redirigiendo entrada desde archivo temporal
+ * @details Genera un escenario temporal, compila código fuente y
+ *          ejecuta la simulación por lotes con --escenario
  */
 void ejecutarSimulacionConSistema(const SistemaPrueba& sistema) {
     std::cout << "\n=== EJECUTANDO SIMULACIÓN CON PROGRAMA PRINCIPAL ===\n";
@@ -140,22 +186,17 @@ void ejecutarSimulacionConSistema(const SistemaPrueba& sistema) {
     generarArchivoEntrada(sistema);
     
     // Compilar el programa principal si es necesario
-    std::cout << "Compilando programa principal...\n";
-    std::string compile_cmd = "cd .. && g++ -o bin/gravedad src/main.cpp src/Cuerpo.cpp src/utilidades.cpp src/vector3D.cpp -I include";
-    if (system(compile_cmd.c_str()) != 0) {
-        std::cout << "❌ Error en compilación. Verifica que el código esté correcto.\n";
-        return;
-    }
+    if (!compilarProgramaPrincipal()) return;
     
     std::cout << "✅ Compilación exitosa\n";
     std::cout << "Ejecutando simulación con algoritmo de Verlet...\n";
     
     // Ejecutar simulación (desde bin/ el archivo temporal estará en ../test/)
-    std::string run_cmd = "cd .. && ./bin/gravedad < test/input_temp.txt";
+    std::string run_cmd = "cd .. && ./bin/gravedad --escenario test/escenario_temp.txt";
     int resultado = system(run_cmd.c_str());
     
     // Limpiar archivo temporal
-    system("rm -f test/input_temp.txt");
+    system("cd .. && rm -f test/escenario_temp.txt");
     
     if (resultado == 0) {
         std::cout << "✅ Simulación completada exitosamente\n";
@@ -208,6 +249,383 @@ void mostrarSistemasPredefinidos() {
     }
 }
 
+/**
+ * @brief Lee los cuadros de una trayectoria binaria, sin redondeo
+ * @param ruta Archivo sim_data.bin
+ * @return Un vector por cuadro con el tiempo y los campos guardados (vacío si no se pudo leer)
+ */
+static std::vector<std::vector<double> > leerTrayectoriaBinaria(const std::string& ruta) {
+    std::vector<std::vector<double> > cuadros;
+    std::ifstream datos(ruta.c_str(), std::ios::binary);
+    char cabecera[48];
+    if (!datos.read(cabecera, sizeof(cabecera))) return cuadros;
+    std::uint32_t tam_cabecera, tam_cuadro;
+    std::memcpy(&tam_cabecera, cabecera + 12, sizeof(tam_cabecera));
+    std::memcpy(&tam_cuadro, cabecera + 44, sizeof(tam_cuadro));
+    datos.seekg(tam_cabecera);
+    std::vector<double> cuadro(tam_cuadro / sizeof(double));
+    while (datos.read(reinterpret_cast<char*>(cuadro.data()), tam_cuadro)) {
+        cuadros.push_back(cuadro);
+    }
+    return cuadros;
+}
+
+ResultadoIntegrador ejecutarConIntegrador(const SistemaPrueba& sistema, const std::string& opciones, double dt,
+                                          double periodo) {
+    ResultadoIntegrador resultado;
+    resultado.valido = false;
+    resultado.evaluaciones = 0;
+    resultado.error_energia = 0.0;
+    resultado.t_choque = 0.0;
+    resultado.interacciones = 0.0;
+    resultado.error_fase = 0.0;
+    
+    generarArchivoEntrada(sistema);
+    std::ostringstream comando;
+    comando << std::setprecision(17) << "cd .. && ./bin/gravedad --escenario test/escenario_temp.txt --dt " << dt
+            << " " << opciones << " --salida results/comparacion --formato binario --campos p"
+            << " --cada-pasos " << static_cast<long>(periodo / dt + 0.5)
+            << " --cadencia-diagnosticos 1 2>&1";
+    FILE* proceso = popen(comando.str().c_str(), "r");
+    if (!proceso) return resultado;
+    
+    // El informe final trae "... ms en N evaluaciones" y "Variación relativa de la energía total: X";
+    // con RESPA, también "RESPA (...): X interacciones de pares"
+    char linea[1024];
+    bool con_energia = false;
+    while (fgets(linea, sizeof(linea), proceso)) {
+        std::string texto(linea);
+        size_t pos = texto.find(" ms en ");
+        if (pos != std::string::npos) resultado.evaluaciones = std::atol(texto.c_str() + pos + 7);
+        pos = texto.find("energía total: ");
+        if (pos != std::string::npos) {
+            resultado.error_energia = std::atof(texto.c_str() + pos + std::string("energía total: ").size());
+            con_energia = true;
+        }
+        pos = texto.find(" interacciones de pares");
+        if (pos != std::string::npos) {
+            size_t inicio = texto.rfind(": ", pos);
+            if (inicio != std::string::npos) resultado.interacciones = std::atof(texto.c_str() + inicio + 2);
+        }
+        pos = texto.find("se detuvo en t = ");
+        if (pos != std::string::npos) {
+            resultado.t_choque = std::atof(texto.c_str() + pos + std::string("se detuvo en t = ").size());
+        }
+    }
+    int estado = pclose(proceso);
+    system("rm -f escenario_temp.txt");
+    if (estado != 0 || !con_energia) return resultado;
+    
+    // Trayectoria binaria sin redondeo: cuadros t, x[N], y[N], z[N]
+    resultado.cuadros = leerTrayectoriaBinaria("../results/comparacion/sim_data.bin");
+    resultado.valido = !resultado.cuadros.empty();
+    return resultado;
+}
+
+/**
+ * @brief Máxima distancia entre las posiciones de dos ejecuciones en los tiempos comunes
+ */
+static double errorDeFase(const ResultadoIntegrador& prueba, const ResultadoIntegrador& referencia) {
+    double error = 0.0;
+    for (size_t k = 0; k < prueba.cuadros.size() && k < referencia.cuadros.size(); ++k) {
+        const std::vector<double>& a = prueba.cuadros[k];
+        const std::vector<double>& b = referencia.cuadros[k];
+        if (a.size() != b.size() || std::fabs(a[0] - b[0]) > 1e-6) break; // Cuadro ausente en una de las dos
+        const size_t n = (a.size() - 1) / 3;
+        for (size_t i = 1; i <= n; ++i) {
+            double dx = a[i] - b[i], dy = a[i + n] - b[i + n], dz = a[i + 2 * n] - b[i + 2 * n];
+            error = std::max(error, std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Compila el programa principal solo la primera vez en esta sesión
+ */
+static bool compilarUnaVez() {
+    static bool compilado = false;
+    if (!compilado) compilado = compilarProgramaPrincipal();
+    return compilado;
+}
+
+std::vector<ResultadoIntegrador> ejecutarComparacion(const SistemaPrueba& sistema,
+                                                     const CasoComparacion& referencia,
+                                                     const std::vector<CasoComparacion>& casos, double periodo) {
+    std::vector<ResultadoIntegrador> resultados;
+    if (!compilarUnaVez()) return resultados;
+    
+    ResultadoIntegrador ref = ejecutarConIntegrador(sistema, referencia.opciones, referencia.dt, periodo);
+    if (!ref.valido) {
+        std::cout << "❌ No se pudo ejecutar la referencia de " << sistema.nombre << "\n";
+        return resultados;
+    }
+    std::cout << "\nSistema: " << sistema.nombre << " (N = " << sistema.n_cuerpos << ", t = " << sistema.t_max
+              << ", referencia " << referencia.nombre << " con dt = " << referencia.dt << ")\n";
+    std::cout << std::left << std::setw(24) << "Integrador" << std::right << std::setw(11) << "dt"
+              << std::setw(13) << "Evaluaciones" << std::setw(14) << "Pares"
+              << std::setw(13) << "|ΔE/E|" << std::setw(15) << "Error de fase" << "\n";
+    const double pares = 0.5 * sistema.n_cuerpos * (sistema.n_cuerpos - 1);
+    for (size_t k = 0; k < casos.size(); ++k) {
+        ResultadoIntegrador r = ejecutarConIntegrador(sistema, casos[k].opciones, casos[k].dt, periodo);
+        std::cout << std::left << std::setw(24) << casos[k].nombre << std::right << std::setw(11) << casos[k].dt;
+        if (!r.valido) {
+            std::cout << "   ❌ falló la ejecución\n";
+        } else {
+            r.error_fase = errorDeFase(r, ref);
+            const double interacciones = r.interacciones > 0 ? r.interacciones : r.evaluaciones * pares;
+            std::cout << std::setw(13) << r.evaluaciones << std::setw(14) << static_cast<long>(interacciones)
+                      << std::scientific << std::setprecision(2) << std::setw(13) << r.error_energia
+                      << std::setw(13) << r.error_fase << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+        r.cuadros.clear(); // Solo hacía falta para el error de fase
+        resultados.push_back(r);
+    }
+    return resultados;
+}
+
+bool compararIntegradores() {
+    std::cout << "\n=== COMPARACIÓN DE INTEGRADORES: PASOS FRENTE A PRECISIÓN ===\n";
+    
+    const char* nombres[] = {"Verlet", "Hermite 4", "Forest-Ruth 4", "Yoshida 6", "Yoshida 8", "Wisdom-Holman"};
+    const char* opciones[] = {"--integrador verlet", "--integrador hermite",
+                              "--integrador composicion --orden-composicion 4",
+                              "--integrador composicion --orden-composicion 6",
+                              "--integrador composicion --orden-composicion 8",
+                              "--integrador wisdom-holman"};
+    const int n_integradores = 6;
+    const int n_pasos = 6; // dt, 2dt, 4dt, 8dt, 16dt, 32dt
+    bool correcto = true;
+    
+    auto sistemas = obtenerSistemasPredefinidos();
+    for (const auto& sistema : sistemas) {
+        if (sistema.nombre != "orbita_circular" && sistema.nombre != "orbita_eliptica" &&
+            sistema.nombre != "sistema_planetario") continue;
+        
+        const double periodo = sistema.dt * (1 << (n_pasos - 1)); // Tiempos de comparación comunes a todos los dt
+        std::vector<CasoComparacion> casos;
+        for (int i = 0; i < n_integradores; ++i) {
+            for (int k = 0; k < n_pasos; ++k) {
+                CasoComparacion caso = {nombres[i], opciones[i], sistema.dt * (1 << k)};
+                casos.push_back(caso);
+            }
+        }
+        const CasoComparacion referencia = {nombres[4], opciones[4], sistema.dt / 4};
+        std::vector<ResultadoIntegrador> r = ejecutarComparacion(sistema, referencia, casos, periodo);
+        if (r.empty()) {
+            correcto = false;
+            continue;
+        }
+        
+        // Cada fila de Yoshida 8 frente a la de Verlet con menos evaluaciones entre las que
+        // tienen al menos tantas (16dt frente a dt, 32dt frente a 2dt)
+        const int verlet = 0, yoshida8 = 4 * n_pasos;
+        for (int k = 0; k < n_pasos; ++k) {
+            const ResultadoIntegrador& y8 = r[yoshida8 + k];
+            int elegido = -1;
+            for (int j = 0; j < n_pasos; ++j) {
+                const ResultadoIntegrador& v = r[verlet + j];
+                if (v.valido && v.evaluaciones >= y8.evaluaciones &&
+                    (elegido < 0 || v.evaluaciones < r[verlet + elegido].evaluaciones)) elegido = j;
+            }
+            if (elegido < 0) continue;
+            const ResultadoIntegrador& v = r[verlet + elegido];
+            const bool pasa = y8.valido && y8.error_fase < v.error_fase;
+            correcto = correcto && pasa;
+            std::cout << (pasa ? "✅" : "❌") << " Yoshida 8 (dt = " << casos[yoshida8 + k].dt << ", "
+                      << y8.evaluaciones << " evaluaciones): error de fase " << y8.error_fase
+                      << (pasa ? " < " : " >= ") << v.error_fase << " de Verlet (dt = " << casos[verlet + elegido].dt
+                      << ", " << v.evaluaciones << " evaluaciones)\n";
+        }
+    }
+    std::cout << "\nMenor error con menos evaluaciones = mejor integrador para ese sistema.\n";
+    std::cout << (correcto ? "✅ Comprobaciones superadas\n" : "❌ Alguna comprobación falló\n");
+    return correcto;
+}
+
+void compararEncuentrosCercanos() {
+    std::cout << "\n=== ENCUENTROS CERCANOS: IAS15 FRENTE A VERLET ===\n";
+    if (!compilarUnaVez()) return;
+    
+    const double periodo = 0.05; // Intervalo de salida de IAS15 y tiempo entre cuadros comparados
+    auto sistemas = obtenerSistemasPredefinidos();
+    for (auto sistema : sistemas) {
+        if (sistema.nombre != "cuatro_cuerpos_caotico" && sistema.nombre != "colision_frontal") continue;
+        
+        // IAS15 se detiene en el choque: ese tiempo fija el tramo que se puede comparar
+        ResultadoIntegrador completo = ejecutarConIntegrador(sistema, "--integrador ias15", periodo, periodo);
+        if (completo.t_choque > 0) {
+            std::cout << "\n" << sistema.nombre << ": IAS15 detecta un choque de masas puntuales en t = "
+                      << std::setprecision(10) << completo.t_choque << std::setprecision(6) << "\n";
+            sistema.t_max = periodo * std::floor(0.95 * completo.t_choque / periodo);
+        }
+        std::vector<CasoComparacion> casos;
+        for (int k = 0; k < 4; ++k) { // dt, dt/4, dt/16, dt/64
+            CasoComparacion caso = {"Verlet", "--integrador verlet", sistema.dt / (1 << (2 * k))};
+            casos.push_back(caso);
+        }
+        CasoComparacion ias15 = {"IAS15 (1e-9)", "--integrador ias15", periodo};
+        casos.push_back(ias15);
+        const CasoComparacion referencia = {"IAS15 (1e-11)", "--integrador ias15 --tolerancia-ias15 1e-11", periodo};
+        ejecutarComparacion(sistema, referencia, casos, periodo);
+    }
+    std::cout << "\nPara IAS15, dt es solo el intervalo de salida: los pasos internos son adaptativos.\n";
+}
+
+bool compararRESPA() {
+    std::cout << "\n=== RESPA FRENTE A VERLET EN UN CÚMULO DE BINARIAS ===\n";
+    bool correcto = true;
+    
+    auto sistemas = obtenerSistemasPredefinidos();
+    for (const auto& sistema : sistemas) {
+        if (sistema.nombre != "cumulo_binarias") continue;
+        
+        // Verlet con el paso de las binarias y RESPA con ese mismo paso interno
+        const double periodo = 0.16; // Múltiplo de todos los pasos comparados
+        std::vector<CasoComparacion> casos;
+        CasoComparacion verlet = {"Verlet", "--integrador verlet", sistema.dt};
+        casos.push_back(verlet);
+        const int subpasos[] = {4, 8, 16};
+        const double radios[][2] = {{0.5, 1.0}, {1.0, 2.0}};
+        for (int r = 0; r < 2; ++r) {
+            for (int k = 0; k < 3; ++k) {
+                std::ostringstream opciones, nombre;
+                opciones << "--integrador respa --subpasos-respa " << subpasos[k] << " --radio-interior-respa "
+                         << radios[r][0] << " --radio-exterior-respa " << radios[r][1];
+                nombre << "RESPA " << radios[r][0] << "-" << radios[r][1] << ", M = " << subpasos[k];
+                CasoComparacion caso = {nombre.str(), opciones.str(), sistema.dt * subpasos[k]};
+                casos.push_back(caso);
+            }
+        }
+        const CasoComparacion referencia = {"Verlet", "--integrador verlet", sistema.dt / 4};
+        std::vector<ResultadoIntegrador> r = ejecutarComparacion(sistema, referencia, casos, periodo);
+        if (r.empty()) {
+            correcto = false;
+            continue;
+        }
+        
+        // RESPA 0.5-1 con M = 4 frente a Verlet con su paso interno
+        const double pares_verlet = r[0].evaluaciones * 0.5 * sistema.n_cuerpos * (sistema.n_cuerpos - 1);
+        const bool pasa = r[0].valido && r[1].valido && r[1].interacciones < pares_verlet &&
+                          r[1].error_fase <= 1.01 * r[0].error_fase;
+        correcto = correcto && pasa;
+        std::cout << (pasa ? "✅" : "❌") << " " << casos[1].nombre << ": " << static_cast<long>(r[1].interacciones)
+                  << " pares frente a " << static_cast<long>(pares_verlet) << " de Verlet, error de fase "
+                  << r[1].error_fase << " frente a " << r[0].error_fase << "\n";
+    }
+    std::cout << "\nRESPA recorre todos los pares una vez por dt y solo los cercanos en cada subpaso dt/M.\n";
+    std::cout << (correcto ? "✅ Comprobaciones superadas\n" : "❌ Alguna comprobación falló\n");
+    return correcto;
+}
+
+bool probarReanudacion() {
+    std::cout << "\n=== REANUDACIÓN DESDE UN PUNTO DE CONTROL ===\n";
+    if (!compilarUnaVez()) return false;
+    
+    // 200 pasos de dt = 0.01 con un punto de control cada 120: se reanuda desde el paso 120
+    SistemaPrueba sistema;
+    auto sistemas = obtenerSistemasPredefinidos();
+    for (const auto& s : sistemas) { if (s.nombre == "sistema_planetario") sistema = s; }
+    sistema.t_max = 2.0;
+    generarArchivoEntrada(sistema);
+    
+    const char* nombres[] = {"Verlet", "Bloques", "Hermite", "Yoshida 6", "Wisdom-Holman", "IAS15", "RESPA"};
+    const char* opciones[] = {"--integrador verlet", "--integrador bloques", "--integrador hermite",
+                              "--integrador composicion --orden-composicion 6", "--integrador wisdom-holman",
+                              "--integrador ias15",
+                              "--integrador respa --radio-interior-respa 1 --radio-exterior-respa 2"};
+    const std::string comun = "cd .. && ./bin/gravedad --escenario test/escenario_temp.txt --formato binario"
+                              " --campos pv --punto-control-cada 120 ";
+    bool correcto = true;
+    for (int i = 0; i < 7; ++i) {
+        system("rm -rf ../results/reanudacion");
+        const std::string completa = comun + opciones[i] + " --salida results/reanudacion/completa > /dev/null 2>&1";
+        const std::string reanudada = comun + opciones[i] + " --salida results/reanudacion/reanudada"
+                                      " --restart results/reanudacion/completa/punto_control.bin > /dev/null 2>&1";
+        std::vector<std::vector<double> > a, b;
+        if (system(completa.c_str()) == 0 && system(reanudada.c_str()) == 0) {
+            a = leerTrayectoriaBinaria("../results/reanudacion/completa/sim_data.bin");
+            b = leerTrayectoriaBinaria("../results/reanudacion/reanudada/sim_data.bin");
+        }
+        // La trayectoria reanudada debe ser, bit a bit, la cola de la completa
+        bool pasa = !b.empty() && b.size() < a.size();
+        for (size_t k = 0; pasa && k < b.size(); ++k) { pasa = (b[k] == a[a.size() - b.size() + k]); }
+        correcto = correcto && pasa;
+        std::cout << (pasa ? "✅ " : "❌ ") << std::left << std::setw(15) << nombres[i] << std::right;
+        if (b.empty()) std::cout << "no se pudo ejecutar o reanudar\n";
+        else std::cout << b.size() << " de " << a.size() << " cuadros desde t = " << b[0][0]
+                       << (pasa ? ", idénticos\n" : ", distintos\n");
+    }
+    system("rm -f escenario_temp.txt");
+    return correcto;
+}
+
+bool probarNucleosFuerzas() {
+    std::cout << "\n=== NÚCLEOS DE FUERZAS FRENTE AL ESCALAR ===\n";
+    // Tamaños con restos en los carriles y en los bloques j de la caché L1
+    const int bloque = tamanoBloqueJ();
+    const int tamanos[] = {2, 3, 17, bloque + 5, 1000, 3 * bloque + 1};
+    const NivelSIMD nivel_inicial = nivelSIMDActivo();
+    bool correcto = true;
+    for (int t = 0; t < 6; ++t) {
+        // Sistema determinista con masas distintas: generador congruencial en el cubo [-1, 1]³
+        const int n = tamanos[t];
+        SistemaCuerpos cuerpos(n);
+        unsigned long long semilla = 12345;
+        for (int i = 0; i < n; ++i) {
+            double u[4];
+            for (int c = 0; c < 4; ++c) {
+                semilla = semilla * 6364136223846793005ULL + 1442695040888963407ULL;
+                u[c] = static_cast<double>(semilla >> 11) / 9007199254740992.0;
+            }
+            cuerpos.x[i] = 2.0 * u[0] - 1.0;
+            cuerpos.y[i] = 2.0 * u[1] - 1.0;
+            cuerpos.z[i] = 2.0 * u[2] - 1.0;
+            cuerpos.fijarMasa(i, (0.5 + u[3]) / n);
+        }
+        Aceleraciones referencia, a;
+        referencia.redimensionar(n);
+        a.redimensionar(n);
+        calcularFuerzasEscalar(cuerpos, referencia);
+        
+        for (int nivel = SIMD_ESCALAR; nivel <= detectarNivelSIMD(); ++nivel) {
+            fijarNivelSIMD(static_cast<NivelSIMD>(nivel));
+            calcularTodasLasFuerzas(cuerpos, a);
+            const double diferencia = diferenciaRelativaMaxima(a, referencia);
+            SumaDirectaParalela paralela(3);
+            paralela.calcularFuerzas(cuerpos, a);
+            const double diferencia_paralela = diferenciaRelativaMaxima(a, referencia);
+            const bool pasa = diferencia <= TOLERANCIA_FUERZAS_SIMD && diferencia_paralela <= TOLERANCIA_FUERZAS_SIMD;
+            correcto = correcto && pasa;
+            std::cout << (pasa ? "✅ " : "❌ ") << std::left << std::setw(8)
+                      << nombreNivelSIMD(static_cast<NivelSIMD>(nivel)) << std::right << " N = " << std::setw(5) << n << std::scientific << std::setprecision(2)
+                      << ": diferencia " << diferencia << ", con 3 hilos " << diferencia_paralela
+                      << std::defaultfloat << std::setprecision(6) << "\n";
+        }
+        fijarNivelSIMD(nivel_inicial);
+        
+        // Con θ = 0 ninguna celda se acepta como monopolo: Barnes-Hut suma todos los pares
+        BarnesHut arbol(0.0);
+        arbol.calcularFuerzas(cuerpos, a);
+        const double diferencia = diferenciaRelativaMaxima(a, referencia);
+        const bool pasa = diferencia <= TOLERANCIA_FUERZAS_SIMD;
+        correcto = correcto && pasa;
+        std::cout << (pasa ? "✅ " : "❌ ") << std::left << std::setw(9) << "BH θ=0" << std::right << " N = "
+                  << std::setw(5) << n << std::scientific << std::setprecision(2) << ": diferencia " << diferencia
+                  << std::defaultfloat << std::setprecision(6) << "\n";
+    }
+    std::cout << "Tolerancia relativa por cuerpo: " << TOLERANCIA_FUERZAS_SIMD << "\n";
+    return correcto;
+}
+
+int ejecutarPruebasAutomaticas() {
+    const bool nucleos = probarNucleosFuerzas();
+    const bool reanudacion = probarReanudacion();
+    const bool correcto = nucleos && reanudacion;
+    std::cout << "\n" << (correcto ? "✅ Pruebas superadas\n" : "❌ Alguna prueba falló\n");
+    return correcto ? 0 : 1;
+}
+
 /**
  * @brief Menú principal
  */
@@ -230,7 +648,11 @@ void mostrarMenuTesting() {
     std::cout << "11. Ver archivos de resultados\n";
     std::cout << "12. Verificar datos generados\n";
     std::cout << "13. Limpiar archivos de resultados\n";
-    std::cout << "14. Salir\n";
+    std::cout << "\n--- INTEGRADORES ---\n";
+    std::cout << "14. Comparar integradores (pasos frente a precisión en órbitas)\n";
+    std::cout << "15. Comparar IAS15 y Verlet en encuentros cercanos\n";
+    std::cout << "16. Comparar RESPA y Verlet en un cúmulo de binarias\n";
+    std::cout << "17. Salir\n";
     std::cout << "========================================================\n";
 }
 
@@ -240,7 +662,7 @@ void ejecutarModoTesting() {
     
     while (continuar) {
         mostrarMenuTesting();
-        std::cout << "Selecciona una opción (1-14): ";
+        std::cout << "Selecciona una opción (1-17): ";
         std::cin >> opcion;
         std::cin.ignore(); // Limpiar buffer
         
@@ -262,13 +684,10 @@ void ejecutarModoTesting() {
             }
             case 3:
                 std::cout << "\n=== EJECUCIÓN MANUAL DEL PROGRAMA PRINCIPAL ===\n";
-                std::cout << "Compilando...\n";
-                if (system("cd .. && g++ -o simulacion src/main.cpp src/Cuerpo.cpp src/utilidades.cpp src/vector3D.cpp -I include") == 0) {
+                if (compilarProgramaPrincipal()) {
                     std::cout << "✅ Compilación exitosa\n";
                     std::cout << "Ejecutando programa principal...\n";
-                    system("cd .. && ./simulacion");
-                } else {
-                    std::cout << "❌ Error en compilación\n";
+                    system("cd .. && ./bin/gravedad");
                 }
                 break;
             case 4:
@@ -308,6 +727,15 @@ void ejecutarModoTesting() {
                 }
                 break;
             case 14:
+                compararIntegradores();
+                break;
+            case 15:
+                compararEncuentrosCercanos();
+                break;
+            case 16:
+                compararRESPA();
+                break;
+            case 17:
                 std::cout << "Saliendo del modo testing...\n";
                 continuar = false;
                 break;
@@ -335,7 +763,7 @@ void ejecutarModoTesting() {
         }
         
         // Pausa para utilidades
-        if (continuar && (opcion >= 11 && opcion <= 13)) {
+        if (continuar && (opcion >= 11 && opcion <= 16)) {
             std::cout << "\nPresiona Enter para continuar...";
             std::cin.get();
         }
@@ -135,12 +135,20 @@ namespace Testing {
     void mostrarSistemasPredefinidos();
     
     /**
-     * @brief Genera archivo de entrada temporal para el programa principal
+     * @brief Genera archivo de escenario temporal para el programa principal
      * @param sistema Sistema predefinido cuyos datos se escribirán al archivo
-     * @details Crea input_temp.txt con formato compatible con main.cpp
+     * @details Crea escenario_temp.txt, que main.cpp lee con --escenario
      */
     void generarArchivoEntrada(const SistemaPrueba& sistema);
     
+    /**
+     * @brief Compila el programa principal con el Makefile del proyecto
+     * @return true si bin/gravedad quedó actualizado
+     * @details Ejecuta make -C .. all, con las mismas opciones (-O2, -pthread)
+     *          que una compilación normal; solo recompila lo que cambió
+     */
+    bool compilarProgramaPrincipal();
+    
     /**
      * @brief Ejecuta simulación completa usando el programa principal compilado
      * @param sistema Sistema predefinido a simular
@@ -157,6 +165,122 @@ namespace Testing {
      */
     void verificarFormatoArchivo();
     
+    /**
+     * @struct ResultadoIntegrador
+     * @brief Costo y precisión de una ejecución del programa principal
+     */
+    struct ResultadoIntegrador {
+        bool valido;              ///< true si la simulación terminó y se leyó su salida
+        long evaluaciones;        ///< Evaluaciones de fuerza informadas por el programa
+        double error_energia;     ///< Variación relativa de la energía total al final
+        double t_choque;          ///< Tiempo en que IAS15 detectó un choque (0 si no lo hubo)
+        double interacciones;     ///< Interacciones de pares informadas por RESPA (0 con otros integradores)
+        double error_fase;        ///< Máxima distancia a la referencia (la llena ejecutarComparacion)
+        std::vector<std::vector<double> > cuadros; ///< Cuadros t, x[N], y[N], z[N] de la trayectoria
+    };
+    
+    /**
+     * @brief Ejecuta un sistema predefinido con un integrador y un paso dados
+     * @param sistema Sistema a simular (se usan sus cuerpos y t_max)
+     * @param opciones Opciones de línea de comandos del integrador, p. ej. "--integrador verlet"
+     * @param dt Paso de tiempo
+     * @param periodo Tiempo entre cuadros guardados (múltiplo de dt)
+     * @return Evaluaciones de fuerza, error de energía y posiciones cada periodo
+     * @details Lanza ../bin/gravedad por lotes con popen() y lee su informe
+     *          final y la trayectoria binaria results/comparacion/sim_data.bin
+     */
+    ResultadoIntegrador ejecutarConIntegrador(const SistemaPrueba& sistema, const std::string& opciones, double dt,
+                                              double periodo);
+    
+    /**
+     * @struct CasoComparacion
+     * @brief Una ejecución de una tabla de comparación
+     */
+    struct CasoComparacion {
+        std::string nombre;       ///< Nombre en la tabla
+        std::string opciones;     ///< Opciones de línea de comandos, p. ej. "--integrador verlet"
+        double dt;                ///< Paso de tiempo (con IAS15, intervalo de salida)
+    };
+    
+    /**
+     * @brief Ejecuta una lista de casos y los compara con una referencia
+     * @param sistema Sistema a simular
+     * @param referencia Caso de referencia, más preciso que todos los demás
+     * @param casos Casos de la tabla
+     * @param periodo Tiempo entre cuadros comparados (múltiplo de todos los dt)
+     * @return Resultado de cada caso, en el orden de casos, con su error de
+     *         fase; vacío si la referencia falló
+     * @details Compila el programa principal la primera vez que se llama e
+     *          imprime una fila por caso con evaluaciones de fuerza,
+     *          interacciones de pares (las de RESPA o evaluaciones·N(N-1)/2),
+     *          variación de la energía y error de fase
+     */
+    std::vector<ResultadoIntegrador> ejecutarComparacion(const SistemaPrueba& sistema,
+                                                         const CasoComparacion& referencia,
+                                                         const std::vector<CasoComparacion>& casos, double periodo);
+    
+    /**
+     * @brief Compara pasos frente a precisión de los integradores en las órbitas de prueba
+     * @details Integra orbita_circular, orbita_eliptica y sistema_planetario con
+     *          Verlet, Hermite, las composiciones simplécticas de orden 4, 6 y 8
+     *          y Wisdom-Holman, con dt, 2dt,
+     *          4dt, ... Para cada caso muestra evaluaciones de fuerza,
+     *          variación de la energía y error de fase: la máxima distancia,
+     *          cada 32dt, a una referencia de Yoshida 8 con dt/4
+     * @return true si Yoshida 8 tiene menor error de fase que Verlet con el
+     *         mismo número de evaluaciones de fuerza o más, en todos los sistemas
+     */
+    bool compararIntegradores();
+    
+    /**
+     * @brief Compara IAS15 con Verlet en los sistemas con encuentros cercanos
+     * @details En cuatro_cuerpos_caotico y colision_frontal hay choques de
+     *          masas puntuales con momento angular relativo nulo. Primero IAS15
+     *          localiza el choque; después se integra hasta el 95 % de ese tiempo
+     *          con Verlet (dt, dt/4, dt/16, dt/64) y con IAS15, y se muestran
+     *          evaluaciones de fuerza, variación de la energía y error de fase
+     *          frente a IAS15 con ε = 1e-11
+     */
+    void compararEncuentrosCercanos();
+    
+    /**
+     * @brief Compara RESPA con Verlet en el cúmulo de binarias
+     * @details Verlet usa el paso dt que resuelve las binarias; RESPA usa
+     *          dt·M con M = 4, 8 y 16 subpasos internos de dt, para dos
+     *          pares de radios de conmutación. Se muestran interacciones de
+     *          pares, variación de la energía y error de fase frente a
+     *          Verlet con dt/4
+     * @return true si RESPA con M = 4 recorre menos pares que Verlet con su
+     *         mismo paso interno sin aumentar el error de fase más de un 1 %
+     */
+    bool compararRESPA();
+    
+    /**
+     * @brief Comprueba que una simulación reanudada repite la original
+     * @details Integra sistema_planetario 200 pasos con cada integrador
+     *          guardando un punto de control cada 120, lo reanuda desde el
+     *          paso 120 en otro directorio y compara la trayectoria binaria
+     *          reanudada con la cola de la completa, bit a bit
+     * @return true si todos los integradores dan la misma cola
+     */
+    bool probarReanudacion();
+    
+    /**
+     * @brief Compara los núcleos de fuerzas con calcularFuerzasEscalar
+     * @details Para N con restos en los carriles y en los bloques de la caché,
+     *          fija cada NivelSIMD disponible con fijarNivelSIMD y compara
+     *          calcularTodasLasFuerzas y la suma directa con 3 hilos; compara
+     *          también Barnes-Hut con θ = 0, que debe coincidir con la suma directa
+     * @return true si todas las diferencias quedan bajo TOLERANCIA_FUERZAS_SIMD
+     */
+    bool probarNucleosFuerzas();
+    
+    /**
+     * @brief Ejecuta las pruebas que no necesitan respuestas del usuario
+     * @return Código de salida: 0 si todas pasan, 1 si alguna falla
+     */
+    int ejecutarPruebasAutomaticas();
+    
 } // namespace Testing
 
 #endif // TESTING_H
\ No newline at end of file
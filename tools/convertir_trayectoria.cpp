@@ -0,0 +1,38 @@
+/**
+ * @file convertir_trayectoria.cpp
+ * @brief Convierte una trayectoria binaria (sim_data.bin) al formato de texto
+ * @details Uso: convertir_trayectoria [entrada.bin] [salida.dat]
+ *          Por defecto convierte results/sim_data.bin en results/sim_data.dat,
+ *          que es el archivo que leen los scripts de graficación.
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "Trayectoria.h"
+
+int main(int argc, char* argv[]) {
+    std::string entrada = (argc > 1) ? argv[1] : "results/sim_data.bin";
+    std::string salida = (argc > 2) ? argv[2] : "results/sim_data.dat";
+
+    std::ifstream archivo(entrada.c_str(), std::ios::binary);
+    CabeceraTrayectoria cabecera;
+    std::string error;
+    if (!archivo.is_open() || !leerCabeceraTrayectoria(archivo, cabecera, error)) {
+        std::cerr << "Error: " << (error.empty() ? "no se pudo abrir " + entrada : error) << std::endl;
+        return 1;
+    }
+    archivo.close();
+    std::cout << entrada << ": formato v" << cabecera.version << ", N = " << cabecera.n_cuerpos
+              << ", dt = " << cabecera.dt << ", " << cabecera.n_cuadros << " cuadros de "
+              << cabecera.tam_cuadro << " bytes" << std::endl;
+
+    if (!convertirTrayectoriaATexto(entrada, salida, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "Trayectoria convertida a " << salida << std::endl;
+    return 0;
+}
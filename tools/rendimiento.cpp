@@ -0,0 +1,798 @@
+/**
+ * @file rendimiento.cpp
+ * @brief Mide el rendimiento de los motores de fuerza, la energía, el paso y la salida
+ * @details Uso: rendimiento [--rapido] [--n-max N] [--pasadas k] [--json archivo]
+ *                           [--referencia archivo] [--tolerancia x]
+ *                           [--dispersion-maxima x] [--estricto]
+ *
+ *          Cada prueba se repite hasta sumar un tiempo mínimo (0.25 s, 0.05 s
+ *          con --rapido) y se informa el tiempo por repetición (el menor de
+ *          cinco lotes) junto con la métrica propia de la prueba: ns por interacción
+ *          de pares (suma directa), ns por cuerpo (árboles y pasadas O(N)),
+ *          pasos por segundo (paso de Verlet completo) y bytes escritos por
+ *          segundo (trayectoria). La suma directa en precisión mixta se mide
+ *          igual que la de doble precisión y, además, se integra el mismo
+ *          sistema con los dos núcleos para comparar la deriva de la energía.
+ *          La suma directa multihilo se mide además con 1, 2, 4, ..., 64 hilos
+ *          sobre el mayor N de la suma directa, para ver su escalado.
+ *          Las pruebas de conjunto integran M sistemas de 3 cuerpos en
+ *          carriles SIMD (la columna N es M) y se comparan con los mismos M
+ *          sistemas integrados uno tras otro; su métrica es sistemas·pasos/s.
+ *          La lista completa de pruebas se recorre varias veces (3 por
+ *          defecto) y de cada prueba se guarda la pasada más rápida: en una
+ *          máquina compartida las perturbaciones duran segundos y afectan a
+ *          todos los lotes de una prueba a la vez, así que solo se evitan
+ *          comparando pasadas separadas en el tiempo. El ruido solo alarga
+ *          los tiempos, de modo que el mínimo es el estimador más estable del
+ *          coste real; la dispersión (desviación absoluta mediana entre
+ *          pasadas, relativa a la mediana) dice cuánto ruido tuvo la prueba.
+ *          Los resultados se guardan en JSON, un objeto por línea, y si se da
+ *          un archivo de referencia (otro JSON de este programa medido en el
+ *          mismo modo, rápido o completo) se compara el tiempo por repetición
+ *          de cada prueba común y se marcan las regresiones que superan la
+ *          tolerancia (10 % por defecto) más la dispersión de la prueba. Una
+ *          prueba con dispersión mayor que --dispersion-maxima (5 % por
+ *          defecto) se informa como inconclusa: su margen sería tan ancho que
+ *          ocultaría una regresión real.
+ *
+ *          Las condiciones iniciales son deterministas: posiciones de la
+ *          sucesión de Halton en el cubo [-1, 1]³, velocidades pequeñas y
+ *          masas iguales de suma 1, de modo que dos ejecuciones miden
+ *          exactamente el mismo trabajo.
+ * @author Isabel Nieto & Camilo Huertas
+ * @date 2025
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "SistemaCuerpos.h"
+#include "Fuerzas.h"
+#include "FuerzasSIMD.h"
+#include "SumaDirectaParalela.h"
+#include "GrupoHilos.h"
+#include "BarnesHut.h"
+#include "FMM.h"
+#include "Trayectoria.h"
+#include "ConjuntoSistemas.h"
+
+/// Resultado de una prueba
+struct MedicionRendimiento {
+    std::string prueba;          ///< Nombre de la prueba
+    int n;                       ///< Número de cuerpos
+    long repeticiones;           ///< Repeticiones medidas
+    double segundos;             ///< Tiempo por repetición [s]
+    double ns_por_interaccion;   ///< ns por par de cuerpos (0 si no aplica)
+    double ns_por_cuerpo;        ///< ns por cuerpo
+    double pasos_por_s;          ///< Pasos por segundo (0 si no aplica)
+    double bytes_por_s;          ///< Bytes escritos por segundo (0 si no aplica)
+    double deriva_energia;       ///< |E(t) - E(0)| / |E(0)| al final de la integración (0 si no aplica)
+    double dispersion;           ///< Desviación absoluta mediana / mediana entre pasadas (entre lotes con una pasada)
+};
+
+/// Opciones de la línea de comandos
+struct OpcionesRendimiento {
+    double tiempo_minimo;     ///< Tiempo mínimo medido por prueba [s]
+    int n_max;                ///< Mayor N de las pruebas
+    std::string json;         ///< Archivo de resultados
+    std::string referencia;   ///< Resultados de referencia (vacío = sin comparación)
+    double tolerancia;        ///< Aumento relativo del tiempo que cuenta como regresión
+    double dispersion_maxima; ///< Dispersión por encima de la cual una comparación es inconclusa
+    bool estricto;            ///< Terminar con código 3 si hay regresiones
+    bool rapido;              ///< Modo corto: solo se compara con una referencia del mismo modo
+    int pasadas;              ///< Veces que se recorre la lista completa de pruebas (se informa la más rápida)
+};
+
+/// Elemento k de la sucesión de Halton en la base dada, en [0, 1)
+static double halton(long k, int base) {
+    double resultado = 0.0, f = 1.0;
+    while (k > 0) {
+        f /= base;
+        resultado += f * (k % base);
+        k /= base;
+    }
+    return resultado;
+}
+
+/// Sistema determinista de n cuerpos en el cubo [-1, 1]³ con masa total 1
+static void generarSistema(SistemaCuerpos& cuerpos, int n) {
+    cuerpos.redimensionar(n);
+    for (int i = 0; i < n; ++i) {
+        cuerpos.x[i] = 2.0 * halton(i + 1, 2) - 1.0;
+        cuerpos.y[i] = 2.0 * halton(i + 1, 3) - 1.0;
+        cuerpos.z[i] = 2.0 * halton(i + 1, 5) - 1.0;
+        cuerpos.vx[i] = 0.1 * (halton(i + 1, 7) - 0.5);
+        cuerpos.vy[i] = 0.1 * (halton(i + 1, 11) - 0.5);
+        cuerpos.vz[i] = 0.1 * (halton(i + 1, 13) - 0.5);
+        cuerpos.fijarMasa(i, 1.0 / n);
+        cuerpos.R[i] = 0.0;
+    }
+}
+
+/// Repeticiones y ruido de una medición
+struct Muestreo {
+    long repeticiones; ///< Repeticiones medidas
+    double dispersion; ///< Desviación absoluta mediana / mediana de los lotes (0 con una sola medición)
+};
+
+/**
+ * @brief Dispersión robusta de una muestra de tiempos
+ * @param valores Tiempos (se reordenan)
+ * @return Desviación absoluta mediana dividida por la mediana: un lote o una
+ *         pasada interrumpidos no la cambian, a diferencia del rango
+ */
+static double dispersionRobusta(std::vector<double> valores) {
+    std::sort(valores.begin(), valores.end());
+    const double mediana = valores[(valores.size() - 1) / 2];
+    for (size_t k = 0; k < valores.size(); ++k) { valores[k] = std::fabs(valores[k] - mediana); }
+    std::sort(valores.begin(), valores.end());
+    return mediana > 0 ? valores[(valores.size() - 1) / 2] / mediana : 0.0;
+}
+
+/**
+ * @brief Repite una operación hasta sumar el tiempo mínimo
+ * @param operacion Functor sin argumentos
+ * @param tiempo_minimo Tiempo total mínimo [s]
+ * @param muestreo Salida: repeticiones medidas y dispersión entre lotes
+ * @return Tiempo por repetición [s]: el menor de cinco lotes
+ * @details La primera llamada calienta cachés y reservas de memoria y no se
+ *          cuenta, salvo que ya dure el tiempo mínimo (N grandes): entonces
+ *          es la única medición. El resto se reparte en cinco lotes de al
+ *          menos tiempo_minimo/5 cada uno; otro proceso solo puede alargar un
+ *          lote, así que el mínimo no depende de las interrupciones, y la
+ *          dispersión entre lotes dice cuánto ruido tiene la prueba en esta máquina
+ */
+template <class Operacion>
+static double medir(Operacion operacion, double tiempo_minimo, Muestreo& muestreo) {
+    typedef std::chrono::steady_clock reloj;
+    const reloj::time_point inicio_calentamiento = reloj::now();
+    operacion();
+    const double calentamiento = std::chrono::duration<double>(reloj::now() - inicio_calentamiento).count();
+    muestreo.repeticiones = 1;
+    muestreo.dispersion = 0.0;
+    if (calentamiento >= tiempo_minimo) return calentamiento;
+    muestreo.repeticiones = 0;
+    std::vector<double> lotes(5);
+    for (int lote = 0; lote < 5; ++lote) {
+        const reloj::time_point inicio = reloj::now();
+        double transcurrido = 0.0;
+        long repeticiones_lote = 0;
+        do {
+            operacion();
+            repeticiones_lote++;
+            transcurrido = std::chrono::duration<double>(reloj::now() - inicio).count();
+        } while (transcurrido < 0.2 * tiempo_minimo);
+        muestreo.repeticiones += repeticiones_lote;
+        lotes[lote] = transcurrido / repeticiones_lote;
+    }
+    muestreo.dispersion = dispersionRobusta(lotes);
+    return *std::min_element(lotes.begin(), lotes.end());
+}
+
+/// Tamaño de un archivo en bytes (0 si no existe)
+static double tamanoArchivo(const std::string& ruta) {
+    std::ifstream archivo(ruta.c_str(), std::ios::binary | std::ios::ate);
+    return archivo.is_open() ? static_cast<double>(archivo.tellg()) : 0.0;
+}
+
+/// Crea una medición con las métricas derivadas del tiempo por repetición
+static MedicionRendimiento crearMedicion(const std::string& prueba, int n, long repeticiones, double segundos) {
+    MedicionRendimiento m;
+    m.prueba = prueba;
+    m.n = n;
+    m.repeticiones = repeticiones;
+    m.segundos = segundos;
+    m.ns_por_interaccion = 0.0;
+    m.ns_por_cuerpo = 1e9 * segundos / n;
+    m.pasos_por_s = 0.0;
+    m.bytes_por_s = 0.0;
+    m.deriva_energia = 0.0;
+    m.dispersion = 0.0;
+    return m;
+}
+
+/// Crea una medición a partir del muestreo de medir()
+static MedicionRendimiento crearMedicion(const std::string& prueba, int n, const Muestreo& muestreo, double segundos) {
+    MedicionRendimiento m = crearMedicion(prueba, n, muestreo.repeticiones, segundos);
+    m.dispersion = muestreo.dispersion;
+    return m;
+}
+
+/// Imprime una medición en una línea de la tabla
+static void imprimirMedicion(const MedicionRendimiento& m) {
+    std::cout << std::left << std::setw(22) << m.prueba << std::right << std::setw(9) << m.n
+              << std::setw(8) << m.repeticiones << std::scientific << std::setprecision(3)
+              << std::setw(12) << m.segundos << std::defaultfloat << std::setprecision(4);
+    if (m.ns_por_interaccion > 0) std::cout << "  " << m.ns_por_interaccion << " ns/interacción";
+    std::cout << "  " << m.ns_por_cuerpo << " ns/cuerpo";
+    if (m.pasos_por_s > 0) std::cout << "  " << m.pasos_por_s << " pasos/s";
+    if (m.bytes_por_s > 0) std::cout << "  " << m.bytes_por_s / 1e6 << " MB/s";
+    if (m.deriva_energia > 0) std::cout << "  ΔE/E = " << std::scientific << std::setprecision(3) << m.deriva_energia;
+    if (m.dispersion > 0) std::cout << "  dispersión " << std::fixed << std::setprecision(2) << m.dispersion;
+    std::cout << std::endl;
+}
+
+/// Suma directa de un solo hilo con el núcleo vectorizado activo
+static void pruebaFuerzasDirecta(const OpcionesRendimiento& opciones, const std::vector<int>& tamanos,
+                                 std::vector<MedicionRendimiento>& resultados) {
+    for (size_t k = 0; k < tamanos.size(); ++k) {
+        const int n = tamanos[k];
+        SistemaCuerpos cuerpos;
+        generarSistema(cuerpos, n);
+        Aceleraciones a;
+        a.redimensionar(n);
+        Muestreo muestreo;
+        const double t = medir([&]() { calcularTodasLasFuerzas(cuerpos, a); }, opciones.tiempo_minimo, muestreo);
+        MedicionRendimiento m = crearMedicion("fuerzas_directa", n, muestreo, t);
+        m.ns_por_interaccion = 1e9 * t / (0.5 * n * (n - 1.0));
+        imprimirMedicion(m);
+        resultados.push_back(m);
+    }
+}
+
+/// Suma directa repartida entre todos los núcleos
+static void pruebaFuerzasParalela(const OpcionesRendimiento& opciones, const std::vector<int>& tamanos,
+                                  std::vector<MedicionRendimiento>& resultados) {
+    SumaDirectaParalela suma(GrupoHilos::hilosDisponibles());
+    for (size_t k = 0; k < tamanos.size(); ++k) {
+        const int n = tamanos[k];
+        SistemaCuerpos cuerpos;
+        generarSistema(cuerpos, n);
+        Aceleraciones a;
+        a.redimensionar(n);
+        Muestreo muestreo;
+        const double t = medir([&]() { suma.calcularFuerzas(cuerpos, a); }, opciones.tiempo_minimo, muestreo);
+        MedicionRendimiento m = crearMedicion("fuerzas_paralela", n, muestreo, t);
+        m.ns_por_interaccion = 1e9 * t / (0.5 * n * (n - 1.0));
+        imprimirMedicion(m);
+        resultados.push_back(m);
+    }
+}
+
+/**
+ * @brief Escalado de la suma directa multihilo con 1, 2, 4, ..., hilos_max hilos
+ * @param n Número de cuerpos
+ * @details Cada número de hilos es una prueba (escalado_hilos_T) y al final se
+ *          imprimen la aceleración t(1)/t(T) y la eficiencia t(1)/(T·t(T)).
+ *          Con más hilos que núcleos solo se mide la sobrecarga del reparto y
+ *          de la reducción de los T arreglos de N aceleraciones
+ */
+static void pruebaEscaladoHilos(const OpcionesRendimiento& opciones, int n, int hilos_max,
+                                std::vector<MedicionRendimiento>& resultados) {
+    SistemaCuerpos cuerpos;
+    generarSistema(cuerpos, n);
+    Aceleraciones a;
+    a.redimensionar(n);
+    std::vector<int> hilos;
+    std::vector<double> tiempos;
+    for (int h = 1; h <= hilos_max; h *= 2) {
+        SumaDirectaParalela suma(h);
+        Muestreo muestreo;
+        const double t = medir([&]() { suma.calcularFuerzas(cuerpos, a); }, opciones.tiempo_minimo, muestreo);
+        std::ostringstream nombre;
+        nombre << "escalado_hilos_" << h;
+        MedicionRendimiento m = crearMedicion(nombre.str(), n, muestreo, t);
+        m.ns_por_interaccion = 1e9 * t / (0.5 * n * (n - 1.0));
+        imprimirMedicion(m);
+        resultados.push_back(m);
+        hilos.push_back(h);
+        tiempos.push_back(t);
+    }
+    std::cout << "  N = " << n << ", " << GrupoHilos::hilosDisponibles()
+              << " núcleos disponibles; hilos / aceleración / eficiencia:";
+    for (size_t k = 0; k < hilos.size(); ++k) {
+        std::cout << std::fixed << std::setprecision(2) << "  " << hilos[k] << " / " << tiempos[0] / tiempos[k]
+                  << " / " << tiempos[0] / (hilos[k] * tiempos[k]);
+    }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+/// Suma directa de un solo hilo en precisión mixta (pares contados una vez, como fuerzas_directa)
+static void pruebaFuerzasMixtas(const OpcionesRendimiento& opciones, const std::vector<int>& tamanos,
+                                std::vector<MedicionRendimiento>& resultados) {
+    CoordenadasSimples simples;
+    for (size_t k = 0; k < tamanos.size(); ++k) {
+        const int n = tamanos[k];
+        SistemaCuerpos cuerpos;
+        generarSistema(cuerpos, n);
+        Aceleraciones a;
+        a.redimensionar(n);
+        Muestreo muestreo;
+        const double t = medir([&]() { calcularFuerzasMixtas(cuerpos, simples, a, nivelSIMDActivo()); },
+                               opciones.tiempo_minimo, muestreo);
+        MedicionRendimiento m = crearMedicion("fuerzas_mixta", n, muestreo, t);
+        m.ns_por_interaccion = 1e9 * t / (0.5 * n * (n - 1.0));
+        imprimirMedicion(m);
+        resultados.push_back(m);
+    }
+}
+
+/**
+ * @brief Deriva de la energía con la suma directa en doble precisión y en precisión mixta
+ * @details Integra el mismo sistema con Verlet de velocidades durante un
+ *          número fijo de pasos con cada núcleo. La energía se evalúa en
+ *          doble precisión (calcularEnergiaPotencialTotal) al principio y al
+ *          final, para que la comparación mida la integración y no el
+ *          redondeo del potencial. Se informa además la diferencia RMS entre
+ *          las posiciones finales de las dos integraciones.
+ */
+static void pruebaDerivaMixta(const std::vector<int>& tamanos, int pasos,
+                              std::vector<MedicionRendimiento>& resultados) {
+    const double dt = 1e-3;
+    typedef std::chrono::steady_clock reloj;
+    CoordenadasSimples simples;
+    for (size_t k = 0; k < tamanos.size(); ++k) {
+        const int n = tamanos[k];
+        SistemaCuerpos finales[2];
+        double derivas[2];
+        for (int mixta = 0; mixta < 2; ++mixta) {
+            SistemaCuerpos& cuerpos = finales[mixta];
+            generarSistema(cuerpos, n);
+            Aceleraciones a_siguiente;
+            a_siguiente.redimensionar(n);
+            const double E_inicial = calcularDiagnosticos(cuerpos, calcularEnergiaPotencialTotal(cuerpos)).energiaTotal();
+            if (mixta) calcularFuerzasMixtas(cuerpos, simples, a_siguiente, nivelSIMDActivo());
+            else calcularTodasLasFuerzas(cuerpos, a_siguiente);
+            cuerpos.intercambiarAceleraciones(a_siguiente);
+            const reloj::time_point inicio = reloj::now();
+            for (int paso = 0; paso < pasos; ++paso) {
+                cuerpos.Muevase_r(dt);
+                if (mixta) calcularFuerzasMixtas(cuerpos, simples, a_siguiente, nivelSIMDActivo());
+                else calcularTodasLasFuerzas(cuerpos, a_siguiente);
+                cuerpos.Muevase_V(dt, a_siguiente);
+                cuerpos.intercambiarAceleraciones(a_siguiente);
+            }
+            const double t = std::chrono::duration<double>(reloj::now() - inicio).count() / pasos;
+            const double E_final = calcularDiagnosticos(cuerpos, calcularEnergiaPotencialTotal(cuerpos)).energiaTotal();
+            derivas[mixta] = std::fabs((E_final - E_inicial) / E_inicial);
+            MedicionRendimiento m = crearMedicion(mixta ? "deriva_mixta" : "deriva_doble", n, pasos, t);
+            m.pasos_por_s = 1.0 / t;
+            m.deriva_energia = derivas[mixta];
+            imprimirMedicion(m);
+            resultados.push_back(m);
+        }
+        double suma2 = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const double dx = finales[1].x[i] - finales[0].x[i];
+            const double dy = finales[1].y[i] - finales[0].y[i];
+            const double dz = finales[1].z[i] - finales[0].z[i];
+            suma2 += dx * dx + dy * dy + dz * dz;
+        }
+        std::cout << std::defaultfloat << std::setprecision(3) << "  N = " << n << ", " << pasos << " pasos de dt = "
+                  << dt << ": deriva mixta / doble = " << derivas[1] / std::max(derivas[0], 1e-300)
+                  << ", diferencia RMS de las posiciones finales = " << std::sqrt(suma2 / n)
+                  << " (el cubo mide 2 de lado)" << std::endl;
+    }
+}
+
+/// Barnes-Hut (θ = 0.5) y FMM (p = 8), incluida la construcción del árbol
+static void pruebaFuerzasArboles(const OpcionesRendimiento& opciones, const std::vector<int>& tamanos,
+                                 std::vector<MedicionRendimiento>& resultados) {
+    BarnesHut barnes_hut(0.5);
+    FMM fmm(8);
+    for (size_t k = 0; k < tamanos.size(); ++k) {
+        const int n = tamanos[k];
+        SistemaCuerpos cuerpos;
+        generarSistema(cuerpos, n);
+        Aceleraciones a;
+        a.redimensionar(n);
+        Muestreo muestreo;
+        double t = medir([&]() { barnes_hut.calcularFuerzas(cuerpos, a); }, opciones.tiempo_minimo, muestreo);
+        MedicionRendimiento m = crearMedicion("fuerzas_barnes_hut", n, muestreo, t);
+        imprimirMedicion(m);
+        resultados.push_back(m);
+        t = medir([&]() { fmm.calcularFuerzas(cuerpos, a); }, opciones.tiempo_minimo, muestreo);
+        m = crearMedicion("fuerzas_fmm", n, muestreo, t);
+        imprimirMedicion(m);
+        resultados.push_back(m);
+    }
+}
+
+/// Energía: pasada O(N) de diagnósticos y potencial O(N²) por separado
+static void pruebaEnergia(const OpcionesRendimiento& opciones, const std::vector<int>& tamanos_directa,
+                          const std::vector<int>& tamanos, std::vector<MedicionRendimiento>& resultados) {
+    volatile double sumidero = 0.0; // Impide que el compilador descarte los cálculos
+    for (size_t k = 0; k < tamanos.size(); ++k) {
+        const int n = tamanos[k];
+        SistemaCuerpos cuerpos;
+        generarSistema(cuerpos, n);
+        Muestreo muestreo;
+        const double t = medir([&]() { sumidero = sumidero + calcularDiagnosticos(cuerpos, 0.0).energiaTotal(); },
+                               opciones.tiempo_minimo, muestreo);
+        MedicionRendimiento m = crearMedicion("diagnosticos", n, muestreo, t);
+        imprimirMedicion(m);
+        resultados.push_back(m);
+    }
+    for (size_t k = 0; k < tamanos_directa.size(); ++k) {
+        const int n = tamanos_directa[k];
+        SistemaCuerpos cuerpos;
+        generarSistema(cuerpos, n);
+        Muestreo muestreo;
+        const double t = medir([&]() { sumidero = sumidero + calcularEnergiaPotencialTotal(cuerpos); },
+                               opciones.tiempo_minimo, muestreo);
+        MedicionRendimiento m = crearMedicion("energia_potencial", n, muestreo, t);
+        m.ns_por_interaccion = 1e9 * t / (0.5 * n * (n - 1.0));
+        imprimirMedicion(m);
+        resultados.push_back(m);
+    }
+}
+
+/**
+ * @brief Paso completo de Verlet de velocidades con doble buffer, como pasoVerlet()
+ * @details Con suma directa hasta los tamaños directos y con Barnes-Hut por
+ *          encima; el nombre de la prueba indica el motor
+ */
+static void pruebaPasoVerlet(const OpcionesRendimiento& opciones, const std::vector<int>& tamanos_directa,
+                             const std::vector<int>& tamanos_arbol, std::vector<MedicionRendimiento>& resultados) {
+    const double dt = 1e-4;
+    BarnesHut barnes_hut(0.5);
+    for (int motor = 0; motor < 2; ++motor) {
+        const std::vector<int>& tamanos = (motor == 0) ? tamanos_directa : tamanos_arbol;
+        for (size_t k = 0; k < tamanos.size(); ++k) {
+            const int n = tamanos[k];
+            SistemaCuerpos cuerpos;
+            generarSistema(cuerpos, n);
+            Aceleraciones a_siguiente;
+            a_siguiente.redimensionar(n);
+            calcularTodasLasFuerzas(cuerpos, a_siguiente);
+            cuerpos.intercambiarAceleraciones(a_siguiente);
+            Muestreo muestreo;
+            const double t = medir([&]() {
+                cuerpos.Muevase_r(dt);
+                if (motor == 0) calcularTodasLasFuerzas(cuerpos, a_siguiente);
+                else barnes_hut.calcularFuerzas(cuerpos, a_siguiente);
+                cuerpos.Muevase_V(dt, a_siguiente);
+                cuerpos.intercambiarAceleraciones(a_siguiente);
+            }, opciones.tiempo_minimo, muestreo);
+            MedicionRendimiento m = crearMedicion(motor == 0 ? "paso_verlet_directa" : "paso_verlet_barnes_hut",
+                                                  n, muestreo, t);
+            m.pasos_por_s = 1.0 / t;
+            imprimirMedicion(m);
+            resultados.push_back(m);
+        }
+    }
+}
+
+/**
+ * @brief Paso de Verlet de M sistemas de 3 cuerpos: en carriles SIMD y uno tras otro
+ * @details Cada repetición avanza 10 pasos. Los cuerpos no tienen radio y no
+ *          hay radio de escape, así que todos los miembros siguen activos y
+ *          se mide el régimen de carriles llenos. La referencia
+ *          "conjunto_separados" integra los mismos sistemas como M
+ *          SistemaCuerpos independientes con la suma directa habitual.
+ */
+static void pruebaConjunto(const OpcionesRendimiento& opciones, const std::vector<int>& miembros,
+                           std::vector<MedicionRendimiento>& resultados) {
+    const double dt = 1e-3;
+    const int pasos = 10;
+    std::vector<Cuerpo> plantilla(3);
+    plantilla[0].Inicie(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 50.0, 0.0);
+    plantilla[1].Inicie(4.0, 0.0, 1.0, 0.0, 2.8, 1.5, 8.0, 0.0);
+    plantilla[2].Inicie(-2.0, 3.5, -1.0, 1.5, -1.0, -0.8, 8.0, 0.0);
+    const NivelSIMD niveles[] = {SIMD_ESCALAR, SIMD_AVX2, SIMD_AVX512};
+    const char* nombres[] = {"conjunto_escalar", "conjunto_avx2", "conjunto_avx512"};
+    for (size_t k = 0; k < miembros.size(); ++k) {
+        const int m = miembros[k];
+        for (int q = 0; q < 3; ++q) {
+            if (niveles[q] > detectarNivelSIMD()) continue;
+            ConjuntoSistemas conjunto;
+            conjunto.fijarNivelSIMD(niveles[q]);
+            conjunto.inicializar(plantilla, m, 1e-3, 1);
+            Muestreo muestreo;
+            const double t = medir([&]() { conjunto.avanzar(dt, pasos); }, opciones.tiempo_minimo, muestreo);
+            MedicionRendimiento medicion = crearMedicion(nombres[q], m, muestreo, t);
+            medicion.ns_por_cuerpo = 1e9 * t / (static_cast<double>(pasos) * m * 3);
+            medicion.pasos_por_s = pasos * m / t;
+            imprimirMedicion(medicion);
+            resultados.push_back(medicion);
+        }
+        // Los mismos sistemas, cada uno en su propio SistemaCuerpos
+        ConjuntoSistemas conjunto;
+        conjunto.inicializar(plantilla, m, 1e-3, 1);
+        std::vector<SistemaCuerpos> separados(m);
+        std::vector<Aceleraciones> a_siguiente(m);
+        for (int s = 0; s < m; ++s) {
+            std::vector<Cuerpo> cuerpos(3);
+            for (int c = 0; c < 3; ++c) { cuerpos[c] = conjunto.cuerpo(s, c); }
+            separados[s].cargarDesde(cuerpos);
+            a_siguiente[s].redimensionar(3);
+            calcularTodasLasFuerzas(separados[s], a_siguiente[s]);
+            separados[s].intercambiarAceleraciones(a_siguiente[s]);
+        }
+        Muestreo muestreo;
+        const double t = medir([&]() {
+            for (int s = 0; s < m; ++s) {
+                for (int p = 0; p < pasos; ++p) {
+                    separados[s].Muevase_r(dt);
+                    calcularTodasLasFuerzas(separados[s], a_siguiente[s]);
+                    separados[s].Muevase_V(dt, a_siguiente[s]);
+                    separados[s].intercambiarAceleraciones(a_siguiente[s]);
+                }
+            }
+        }, opciones.tiempo_minimo, muestreo);
+        MedicionRendimiento medicion = crearMedicion("conjunto_separados", m, muestreo, t);
+        medicion.ns_por_cuerpo = 1e9 * t / (static_cast<double>(pasos) * m * 3);
+        medicion.pasos_por_s = pasos * m / t;
+        imprimirMedicion(medicion);
+        resultados.push_back(medicion);
+    }
+}
+
+/// Escritura de la trayectoria (todos los cuerpos, campos pv) en texto y en binario
+static void pruebaSalida(const OpcionesRendimiento& opciones, const std::vector<int>& tamanos,
+                         const std::string& directorio, std::vector<MedicionRendimiento>& resultados) {
+    for (int formato = TRAYECTORIA_TEXTO; formato <= TRAYECTORIA_BINARIA; ++formato) {
+        for (size_t k = 0; k < tamanos.size(); ++k) {
+            const int n = tamanos[k];
+            SistemaCuerpos cuerpos;
+            generarSistema(cuerpos, n);
+            SeleccionSalida seleccion = {0, n, CAMPO_POSICIONES | CAMPO_VELOCIDADES};
+            const std::string ruta = directorio + "/rendimiento_salida.tmp";
+            EscritorTrayectoria escritor;
+            if (!escritor.abrir(ruta, static_cast<FormatoTrayectoria>(formato), n, 1e-3, seleccion)) {
+                std::cerr << "Aviso: no se pudo abrir " << ruta << "; se omite la prueba de salida" << std::endl;
+                return;
+            }
+            double t_sim = 0.0;
+            Muestreo muestreo;
+            // El cierre (vaciado del búfer) se mide aparte y se reparte entre los cuadros
+            typedef std::chrono::steady_clock reloj;
+            const double t = medir([&]() { escritor.escribirCuadro(t_sim, cuerpos, 0.0, 0.0, 0.0); t_sim += 1e-3; },
+                                   opciones.tiempo_minimo, muestreo);
+            const long cuadros = escritor.cuadros();
+            const reloj::time_point inicio_cierre = reloj::now();
+            escritor.cerrar();
+            const double t_cierre = std::chrono::duration<double>(reloj::now() - inicio_cierre).count();
+            const double bytes = tamanoArchivo(ruta);
+            std::remove(ruta.c_str());
+            const double t_cuadro = t + t_cierre / cuadros;
+            MedicionRendimiento m = crearMedicion(formato == TRAYECTORIA_TEXTO ? "salida_texto" : "salida_binaria",
+                                                  n, muestreo, t_cuadro);
+            m.bytes_por_s = bytes / (t_cuadro * cuadros);
+            imprimirMedicion(m);
+            resultados.push_back(m);
+        }
+    }
+}
+
+/// Escribe los resultados en JSON, un objeto por línea
+static bool guardarJSON(const std::string& ruta, bool rapido, const std::vector<MedicionRendimiento>& resultados) {
+    std::ofstream archivo(ruta.c_str());
+    if (!archivo.is_open()) return false;
+    archivo << "{\n  \"modo\": \"" << (rapido ? "rapido" : "completo") << "\",\n"
+            << "  \"nucleo_simd\": \"" << nombreNivelSIMD(nivelSIMDActivo()) << "\",\n"
+            << "  \"hilos\": " << GrupoHilos::hilosDisponibles() << ",\n"
+            << "  \"compilador\": \"" << __VERSION__ << "\",\n"
+            << "  \"resultados\": [\n" << std::setprecision(6);
+    for (size_t k = 0; k < resultados.size(); ++k) {
+        const MedicionRendimiento& m = resultados[k];
+        archivo << "    {\"prueba\": \"" << m.prueba << "\", \"n\": " << m.n << ", \"repeticiones\": " << m.repeticiones
+                << ", \"segundos\": " << m.segundos << ", \"ns_por_interaccion\": " << m.ns_por_interaccion
+                << ", \"ns_por_cuerpo\": " << m.ns_por_cuerpo << ", \"pasos_por_s\": " << m.pasos_por_s
+                << ", \"bytes_por_s\": " << m.bytes_por_s << ", \"deriva_energia\": " << m.deriva_energia
+                << ", \"dispersion\": " << m.dispersion << "}" << (k + 1 < resultados.size() ? "," : "") << "\n";
+    }
+    archivo << "  ]\n}\n";
+    return archivo.good();
+}
+
+/// Valor de una clave en una línea de resultados de guardarJSON()
+static std::string valorJSON(const std::string& linea, const std::string& clave) {
+    const std::string patron = "\"" + clave + "\": ";
+    size_t inicio = linea.find(patron);
+    if (inicio == std::string::npos) return "";
+    inicio += patron.size();
+    if (linea[inicio] == '"') {
+        const size_t fin = linea.find('"', inicio + 1);
+        return (fin == std::string::npos) ? "" : linea.substr(inicio + 1, fin - inicio - 1);
+    }
+    const size_t fin = linea.find_first_of(",}", inicio);
+    return linea.substr(inicio, fin == std::string::npos ? std::string::npos : fin - inicio);
+}
+
+/**
+ * @brief Lee un archivo escrito por guardarJSON()
+ * @param modo Salida: "rapido" o "completo" (los archivos sin modo son completos)
+ * @return false si no se pudo abrir
+ */
+static bool leerJSON(const std::string& ruta, std::string& modo, std::vector<MedicionRendimiento>& resultados) {
+    std::ifstream archivo(ruta.c_str());
+    if (!archivo.is_open()) return false;
+    modo = "completo";
+    std::string linea;
+    while (std::getline(archivo, linea)) {
+        if (!valorJSON(linea, "modo").empty()) modo = valorJSON(linea, "modo");
+        const std::string prueba = valorJSON(linea, "prueba");
+        if (prueba.empty()) continue;
+        MedicionRendimiento m = crearMedicion(prueba, std::atoi(valorJSON(linea, "n").c_str()),
+                                              std::atol(valorJSON(linea, "repeticiones").c_str()),
+                                              std::atof(valorJSON(linea, "segundos").c_str()));
+        m.dispersion = std::atof(valorJSON(linea, "dispersion").c_str());
+        if (m.n > 0 && m.segundos > 0) resultados.push_back(m);
+    }
+    return true;
+}
+
+/**
+ * @brief Reduce las pasadas a una medición por prueba
+ * @param pasadas Resultados de cada pasada, con las mismas pruebas en el mismo orden
+ * @return De cada prueba, la medición de la pasada más rápida, con la
+ *         dispersión entre pasadas
+ */
+static std::vector<MedicionRendimiento> combinarPasadas(const std::vector<std::vector<MedicionRendimiento> >& pasadas) {
+    std::vector<MedicionRendimiento> resultados;
+    if (pasadas.size() == 1) return pasadas[0];
+    std::vector<double> tiempos(pasadas.size());
+    for (size_t k = 0; k < pasadas[0].size(); ++k) {
+        size_t mas_rapida = 0;
+        for (size_t p = 0; p < pasadas.size(); ++p) {
+            tiempos[p] = pasadas[p][k].segundos;
+            if (tiempos[p] < tiempos[mas_rapida]) mas_rapida = p;
+        }
+        MedicionRendimiento m = pasadas[mas_rapida][k];
+        m.dispersion = dispersionRobusta(tiempos);
+        resultados.push_back(m);
+    }
+    return resultados;
+}
+
+/**
+ * @brief Compara el tiempo por repetición con la referencia
+ * @details La tolerancia de cada prueba es la general más la mayor de las
+ *          dispersiones de las dos mediciones, que no pasa de
+ *          dispersion_maxima: una prueba algo ruidosa necesita más margen que
+ *          una estable, pero con más ruido que eso la comparación es
+ *          inconclusa y no se cuenta como superada ni como regresión
+ * @return Número de regresiones (tiempo mayor que la referencia por más de su tolerancia)
+ */
+static int compararConReferencia(const std::vector<MedicionRendimiento>& resultados,
+                                 const std::vector<MedicionRendimiento>& referencia, double tolerancia,
+                                 double dispersion_maxima) {
+    int regresiones = 0, mejoras = 0, inconclusas = 0, comparadas = 0;
+    std::cout << "\nComparación con la referencia (tiempo actual / referencia; tolerancia "
+              << 100 * tolerancia << " % más la dispersión de la prueba, hasta "
+              << 100 * dispersion_maxima << " %):" << std::endl;
+    for (size_t k = 0; k < resultados.size(); ++k) {
+        const MedicionRendimiento& m = resultados[k];
+        for (size_t j = 0; j < referencia.size(); ++j) {
+            if (referencia[j].prueba != m.prueba || referencia[j].n != m.n) continue;
+            const double cociente = m.segundos / referencia[j].segundos;
+            const double dispersion = std::max(m.dispersion, referencia[j].dispersion);
+            const double tolerancia_prueba = tolerancia + std::min(dispersion, dispersion_maxima);
+            comparadas++;
+            const char* marca = "";
+            if (dispersion > dispersion_maxima) { marca = "  inconclusa (ruidosa)"; inconclusas++; }
+            else if (cociente > 1.0 + tolerancia_prueba) { marca = "  REGRESIÓN"; regresiones++; }
+            else if (cociente < 1.0 - tolerancia_prueba) { marca = "  mejora"; mejoras++; }
+            std::cout << std::left << std::setw(22) << m.prueba << std::right << std::setw(9) << m.n
+                      << std::fixed << std::setprecision(3) << std::setw(9) << cociente << "  ±"
+                      << std::setprecision(2) << tolerancia_prueba << marca
+                      << std::defaultfloat << std::endl;
+            break;
+        }
+    }
+    std::cout << comparadas << " pruebas comparadas: " << regresiones << " regresiones, " << mejoras
+              << " mejoras, " << inconclusas << " inconclusas (dispersión mayor que "
+              << 100 * dispersion_maxima << " %; repita con más --pasadas o en una máquina más tranquila)" << std::endl;
+    return regresiones;
+}
+
+/// Tamaños de la lista que no superan n_max
+static std::vector<int> hasta(const int* lista, int cantidad, int n_max) {
+    std::vector<int> tamanos;
+    for (int k = 0; k < cantidad; ++k) {
+        if (lista[k] <= n_max) tamanos.push_back(lista[k]);
+    }
+    return tamanos;
+}
+
+int main(int argc, char* argv[]) {
+    OpcionesRendimiento opciones = {0.25, 1000000, "results/rendimiento.json", "", 0.10, 0.05, false, false, 3};
+    for (int k = 1; k < argc; ++k) {
+        const std::string argumento = argv[k];
+        const bool hay_valor = k + 1 < argc;
+        if (argumento == "--rapido") { opciones.rapido = true; }
+        else if (argumento == "--estricto") { opciones.estricto = true; }
+        else if (argumento == "--n-max" && hay_valor) { opciones.n_max = std::atoi(argv[++k]); }
+        else if (argumento == "--pasadas" && hay_valor) { opciones.pasadas = std::atoi(argv[++k]); }
+        else if (argumento == "--json" && hay_valor) { opciones.json = argv[++k]; }
+        else if (argumento == "--referencia" && hay_valor) { opciones.referencia = argv[++k]; }
+        else if (argumento == "--tolerancia" && hay_valor) { opciones.tolerancia = std::atof(argv[++k]); }
+        else if (argumento == "--dispersion-maxima" && hay_valor) { opciones.dispersion_maxima = std::atof(argv[++k]); }
+        else {
+            std::cerr << "Uso: " << argv[0] << " [--rapido] [--n-max N] [--pasadas k] [--json archivo]"
+                      << " [--referencia archivo] [--tolerancia x] [--dispersion-maxima x] [--estricto]" << std::endl;
+            return 2;
+        }
+    }
+    if (opciones.rapido) {
+        opciones.tiempo_minimo = 0.05;
+        opciones.n_max = std::min(opciones.n_max, 131072);
+    }
+    if (opciones.n_max < 2 || opciones.tolerancia <= 0 || opciones.dispersion_maxima < 0 || opciones.pasadas < 1) {
+        std::cerr << "Error: --n-max debe ser al menos 2, --pasadas al menos 1, --tolerancia positiva"
+                  << " y --dispersion-maxima no negativa" << std::endl;
+        return 2;
+    }
+
+    // La suma directa llega a 32768 cuerpos (5·10⁸ pares); los árboles y las pasadas O(N), a 10⁶
+    // (el paso con Barnes-Hut, a 131072: a 10⁶ repetiría la medición de las fuerzas)
+    const int lista_directa[] = {2, 8, 64, 512, 4096, 32768};
+    const int lista_arbol[] = {1024, 16384, 131072, 1000000};
+    const int lista_lineal[] = {2, 64, 4096, 131072, 1000000};
+    const int lista_salida[] = {2, 64, 4096, 131072};
+    const std::vector<int> directa = hasta(lista_directa, 6, std::min(opciones.n_max, opciones.rapido ? 4096 : 32768));
+    const std::vector<int> arbol = hasta(lista_arbol, 4, opciones.n_max);
+    const std::vector<int> lineal = hasta(lista_lineal, 5, opciones.n_max);
+    const std::vector<int> salida = hasta(lista_salida, 4, opciones.n_max);
+    std::vector<int> paralela;
+    if (GrupoHilos::hilosDisponibles() > 1) {
+        for (size_t k = 0; k < directa.size(); ++k) { if (directa[k] >= 4096) paralela.push_back(directa[k]); }
+    }
+
+    std::cout << "Núcleo de suma directa: " << nombreNivelSIMD(nivelSIMDActivo()) << ", "
+              << GrupoHilos::hilosDisponibles() << " hilos disponibles; tiempo mínimo por prueba "
+              << opciones.tiempo_minimo << " s, " << opciones.pasadas << " pasadas" << std::endl;
+    const size_t barra = opciones.json.find_last_of('/');
+    std::vector<std::vector<MedicionRendimiento> > pasadas(opciones.pasadas);
+    for (int p = 0; p < opciones.pasadas; ++p) {
+        std::cout << "\nPasada " << p + 1 << " de " << opciones.pasadas << std::endl;
+        std::cout << std::left << std::setw(22) << "prueba" << std::right << std::setw(9) << "N" << std::setw(8)
+                  << "rep." << std::setw(12) << "s/rep." << std::endl;
+        std::vector<MedicionRendimiento>& resultados = pasadas[p];
+        pruebaFuerzasDirecta(opciones, directa, resultados);
+        pruebaFuerzasMixtas(opciones, directa, resultados);
+        pruebaFuerzasParalela(opciones, paralela, resultados);
+        pruebaEscaladoHilos(opciones, directa.back(), 64, resultados);
+        pruebaFuerzasArboles(opciones, arbol, resultados);
+        pruebaEnergia(opciones, directa, lineal, resultados);
+        pruebaPasoVerlet(opciones, directa, hasta(lista_arbol, 3, opciones.n_max), resultados);
+        // La deriva se mide con un número fijo de pasos (no con el tiempo mínimo): 1024 y 4096 cuerpos
+        const int lista_deriva[] = {1024, 4096};
+        pruebaDerivaMixta(hasta(lista_deriva, 2, std::min(opciones.n_max, opciones.rapido ? 1024 : 4096)), 200, resultados);
+        // Conjuntos de 64 y 4096 sistemas de 3 cuerpos (N es aquí el número de sistemas)
+        const int lista_conjunto[] = {64, 4096};
+        pruebaConjunto(opciones, std::vector<int>(lista_conjunto, lista_conjunto + 2), resultados);
+        pruebaSalida(opciones, salida, barra == std::string::npos ? "." : opciones.json.substr(0, barra), resultados);
+    }
+    const std::vector<MedicionRendimiento> resultados = combinarPasadas(pasadas);
+    if (opciones.pasadas > 1) {
+        std::cout << "\nMínimo de " << opciones.pasadas << " pasadas (dispersión = desviación absoluta mediana / mediana):"
+                  << std::endl;
+        for (size_t k = 0; k < resultados.size(); ++k) { imprimirMedicion(resultados[k]); }
+    }
+
+    if (!guardarJSON(opciones.json, opciones.rapido, resultados)) {
+        std::cerr << "Error: no se pudo escribir " << opciones.json << std::endl;
+        return 1;
+    }
+    std::cout << "Resultados guardados en " << opciones.json << std::endl;
+
+    if (!opciones.referencia.empty()) {
+        std::vector<MedicionRendimiento> referencia;
+        std::string modo;
+        if (!leerJSON(opciones.referencia, modo, referencia)) {
+            std::cout << "Sin referencia en " << opciones.referencia
+                      << " (se crea con make bench-referencia); no se compara" << std::endl;
+            return 0;
+        }
+        if (modo != (opciones.rapido ? "rapido" : "completo")) {
+            // Con 0.05 s por prueba y N menores, los tiempos no son comparables con los del modo completo
+            std::cout << "La referencia " << opciones.referencia << " se midió en modo " << modo
+                      << "; solo se compara con una referencia del mismo modo" << std::endl;
+            return 0;
+        }
+        const int regresiones = compararConReferencia(resultados, referencia, opciones.tolerancia,
+                                                        opciones.dispersion_maxima);
+        if (regresiones > 0 && opciones.estricto) return 3;
+    }
+    return 0;
+}